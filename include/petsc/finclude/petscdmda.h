@@ -11,6 +11,7 @@
 #include "petsc/finclude/petscdm.h"
 
 #define DMDAStencilType PetscEnum
+#define DMDAGhostUpdateType PetscEnum
 
 #define DMDALocalInfo PetscInt
 !
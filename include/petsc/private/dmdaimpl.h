@@ -8,6 +8,9 @@
 #include <petscdmda.h>
 #include <petsc/private/dmimpl.h>
 
+typedef struct _n_DMDAGhostRMA *DMDAGhostRMA;
+typedef struct _n_DMDAGhostHalo *DMDAGhostHalo;
+
 typedef struct {
   PetscInt              M,N,P;                 /* array dimensions */
   PetscInt              m,n,p;                 /* processor layout */
@@ -20,6 +23,10 @@ typedef struct {
   DMBoundaryType        bx,by,bz;              /* indicates type of ghost nodes at boundary */
   VecScatter            gtol,ltol;        /* scatters, see below for details */
   DMDAStencilType       stencil_type;          /* stencil, either box or star */
+  DMDAGhostUpdateType   ghostupdate;           /* how DMGlobalToLocal() updates the ghost points */
+  DMDAGhostRMA          rma;                   /* one-sided ghost update, created at the first update */
+  DMDAGhostHalo         halo;                  /* structured ghost update, created at the first update */
+  PetscInt              tilesize[3];           /* size of the tiles of DMDATileIterator, 0 for the default */
   DMDAInterpolationType interptype;
 
   PetscInt              nlocal,Nlocal;         /* local size of local vector and global vector, includes the * w term */
@@ -88,6 +95,13 @@ typedef struct {
             nearest neighbor timestepping.
 */
 
+PETSC_INTERN PetscErrorCode DMDAGhostRMABegin(DM,Vec,Vec,PetscBool*);
+PETSC_INTERN PetscErrorCode DMDAGhostRMAEnd(DM,Vec,PetscBool*);
+PETSC_INTERN PetscErrorCode DMDAGhostRMADestroy(DMDAGhostRMA*);
+PETSC_INTERN PetscErrorCode DMDAGhostHaloBegin(DM,Vec,Vec,PetscBool*);
+PETSC_INTERN PetscErrorCode DMDAGhostHaloEnd(DM,Vec,PetscBool*);
+PETSC_INTERN PetscErrorCode DMDAGhostHaloDestroy(DMDAGhostHalo*);
+PETSC_INTERN PetscErrorCode DMDAGhostHaloInProgress(DMDAGhostHalo,PetscBool*);
 PETSC_INTERN PetscErrorCode VecView_MPI_DA(Vec,PetscViewer);
 PETSC_INTERN PetscErrorCode VecLoad_Default_DA(Vec, PetscViewer);
 PETSC_INTERN PetscErrorCode DMView_DA_Matlab(DM,PetscViewer);
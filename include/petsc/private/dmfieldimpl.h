@@ -30,4 +30,5 @@ struct _p_DMField {
 };
 
 PETSC_INTERN PetscErrorCode DMFieldCreate(DM,PetscInt,DMFieldContinuity,DMField*);
+PETSC_INTERN PetscErrorCode DMFieldDSGetVec_Internal(DMField,Vec*);
 #endif
@@ -49,6 +49,7 @@ struct _DMOps {
   PetscErrorCode (*localtoglobalend)(DM,Vec,InsertMode,Vec);
   PetscErrorCode (*localtolocalbegin)(DM,Vec,InsertMode,Vec);
   PetscErrorCode (*localtolocalend)(DM,Vec,InsertMode,Vec);
+  PetscErrorCode (*globaltolocalbatchadd)(DM,PetscSFBatch,Vec,InsertMode,Vec);
 
   PetscErrorCode (*destroy)(DM);
 
@@ -37,6 +37,7 @@ PETSC_EXTERN PetscLogEvent DMPLEX_InjectorFEM;
 PETSC_EXTERN PetscLogEvent DMPLEX_IntegralFEM;
 PETSC_EXTERN PetscLogEvent DMPLEX_CreateGmsh;
 PETSC_EXTERN PetscLogEvent DMPLEX_RebalanceSharedPoints;
+PETSC_EXTERN PetscLogEvent DMPLEX_RebalanceMesh;
 PETSC_EXTERN PetscLogEvent DMPLEX_CreateFromFile;
 PETSC_EXTERN PetscLogEvent DMPLEX_BuildFromCellList;
 PETSC_EXTERN PetscLogEvent DMPLEX_BuildCoordinatesFromCellList;
@@ -105,6 +106,31 @@ struct _PetscGridHash {
   DMLabel      cellsSparse; /* Sparse storage for cell map */
 };
 
+/* Fixed-width cones: a run of consecutive points with the same cone size, stored contiguously, so that the cone of
+   any point in the run is found from its number without going through the cone section */
+#define DMPLEX_MAX_CONE_RUNS 16
+typedef struct {
+  PetscInt pStart, pEnd; /* The points in the run */
+  PetscInt size;         /* The cone size of every point in the run */
+  PetscInt offset;       /* The offset of the cone of pStart */
+} DMPlexConeRun;
+
+/* Closure dof cache: the flattened dof indices of the closure of each point in a range, in the order used by
+   DMPlexVecGetClosure(), so that closure operations touch one contiguous index array instead of the DAG. It is
+   attached to the local section it was built with, like the closure index and permutation. */
+typedef struct {
+  PetscObjectId dmId;          /* The DM the cache was built for */
+  PetscSection  globalSection; /* The global section the cache was built for */
+  PetscInt      pStart, pEnd;  /* The points with a cached closure */
+  PetscInt     *offsets;       /* Offset of the closure of each point into the index arrays, size pEnd-pStart+1 */
+  PetscInt     *lidx;          /* Local vector indices, with constrained dofs given as -(idx+1) */
+  PetscInt     *gidx;          /* Global indices, as returned by DMPlexGetClosureIndices() */
+  PetscScalar  *flips;         /* Sign flip of each closure dof induced by the point symmetries, or NULL if there are none */
+  PetscInt      numColors;     /* Number of colors of the points, 0 if the coloring is not set up */
+  PetscInt     *colorOffsets;  /* Offset of the points of each color into colorPoints, size numColors+1 */
+  PetscInt     *colorPoints;   /* The points sorted by color, where points of one color share no closure dof */
+} DMPlexClosureDofCache;
+
 /* Point Numbering in Plex:
 
    Points are numbered contiguously by stratum. Strate are organized as follows:
@@ -127,6 +153,9 @@ typedef struct {
   PetscSection         supportSection;    /* Layout of cones (inedges for DAG) */
   PetscInt             maxSupportSize;    /* Cached for fast lookup */
   PetscInt            *supports;          /* Cone for each point */
+  PetscInt             numConeRuns;       /* Number of fixed-width cone runs covering the chart, 0 if they are not set up */
+  DMPlexConeRun        coneRuns[DMPLEX_MAX_CONE_RUNS];
+  PetscBool            useClDofCache;     /* Set up the closure dof cache for residual and Jacobian assembly */
   PetscBool            refinementUniform; /* Flag for uniform cell refinement */
   PetscReal            refinementLimit;   /* Maximum volume for refined cell */
   PetscErrorCode     (*refinementFunc)(const PetscReal [], PetscReal *); /* Function giving the maximum volume for refined cell */
@@ -183,6 +212,8 @@ typedef struct {
 
   /* Projection */
   PetscInt             maxProjectionHeight; /* maximum height of cells used in DMPlexProject functions */
+  PetscBool            cacheElemMat;        /* Reuse element matrices of an affine residual in DMPlexComputeResidual_Internal() */
+  PetscObjectState     elemMatState;        /* Incremented to invalidate cached element matrices */
   PetscInt             activePoint;         /* current active point in iteration */
 
   /* Output */
@@ -271,6 +302,10 @@ PETSC_INTERN PetscErrorCode DMPlexRestoreRawFaces_Internal(DM,DMPolytopeType,con
 PETSC_INTERN PetscErrorCode CellRefinerInCellTest_Internal(DMPolytopeType, const PetscReal[], PetscBool *);
 PETSC_INTERN PetscErrorCode DMPlexCellRefinerAdaptLabel(DM, DMLabel, DM *);
 PETSC_INTERN PetscErrorCode DMPlexComputeCellType_Internal(DM, PetscInt, PetscInt, DMPolytopeType *);
+PETSC_INTERN PetscErrorCode DMPlexSetUpConeRuns_Internal(DM);
+PETSC_INTERN PetscErrorCode DMPlexSetUpClosureDofCache_Internal(DM);
+PETSC_INTERN PetscErrorCode DMPlexClosureDofCacheGather_Internal(DMPlexClosureDofCache *, PetscInt, PetscInt, const PetscScalar[], PetscScalar[]);
+PETSC_INTERN PetscErrorCode DMPlexClosureDofCacheScatter_Internal(DMPlexClosureDofCache *, PetscInt, PetscInt, const PetscScalar[], InsertMode, PetscScalar[]);
 PETSC_INTERN PetscErrorCode DMPlexCreateCellTypeOrder_Internal(DMPolytopeType, PetscInt *[], PetscInt *[]);
 PETSC_INTERN PetscErrorCode DMPlexVecSetFieldClosure_Internal(DM, PetscSection, Vec, PetscBool[], PetscInt, PetscInt, const PetscInt[], DMLabel, PetscInt, const PetscScalar[], InsertMode);
 PETSC_INTERN PetscErrorCode DMPlexProjectConstraints_Internal(DM, Vec, Vec);
@@ -294,9 +329,51 @@ PETSC_INTERN PetscErrorCode DMPlexCreateVertexNumbering_Internal(DM, PetscBool,
 PETSC_INTERN PetscErrorCode DMPlexRefine_Internal(DM, DMLabel, DM *);
 PETSC_INTERN PetscErrorCode DMPlexCoarsen_Internal(DM, DMLabel, DM *);
 PETSC_INTERN PetscErrorCode DMCreateMatrix_Plex(DM, Mat*);
+PETSC_INTERN PetscErrorCode DMPlexSetUpMatrixFree_Internal(DM, Mat, PetscBool *);
 
 PETSC_INTERN PetscErrorCode DMPlexGetOverlap_Plex(DM, PetscInt *);
 
+/* The closure dof cache of dm attached to section, or NULL if there is none or it was built for another DM or global section */
+PETSC_STATIC_INLINE DMPlexClosureDofCache *DMPlexGetClosureDofCache_Private(DM dm, PetscSection section)
+{
+  DMPlexClosureDofCache *cache = section ? (DMPlexClosureDofCache *) section->clDofCache : NULL;
+
+  if (!cache || cache->dmId != ((PetscObject) dm)->id || cache->globalSection != dm->globalSection) return NULL;
+  return cache;
+}
+
+/* Add the closure values of point p of the cache into array, with the semantics of ADD_ALL_VALUES. This makes no PETSc
+   calls, so that it may be called concurrently for points which share no closure dof. */
+PETSC_STATIC_INLINE void DMPlexClosureDofCacheAddPoint_Private(const DMPlexClosureDofCache *cache, PetscInt p, const PetscScalar values[], PetscScalar array[])
+{
+  const PetscInt     start = cache->offsets[p-cache->pStart];
+  const PetscInt     n     = cache->offsets[p-cache->pStart+1] - start;
+  const PetscInt    *lidx  = &cache->lidx[start];
+  const PetscScalar *flips = cache->flips ? &cache->flips[start] : NULL;
+  PetscInt           i;
+
+  if (flips) {for (i = 0; i < n; ++i) array[lidx[i] < 0 ? -(lidx[i]+1) : lidx[i]] += values[i]*flips[i];}
+  else       {for (i = 0; i < n; ++i) array[lidx[i] < 0 ? -(lidx[i]+1) : lidx[i]] += values[i];}
+}
+
+/* The cone size and cone offset of p from the fixed-width cone runs, returning PETSC_FALSE if the runs do not cover p */
+PETSC_STATIC_INLINE PetscBool DMPlexGetConeRun_Private(DM_Plex *mesh, PetscInt p, PetscInt *size, PetscInt *off)
+{
+  PetscInt r;
+
+  for (r = 0; r < mesh->numConeRuns; ++r) {
+    const DMPlexConeRun *run = &mesh->coneRuns[r];
+
+    if (p < run->pStart) break;
+    if (p < run->pEnd) {
+      *size = run->size;
+      *off  = run->offset + (p - run->pStart)*run->size;
+      return PETSC_TRUE;
+    }
+  }
+  return PETSC_FALSE;
+}
+
 /* invert dihedral symmetry: return a^-1,
  * using the representation described in
  * DMPlexGetConeOrientation() */
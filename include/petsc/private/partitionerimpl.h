@@ -29,6 +29,9 @@ struct _p_PetscPartitioner {
   PetscBool   viewGraph;
   PetscBool   noGraph;          /* if true, the partitioner does not need the connectivity graph, only the number of local vertices */
   PetscBool   usevwgt;          /* if true, the partitioner looks at the local section vertSection to weight the vertices of the graph */
+  PetscBool   useewgt;          /* if true, the partitioner weights the edges of the graph by the communication they would cause if cut */
+  PetscBool   useawgt;          /* if true, the partitioner adds the assembly cost of each vertex as a second vertex weight */
+  PetscInt   *edgeWeights;      /* weights of the local edges for the next partition, see PetscPartitionerSetEdgeWeights() */
 };
 
 #endif
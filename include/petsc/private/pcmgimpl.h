@@ -36,6 +36,7 @@ typedef struct {
   Mat           restrct;                       /* restrict is a reserved word in C99 and on Cray */
   Mat           inject;                        /* Used for moving state if provided. */
   Vec           rscale;                        /* scaling of restriction matrix */
+  Vec           wx,wr;                         /* work vectors used by the AFACx and mult-additive cycles */
   PetscLogEvent eventsmoothsetup;              /* if logging times for each level */
   PetscLogEvent eventsmoothsolve;
   PetscLogEvent eventresidual;
@@ -48,6 +49,7 @@ typedef struct {
 typedef struct {
   PCMGType            am;                     /* Multiplicative, additive or full */
   PetscInt            cyclesperpcapply;       /* Number of cycles to use in each PCApply(), multiplicative only*/
+  PCMGAdditiveType    additivetype;           /* Variant of the additive cycle, additive only */
   PetscInt            maxlevels;              /* total number of levels allocated */
   PCMGGalerkinType    galerkin;               /* use Galerkin process to compute coarser matrices */
   PetscBool           usedmfornumberoflevels; /* sets the number of levels by getting this information out of the DM */
@@ -43,6 +43,8 @@ struct _p_PetscSection {
   PetscClPerm                   clHash;       /* Hash of (depth, size) to perm and invPerm */
   PetscSection                  clSection;    /* Section giving the number of points in each closure */
   IS                            clPoints;     /* Points in each closure */
+  void                         *clDofCache;   /* Flattened closure dofs of a DM using this section, dropped with the closure permutation */
+  PetscErrorCode              (*clDofCacheDestroy)(void*);
   PetscSectionSym               sym;          /* Symmetries of the data */
 };
 
@@ -72,6 +74,7 @@ struct _p_PetscSectionSym {
 PETSC_EXTERN PetscErrorCode PetscSectionSetClosurePermutation_Internal(PetscSection, PetscObject, PetscInt, PetscInt, PetscCopyMode, PetscInt *);
 PETSC_EXTERN PetscErrorCode PetscSectionGetClosurePermutation_Internal(PetscSection, PetscObject, PetscInt, PetscInt, const PetscInt *[]);
 PETSC_EXTERN PetscErrorCode PetscSectionGetClosureInversePermutation_Internal(PetscSection, PetscObject, PetscInt, PetscInt, const PetscInt *[]);
+PETSC_EXTERN PetscErrorCode PetscSectionSetClosureDofCache_Internal(PetscSection, void *, PetscErrorCode (*)(void*));
 PETSC_EXTERN PetscErrorCode ISIntersect_Caching_Internal(IS, IS, IS *);
 
 #endif
@@ -30,6 +30,7 @@ PETSC_EXTERN PetscLogEvent PETSCSF_SectSF;
 PETSC_EXTERN PetscLogEvent PETSCSF_RemoteOff;
 PETSC_EXTERN PetscLogEvent PETSCSF_Pack;
 PETSC_EXTERN PetscLogEvent PETSCSF_Unpack;
+PETSC_EXTERN PetscLogEvent PETSCSF_Autotune;
 
 typedef enum {PETSCSF_ROOT2LEAF=0, PETSCSF_LEAF2ROOT} PetscSFDirection;
 typedef enum {PETSCSF_BCAST=0, PETSCSF_REDUCE, PETSCSF_FETCH} PetscSFOperation;
@@ -113,6 +114,10 @@ struct _p_PetscSF {
   PetscBool       setupcalled;     /* Type and communication structures have been set up */
   PetscSFPattern  pattern;         /* Pattern of the graph */
   PetscBool       persistent;      /* Does this SF use MPI persistent requests for communication */
+  PetscBool       autotune;        /* Choose the type in PetscSFSetUp() by timing candidate types on the graph */
+  char            *autotunetypes;  /* Comma-separated candidate types, NULL for the default ones */
+  PetscInt        autotunereps;    /* Number of timed rounds per candidate */
+  char            *autotunechoice; /* Candidate chosen without timing, for testing */
   PetscLayout     map;             /* Layout of leaves over all processes when building a patterned graph */
   PetscBool       use_default_stream;  /* If true, SF assumes root/leafdata is on the default stream upon input and will also leave them there upon output */
   PetscBool       use_gpu_aware_mpi;   /* If true, SF assumes it can pass GPU pointers to MPI */
@@ -128,8 +133,11 @@ PETSC_EXTERN PetscBool PetscSFRegisterAllCalled;
 PETSC_EXTERN PetscErrorCode PetscSFRegisterAll(void);
 
 PETSC_INTERN PetscErrorCode PetscSFCreateLocalSF_Private(PetscSF,PetscSF*);
+PETSC_INTERN PetscErrorCode PetscSFAutotune_Private(PetscSF);
 PETSC_INTERN PetscErrorCode PetscSFBcastToZero_Private(PetscSF,MPI_Datatype,const void*,void*);
 
+PETSC_EXTERN PetscErrorCode PetscSFBatchAddEndHook_Private(PetscSFBatch,PetscErrorCode (*)(void*),void*);
+
 PETSC_EXTERN PetscErrorCode MPIPetsc_Type_unwrap(MPI_Datatype,MPI_Datatype*,PetscBool*);
 PETSC_EXTERN PetscErrorCode MPIPetsc_Type_compare(MPI_Datatype,MPI_Datatype,PetscBool*);
 PETSC_EXTERN PetscErrorCode MPIPetsc_Type_compare_contig(MPI_Datatype,MPI_Datatype,PetscInt*);
@@ -35,6 +35,14 @@ PETSC_EXTERN PetscErrorCode DMDACreateAggregates(DM,DM,Mat*);
 /* FEM */
 PETSC_EXTERN PetscErrorCode DMDASetElementType(DM,DMDAElementType);
 PETSC_EXTERN PetscErrorCode DMDAGetElementType(DM,DMDAElementType*);
+PETSC_EXTERN const char *const DMDAGhostUpdateTypes[];
+PETSC_EXTERN PetscErrorCode DMDASetGhostUpdateType(DM,DMDAGhostUpdateType);
+PETSC_EXTERN PetscErrorCode DMDAGetGhostUpdateType(DM,DMDAGhostUpdateType*);
+PETSC_EXTERN PetscErrorCode DMDASetTileSize(DM,PetscInt,PetscInt,PetscInt);
+PETSC_EXTERN PetscErrorCode DMDAGetTileSize(DM,PetscInt*,PetscInt*,PetscInt*);
+PETSC_EXTERN PetscErrorCode DMDATileIteratorBegin(DM,PetscInt,DMDATileIterator*);
+PETSC_EXTERN PetscErrorCode DMDATileIteratorNext(DMDATileIterator*,DMDALocalInfo*,PetscInt*,PetscBool*);
+PETSC_EXTERN PetscErrorCode DMDAStencilApply(DM,const PetscScalar[],Vec,Vec);
 PETSC_EXTERN PetscErrorCode DMDAGetElements(DM,PetscInt*,PetscInt*,const PetscInt*[]);
 PETSC_EXTERN PetscErrorCode DMDARestoreElements(DM,PetscInt*,PetscInt*,const PetscInt*[]);
 PETSC_EXTERN PetscErrorCode DMDAGetElementsSizes(DM,PetscInt*,PetscInt*,PetscInt*);
@@ -34,6 +34,20 @@ typedef enum { DMDA_Q0, DMDA_Q1 } DMDAInterpolationType;
 E*/
 typedef enum { DMDA_ELEMENT_P1, DMDA_ELEMENT_Q1 } DMDAElementType;
 
+/*E
+    DMDAGhostUpdateType - Defines how DMGlobalToLocalBegin() and DMGlobalToLocalEnd() update the ghost points of a DMDA
+
+$   DMDA_GHOST_UPDATE_SCATTER - the VecScatter from the global to the local vector (default)
+$   DMDA_GHOST_UPDATE_RMA_ACTIVE - MPI_Put() into persistent windows, with MPI_Win_post()/MPI_Win_start() synchronization among neighbors
+$   DMDA_GHOST_UPDATE_RMA_PASSIVE - MPI_Put() into persistent windows in a passive target epoch, completed with MPI_Win_flush_all()
+$   DMDA_GHOST_UPDATE_STRUCTURED - messages with the faces, edges and corners of the neighbors, packed with strided copies
+
+   Level: advanced
+
+.seealso: DMDASetGhostUpdateType(), DMDAGetGhostUpdateType(), DMGlobalToLocalBegin()
+E*/
+typedef enum { DMDA_GHOST_UPDATE_SCATTER, DMDA_GHOST_UPDATE_RMA_ACTIVE, DMDA_GHOST_UPDATE_RMA_PASSIVE, DMDA_GHOST_UPDATE_STRUCTURED } DMDAGhostUpdateType;
+
 /*S
      DMDALocalInfo - C struct that contains information about a structured grid and a processors logical
               location in it.
@@ -61,4 +75,23 @@ typedef struct {
   DM               da;
 } DMDALocalInfo;
 
+/*S
+     DMDATileIterator - C struct that iterates over the tiles of the locally owned part of a DMDA, for cache blocking
+
+   Level: intermediate
+
+   Notes:
+   The fields are private, it is used with DMDATileIteratorBegin() and DMDATileIteratorNext().
+
+.seealso:  DMDATileIteratorBegin(), DMDATileIteratorNext(), DMDASetTileSize(), DMDALocalInfo
+S*/
+typedef struct {
+  DMDALocalInfo    info;        /* the locally owned part */
+  PetscInt         ts[3];       /* tile size */
+  PetscInt         nsteps,r;    /* number of time steps of the wavefront and radius of the stencil of a step */
+  PetscInt         ext[2][3];   /* whether the owned range can be extended on each side, into ghost points of neighbors */
+  PetscInt         nfronts;     /* number of positions of the wavefront */
+  PetscInt         front,step,tile; /* current position */
+} DMDATileIterator;
+
 #endif
@@ -200,6 +200,7 @@ PETSC_EXTERN PetscErrorCode DMPlexGetPartitionBalance(DM, PetscBool *);
 PETSC_EXTERN PetscErrorCode DMPlexIsDistributed(DM, PetscBool *);
 PETSC_EXTERN PetscErrorCode DMPlexDistribute(DM, PetscInt, PetscSF*, DM*);
 PETSC_EXTERN PetscErrorCode DMPlexDistributeOverlap(DM, PetscInt, PetscSF *, DM *);
+PETSC_EXTERN PetscErrorCode DMPlexRebalance(DM, PetscReal, PetscSF *, DM *);
 PETSC_EXTERN PetscErrorCode DMPlexGetOverlap(DM, PetscInt *);
 PETSC_EXTERN PetscErrorCode DMPlexDistributeField(DM,PetscSF,PetscSection,Vec,PetscSection,Vec);
 PETSC_EXTERN PetscErrorCode DMPlexDistributeFieldIS(DM, PetscSF, PetscSection, IS, PetscSection, IS *);
@@ -216,8 +217,11 @@ PETSC_EXTERN PetscErrorCode DMPlexGetAdjacency(DM, PetscInt, PetscInt *, PetscIn
 PETSC_EXTERN PetscErrorCode DMPlexSetMigrationSF(DM, PetscSF);
 PETSC_EXTERN PetscErrorCode DMPlexGetMigrationSF(DM, PetscSF *);
 
+#define DMPLEXORDERINGHILBERT "hilbert"
+#define DMPLEXORDERINGMORTON  "morton"
 PETSC_EXTERN PetscErrorCode DMPlexGetOrdering(DM, MatOrderingType, DMLabel, IS *);
 PETSC_EXTERN PetscErrorCode DMPlexPermute(DM, IS, DM *);
+PETSC_EXTERN PetscErrorCode DMPlexComputeStratumBandwidth(DM, PetscInt, PetscInt *, PetscInt *);
 
 PETSC_EXTERN PetscErrorCode DMPlexCreateProcessSF(DM, PetscSF, IS *, PetscSF *);
 PETSC_EXTERN PetscErrorCode DMPlexCreateTwoSidedProcessSF(DM, PetscSF, PetscSection, IS, PetscSection, IS, IS *, PetscSF *);
@@ -330,6 +334,12 @@ PETSC_EXTERN PetscErrorCode DMPlexRestoreClosureIndices(DM, PetscSection, PetscS
 PETSC_EXTERN PetscErrorCode DMPlexMatSetClosureRefined(DM, PetscSection, PetscSection, DM, PetscSection, PetscSection, Mat, PetscInt, const PetscScalar[], InsertMode);
 PETSC_EXTERN PetscErrorCode DMPlexMatGetClosureIndicesRefined(DM, PetscSection, PetscSection, DM, PetscSection, PetscSection, PetscInt, PetscInt[], PetscInt[]);
 PETSC_EXTERN PetscErrorCode DMPlexCreateClosureIndex(DM, PetscSection);
+PETSC_EXTERN PetscErrorCode DMPlexCreateClosureDofCache(DM, PetscInt, PetscInt);
+PETSC_EXTERN PetscErrorCode DMPlexDestroyClosureDofCache(DM);
+PETSC_EXTERN PetscErrorCode DMPlexGetClosureDofCache(DM, PetscInt *, PetscInt *, const PetscInt *[], const PetscInt *[], const PetscInt *[]);
+PETSC_EXTERN PetscErrorCode DMPlexGetClosureDofCacheColoring(DM, PetscInt *, const PetscInt *[], const PetscInt *[]);
+PETSC_EXTERN PetscErrorCode DMPlexVecGetClosures(DM, Vec, PetscInt, PetscInt, PetscScalar[]);
+PETSC_EXTERN PetscErrorCode DMPlexVecSetClosures(DM, Vec, PetscInt, PetscInt, const PetscScalar[], InsertMode);
 PETSC_EXTERN PetscErrorCode DMPlexSetClosurePermutationTensor(DM, PetscInt, PetscSection);
 
 PETSC_EXTERN PetscErrorCode DMPlexConstructGhostCells(DM, const char [], PetscInt *, DM *);
@@ -360,6 +370,8 @@ typedef struct {
 
 PETSC_EXTERN PetscErrorCode DMPlexSetMaxProjectionHeight(DM, PetscInt);
 PETSC_EXTERN PetscErrorCode DMPlexGetMaxProjectionHeight(DM, PetscInt*);
+PETSC_EXTERN PetscErrorCode DMPlexSetCacheElementMatrices(DM, PetscBool);
+PETSC_EXTERN PetscErrorCode DMPlexGetCacheElementMatrices(DM, PetscBool*);
 PETSC_EXTERN PetscErrorCode DMPlexGetActivePoint(DM, PetscInt*);
 PETSC_EXTERN PetscErrorCode DMPlexSetActivePoint(DM, PetscInt);
 PETSC_EXTERN PetscErrorCode DMPlexProjectFieldLocal(DM, Vec,
@@ -384,6 +396,9 @@ PETSC_EXTERN PetscErrorCode DMPlexComputeGradientClementInterpolant(DM, Vec, Vec
 PETSC_EXTERN PetscErrorCode DMPlexComputeInjectorFEM(DM, DM, VecScatter *, void *);
 PETSC_EXTERN PetscErrorCode DMPlexComputeMassMatrixNested(DM, DM, Mat, void *);
 PETSC_EXTERN PetscErrorCode DMPlexComputeMassMatrixGeneral(DM, DM, Mat, void *);
+PETSC_EXTERN PetscErrorCode DMPlexCreateMatrixFree(DM, Mat *);
+PETSC_EXTERN PetscErrorCode DMPlexMatrixFreeSetSolution(Mat, Vec);
+PETSC_EXTERN PetscErrorCode DMPlexCreatePCoarseDM(DM, PetscInt, DM *);
 
 PETSC_EXTERN PetscErrorCode DMPlexCreateRigidBody(DM, PetscInt, MatNullSpace *);
 PETSC_EXTERN PetscErrorCode DMPlexCreateRigidBodies(DM, PetscInt, DMLabel, const PetscInt[], const PetscInt[], MatNullSpace *);
@@ -30,6 +30,7 @@ PETSC_EXTERN const char *const PCPARMSGlobalTypes[];
 PETSC_EXTERN const char *const PCPARMSLocalTypes[];
 PETSC_EXTERN const char *const PCMGTypes[];
 PETSC_EXTERN const char *const PCMGCycleTypes[];
+PETSC_EXTERN const char *const PCMGAdditiveTypes[];
 PETSC_EXTERN const char *const PCMGGalerkinTypes[];
 PETSC_EXTERN const char *const PCMGCoarseSpaceTypes[];
 PETSC_EXTERN const char *const PCExoticTypes[];
@@ -360,6 +361,8 @@ PETSC_EXTERN PetscErrorCode PCMGSetCycleType(PC,PCMGCycleType);
 PETSC_EXTERN PetscErrorCode PCMGSetCycleTypeOnLevel(PC,PetscInt,PCMGCycleType);
 PETSC_DEPRECATED_FUNCTION("Use PCMGSetCycleTypeOnLevel() (since version 3.5)") PETSC_STATIC_INLINE PetscErrorCode PCMGSetCyclesOnLevel(PC pc,PetscInt l,PetscInt t) {return PCMGSetCycleTypeOnLevel(pc,l,(PCMGCycleType)t);}
 PETSC_EXTERN PetscErrorCode PCMGMultiplicativeSetCycles(PC,PetscInt);
+PETSC_EXTERN PetscErrorCode PCMGSetAdditiveType(PC,PCMGAdditiveType);
+PETSC_EXTERN PetscErrorCode PCMGGetAdditiveType(PC,PCMGAdditiveType*);
 PETSC_EXTERN PetscErrorCode PCMGSetGalerkin(PC,PCMGGalerkinType);
 PETSC_EXTERN PetscErrorCode PCMGGetGalerkin(PC,PCMGGalerkinType*);
 PETSC_EXTERN PetscErrorCode PCMGSetAdaptInterpolation(PC,PetscBool);
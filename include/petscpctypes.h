@@ -248,7 +248,7 @@ typedef const char *PCGAMGClassicalType;
 +  PC_MG_MULTIPLICATIVE (default) - traditional V or W cycle as determined by PCMGSetCycleType()
 .  PC_MG_ADDITIVE - the additive multigrid preconditioner where all levels are
                 smoothed before updating the residual. This only uses the
-                down smoother, in the preconditioner the upper smoother is ignored
+                down smoother, in the preconditioner the upper smoother is ignored except by the PC_MG_ADDITIVE_MULT variant, see PCMGSetAdditiveType()
 .  PC_MG_FULL - same as multiplicative except one also performs grid sequencing,
             that is starts on the coarsest grid, performs a cycle, interpolates
             to the next, performs a cycle etc. This is much like the F-cycle presented in "Multigrid" by Trottenberg, Oosterlee, Schuller page 49, but that
@@ -277,6 +277,27 @@ typedef enum { PC_MG_MULTIPLICATIVE,PC_MG_ADDITIVE,PC_MG_FULL,PC_MG_KASKADE } PC
 E*/
 typedef enum { PC_MG_CYCLE_V = 1,PC_MG_CYCLE_W = 2 } PCMGCycleType;
 
+/*E
+    PCMGAdditiveType - Determines the variant of additive multigrid used with PC_MG_ADDITIVE
+
+   Level: advanced
+
+   Values:
++  PC_MG_ADDITIVE_BPX (default) - restrict the residual to all levels, smooth each level independently and sum the interpolated corrections
+.  PC_MG_ADDITIVE_AFACX - asynchronous fast adaptive composite grid variant: each level only corrects the part of the error
+                that is not already captured by one smoothing step on the next coarser level
+-  PC_MG_ADDITIVE_MULT - multiplicative-additive variant: restriction and interpolation are replaced by their smoothed counterparts
+                and each level uses the symmetrized smoother, which mimics a V-cycle while keeping all level solves independent
+
+   Notes:
+   In all variants the restrictions are performed first, then the level corrections are computed independently of each other
+   and finally the corrections are interpolated and summed, so there is no coarse-to-fine dependency between the level solves.
+
+.seealso: PCMGSetAdditiveType(), PCMGSetType()
+
+E*/
+typedef enum { PC_MG_ADDITIVE_BPX,PC_MG_ADDITIVE_AFACX,PC_MG_ADDITIVE_MULT } PCMGAdditiveType;
+
 /*E
     PCMGalerkinType - Determines if the coarse grid operators are computed via the Galerkin process
 
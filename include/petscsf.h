@@ -17,6 +17,7 @@ PETSC_EXTERN PetscClassId PETSCSF_CLASSID;
 #define PETSCSFGATHER     "gather"
 #define PETSCSFALLTOALL   "alltoall"
 #define PETSCSFWINDOW     "window"
+#define PETSCSFHIER       "hier"
 
 /*E
    PetscSFPattern - Pattern of the PetscSF graph
@@ -98,6 +99,7 @@ PETSC_EXTERN PetscErrorCode PetscSFWindowGetFlavorType(PetscSF,PetscSFWindowFlav
 PETSC_EXTERN PetscErrorCode PetscSFWindowSetInfo(PetscSF,MPI_Info);
 PETSC_EXTERN PetscErrorCode PetscSFWindowGetInfo(PetscSF,MPI_Info*);
 PETSC_EXTERN PetscErrorCode PetscSFSetRankOrder(PetscSF,PetscBool);
+PETSC_EXTERN PetscErrorCode PetscSFSetAutotune(PetscSF,PetscBool,const char[]);
 PETSC_EXTERN PetscErrorCode PetscSFSetGraph(PetscSF,PetscInt,PetscInt,const PetscInt*,PetscCopyMode,const PetscSFNode*,PetscCopyMode);
 PETSC_EXTERN PetscErrorCode PetscSFSetGraphWithPattern(PetscSF,PetscLayout,PetscSFPattern);
 PETSC_EXTERN PetscErrorCode PetscSFGetGraph(PetscSF,PetscInt*,PetscInt*,const PetscInt**,const PetscSFNode**);
@@ -161,6 +163,16 @@ PETSC_EXTERN PetscErrorCode PetscSFScatterBegin(PetscSF,MPI_Datatype,const void*
 PETSC_EXTERN PetscErrorCode PetscSFScatterEnd(PetscSF,MPI_Datatype,const void*,void*)
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2);
 
+/* Combine several Bcast/Reduce operations into one communication round */
+PETSC_EXTERN PetscErrorCode PetscSFBatchCreate(MPI_Comm,PetscSFBatch*);
+PETSC_EXTERN PetscErrorCode PetscSFBatchDestroy(PetscSFBatch*);
+PETSC_EXTERN PetscErrorCode PetscSFBatchAddBcast(PetscSFBatch,PetscSF,MPI_Datatype,const void*,void*,MPI_Op)
+  PetscAttrMPIPointerWithType(4,3) PetscAttrMPIPointerWithType(5,3);
+PETSC_EXTERN PetscErrorCode PetscSFBatchAddReduce(PetscSFBatch,PetscSF,MPI_Datatype,const void*,void*,MPI_Op)
+  PetscAttrMPIPointerWithType(4,3) PetscAttrMPIPointerWithType(5,3);
+PETSC_EXTERN PetscErrorCode PetscSFBatchBegin(PetscSFBatch);
+PETSC_EXTERN PetscErrorCode PetscSFBatchEnd(PetscSFBatch);
+
 PETSC_EXTERN PetscErrorCode PetscSFCompose(PetscSF,PetscSF,PetscSF*);
 PETSC_EXTERN PetscErrorCode PetscSFComposeInverse(PetscSF,PetscSF,PetscSF*);
 
@@ -48,6 +48,16 @@ typedef struct {
   PetscInt index;               /* Index of node on rank */
 } PetscSFNode;
 
+/*S
+   PetscSFBatch - Queue of PetscSF Bcast and Reduce operations, possibly on different star forests, that are communicated
+   together with one message per neighbor rank
+
+   Level: advanced
+
+.seealso: PetscSFBatchCreate(), PetscSFBatchAddBcast(), PetscSFBatchAddReduce(), PetscSFBatchBegin(), PetscSFBatchEnd()
+S*/
+typedef struct _n_PetscSFBatch* PetscSFBatch;
+
 /*S
      VecScatter - Object used to manage communication of data
        between vectors in parallel. Manages both scatters and gathers
@@ -511,6 +511,9 @@ $  PETSC_BUILDTWOSIDED_IBARRIER - nonblocking algorithm based on MPI_Issend and
 $      Proved communication-optimal in Hoefler, Siebert, and Lumsdaine (2010). Requires MPI-3.
 $  PETSC_BUILDTWOSIDED_REDSCATTER - similar to above, but use more optimized function
 $      that only communicates the part of the reduction that is necessary.  Requires MPI-2.
+$  PETSC_BUILDTWOSIDED_NODE - hierarchical variant of PETSC_BUILDTWOSIDED_IBARRIER: messages are gathered by a leader
+$      on each node (shared-memory or set with -build_twosided_node_size), the leaders exchange one aggregated message per pair of communicating nodes,
+$      and scatter what they receive to the ranks of their node. Requires MPI-3.
 
    Level: developer
 
@@ -520,7 +523,8 @@ typedef enum {
   PETSC_BUILDTWOSIDED_NOTSET = -1,
   PETSC_BUILDTWOSIDED_ALLREDUCE = 0,
   PETSC_BUILDTWOSIDED_IBARRIER = 1,
-  PETSC_BUILDTWOSIDED_REDSCATTER = 2
+  PETSC_BUILDTWOSIDED_REDSCATTER = 2,
+  PETSC_BUILDTWOSIDED_NODE = 3
   /* Updates here must be accompanied by updates in finclude/petscsys.h and the string array in mpits.c */
 } PetscBuildTwoSidedType;
 
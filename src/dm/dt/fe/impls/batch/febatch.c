@@ -0,0 +1,404 @@
+#include <petsc/private/petscfeimpl.h> /*I "petscfe.h" I*/
+
+/*
+  The batch implementation integrates PETSCFE_BATCH_WIDTH cells at a time. All per-cell data is stored in
+  structure-of-arrays layout with the cell (lane) index fastest, so that the basis contractions, which
+  dominate the cost for moderate order, become fixed-length loops over the lanes which the compiler can vectorize.
+  The pointwise functions are still called one point at a time, since their interface is scalar.
+*/
+
+static PetscErrorCode PetscFEDestroy_Batch(PetscFE fem)
+{
+  PetscFE_Batch *b = (PetscFE_Batch *) fem->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(b->work, b->rwork);CHKERRQ(ierr);
+  ierr = PetscFree(b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscFEView_Batch_Ascii(PetscFE fe, PetscViewer v)
+{
+  PetscInt          dim, Nc;
+  PetscSpace        basis = NULL;
+  PetscDualSpace    dual = NULL;
+  PetscQuadrature   quad = NULL;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFEGetSpatialDimension(fe, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetNumComponents(fe, &Nc);CHKERRQ(ierr);
+  ierr = PetscFEGetBasisSpace(fe, &basis);CHKERRQ(ierr);
+  ierr = PetscFEGetDualSpace(fe, &dual);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(fe, &quad);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPushTab(v);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(v, "Batch Finite Element in %D dimensions with %D components, integrating %D cells per batch\n", dim, Nc, (PetscInt) PETSCFE_BATCH_WIDTH);CHKERRQ(ierr);
+  if (basis) {ierr = PetscSpaceView(basis, v);CHKERRQ(ierr);}
+  if (dual)  {ierr = PetscDualSpaceView(dual, v);CHKERRQ(ierr);}
+  if (quad)  {ierr = PetscQuadratureView(quad, v);CHKERRQ(ierr);}
+  ierr = PetscViewerASCIIPopTab(v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscFEView_Batch(PetscFE fe, PetscViewer v)
+{
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject) v, PETSCVIEWERASCII, &iascii);CHKERRQ(ierr);
+  if (iascii) {ierr = PetscFEView_Batch_Ascii(fe, v);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* The batched kernels handle H^1 PetscFE fields which need at most first derivatives */
+static PetscErrorCode PetscFEBatchCheckDS_Private(PetscDS ds, PetscBool *supported)
+{
+  PetscBool      isHybrid;
+  PetscInt       Nf, f;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *supported = PETSC_FALSE;
+  ierr = PetscDSGetHybrid(ds, &isHybrid);CHKERRQ(ierr);
+  if (isHybrid) PetscFunctionReturn(0);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  for (f = 0; f < Nf; ++f) {
+    PetscObject    obj;
+    PetscClassId   id;
+    PetscDualSpace Q;
+    PetscInt       k, jet;
+
+    ierr = PetscDSGetDiscretization(ds, f, &obj);CHKERRQ(ierr);
+    if (!obj) PetscFunctionReturn(0);
+    ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+    if (id != PETSCFE_CLASSID) PetscFunctionReturn(0);
+    ierr = PetscFEGetDualSpace((PetscFE) obj, &Q);CHKERRQ(ierr);
+    ierr = PetscDualSpaceGetDeRahm(Q, &k);CHKERRQ(ierr);
+    if (k) PetscFunctionReturn(0);
+    ierr = PetscDSGetJetDegree(ds, f, &jet);CHKERRQ(ierr);
+    if (jet > 1) PetscFunctionReturn(0);
+  }
+  *supported = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+  Evaluate the fields and their physical gradients at every quadrature point of a batch of cells
+
+  coef[i*W+w]            - Dof i on cell w
+  invJ[(g*dim*dim+k)*W+w] - Inverse Jacobian entry k at geometry point g = q*gStride on cell w
+  u[(q*NcT+c)*W+w]        - Component c at quadrature point q on cell w
+  u_x[((q*NcT+c)*dim+d)*W+w]
+*/
+static void PetscFEBatchEvaluateFieldJets_Private(PetscInt Nf, PetscTabulation T[], PetscInt dim, PetscInt NcT, PetscInt gStride, const PetscReal invJ[], const PetscScalar coef[], const PetscScalar coef_t[], PetscScalar u[], PetscScalar u_x[], PetscScalar u_t[])
+{
+  PetscScalar gref[3*PETSCFE_BATCH_WIDTH];
+  PetscInt    dOff = 0, fOff = 0, f, q, b, c, d, e, w;
+
+  for (f = 0; f < Nf; ++f) {
+    const PetscInt Nq = T[f]->Np;
+    const PetscInt Nb = T[f]->Nb;
+    const PetscInt Nc = T[f]->Nc;
+
+    for (q = 0; q < Nq; ++q) {
+      const PetscReal *Bq = &T[f]->T[0][q*Nb*Nc];
+      const PetscReal *Dq = &T[f]->T[1][q*Nb*Nc*dim];
+      const PetscReal *iJ = &invJ[q*gStride*dim*dim*PETSCFE_BATCH_WIDTH];
+
+      for (c = 0; c < Nc; ++c) {
+        PetscScalar *uc  = &u[(q*NcT+fOff+c)*PETSCFE_BATCH_WIDTH];
+        PetscScalar *uxc = &u_x[(q*NcT+fOff+c)*dim*PETSCFE_BATCH_WIDTH];
+
+        for (w = 0; w < PETSCFE_BATCH_WIDTH; ++w) uc[w] = 0.0;
+        for (w = 0; w < dim*PETSCFE_BATCH_WIDTH; ++w) gref[w] = 0.0;
+        for (b = 0; b < Nb; ++b) {
+          const PetscScalar *cb = &coef[(dOff+b)*PETSCFE_BATCH_WIDTH];
+          const PetscReal    bv = Bq[b*Nc+c];
+
+          for (w = 0; w < PETSCFE_BATCH_WIDTH; ++w) uc[w] += bv*cb[w];
+          for (d = 0; d < dim; ++d) {
+            const PetscReal dv = Dq[(b*Nc+c)*dim+d];
+
+            for (w = 0; w < PETSCFE_BATCH_WIDTH; ++w) gref[d*PETSCFE_BATCH_WIDTH+w] += dv*cb[w];
+          }
+        }
+        /* Push the reference gradient forward, u_x = J^{-T} \hat\nabla u */
+        for (d = 0; d < dim; ++d) {
+          for (w = 0; w < PETSCFE_BATCH_WIDTH; ++w) uxc[d*PETSCFE_BATCH_WIDTH+w] = 0.0;
+          for (e = 0; e < dim; ++e) {
+            const PetscReal *iJed = &iJ[(e*dim+d)*PETSCFE_BATCH_WIDTH];
+
+            for (w = 0; w < PETSCFE_BATCH_WIDTH; ++w) uxc[d*PETSCFE_BATCH_WIDTH+w] += iJed[w]*gref[e*PETSCFE_BATCH_WIDTH+w];
+          }
+        }
+        if (u_t) {
+          PetscScalar *utc = &u_t[(q*NcT+fOff+c)*PETSCFE_BATCH_WIDTH];
+
+          for (w = 0; w < PETSCFE_BATCH_WIDTH; ++w) utc[w] = 0.0;
+          for (b = 0; b < Nb; ++b) {
+            const PetscScalar *cb = &coef_t[(dOff+b)*PETSCFE_BATCH_WIDTH];
+            const PetscReal    bv = Bq[b*Nc+c];
+
+            for (w = 0; w < PETSCFE_BATCH_WIDTH; ++w) utc[w] += bv*cb[w];
+          }
+        }
+      }
+    }
+    dOff += Nb;
+    fOff += Nc;
+  }
+}
+
+/*
+  Contract the weighted pointwise terms against the reference basis for a batch of cells
+
+  f0[(q*Nc+c)*W+w]         - The f0 term, scaled by the quadrature weight and |J|
+  f1[((q*Nc+c)*dim+d)*W+w] - The f1 term, pulled back to the reference cell and scaled by the quadrature weight and |J|
+  ev[b*W+w]                - The element vector
+*/
+static void PetscFEBatchUpdateElementVec_Private(PetscTabulation T, PetscInt dim, const PetscScalar f0[], const PetscScalar f1[], PetscScalar ev[])
+{
+  const PetscInt Nq = T->Np;
+  const PetscInt Nb = T->Nb;
+  const PetscInt Nc = T->Nc;
+  PetscInt       q, b, c, d, w;
+
+  for (w = 0; w < Nb*PETSCFE_BATCH_WIDTH; ++w) ev[w] = 0.0;
+  for (q = 0; q < Nq; ++q) {
+    const PetscReal *Bq = &T->T[0][q*Nb*Nc];
+    const PetscReal *Dq = &T->T[1][q*Nb*Nc*dim];
+
+    for (b = 0; b < Nb; ++b) {
+      PetscScalar *evb = &ev[b*PETSCFE_BATCH_WIDTH];
+
+      for (c = 0; c < Nc; ++c) {
+        if (f0) {
+          const PetscScalar *f0c = &f0[(q*Nc+c)*PETSCFE_BATCH_WIDTH];
+          const PetscReal    bv  = Bq[b*Nc+c];
+
+          for (w = 0; w < PETSCFE_BATCH_WIDTH; ++w) evb[w] += bv*f0c[w];
+        }
+        if (f1) {
+          for (d = 0; d < dim; ++d) {
+            const PetscScalar *f1cd = &f1[((q*Nc+c)*dim+d)*PETSCFE_BATCH_WIDTH];
+            const PetscReal    dv   = Dq[(b*Nc+c)*dim+d];
+
+            for (w = 0; w < PETSCFE_BATCH_WIDTH; ++w) evb[w] += dv*f1cd[w];
+          }
+        }
+      }
+    }
+  }
+}
+
+static PetscErrorCode PetscFEIntegrateResidual_Batch(PetscDS ds, PetscInt field, PetscInt Ne, PetscFEGeom *cgeom,
+                                                     const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscDS dsAux, const PetscScalar coefficientsAux[], PetscReal t, PetscScalar elemVec[])
+{
+  const PetscInt     W = PETSCFE_BATCH_WIDTH;
+  PetscFE            fe;
+  PetscFE_Batch     *bt;
+  PetscPointFunc     f0_func;
+  PetscPointFunc     f1_func;
+  PetscQuadrature    quad;
+  PetscTabulation   *T, *TAux = NULL;
+  PetscScalar       *f0, *f1, *u, *u_t = NULL, *u_x, *a = NULL, *a_x = NULL;
+  PetscScalar       *coef, *coef_t = NULL, *coefAux = NULL, *uS, *utS = NULL, *uxS, *aS = NULL, *axS = NULL, *f0S = NULL, *f1S = NULL, *ev;
+  PetscReal         *invJS, *wdetJS;
+  const PetscScalar *constants;
+  PetscInt          *uOff, *uOff_x, *aOff = NULL, *aOff_x = NULL;
+  PetscInt           dim, numConstants, Nf, NfAux = 0, NcT, NcTAux = 0, totDim, totDimAux = 0, fOffset, Nb, Nc, nG, wsz, rwsz, e0;
+  PetscBool          isAffine, supported;
+  const PetscReal   *quadPoints, *quadWeights;
+  PetscInt           qNc, Nq, Np, dE;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscDSGetDiscretization(ds, field, (PetscObject *) &fe);CHKERRQ(ierr);
+  ierr = PetscDSGetResidual(ds, field, &f0_func, &f1_func);CHKERRQ(ierr);
+  if (!f0_func && !f1_func) PetscFunctionReturn(0);
+  ierr = PetscFEBatchCheckDS_Private(ds, &supported);CHKERRQ(ierr);
+  if (supported && dsAux) {ierr = PetscFEBatchCheckDS_Private(dsAux, &supported);CHKERRQ(ierr);}
+  if (cgeom->dim != cgeom->dimEmbed || cgeom->dim > 3) supported = PETSC_FALSE;
+  if (!supported) {
+    ierr = PetscFEIntegrateResidual_Basic(ds, field, Ne, cgeom, coefficients, coefficients_t, dsAux, coefficientsAux, t, elemVec);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  bt   = (PetscFE_Batch *) fe->data;
+  ierr = PetscFEGetSpatialDimension(fe, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(fe, &quad);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalComponents(ds, &NcT);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, field, &fOffset);CHKERRQ(ierr);
+  ierr = PetscDSGetEvaluationArrays(ds, &u, coefficients_t ? &u_t : NULL, &u_x);CHKERRQ(ierr);
+  ierr = PetscDSGetWeakFormArrays(ds, &f0, &f1, NULL, NULL, NULL, NULL);CHKERRQ(ierr);
+  ierr = PetscDSGetTabulation(ds, &T);CHKERRQ(ierr);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  if (dsAux) {
+    ierr = PetscDSGetNumFields(dsAux, &NfAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalComponents(dsAux, &NcTAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalDimension(dsAux, &totDimAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentOffsets(dsAux, &aOff);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentDerivativeOffsets(dsAux, &aOff_x);CHKERRQ(ierr);
+    ierr = PetscDSGetEvaluationArrays(dsAux, &a, NULL, &a_x);CHKERRQ(ierr);
+    ierr = PetscDSGetTabulation(dsAux, &TAux);CHKERRQ(ierr);
+    if (T[0]->Np != TAux[0]->Np) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Number of tabulation points %D != %D number of auxiliary tabulation points", T[0]->Np, TAux[0]->Np);
+  }
+  ierr = PetscQuadratureGetData(quad, NULL, &qNc, &Nq, &quadPoints, &quadWeights);CHKERRQ(ierr);
+  if (qNc != 1) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Only supports scalar quadrature, not %D components\n", qNc);
+  Np       = cgeom->numPoints;
+  dE       = cgeom->dimEmbed;
+  isAffine = cgeom->isAffine;
+  nG       = isAffine ? 1 : Nq;
+  Nb       = T[field]->Nb;
+  Nc       = T[field]->Nc;
+  /* Size the batch workspace */
+  wsz  = (totDim*(coefficients_t ? 2 : 1) + totDimAux + Nq*NcT*(dim + (coefficients_t ? 2 : 1)) + Nq*NcTAux*(dim+1) + Nq*Nc*(dim+1) + Nb)*W;
+  rwsz = (nG*dim*dim + Nq)*W;
+  if (wsz > bt->workSize || rwsz > bt->rworkSize) {
+    ierr = PetscFree2(bt->work, bt->rwork);CHKERRQ(ierr);
+    bt->workSize  = PetscMax(wsz, bt->workSize);
+    bt->rworkSize = PetscMax(rwsz, bt->rworkSize);
+    ierr = PetscMalloc2(bt->workSize, &bt->work, bt->rworkSize, &bt->rwork);CHKERRQ(ierr);
+  }
+  coef    = bt->work;
+  uS      = coef + totDim*W;
+  uxS     = uS   + Nq*NcT*W;
+  ev      = uxS  + Nq*NcT*dim*W;
+  f0S     = ev   + Nb*W;
+  f1S     = f0S  + Nq*Nc*W;
+  coefAux = f1S  + Nq*Nc*dim*W;
+  if (coefficients_t) {coef_t = coefAux + totDimAux*W; utS = coef_t + totDim*W;}
+  if (dsAux) {aS = coefAux + totDimAux*W + (coefficients_t ? totDim*W + Nq*NcT*W : 0); axS = aS + Nq*NcTAux*W;}
+  invJS   = bt->rwork;
+  wdetJS  = invJS + nG*dim*dim*W;
+  for (e0 = 0; e0 < Ne; e0 += W) {
+    const PetscInt nw = PetscMin(W, Ne - e0);
+    PetscInt       w, q, g, i, c, d, k;
+
+    /* Padded lanes are integrated with zero data and then discarded */
+    if (nw < W) {
+      ierr = PetscArrayzero(bt->work, wsz);CHKERRQ(ierr);
+      ierr = PetscArrayzero(bt->rwork, rwsz);CHKERRQ(ierr);
+    }
+    /* Transpose the cell data into structure-of-arrays layout */
+    for (w = 0; w < nw; ++w) {
+      const PetscInt e = e0 + w;
+
+      for (i = 0; i < totDim; ++i) coef[i*W+w] = coefficients[e*totDim+i];
+      if (coefficients_t) for (i = 0; i < totDim; ++i) coef_t[i*W+w] = coefficients_t[e*totDim+i];
+      if (dsAux) for (i = 0; i < totDimAux; ++i) coefAux[i*W+w] = coefficientsAux[e*totDimAux+i];
+      for (g = 0; g < nG; ++g) {
+        const PetscReal *invJ = &cgeom->invJ[(isAffine ? e*Np : e*Np+g)*dE*dE];
+
+        for (k = 0; k < dim*dim; ++k) invJS[(g*dim*dim+k)*W+w] = invJ[k];
+      }
+      for (q = 0; q < Nq; ++q) wdetJS[q*W+w] = cgeom->detJ[isAffine ? e*Np : e*Np+q]*quadWeights[q];
+    }
+    PetscFEBatchEvaluateFieldJets_Private(Nf, T, dim, NcT, isAffine ? 0 : 1, invJS, coef, coef_t, uS, uxS, utS);
+    if (dsAux) PetscFEBatchEvaluateFieldJets_Private(NfAux, TAux, dim, NcTAux, isAffine ? 0 : 1, invJS, coefAux, NULL, aS, axS, NULL);
+    /* Call the pointwise functions, which see the usual point layout */
+    for (w = 0; w < nw; ++w) {
+      const PetscInt e = e0 + w;
+
+      for (q = 0; q < Nq; ++q) {
+        const PetscReal  wq   = wdetJS[q*W+w];
+        const PetscReal *invJ = &invJS[(isAffine ? 0 : q)*dim*dim*W];
+        PetscReal        xq[3];
+        const PetscReal *x;
+
+        if (isAffine) {
+          CoordinatesRefToReal(dE, dim, cgeom->xi, &cgeom->v[e*Np*dE], &cgeom->J[e*Np*dE*dE], &quadPoints[q*dim], xq);
+          x = xq;
+        } else {
+          x = &cgeom->v[(e*Np+q)*dE];
+        }
+        for (c = 0; c < NcT; ++c) {
+          u[c] = uS[(q*NcT+c)*W+w];
+          for (d = 0; d < dim; ++d) u_x[c*dim+d] = uxS[((q*NcT+c)*dim+d)*W+w];
+          if (u_t) u_t[c] = utS[(q*NcT+c)*W+w];
+        }
+        for (c = 0; c < NcTAux; ++c) {
+          a[c] = aS[(q*NcTAux+c)*W+w];
+          for (d = 0; d < dim; ++d) a_x[c*dim+d] = axS[((q*NcTAux+c)*dim+d)*W+w];
+        }
+        if (f0_func) {
+          ierr = PetscArrayzero(f0, Nc);CHKERRQ(ierr);
+          f0_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, x, numConstants, constants, f0);
+          for (c = 0; c < Nc; ++c) f0S[(q*Nc+c)*W+w] = f0[c]*wq;
+        }
+        if (f1_func) {
+          ierr = PetscArrayzero(f1, Nc*dim);CHKERRQ(ierr);
+          f1_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, x, numConstants, constants, f1);
+          /* Pull f1 back to the reference cell, so that the update only needs the reference basis derivatives */
+          for (c = 0; c < Nc; ++c) {
+            for (i = 0; i < dim; ++i) {
+              PetscScalar val = 0.0;
+
+              for (d = 0; d < dim; ++d) val += invJ[(i*dim+d)*W+w]*f1[c*dim+d];
+              f1S[((q*Nc+c)*dim+i)*W+w] = val*wq;
+            }
+          }
+        }
+      }
+    }
+    PetscFEBatchUpdateElementVec_Private(T[field], dim, f0_func ? f0S : NULL, f1_func ? f1S : NULL, ev);
+    for (w = 0; w < nw; ++w) {
+      PetscInt b;
+
+      for (b = 0; b < Nb; ++b) elemVec[(e0+w)*totDim+fOffset+b] = ev[b*W+w];
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscFEInitialize_Batch(PetscFE fem)
+{
+  PetscFunctionBegin;
+  fem->ops->setfromoptions          = NULL;
+  fem->ops->setup                   = PetscFESetUp_Basic;
+  fem->ops->view                    = PetscFEView_Batch;
+  fem->ops->destroy                 = PetscFEDestroy_Batch;
+  fem->ops->getdimension            = PetscFEGetDimension_Basic;
+  fem->ops->createtabulation        = PetscFECreateTabulation_Basic;
+  fem->ops->integrate               = PetscFEIntegrate_Basic;
+  fem->ops->integratebd             = PetscFEIntegrateBd_Basic;
+  fem->ops->integrateresidual       = PetscFEIntegrateResidual_Batch;
+  fem->ops->integratebdresidual     = PetscFEIntegrateBdResidual_Basic;
+  fem->ops->integratehybridresidual = PetscFEIntegrateHybridResidual_Basic;
+  fem->ops->integratejacobianaction = NULL/* PetscFEIntegrateJacobianAction_Basic */;
+  fem->ops->integratejacobian       = PetscFEIntegrateJacobian_Basic;
+  fem->ops->integratebdjacobian     = PetscFEIntegrateBdJacobian_Basic;
+  fem->ops->integratehybridjacobian = PetscFEIntegrateHybridJacobian_Basic;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+  PETSCFEBATCH = "batch" - A PetscFE object that integrates the residual over batches of cells in structure-of-arrays layout, so that the basis contractions vectorize across cells
+
+  Level: intermediate
+
+  Notes:
+  Batches hold PETSCFE_BATCH_WIDTH cells, which is fixed at compile time. Only H^1 fields needing at most first derivatives in the pointwise
+  functions are batched; other discretizations, as well as boundary and Jacobian integrals, use the PETSCFEBASIC kernels.
+
+.seealso: PetscFEType, PetscFECreate(), PetscFESetType(), PETSCFEBASIC
+M*/
+
+PETSC_EXTERN PetscErrorCode PetscFECreate_Batch(PetscFE fem)
+{
+  PetscFE_Batch *b;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(fem, PETSCFE_CLASSID, 1);
+  ierr      = PetscNewLog(fem,&b);CHKERRQ(ierr);
+  fem->data = b;
+
+  ierr = PetscFEInitialize_Batch(fem);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
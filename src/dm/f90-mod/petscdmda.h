@@ -18,3 +18,10 @@
 !
       PetscEnum, parameter :: DMDA_ELEMENT_P1=0
       PetscEnum, parameter :: DMDA_ELEMENT_Q1=1
+!
+!     DMDAGhostUpdateType
+!
+      PetscEnum, parameter :: DMDA_GHOST_UPDATE_SCATTER=0
+      PetscEnum, parameter :: DMDA_GHOST_UPDATE_RMA_ACTIVE=1
+      PetscEnum, parameter :: DMDA_GHOST_UPDATE_RMA_PASSIVE=2
+      PetscEnum, parameter :: DMDA_GHOST_UPDATE_STRUCTURED=3
@@ -1067,6 +1067,19 @@ PETSC_INTERN PetscErrorCode DMFieldCreate_DS(DMField field)
   PetscFunctionReturn(0);
 }
 
+/* Returns the vector a DMFIELDDS evaluates, or NULL for other types, so that callers may cache on its state */
+PetscErrorCode DMFieldDSGetVec_Internal(DMField field, Vec *vec)
+{
+  PetscBool      isds;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *vec = NULL;
+  ierr = PetscObjectTypeCompare((PetscObject) field, DMFIELDDS, &isds);CHKERRQ(ierr);
+  if (isds) *vec = ((DMField_DS *) field->data)->vec;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode DMFieldCreateDS(DM dm, PetscInt fieldNum, Vec vec,DMField *field)
 {
   DMField        b;
@@ -3,6 +3,7 @@
 #include <petsc/private/isimpl.h>
 #include <petsc/private/glvisviewerimpl.h>
 #include <petscds.h>
+#include <petsc/private/sfimpl.h>
 
 /*@C
     DMCompositeSetCoupling - Sets user provided routines that compute the coupling between the
@@ -52,6 +53,7 @@ PetscErrorCode  DMDestroy_Composite(DM dm)
     ierr = PetscFree(prev->grstarts);CHKERRQ(ierr);
     ierr = PetscFree(prev);CHKERRQ(ierr);
   }
+  ierr = PetscSFBatchDestroy(&com->batch);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)dm,"DMSetUpGLVisViewer_C",NULL);CHKERRQ(ierr);
   /* This was originally freed in DMDestroy(), but that prevents reference counting of backend objects */
   ierr = PetscFree(com);CHKERRQ(ierr);
@@ -513,6 +515,18 @@ PetscErrorCode  DMCompositeRestoreLocalAccessArray(DM dm,Vec pvec,PetscInt nwant
   PetscFunctionReturn(0);
 }
 
+/* The batch is created lazily since most DMComposites never update ghost values */
+static PetscErrorCode DMCompositeGetBatch_Private(DM dm,PetscSFBatch *batch)
+{
+  DM_Composite   *com = (DM_Composite*)dm->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!com->batch) {ierr = PetscSFBatchCreate(PetscObjectComm((PetscObject)dm),&com->batch);CHKERRQ(ierr);}
+  *batch = com->batch;
+  PetscFunctionReturn(0);
+}
+
 /*@C
     DMCompositeScatter - Scatters from a global packed vector into its individual local vectors
 
@@ -543,6 +557,9 @@ PetscErrorCode  DMCompositeScatter(DM dm,Vec gvec,...)
   PetscInt               cnt;
   DM_Composite           *com = (DM_Composite*)dm->data;
   PetscBool              flg;
+  PetscSFBatch           batch;
+  const PetscScalar      *array;
+  Vec                    *globals;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(dm,DM_CLASSID,1);
@@ -553,26 +570,33 @@ PetscErrorCode  DMCompositeScatter(DM dm,Vec gvec,...)
     ierr = DMSetUp(dm);CHKERRQ(ierr);
   }
 
-  /* loop over packed objects, handling one at at time */
+  ierr = DMCompositeGetBatch_Private(dm,&batch);CHKERRQ(ierr);
+  ierr = PetscCalloc1(com->nDM,&globals);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(gvec,&array);CHKERRQ(ierr);
+
+  /* loop over packed objects, enqueuing their updates so that they are communicated together */
   va_start(Argp,gvec);
   for (cnt=3,next=com->next; next; cnt++,next=next->next) {
     Vec local;
     local = va_arg(Argp, Vec);
     if (local) {
-      Vec               global;
-      const PetscScalar *array;
       PetscValidHeaderSpecific(local,VEC_CLASSID,cnt);
-      ierr = DMGetGlobalVector(next->dm,&global);CHKERRQ(ierr);
-      ierr = VecGetArrayRead(gvec,&array);CHKERRQ(ierr);
-      ierr = VecPlaceArray(global,array+next->rstart);CHKERRQ(ierr);
-      ierr = DMGlobalToLocalBegin(next->dm,global,INSERT_VALUES,local);CHKERRQ(ierr);
-      ierr = DMGlobalToLocalEnd(next->dm,global,INSERT_VALUES,local);CHKERRQ(ierr);
-      ierr = VecRestoreArrayRead(gvec,&array);CHKERRQ(ierr);
-      ierr = VecResetArray(global);CHKERRQ(ierr);
-      ierr = DMRestoreGlobalVector(next->dm,&global);CHKERRQ(ierr);
+      ierr = DMGetGlobalVector(next->dm,&globals[cnt-3]);CHKERRQ(ierr);
+      ierr = VecPlaceArray(globals[cnt-3],array+next->rstart);CHKERRQ(ierr);
+      ierr = DMGlobalToLocalBatchAdd(next->dm,batch,globals[cnt-3],INSERT_VALUES,local);CHKERRQ(ierr);
     }
   }
   va_end(Argp);
+  ierr = PetscSFBatchBegin(batch);CHKERRQ(ierr);
+  ierr = PetscSFBatchEnd(batch);CHKERRQ(ierr);
+  for (cnt=0,next=com->next; next; cnt++,next=next->next) {
+    if (globals[cnt]) {
+      ierr = VecResetArray(globals[cnt]);CHKERRQ(ierr);
+      ierr = DMRestoreGlobalVector(next->dm,&globals[cnt]);CHKERRQ(ierr);
+    }
+  }
+  ierr = VecRestoreArrayRead(gvec,&array);CHKERRQ(ierr);
+  ierr = PetscFree(globals);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -603,6 +627,9 @@ PetscErrorCode  DMCompositeScatterArray(DM dm,Vec gvec,Vec *lvecs)
   PetscInt               i;
   DM_Composite           *com = (DM_Composite*)dm->data;
   PetscBool              flg;
+  PetscSFBatch           batch;
+  const PetscScalar      *array;
+  Vec                    *globals;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(dm,DM_CLASSID,1);
@@ -613,22 +640,29 @@ PetscErrorCode  DMCompositeScatterArray(DM dm,Vec gvec,Vec *lvecs)
     ierr = DMSetUp(dm);CHKERRQ(ierr);
   }
 
-  /* loop over packed objects, handling one at at time */
+  ierr = DMCompositeGetBatch_Private(dm,&batch);CHKERRQ(ierr);
+  ierr = PetscCalloc1(com->nDM,&globals);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(gvec,&array);CHKERRQ(ierr);
+
+  /* loop over packed objects, enqueuing their updates so that they are communicated together */
   for (i=0,next=com->next; next; next=next->next,i++) {
     if (lvecs[i]) {
-      Vec         global;
-      const PetscScalar *array;
       PetscValidHeaderSpecific(lvecs[i],VEC_CLASSID,3);
-      ierr = DMGetGlobalVector(next->dm,&global);CHKERRQ(ierr);
-      ierr = VecGetArrayRead(gvec,&array);CHKERRQ(ierr);
-      ierr = VecPlaceArray(global,(PetscScalar*)array+next->rstart);CHKERRQ(ierr);
-      ierr = DMGlobalToLocalBegin(next->dm,global,INSERT_VALUES,lvecs[i]);CHKERRQ(ierr);
-      ierr = DMGlobalToLocalEnd(next->dm,global,INSERT_VALUES,lvecs[i]);CHKERRQ(ierr);
-      ierr = VecRestoreArrayRead(gvec,&array);CHKERRQ(ierr);
-      ierr = VecResetArray(global);CHKERRQ(ierr);
-      ierr = DMRestoreGlobalVector(next->dm,&global);CHKERRQ(ierr);
+      ierr = DMGetGlobalVector(next->dm,&globals[i]);CHKERRQ(ierr);
+      ierr = VecPlaceArray(globals[i],(PetscScalar*)array+next->rstart);CHKERRQ(ierr);
+      ierr = DMGlobalToLocalBatchAdd(next->dm,batch,globals[i],INSERT_VALUES,lvecs[i]);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscSFBatchBegin(batch);CHKERRQ(ierr);
+  ierr = PetscSFBatchEnd(batch);CHKERRQ(ierr);
+  for (i=0,next=com->next; next; next=next->next,i++) {
+    if (globals[i]) {
+      ierr = VecResetArray(globals[i]);CHKERRQ(ierr);
+      ierr = DMRestoreGlobalVector(next->dm,&globals[i]);CHKERRQ(ierr);
     }
   }
+  ierr = VecRestoreArrayRead(gvec,&array);CHKERRQ(ierr);
+  ierr = PetscFree(globals);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1618,58 +1652,139 @@ PetscErrorCode  DMCreateColoring_Composite(DM dm,ISColoringType ctype,ISColoring
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode  DMGlobalToLocalBegin_Composite(DM dm,Vec gvec,InsertMode mode,Vec lvec)
+/* The vectors of a ghost update enqueued on a PetscSFBatch, which are held until the batch is complete */
+typedef struct {
+  DM                dm;
+  Vec               gvec,lvec;
+  const PetscScalar *garray;
+  PetscScalar       *larray;
+  Vec               *globals,*locals;  /* the vectors of the packed DMs, on the arrays of gvec and lvec */
+} DMCompositeBatchCtx;
+
+static PetscErrorCode DMCompositeBatchRestore_Private(void *ctx)
 {
   PetscErrorCode         ierr;
+  DMCompositeBatchCtx    *c = (DMCompositeBatchCtx*)ctx;
+  DM_Composite           *com = (DM_Composite*)c->dm->data;
   struct DMCompositeLink *next;
-  PetscScalar            *garray,*larray;
-  DM_Composite           *com = (DM_Composite*)dm->data;
+  PetscInt               i;
 
   PetscFunctionBegin;
-  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
-  PetscValidHeaderSpecific(gvec,VEC_CLASSID,2);
+  for (i=0,next=com->next; next; next=next->next,i++) {
+    ierr = VecResetArray(c->globals[i]);CHKERRQ(ierr);
+    ierr = VecResetArray(c->locals[i]);CHKERRQ(ierr);
+    ierr = DMRestoreGlobalVector(next->dm,&c->globals[i]);CHKERRQ(ierr);
+    ierr = DMRestoreLocalVector(next->dm,&c->locals[i]);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArrayRead(c->gvec,&c->garray);CHKERRQ(ierr);
+  ierr = VecLockReadPop(c->gvec);CHKERRQ(ierr);
+  ierr = VecRestoreArray(c->lvec,&c->larray);CHKERRQ(ierr);
+  ierr = PetscFree2(c->globals,c->locals);CHKERRQ(ierr);
+  ierr = PetscFree(c);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMGlobalToLocalBatchAdd_Composite(DM dm,PetscSFBatch batch,Vec gvec,InsertMode mode,Vec lvec)
+{
+  PetscErrorCode         ierr;
+  struct DMCompositeLink *next;
+  const PetscScalar      *garray;
+  PetscScalar            *larray;
+  DM_Composite           *com = (DM_Composite*)dm->data;
+  DMCompositeBatchCtx    *c;
+  PetscInt               i;
 
+  PetscFunctionBegin;
   if (!com->setup) {
     ierr = DMSetUp(dm);CHKERRQ(ierr);
   }
 
-  ierr = VecGetArray(gvec,&garray);CHKERRQ(ierr);
-  ierr = VecGetArray(lvec,&larray);CHKERRQ(ierr);
-
-  /* loop over packed objects, handling one at at time */
-  next = com->next;
-  while (next) {
-    Vec      local,global;
-    PetscInt N;
-
-    ierr = DMGetGlobalVector(next->dm,&global);CHKERRQ(ierr);
-    ierr = VecGetLocalSize(global,&N);CHKERRQ(ierr);
-    ierr = VecPlaceArray(global,garray);CHKERRQ(ierr);
-    ierr = DMGetLocalVector(next->dm,&local);CHKERRQ(ierr);
-    ierr = VecPlaceArray(local,larray);CHKERRQ(ierr);
-    ierr = DMGlobalToLocalBegin(next->dm,global,mode,local);CHKERRQ(ierr);
-    ierr = DMGlobalToLocalEnd(next->dm,global,mode,local);CHKERRQ(ierr);
-    ierr = VecResetArray(global);CHKERRQ(ierr);
-    ierr = VecResetArray(local);CHKERRQ(ierr);
-    ierr = DMRestoreGlobalVector(next->dm,&global);CHKERRQ(ierr);
-    ierr = DMRestoreLocalVector(next->dm,&local);CHKERRQ(ierr);
+  ierr = PetscNew(&c);CHKERRQ(ierr);
+  ierr = PetscMalloc2(com->nDM,&c->globals,com->nDM,&c->locals);CHKERRQ(ierr);
+  c->dm   = dm;
+  c->gvec = gvec;
+  c->lvec = lvec;
+  ierr = VecLockReadPush(gvec);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(gvec,&c->garray);CHKERRQ(ierr);
+  ierr = VecGetArray(lvec,&c->larray);CHKERRQ(ierr);
+  garray = c->garray;
+  larray = c->larray;
+
+  /* loop over packed objects, enqueuing their updates so that they are communicated together */
+  for (i=0,next=com->next; next; next=next->next,i++) {
+    ierr = DMGetGlobalVector(next->dm,&c->globals[i]);CHKERRQ(ierr);
+    ierr = VecPlaceArray(c->globals[i],garray);CHKERRQ(ierr);
+    ierr = DMGetLocalVector(next->dm,&c->locals[i]);CHKERRQ(ierr);
+    ierr = VecPlaceArray(c->locals[i],larray);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalBatchAdd(next->dm,batch,c->globals[i],mode,c->locals[i]);CHKERRQ(ierr);
 
     larray += next->nlocal;
     garray += next->n;
-    next    = next->next;
   }
+  /* Added after the hooks of the packed DMs, so that the vectors are released after them */
+  ierr = PetscSFBatchAddEndHook_Private(batch,DMCompositeBatchRestore_Private,c);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
-  ierr = VecRestoreArray(gvec,NULL);CHKERRQ(ierr);
-  ierr = VecRestoreArray(lvec,NULL);CHKERRQ(ierr);
+static PetscErrorCode DMCompositeBatchDestroy_Private(void *ctx)
+{
+  PetscErrorCode ierr;
+  PetscSFBatch   batch = (PetscSFBatch)ctx;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBatchDestroy(&batch);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Each update has its own batch, kept with the local vector, so that the updates of several vectors can overlap */
+static PetscErrorCode DMCompositeGetLocalBatch_Private(DM dm,Vec lvec,PetscBool create,PetscSFBatch *batch)
+{
+  PetscErrorCode ierr;
+  PetscContainer container;
+
+  PetscFunctionBegin;
+  *batch = NULL;
+  ierr = PetscObjectQuery((PetscObject)lvec,"DMComposite_GlobalToLocalBatch",(PetscObject*)&container);CHKERRQ(ierr);
+  if (container) {
+    ierr = PetscContainerGetPointer(container,(void**)batch);CHKERRQ(ierr);
+  } else if (create) {
+    ierr = PetscSFBatchCreate(PetscObjectComm((PetscObject)dm),batch);CHKERRQ(ierr);
+    ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+    ierr = PetscContainerSetPointer(container,*batch);CHKERRQ(ierr);
+    ierr = PetscContainerSetUserDestroy(container,DMCompositeBatchDestroy_Private);CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject)lvec,"DMComposite_GlobalToLocalBatch",(PetscObject)container);CHKERRQ(ierr);
+    ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode  DMGlobalToLocalBegin_Composite(DM dm,Vec gvec,InsertMode mode,Vec lvec)
+{
+  PetscErrorCode ierr;
+  PetscSFBatch   batch;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  PetscValidHeaderSpecific(gvec,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(lvec,VEC_CLASSID,4);
+  ierr = DMCompositeGetLocalBatch_Private(dm,lvec,PETSC_TRUE,&batch);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBatchAdd_Composite(dm,batch,gvec,mode,lvec);CHKERRQ(ierr);
+  ierr = PetscSFBatchBegin(batch);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
 PetscErrorCode  DMGlobalToLocalEnd_Composite(DM dm,Vec gvec,InsertMode mode,Vec lvec)
 {
+  PetscErrorCode ierr;
+  PetscSFBatch   batch;
+
   PetscFunctionBegin;
   PetscValidHeaderSpecific(dm,DM_CLASSID,1);
   PetscValidHeaderSpecific(gvec,VEC_CLASSID,2);
   PetscValidHeaderSpecific(lvec,VEC_CLASSID,4);
+  ierr = DMCompositeGetLocalBatch_Private(dm,lvec,PETSC_FALSE,&batch);CHKERRQ(ierr);
+  if (!batch) SETERRQ(PetscObjectComm((PetscObject)dm),PETSC_ERR_ARG_WRONGSTATE,"Must call DMGlobalToLocalBegin() with this local vector first");
+  ierr = PetscSFBatchEnd(batch);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1817,6 +1932,7 @@ PETSC_EXTERN PetscErrorCode DMCreate_Composite(DM p)
   p->ops->getcoloring                     = DMCreateColoring_Composite;
   p->ops->globaltolocalbegin              = DMGlobalToLocalBegin_Composite;
   p->ops->globaltolocalend                = DMGlobalToLocalEnd_Composite;
+  p->ops->globaltolocalbatchadd           = DMGlobalToLocalBatchAdd_Composite;
   p->ops->localtoglobalbegin              = DMLocalToGlobalBegin_Composite;
   p->ops->localtoglobalend                = DMLocalToGlobalEnd_Composite;
   p->ops->localtolocalbegin               = DMLocalToLocalBegin_Composite;
@@ -76,6 +76,14 @@ PetscErrorCode  DMSetFromOptions_DA(PetscOptionItems *PetscOptionsObject,DM da)
   }
 
   ierr = PetscOptionsBoundedInt("-da_refine","Uniformly refine DA one or more times","None",refine,&refine,NULL,0);CHKERRQ(ierr);
+  {
+    DMDAGhostUpdateType gtype = dd->ghostupdate;
+
+    ierr = PetscOptionsEnum("-da_ghost_update_type","How the ghost points are updated","DMDASetGhostUpdateType",DMDAGhostUpdateTypes,(PetscEnum)gtype,(PetscEnum*)&gtype,&flg);CHKERRQ(ierr);
+    if (flg) {ierr = DMDASetGhostUpdateType(da,gtype);CHKERRQ(ierr);}
+  }
+  n    = dim;
+  ierr = PetscOptionsIntArray("-da_tile_size","Size of the tiles of the cache blocked iterations","DMDASetTileSize",dd->tilesize,&n,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
 
   while (refine--) {
@@ -113,6 +121,7 @@ extern PetscErrorCode  DMCreateGlobalVector_DA(DM,Vec*);
 extern PetscErrorCode  DMCreateLocalVector_DA(DM,Vec*);
 extern PetscErrorCode  DMGlobalToLocalBegin_DA(DM,Vec,InsertMode,Vec);
 extern PetscErrorCode  DMGlobalToLocalEnd_DA(DM,Vec,InsertMode,Vec);
+extern PetscErrorCode  DMGlobalToLocalBatchAdd_DA(DM,PetscSFBatch,Vec,InsertMode,Vec);
 extern PetscErrorCode  DMLocalToGlobalBegin_DA(DM,Vec,InsertMode,Vec);
 extern PetscErrorCode  DMLocalToGlobalEnd_DA(DM,Vec,InsertMode,Vec);
 extern PetscErrorCode  DMLocalToLocalBegin_DA(DM,Vec,InsertMode,Vec);
@@ -418,6 +427,7 @@ PETSC_EXTERN PetscErrorCode DMCreate_DA(DM da)
 
   da->ops->globaltolocalbegin          = DMGlobalToLocalBegin_DA;
   da->ops->globaltolocalend            = DMGlobalToLocalEnd_DA;
+  da->ops->globaltolocalbatchadd       = DMGlobalToLocalBatchAdd_DA;
   da->ops->localtoglobalbegin          = DMLocalToGlobalBegin_DA;
   da->ops->localtoglobalend            = DMLocalToGlobalEnd_DA;
   da->ops->localtolocalbegin           = DMLocalToLocalBegin_DA;
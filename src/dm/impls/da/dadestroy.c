@@ -20,6 +20,8 @@ PetscErrorCode  DMDestroy_DA(DM da)
     ierr = PetscFree(dd->startin[i]);CHKERRQ(ierr);
   }
 
+  ierr = DMDAGhostRMADestroy(&dd->rma);CHKERRQ(ierr);
+  ierr = DMDAGhostHaloDestroy(&dd->halo);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&dd->gtol);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&dd->ltol);CHKERRQ(ierr);
   ierr = VecDestroy(&dd->natural);CHKERRQ(ierr);
@@ -8,11 +8,17 @@ PetscErrorCode  DMGlobalToLocalBegin_DA(DM da,Vec g,InsertMode mode,Vec l)
 {
   PetscErrorCode ierr;
   DM_DA          *dd = (DM_DA*)da->data;
+  PetscBool      done = PETSC_FALSE;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(da,DM_CLASSID,1);
   PetscValidHeaderSpecific(g,VEC_CLASSID,2);
   PetscValidHeaderSpecific(l,VEC_CLASSID,4);
+  if (mode == INSERT_VALUES) {
+    ierr = DMDAGhostHaloBegin(da,g,l,&done);CHKERRQ(ierr);
+    if (!done) {ierr = DMDAGhostRMABegin(da,g,l,&done);CHKERRQ(ierr);}
+  }
+  if (done) PetscFunctionReturn(0);
   ierr = VecScatterBegin(dd->gtol,g,l,mode,SCATTER_FORWARD);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -21,15 +27,31 @@ PetscErrorCode  DMGlobalToLocalEnd_DA(DM da,Vec g,InsertMode mode,Vec l)
 {
   PetscErrorCode ierr;
   DM_DA          *dd = (DM_DA*)da->data;
+  PetscBool      done = PETSC_FALSE;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(da,DM_CLASSID,1);
   PetscValidHeaderSpecific(g,VEC_CLASSID,2);
   PetscValidHeaderSpecific(l,VEC_CLASSID,4);
+  if (mode == INSERT_VALUES) {
+    ierr = DMDAGhostHaloEnd(da,l,&done);CHKERRQ(ierr);
+    if (!done) {ierr = DMDAGhostRMAEnd(da,l,&done);CHKERRQ(ierr);}
+  }
+  if (done) PetscFunctionReturn(0);
   ierr = VecScatterEnd(dd->gtol,g,l,mode,SCATTER_FORWARD);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode  DMGlobalToLocalBatchAdd_DA(DM da,PetscSFBatch batch,Vec g,InsertMode mode,Vec l)
+{
+  PetscErrorCode ierr;
+  DM_DA          *dd = (DM_DA*)da->data;
+
+  PetscFunctionBegin;
+  ierr = VecScatterBatchAdd(dd->gtol,batch,g,l,mode,SCATTER_FORWARD);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode  DMLocalToGlobalBegin_DA(DM da,Vec l,InsertMode mode,Vec g)
 {
   PetscErrorCode ierr;
@@ -0,0 +1,314 @@
+/*
+  Ghost point update of DMDA exploiting its structure.
+
+  The ghost region of a process is made of the (up to 3^dim - 1) boxes lying on the faces, edges and corners of its
+  owned box, each owned by a single neighbor. Neighbors therefore exchange boxes, which are packed and unpacked with
+  one contiguous copy per row (all the dof of a row of points being contiguous) instead of the index lists of the
+  general scatter. All the boxes exchanged with a neighbor go in a single message, corners are skipped with star
+  stencils and the width of the boxes is the stencil width, so that deep halos are exchanged with the same messages.
+*/
+
+#include <petsc/private/dmdaimpl.h>    /*I   "petscdmda.h"   I*/
+
+typedef struct {
+  PetscInt xs,xe,ys,ye,zs,ze;          /* the x range is in units of scalars, not points */
+} DMDAHaloBox;
+
+struct _n_DMDAGhostHalo {
+  MPI_Comm     comm;
+  PetscMPIInt  tag;
+  PetscBool    supported;          /* all the processes can use the boxes, otherwise the scatter is used */
+  PetscInt     gx,gy;              /* strides of the global (owned) array, x in scalars */
+  PetscInt     lx,ly;              /* strides of the local (ghosted) array, x in scalars */
+  PetscMPIInt  nranks,*ranks;      /* neighbors, the same ones sending and receiving */
+  PetscInt     *boffset;           /* CSR offsets of the neighbors into sboxes[] and rboxes[] */
+  DMDAHaloBox  *sboxes,*rboxes;    /* owned boxes sent, in global array coordinates, and ghost boxes received */
+  PetscInt     *soffset,*roffset;  /* offsets of the neighbors into sbuf[] and rbuf[] */
+  PetscScalar  *sbuf,*rbuf;
+  MPI_Request  *sreqs,*rreqs;      /* persistent requests */
+  PetscInt     nself;              /* copies within the process, the owned box first */
+  DMDAHaloBox  *selfsboxes,*selfrboxes;
+  Vec          l;                  /* local vector of the update in progress, if any */
+};
+
+PETSC_STATIC_INLINE PetscInt DMDAHaloBoxSize(const DMDAHaloBox *b)
+{
+  return (b->xe-b->xs)*(b->ye-b->ys)*(b->ze-b->zs);
+}
+
+/* Copies the rows of box b of array a, with strides nx and ny, to the contiguous buffer buf */
+PETSC_STATIC_INLINE PetscErrorCode DMDAHaloPack(const DMDAHaloBox *b,PetscInt nx,PetscInt ny,const PetscScalar *a,PetscScalar *buf)
+{
+  PetscErrorCode ierr;
+  PetscInt       j,k,n = b->xe-b->xs;
+
+  PetscFunctionBegin;
+  for (k=b->zs; k<b->ze; k++) {
+    for (j=b->ys; j<b->ye; j++) {
+      ierr = PetscArraycpy(buf,a+(k*ny+j)*nx+b->xs,n);CHKERRQ(ierr);
+      buf += n;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+PETSC_STATIC_INLINE PetscErrorCode DMDAHaloUnpack(const DMDAHaloBox *b,PetscInt nx,PetscInt ny,const PetscScalar *buf,PetscScalar *a)
+{
+  PetscErrorCode ierr;
+  PetscInt       j,k,n = b->xe-b->xs;
+
+  PetscFunctionBegin;
+  for (k=b->zs; k<b->ze; k++) {
+    for (j=b->ys; j<b->ye; j++) {
+      ierr = PetscArraycpy(a+(k*ny+j)*nx+b->xs,buf,n);CHKERRQ(ierr);
+      buf += n;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Copies box sb of the global array g to box rb, of the same shape, of the local array l */
+static PetscErrorCode DMDAHaloCopy(DMDAGhostHalo h,const DMDAHaloBox *sb,const DMDAHaloBox *rb,const PetscScalar *g,PetscScalar *l)
+{
+  PetscErrorCode ierr;
+  PetscInt       j,k,n = sb->xe-sb->xs;
+
+  PetscFunctionBegin;
+  for (k=0; k<sb->ze-sb->zs; k++) {
+    for (j=0; j<sb->ye-sb->ys; j++) {
+      ierr = PetscArraycpy(l+((rb->zs+k)*h->ly+rb->ys+j)*h->lx+rb->xs,g+((sb->zs+k)*h->gy+sb->ys+j)*h->gx+sb->xs,n);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+  The boxes of direction d, with offsets d % 3 - 1, (d/3) % 3 - 1 and d/9 - 1 along the dimensions: sb is the owned box
+  sent to the neighbor on that side, relative to the owned box, and rb the ghost box received from it, relative to the
+  ghosted box. The neighbor receives sb in the opposite direction 3^dim - 1 - d.
+*/
+static void DMDAHaloGetBoxes(DM da,PetscInt d,DMDAHaloBox *sb,DMDAHaloBox *rb)
+{
+  DM_DA    *dd = (DM_DA*)da->data;
+  PetscInt i,o,w = dd->s,s[3],e[3],S[3],ss[3],se[3],rs[3],re[3];
+
+  s[0] = dd->xs/dd->w; e[0] = dd->xe/dd->w; S[0] = dd->Xs/dd->w;
+  s[1] = dd->ys;       e[1] = dd->ye;       S[1] = dd->Ys;
+  s[2] = dd->zs;       e[2] = dd->ze;       S[2] = dd->Zs;
+  for (i=0; i<3; i++, d/=3) {
+    o = i < da->dim ? d%3-1 : 0;
+    if (i >= da->dim) {ss[i] = 0; se[i] = e[i]-s[i]; rs[i] = 0; re[i] = e[i]-s[i];}
+    else if (o < 0)   {ss[i] = 0; se[i] = w; rs[i] = s[i]-w-S[i]; re[i] = s[i]-S[i];}
+    else if (o == 0)  {ss[i] = 0; se[i] = e[i]-s[i]; rs[i] = s[i]-S[i]; re[i] = e[i]-S[i];}
+    else              {ss[i] = e[i]-s[i]-w; se[i] = e[i]-s[i]; rs[i] = e[i]-S[i]; re[i] = e[i]+w-S[i];}
+  }
+  if (sb) {sb->xs = ss[0]*dd->w; sb->xe = se[0]*dd->w; sb->ys = ss[1]; sb->ye = se[1]; sb->zs = ss[2]; sb->ze = se[2];}
+  if (rb) {rb->xs = rs[0]*dd->w; rb->xe = re[0]*dd->w; rb->ys = rs[1]; rb->ye = re[1]; rb->zs = rs[2]; rb->ze = re[2];}
+}
+
+static PetscErrorCode DMDAGhostHaloSetUp(DM da,DMDAGhostHalo *halo)
+{
+  PetscErrorCode ierr;
+  DM_DA          *dd = (DM_DA*)da->data;
+  DMDAGhostHalo  h;
+  PetscMPIInt    rank,nbr[27];
+  PetscInt       dim = da->dim,nd = 1,d,i,j,c,procs[3],coords[3],width[3];
+  DMBoundaryType bd[3];
+
+  PetscFunctionBegin;
+  ierr = PetscNew(&h);CHKERRQ(ierr);
+  ierr = PetscCommDuplicate(PetscObjectComm((PetscObject)da),&h->comm,&h->tag);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(h->comm,&rank);CHKERRMPI(ierr);
+  h->gx = dd->xe-dd->xs; h->gy = dd->ye-dd->ys;
+  h->lx = dd->Xe-dd->Xs; h->ly = dd->Ye-dd->Ys;
+  procs[0]  = dd->m;           procs[1]  = dd->n;              procs[2]  = dd->p;
+  coords[0] = rank % dd->m;    coords[1] = (rank/dd->m) % dd->n; coords[2] = rank/(dd->m*dd->n);
+  width[0]  = h->gx/dd->w;     width[1]  = h->gy;              width[2]  = dd->ze-dd->zs;
+  bd[0]     = dd->bx;          bd[1]     = dd->by;             bd[2]     = dd->bz;
+  for (i=0; i<dim; i++) nd *= 3;
+
+  /* The ghost points along a dimension must all come from the nearest neighbor, in which case all the processes must
+     use the boxes since they exchange them with each other */
+  h->supported = PETSC_TRUE;
+  for (i=0; i<dim; i++) {
+    if (bd[i] == DM_BOUNDARY_MIRROR || bd[i] == DM_BOUNDARY_TWIST) h->supported = PETSC_FALSE;
+    if ((procs[i] > 1 || bd[i] == DM_BOUNDARY_PERIODIC) && width[i] < dd->s) h->supported = PETSC_FALSE;
+  }
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&h->supported,1,MPIU_BOOL,MPI_LAND,h->comm);CHKERRQ(ierr);
+  if (!h->supported) {
+    ierr = PetscInfo(da,"Ghost points do not all come from the nearest neighbors, using the scatter\n");CHKERRQ(ierr);
+    *halo = h;
+    PetscFunctionReturn(0);
+  }
+
+  /* The neighbor on each side, none at nonperiodic boundaries and at the corners of star stencils */
+  for (d=0; d<nd; d++) {
+    PetscInt o,q[3] = {0,0,0},nz = 0,t = d;
+
+    nbr[d] = -1;
+    for (i=0; i<dim; i++, t/=3) {
+      o    = t%3-1;
+      q[i] = coords[i]+o;
+      if (o) nz++;
+      if (q[i] < 0 || q[i] >= procs[i]) {
+        if (bd[i] != DM_BOUNDARY_PERIODIC) break;
+        q[i] = (q[i]+procs[i]) % procs[i];
+      }
+    }
+    if (i < dim || !nz || (dd->stencil_type == DMDA_STENCIL_STAR && nz > 1)) continue;
+    nbr[d] = (PetscMPIInt)(q[0]+dd->m*(q[1]+dd->n*q[2]));
+  }
+
+  /* One message per distinct neighbor, with the boxes in increasing direction of the receiver */
+  ierr = PetscMalloc1(nd,&h->ranks);CHKERRQ(ierr);
+  for (d=0; d<nd; d++) {
+    if (nbr[d] < 0 || nbr[d] == rank) continue;
+    for (j=0; j<h->nranks; j++) if (h->ranks[j] == nbr[d]) break;
+    if (j == h->nranks) h->ranks[h->nranks++] = nbr[d];
+  }
+  ierr = PetscSortMPIInt(h->nranks,h->ranks);CHKERRQ(ierr);
+  for (h->nself=1,c=0,d=0; d<nd; d++) {
+    if (nbr[d] == rank) h->nself++;
+    else if (nbr[d] >= 0) c++;
+  }
+  ierr = PetscMalloc3(h->nranks+1,&h->boffset,c,&h->sboxes,c,&h->rboxes);CHKERRQ(ierr);
+  ierr = PetscMalloc2(h->nself,&h->selfsboxes,h->nself,&h->selfrboxes);CHKERRQ(ierr);
+  h->boffset[0] = 0;
+  for (j=0; j<h->nranks; j++) {
+    for (c=h->boffset[j],d=nd-1; d>=0; d--) if (nbr[d] == h->ranks[j]) DMDAHaloGetBoxes(da,d,&h->sboxes[c++],NULL);
+    for (c=h->boffset[j],d=0; d<nd; d++) if (nbr[d] == h->ranks[j]) DMDAHaloGetBoxes(da,d,NULL,&h->rboxes[c++]);
+    h->boffset[j+1] = c;
+  }
+
+  /* The owned box, then the periodic ghost points coming from the process itself */
+  DMDAHaloGetBoxes(da,(nd-1)/2,&h->selfsboxes[0],&h->selfrboxes[0]);
+  for (c=1,d=0; d<nd; d++) {
+    if (nbr[d] != rank) continue;
+    DMDAHaloGetBoxes(da,nd-1-d,&h->selfsboxes[c],NULL);
+    DMDAHaloGetBoxes(da,d,NULL,&h->selfrboxes[c++]);
+  }
+
+  /* Buffers and persistent requests, one message per neighbor */
+  ierr = PetscMalloc2(h->nranks+1,&h->soffset,h->nranks+1,&h->roffset);CHKERRQ(ierr);
+  h->soffset[0] = h->roffset[0] = 0;
+  for (j=0; j<h->nranks; j++) {
+    h->soffset[j+1] = h->soffset[j];
+    h->roffset[j+1] = h->roffset[j];
+    for (c=h->boffset[j]; c<h->boffset[j+1]; c++) {
+      h->soffset[j+1] += DMDAHaloBoxSize(&h->sboxes[c]);
+      h->roffset[j+1] += DMDAHaloBoxSize(&h->rboxes[c]);
+    }
+  }
+  ierr = PetscMalloc4(h->soffset[h->nranks],&h->sbuf,h->roffset[h->nranks],&h->rbuf,h->nranks,&h->sreqs,h->nranks,&h->rreqs);CHKERRQ(ierr);
+  for (j=0; j<h->nranks; j++) {
+    ierr = MPI_Recv_init(h->rbuf+h->roffset[j],(PetscMPIInt)(h->roffset[j+1]-h->roffset[j]),MPIU_SCALAR,h->ranks[j],h->tag,h->comm,&h->rreqs[j]);CHKERRMPI(ierr);
+    ierr = MPI_Send_init(h->sbuf+h->soffset[j],(PetscMPIInt)(h->soffset[j+1]-h->soffset[j]),MPIU_SCALAR,h->ranks[j],h->tag,h->comm,&h->sreqs[j]);CHKERRMPI(ierr);
+  }
+  ierr = PetscInfo2(da,"Ghost points exchanged with %d neighbors, %D copied within the process\n",h->nranks,h->nself-1);CHKERRQ(ierr);
+  *halo = h;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode DMDAGhostHaloDestroy(DMDAGhostHalo *halo)
+{
+  PetscErrorCode ierr;
+  DMDAGhostHalo  h = *halo;
+  PetscMPIInt    j;
+
+  PetscFunctionBegin;
+  if (!h) PetscFunctionReturn(0);
+  if (h->l) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot destroy the ghost update during an update");
+  for (j=0; j<h->nranks; j++) {
+    ierr = MPI_Request_free(&h->rreqs[j]);CHKERRMPI(ierr);
+    ierr = MPI_Request_free(&h->sreqs[j]);CHKERRMPI(ierr);
+  }
+  ierr = PetscFree4(h->sbuf,h->rbuf,h->sreqs,h->rreqs);CHKERRQ(ierr);
+  ierr = PetscFree2(h->soffset,h->roffset);CHKERRQ(ierr);
+  ierr = PetscFree2(h->selfsboxes,h->selfrboxes);CHKERRQ(ierr);
+  ierr = PetscFree3(h->boffset,h->sboxes,h->rboxes);CHKERRQ(ierr);
+  ierr = PetscFree(h->ranks);CHKERRQ(ierr);
+  ierr = PetscCommDestroy(&h->comm);CHKERRQ(ierr);
+  ierr = PetscFree(*halo);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Tells whether an update started by DMDAGhostHaloBegin() has not been completed yet */
+PetscErrorCode DMDAGhostHaloInProgress(DMDAGhostHalo h,PetscBool *inprogress)
+{
+  PetscFunctionBegin;
+  *inprogress = (h && h->l) ? PETSC_TRUE : PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*
+  Starts a structured ghost update. Returns PETSC_FALSE in done when it cannot be used for this update (another update
+  with the DMDA is in progress, the ghost points do not all come from nearest neighbors, or the DMDA uses another type
+  of update), the caller then uses the scatter.
+*/
+PetscErrorCode DMDAGhostHaloBegin(DM da,Vec g,Vec l,PetscBool *done)
+{
+  PetscErrorCode    ierr;
+  DM_DA             *dd = (DM_DA*)da->data;
+  DMDAGhostHalo     h;
+  const PetscScalar *garray;
+  PetscScalar       *larray;
+  PetscMPIInt       j;
+  PetscInt          c;
+
+  PetscFunctionBegin;
+  *done = PETSC_FALSE;
+  if (dd->ghostupdate != DMDA_GHOST_UPDATE_STRUCTURED) PetscFunctionReturn(0);
+  if (!dd->halo) {ierr = DMDAGhostHaloSetUp(da,&dd->halo);CHKERRQ(ierr);}
+  h = dd->halo;
+  if (!h->supported || h->l) PetscFunctionReturn(0);
+  if (h->nranks) {ierr = MPI_Startall(h->nranks,h->rreqs);CHKERRMPI(ierr);}
+  ierr = VecGetArrayRead(g,&garray);CHKERRQ(ierr);
+  for (j=0; j<h->nranks; j++) {
+    PetscScalar *buf = h->sbuf+h->soffset[j];
+
+    for (c=h->boffset[j]; c<h->boffset[j+1]; c++) {
+      ierr = DMDAHaloPack(&h->sboxes[c],h->gx,h->gy,garray,buf);CHKERRQ(ierr);
+      buf += DMDAHaloBoxSize(&h->sboxes[c]);
+    }
+  }
+  if (h->nranks) {ierr = MPI_Startall(h->nranks,h->sreqs);CHKERRMPI(ierr);}
+  ierr = VecGetArray(l,&larray);CHKERRQ(ierr);
+  for (c=0; c<h->nself; c++) {
+    ierr = DMDAHaloCopy(h,&h->selfsboxes[c],&h->selfrboxes[c],garray,larray);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(l,&larray);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(g,&garray);CHKERRQ(ierr);
+  h->l  = l;
+  *done = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/* Completes the update started by DMDAGhostHaloBegin(), done is PETSC_FALSE if l is not the vector being updated */
+PetscErrorCode DMDAGhostHaloEnd(DM da,Vec l,PetscBool *done)
+{
+  PetscErrorCode ierr;
+  DM_DA          *dd = (DM_DA*)da->data;
+  DMDAGhostHalo  h = dd->halo;
+  PetscScalar    *larray;
+  PetscMPIInt    j;
+  PetscInt       c;
+
+  PetscFunctionBegin;
+  *done = PETSC_FALSE;
+  if (!h || h->l != l) PetscFunctionReturn(0);
+  ierr = MPI_Waitall(h->nranks,h->rreqs,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+  ierr = VecGetArray(l,&larray);CHKERRQ(ierr);
+  for (j=0; j<h->nranks; j++) {
+    const PetscScalar *buf = h->rbuf+h->roffset[j];
+
+    for (c=h->boffset[j]; c<h->boffset[j+1]; c++) {
+      ierr = DMDAHaloUnpack(&h->rboxes[c],h->lx,h->ly,buf,larray);CHKERRQ(ierr);
+      buf += DMDAHaloBoxSize(&h->rboxes[c]);
+    }
+  }
+  ierr = VecRestoreArray(l,&larray);CHKERRQ(ierr);
+  ierr = MPI_Waitall(h->nranks,h->sreqs,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+  h->l  = NULL;
+  *done = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,370 @@
+/*
+  Ghost point update of DMDA with MPI-3 one-sided communication.
+
+  Each process exposes a persistent window holding the ghost values it receives, grouped by the process owning them.
+  Owners pack their boundary values and MPI_Put() them directly at their place in the windows of the neighbors,
+  using the graph of the global-to-local scatter of the DMDA.
+*/
+
+#include <petsc/private/dmdaimpl.h>    /*I   "petscdmda.h"   I*/
+#include <petsc/private/sfimpl.h>
+
+const char *const DMDAGhostUpdateTypes[] = {"SCATTER","RMA_ACTIVE","RMA_PASSIVE","STRUCTURED","DMDAGhostUpdateType","DMDA_GHOST_UPDATE_",NULL};
+
+struct _n_DMDAGhostRMA {
+  DMDAGhostUpdateType type;
+  MPI_Comm            comm;
+  PetscMPIInt         tagready,tagdone;
+  PetscInt            bs;             /* number of scalars per vertex of the scatter graph */
+  /* Origin side: owned values put into the window of each target */
+  PetscMPIInt         ntargets,*targets;
+  PetscInt            *toffset;       /* CSR offsets of the targets into tidx[] and sendbuf[] */
+  PetscInt            *tidx;          /* indices in the global vector, in units of bs */
+  PetscInt            *tdisp;         /* displacement in the window of each target, in units of bs */
+  PetscScalar         *sendbuf;
+  /* Target side: ghost values received from each origin */
+  PetscMPIInt         norigins,*origins;
+  PetscInt            *ooffset;       /* CSR offsets of the origins into oidx[] and the window */
+  PetscInt            *oidx;          /* indices in the local vector, in units of bs */
+  /* Values copied within the process */
+  PetscInt            nself,*selfroot,*selfleaf;
+  PetscScalar         *recvbuf;       /* the window memory */
+  MPI_Win             win;
+  MPI_Group           targetgroup,origingroup;          /* used by DMDA_GHOST_UPDATE_RMA_ACTIVE */
+  MPI_Request         *readyrecv,*donesend;             /* used by DMDA_GHOST_UPDATE_RMA_PASSIVE, on the origin side */
+  MPI_Request         *donerecv,*readysend;             /* and on the target side */
+  PetscBool           started;        /* an exchange has been completed, so targets have sent a ready message */
+  Vec                 l;              /* local vector of the update in progress, if any */
+};
+
+#if defined(PETSC_HAVE_MPI_ONE_SIDED)
+static PetscErrorCode DMDAGhostRMASetUp(DM da,DMDAGhostUpdateType type,DMDAGhostRMA *rma)
+{
+  PetscErrorCode     ierr;
+  DM_DA              *dd = (DM_DA*)da->data;
+  DMDAGhostRMA       r;
+  PetscSF            sf = dd->gtol;
+  PetscMPIInt        rank,nto,nfrom,*fromranks,i;
+  PetscInt           nroots,nleaves,p,k,*perm,*pranks,*todata,*fromdata,*rremote;
+  const PetscInt     *ilocal;
+  const PetscSFNode  *iremote;
+  MPI_Request        *reqs;
+  MPI_Group          group;
+  MPI_Aint           wsize;
+
+  PetscFunctionBegin;
+  ierr = PetscNew(&r);CHKERRQ(ierr);
+  r->type = type;
+  ierr = PetscCommDuplicate(PetscObjectComm((PetscObject)da),&r->comm,&r->tagready);CHKERRQ(ierr);
+  ierr = PetscCommGetNewTag(r->comm,&r->tagdone);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(r->comm,&rank);CHKERRMPI(ierr);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  r->bs = sf->vscat.bs;
+  ierr = PetscSFGetGraph(sf,&nroots,&nleaves,&ilocal,&iremote);CHKERRQ(ierr);
+
+  /* Group the ghost points by owner, the ones owned by this process being copied */
+  ierr = PetscMalloc2(nleaves,&perm,nleaves,&pranks);CHKERRQ(ierr);
+  for (p=0; p<nleaves; p++) {
+    perm[p]   = p;
+    pranks[p] = iremote[p].rank;
+  }
+  ierr = PetscSortIntWithArray(nleaves,pranks,perm);CHKERRQ(ierr);
+  for (p=0; p<nleaves; p++) {
+    if (pranks[p] == rank) r->nself++;
+    else if (!p || pranks[p] != pranks[p-1]) r->norigins++;
+  }
+  ierr = PetscMalloc2(r->nself,&r->selfroot,r->nself,&r->selfleaf);CHKERRQ(ierr);
+  ierr = PetscMalloc3(r->norigins,&r->origins,r->norigins+1,&r->ooffset,nleaves-r->nself,&r->oidx);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nleaves-r->nself,&rremote);CHKERRQ(ierr);
+  r->ooffset[0] = 0;
+  for (p=0,i=-1,k=0; p<nleaves; p++) {
+    PetscInt leaf = ilocal ? ilocal[perm[p]] : perm[p];
+
+    if (pranks[p] == rank) {
+      r->selfroot[k]   = iremote[perm[p]].index;
+      r->selfleaf[k++] = leaf;
+      continue;
+    }
+    if (i < 0 || r->origins[i] != pranks[p]) {
+      i++;
+      r->origins[i]   = (PetscMPIInt)pranks[p];
+      r->ooffset[i+1] = r->ooffset[i];
+    }
+    r->oidx[r->ooffset[i+1]]    = leaf;
+    rremote[r->ooffset[i+1]++] = iremote[perm[p]].index;
+  }
+  ierr = PetscFree2(perm,pranks);CHKERRQ(ierr);
+
+  /* Tell each owner how many of its values we need and where they go in our window, then which ones */
+  nto  = r->norigins;
+  ierr = PetscMalloc1(2*nto,&todata);CHKERRQ(ierr);
+  for (i=0; i<nto; i++) {
+    todata[2*i]   = r->ooffset[i+1]-r->ooffset[i];
+    todata[2*i+1] = r->ooffset[i];
+  }
+  ierr = PetscCommBuildTwoSided(r->comm,2,MPIU_INT,nto,r->origins,todata,&nfrom,&fromranks,&fromdata);CHKERRQ(ierr);
+  ierr = PetscFree(todata);CHKERRQ(ierr);
+  r->ntargets = nfrom;
+  r->targets  = fromranks;
+  ierr = PetscMalloc2(nfrom+1,&r->toffset,nfrom,&r->tdisp);CHKERRQ(ierr);
+  for (r->toffset[0]=0,i=0; i<nfrom; i++) {
+    r->toffset[i+1] = r->toffset[i]+fromdata[2*i];
+    r->tdisp[i]     = fromdata[2*i+1];
+  }
+  ierr = PetscFree(fromdata);CHKERRQ(ierr);
+  ierr = PetscMalloc1(r->toffset[nfrom],&r->tidx);CHKERRQ(ierr);
+  ierr = PetscMalloc1(r->ntargets+r->norigins,&reqs);CHKERRQ(ierr);
+  for (i=0; i<r->ntargets; i++) {
+    ierr = MPI_Irecv(r->tidx+r->toffset[i],(PetscMPIInt)(r->toffset[i+1]-r->toffset[i]),MPIU_INT,r->targets[i],r->tagdone,r->comm,&reqs[i]);CHKERRMPI(ierr);
+  }
+  for (i=0; i<r->norigins; i++) {
+    ierr = MPI_Isend(rremote+r->ooffset[i],(PetscMPIInt)(r->ooffset[i+1]-r->ooffset[i]),MPIU_INT,r->origins[i],r->tagdone,r->comm,&reqs[r->ntargets+i]);CHKERRMPI(ierr);
+  }
+  ierr = MPI_Waitall(r->ntargets+r->norigins,reqs,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+  ierr = PetscFree(reqs);CHKERRQ(ierr);
+  ierr = PetscFree(rremote);CHKERRQ(ierr);
+  ierr = PetscMalloc1(r->toffset[r->ntargets]*r->bs,&r->sendbuf);CHKERRQ(ierr);
+
+  /* The window, allocated by MPI which may then use memory suitable for RMA */
+  wsize = (MPI_Aint)(r->ooffset[r->norigins]*r->bs*sizeof(PetscScalar));
+  ierr  = MPI_Win_allocate(wsize,(PetscMPIInt)sizeof(PetscScalar),MPI_INFO_NULL,r->comm,&r->recvbuf,&r->win);CHKERRMPI(ierr);
+  if (type == DMDA_GHOST_UPDATE_RMA_ACTIVE) {
+    ierr = MPI_Comm_group(r->comm,&group);CHKERRMPI(ierr);
+    ierr = MPI_Group_incl(group,r->ntargets,r->targets,&r->targetgroup);CHKERRMPI(ierr);
+    ierr = MPI_Group_incl(group,r->norigins,r->origins,&r->origingroup);CHKERRMPI(ierr);
+    ierr = MPI_Group_free(&group);CHKERRMPI(ierr);
+  } else {
+    /* A passive target epoch open for the lifetime of the window; zero-byte messages tell the targets that the puts
+       of an update are complete and the origins that the previous values have been unpacked */
+    ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK,r->win);CHKERRMPI(ierr);
+    ierr = PetscMalloc4(r->ntargets,&r->readyrecv,r->ntargets,&r->donesend,r->norigins,&r->donerecv,r->norigins,&r->readysend);CHKERRQ(ierr);
+    for (i=0; i<r->ntargets; i++) {
+      ierr = MPI_Recv_init(NULL,0,MPI_BYTE,r->targets[i],r->tagready,r->comm,&r->readyrecv[i]);CHKERRMPI(ierr);
+      ierr = MPI_Send_init(NULL,0,MPI_BYTE,r->targets[i],r->tagdone,r->comm,&r->donesend[i]);CHKERRMPI(ierr);
+    }
+    for (i=0; i<r->norigins; i++) {
+      ierr = MPI_Recv_init(NULL,0,MPI_BYTE,r->origins[i],r->tagdone,r->comm,&r->donerecv[i]);CHKERRMPI(ierr);
+      ierr = MPI_Send_init(NULL,0,MPI_BYTE,r->origins[i],r->tagready,r->comm,&r->readysend[i]);CHKERRMPI(ierr);
+    }
+    ierr = MPI_Startall(r->norigins,r->donerecv);CHKERRMPI(ierr);
+  }
+  *rma = r;
+  PetscFunctionReturn(0);
+}
+#endif
+
+PetscErrorCode DMDAGhostRMADestroy(DMDAGhostRMA *rma)
+{
+  PetscErrorCode ierr;
+  DMDAGhostRMA   r = *rma;
+  PetscMPIInt    i;
+
+  PetscFunctionBegin;
+  if (!r) PetscFunctionReturn(0);
+#if defined(PETSC_HAVE_MPI_ONE_SIDED)
+  if (r->type == DMDA_GHOST_UPDATE_RMA_ACTIVE) {
+    ierr = MPI_Group_free(&r->targetgroup);CHKERRMPI(ierr);
+    ierr = MPI_Group_free(&r->origingroup);CHKERRMPI(ierr);
+  } else {
+    /* Collect the ready messages of the last update and withdraw the receives of the next one */
+    if (r->started) {
+      ierr = MPI_Waitall(r->ntargets,r->readyrecv,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+      ierr = MPI_Waitall(r->norigins,r->readysend,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+    }
+    for (i=0; i<r->norigins; i++) {
+      ierr = MPI_Cancel(&r->donerecv[i]);CHKERRMPI(ierr);
+      ierr = MPI_Wait(&r->donerecv[i],MPI_STATUS_IGNORE);CHKERRMPI(ierr);
+      ierr = MPI_Request_free(&r->donerecv[i]);CHKERRMPI(ierr);
+      ierr = MPI_Request_free(&r->readysend[i]);CHKERRMPI(ierr);
+    }
+    for (i=0; i<r->ntargets; i++) {
+      ierr = MPI_Request_free(&r->readyrecv[i]);CHKERRMPI(ierr);
+      ierr = MPI_Request_free(&r->donesend[i]);CHKERRMPI(ierr);
+    }
+    ierr = PetscFree4(r->readyrecv,r->donesend,r->donerecv,r->readysend);CHKERRQ(ierr);
+    ierr = MPI_Win_unlock_all(r->win);CHKERRMPI(ierr);
+  }
+  ierr = MPI_Win_free(&r->win);CHKERRMPI(ierr);
+#endif
+  ierr = PetscFree(r->targets);CHKERRQ(ierr);
+  ierr = PetscFree2(r->toffset,r->tdisp);CHKERRQ(ierr);
+  ierr = PetscFree(r->tidx);CHKERRQ(ierr);
+  ierr = PetscFree(r->sendbuf);CHKERRQ(ierr);
+  ierr = PetscFree3(r->origins,r->ooffset,r->oidx);CHKERRQ(ierr);
+  ierr = PetscFree2(r->selfroot,r->selfleaf);CHKERRQ(ierr);
+  ierr = PetscCommDestroy(&r->comm);CHKERRQ(ierr);
+  ierr = PetscFree(*rma);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  Starts a ghost update with one-sided communication. Returns PETSC_FALSE in done when it cannot be used for this update
+  (another update with the DMDA is in progress, or the DMDA uses the scatter), the caller then uses the scatter.
+*/
+PetscErrorCode DMDAGhostRMABegin(DM da,Vec g,Vec l,PetscBool *done)
+{
+#if defined(PETSC_HAVE_MPI_ONE_SIDED)
+  PetscErrorCode    ierr;
+  DM_DA             *dd = (DM_DA*)da->data;
+  DMDAGhostRMA      r;
+  const PetscScalar *garray;
+  PetscScalar       *larray;
+  PetscInt          i,j,k,bs;
+#endif
+
+  PetscFunctionBegin;
+  *done = PETSC_FALSE;
+#if defined(PETSC_HAVE_MPI_ONE_SIDED)
+  if (dd->ghostupdate != DMDA_GHOST_UPDATE_RMA_ACTIVE && dd->ghostupdate != DMDA_GHOST_UPDATE_RMA_PASSIVE) PetscFunctionReturn(0);
+  if (!dd->rma) {ierr = DMDAGhostRMASetUp(da,dd->ghostupdate,&dd->rma);CHKERRQ(ierr);}
+  r  = dd->rma;
+  if (r->l) PetscFunctionReturn(0);
+  bs = r->bs;
+  if (r->type == DMDA_GHOST_UPDATE_RMA_ACTIVE) {
+    ierr = MPI_Win_post(r->origingroup,0,r->win);CHKERRMPI(ierr);
+  } else if (r->started) {    /* the targets must have unpacked the previous values before they are overwritten */
+    ierr = MPI_Waitall(r->ntargets,r->readyrecv,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+  }
+  ierr = VecGetArrayRead(g,&garray);CHKERRQ(ierr);
+  for (i=0; i<r->toffset[r->ntargets]; i++) {
+    for (k=0; k<bs; k++) r->sendbuf[i*bs+k] = garray[r->tidx[i]*bs+k];
+  }
+  if (r->type == DMDA_GHOST_UPDATE_RMA_ACTIVE) {ierr = MPI_Win_start(r->targetgroup,0,r->win);CHKERRMPI(ierr);}
+  for (j=0; j<r->ntargets; j++) {
+    PetscMPIInt n = (PetscMPIInt)((r->toffset[j+1]-r->toffset[j])*bs);
+    ierr = MPI_Put(r->sendbuf+r->toffset[j]*bs,n,MPIU_SCALAR,r->targets[j],(MPI_Aint)(r->tdisp[j]*bs),n,MPIU_SCALAR,r->win);CHKERRMPI(ierr);
+  }
+  if (r->type == DMDA_GHOST_UPDATE_RMA_PASSIVE) {
+    ierr = MPI_Win_flush_all(r->win);CHKERRMPI(ierr);
+    ierr = MPI_Startall(r->ntargets,r->donesend);CHKERRMPI(ierr);
+  }
+  ierr = VecGetArray(l,&larray);CHKERRQ(ierr);
+  for (i=0; i<r->nself; i++) {
+    for (k=0; k<bs; k++) larray[r->selfleaf[i]*bs+k] = garray[r->selfroot[i]*bs+k];
+  }
+  ierr = VecRestoreArray(l,&larray);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(g,&garray);CHKERRQ(ierr);
+  r->l  = l;
+  *done = PETSC_TRUE;
+#endif
+  PetscFunctionReturn(0);
+}
+
+/* Completes the update started by DMDAGhostRMABegin(), done is PETSC_FALSE if l is not the vector being updated */
+PetscErrorCode DMDAGhostRMAEnd(DM da,Vec l,PetscBool *done)
+{
+#if defined(PETSC_HAVE_MPI_ONE_SIDED)
+  PetscErrorCode ierr;
+  DM_DA          *dd = (DM_DA*)da->data;
+  DMDAGhostRMA   r = dd->rma;
+  PetscScalar    *larray;
+  PetscInt       i,k,bs;
+#endif
+
+  PetscFunctionBegin;
+  *done = PETSC_FALSE;
+#if defined(PETSC_HAVE_MPI_ONE_SIDED)
+  if (!r || r->l != l) PetscFunctionReturn(0);
+  bs = r->bs;
+  if (r->type == DMDA_GHOST_UPDATE_RMA_ACTIVE) {
+    ierr = MPI_Win_complete(r->win);CHKERRMPI(ierr);
+    ierr = MPI_Win_wait(r->win);CHKERRMPI(ierr);
+  } else {
+    ierr = MPI_Waitall(r->norigins,r->donerecv,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+    ierr = MPI_Win_sync(r->win);CHKERRMPI(ierr);
+  }
+  ierr = VecGetArray(l,&larray);CHKERRQ(ierr);
+  for (i=0; i<r->ooffset[r->norigins]; i++) {
+    for (k=0; k<bs; k++) larray[r->oidx[i]*bs+k] = r->recvbuf[i*bs+k];
+  }
+  ierr = VecRestoreArray(l,&larray);CHKERRQ(ierr);
+  if (r->type == DMDA_GHOST_UPDATE_RMA_PASSIVE) {
+    ierr = MPI_Waitall(r->ntargets,r->donesend,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+    if (r->started) {ierr = MPI_Waitall(r->norigins,r->readysend,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);}
+    ierr = MPI_Startall(r->norigins,r->readysend);CHKERRMPI(ierr);
+    ierr = MPI_Startall(r->ntargets,r->readyrecv);CHKERRMPI(ierr);
+    ierr = MPI_Startall(r->norigins,r->donerecv);CHKERRMPI(ierr);
+    r->started = PETSC_TRUE;
+  }
+  r->l  = NULL;
+  *done = PETSC_TRUE;
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMDASetGhostUpdateType - Sets how the ghost points of local vectors are updated by DMGlobalToLocalBegin()/DMGlobalToLocalEnd()
+
+  Logically Collective on da
+
+  Input Parameters:
++ da   - The DMDA
+- type - DMDA_GHOST_UPDATE_SCATTER (default), DMDA_GHOST_UPDATE_RMA_ACTIVE, DMDA_GHOST_UPDATE_RMA_PASSIVE or DMDA_GHOST_UPDATE_STRUCTURED
+
+  Options Database Key:
+. -da_ghost_update_type <scatter,rma_active,rma_passive,structured> - the ghost update type
+
+  Notes:
+  With the RMA types, each process exposes a persistent MPI window receiving its ghost values, and the owners of these
+  values put them there with MPI_Put(). DMDA_GHOST_UPDATE_RMA_ACTIVE synchronizes each update with neighbors only
+  (MPI_Win_post()/MPI_Win_start()/MPI_Win_complete()/MPI_Win_wait()); DMDA_GHOST_UPDATE_RMA_PASSIVE keeps a passive target
+  epoch open and completes the puts with MPI_Win_flush_all(), then notifies the neighbors with zero-byte messages.
+
+  DMDA_GHOST_UPDATE_STRUCTURED sends each neighbor one message with the faces (and the edges and corners with box
+  stencils) of the owned box it needs, packed and unpacked with one contiguous copy per row of points instead of the
+  index lists of the scatter. It requires the ghost points to come from the nearest neighbors only, and no
+  DM_BOUNDARY_MIRROR boundaries, the scatter being used otherwise.
+
+  Only INSERT_VALUES updates use these types, and only one at a time for a given DMDA; other updates use the
+  scatter. The RMA types require MPI-3 one-sided communication.
+
+  Level: advanced
+
+.seealso: DMDAGetGhostUpdateType(), DMGlobalToLocalBegin(), DMGlobalToLocalEnd(), DMDAGhostUpdateType
+@*/
+PetscErrorCode DMDASetGhostUpdateType(DM da,DMDAGhostUpdateType type)
+{
+  PetscErrorCode ierr;
+  DM_DA          *dd = (DM_DA*)da->data;
+  PetscBool      inprogress;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecificType(da,DM_CLASSID,1,DMDA);
+  PetscValidLogicalCollectiveEnum(da,type,2);
+#if !defined(PETSC_HAVE_MPI_ONE_SIDED)
+  if (type == DMDA_GHOST_UPDATE_RMA_ACTIVE || type == DMDA_GHOST_UPDATE_RMA_PASSIVE) SETERRQ1(PetscObjectComm((PetscObject)da),PETSC_ERR_SUP_SYS,"Ghost update type %s requires MPI-3 one-sided communication",DMDAGhostUpdateTypes[type]);
+#endif
+  if (type == dd->ghostupdate) PetscFunctionReturn(0);
+  ierr = DMDAGhostHaloInProgress(dd->halo,&inprogress);CHKERRQ(ierr);
+  if ((dd->rma && dd->rma->l) || inprogress) SETERRQ(PetscObjectComm((PetscObject)da),PETSC_ERR_ARG_WRONGSTATE,"Cannot change the ghost update type during an update");
+  ierr = DMDAGhostRMADestroy(&dd->rma);CHKERRQ(ierr);
+  ierr = DMDAGhostHaloDestroy(&dd->halo);CHKERRQ(ierr);
+  dd->ghostupdate = type;
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMDAGetGhostUpdateType - Gets how the ghost points of local vectors are updated by DMGlobalToLocalBegin()/DMGlobalToLocalEnd()
+
+  Not Collective
+
+  Input Parameter:
+. da   - The DMDA
+
+  Output Parameter:
+. type - The ghost update type
+
+  Level: advanced
+
+.seealso: DMDASetGhostUpdateType(), DMDAGhostUpdateType
+@*/
+PetscErrorCode DMDAGetGhostUpdateType(DM da,DMDAGhostUpdateType *type)
+{
+  DM_DA *dd = (DM_DA*)da->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecificType(da,DM_CLASSID,1,DMDA);
+  PetscValidPointer(type,2);
+  *type = dd->ghostupdate;
+  PetscFunctionReturn(0);
+}
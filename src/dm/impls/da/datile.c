@@ -0,0 +1,325 @@
+/*
+  Cache blocked traversal of the locally owned part of a DMDA, and a matrix-free stencil application built on it
+*/
+
+#include <petsc/private/dmdaimpl.h>    /*I   "petscdmda.h"   I*/
+
+/*@
+   DMDASetTileSize - Sets the size of the tiles used by DMDATileIteratorBegin() and DMDAStencilApply()
+
+   Logically Collective on da
+
+   Input Parameters:
++  da - the DMDA
+.  tx - number of points of a tile in the x direction, or 0 for the default (the whole owned range in 2d and 3d, 1024 in 1d)
+.  ty - number of points of a tile in the y direction, or 0 for the default (16)
+-  tz - number of points of a tile in the z direction, or 0 for the default (16)
+
+   Options Database Key:
+.  -da_tile_size <tx,ty,tz> - the tile size
+
+   Notes:
+   The tiles should fit in the cache together with the ghost points their stencils reach. Long tiles in the x
+   direction, along which the values are contiguous, are usually best.
+
+   Level: intermediate
+
+.seealso: DMDAGetTileSize(), DMDATileIteratorBegin(), DMDAStencilApply()
+@*/
+PetscErrorCode DMDASetTileSize(DM da,PetscInt tx,PetscInt ty,PetscInt tz)
+{
+  DM_DA *dd = (DM_DA*)da->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecificType(da,DM_CLASSID,1,DMDA);
+  PetscValidLogicalCollectiveInt(da,tx,2);
+  PetscValidLogicalCollectiveInt(da,ty,3);
+  PetscValidLogicalCollectiveInt(da,tz,4);
+  if (tx < 0 || ty < 0 || tz < 0) SETERRQ3(PetscObjectComm((PetscObject)da),PETSC_ERR_ARG_OUTOFRANGE,"Tile size %D %D %D cannot be negative",tx,ty,tz);
+  dd->tilesize[0] = tx;
+  dd->tilesize[1] = ty;
+  dd->tilesize[2] = tz;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   DMDAGetTileSize - Gets the size of the tiles used by DMDATileIteratorBegin() and DMDAStencilApply()
+
+   Not Collective
+
+   Input Parameter:
+.  da - the DMDA
+
+   Output Parameters:
++  tx - number of points of a tile in the x direction, 0 for the default
+.  ty - number of points of a tile in the y direction, 0 for the default
+-  tz - number of points of a tile in the z direction, 0 for the default
+
+   Level: intermediate
+
+.seealso: DMDASetTileSize()
+@*/
+PetscErrorCode DMDAGetTileSize(DM da,PetscInt *tx,PetscInt *ty,PetscInt *tz)
+{
+  DM_DA *dd = (DM_DA*)da->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecificType(da,DM_CLASSID,1,DMDA);
+  if (tx) *tx = dd->tilesize[0];
+  if (ty) *ty = dd->tilesize[1];
+  if (tz) *tz = dd->tilesize[2];
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   DMDATileIteratorBegin - Starts an iteration over tiles of the locally owned part of a DMDA
+
+   Not Collective
+
+   Input Parameters:
++  da     - the DMDA
+-  nsteps - 1 for a plain iteration over the tiles, or the number of time steps of a wavefront temporal blocking
+
+   Output Parameter:
+.  it - the iterator, to be passed to DMDATileIteratorNext()
+
+   Notes:
+   With nsteps = 1 the tiles cover the locally owned part of the DMDA once, the x direction varying fastest.
+
+   With nsteps > 1, the iteration performs nsteps time steps of an explicit stencil kernel, each step reading the
+   values of the previous one, alternately stored in two local vectors, with a single ghost point update before the
+   first step. The stencil width of the DMDA must be at least nsteps times the radius r of the kernel, which is taken
+   as the stencil width divided by nsteps. Step s then covers the owned part extended by (nsteps-1-s)*r points into
+   the ghost points of the neighbors (the same values being computed redundantly by neighbors), so that the last step
+   computes the owned part. This needs the ghost points in the corners, so a DMDA_STENCIL_BOX DMDA. The steps proceed
+   as a wavefront along the last dimension: the tiles of all the steps in a layer of tiles are computed before moving
+   to the next layer, each step lagging r points behind the previous one, so that the values of the few layers in
+   flight stay in the cache. A tile of step s may only read the values of step s-1 (the local vector of step 0 for
+   the first step) within r points of it, and write the values of step s in the other local vector.
+
+.vb
+   DMDATileIterator it;
+   DMDALocalInfo    tile;
+   PetscInt         step;
+   PetscBool        more;
+
+   DMDATileIteratorBegin(da,nsteps,&it);
+   while (1) {
+     DMDATileIteratorNext(&it,&tile,&step,&more);
+     if (!more) break;
+     for (k=tile.zs; k<tile.zs+tile.zm; k++) for (j=tile.ys; j<tile.ys+tile.ym; j++) for (i=tile.xs; i<tile.xs+tile.xm; i++) {
+       ...
+     }
+   }
+.ve
+
+   The DMDATileIterator does not hold any resource, so the iteration can be stopped at any time.
+
+   Level: intermediate
+
+.seealso: DMDATileIteratorNext(), DMDASetTileSize(), DMDAGetLocalInfo(), DMDAStencilApply()
+@*/
+PetscErrorCode DMDATileIteratorBegin(DM da,PetscInt nsteps,DMDATileIterator *it)
+{
+  PetscErrorCode ierr;
+  DM_DA          *dd = (DM_DA*)da->data;
+  DMDALocalInfo  *info = &it->info;
+  PetscInt       d,D,lo[3],hi[3],m[3];
+  DMBoundaryType bd[3];
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecificType(da,DM_CLASSID,1,DMDA);
+  PetscValidPointer(it,3);
+  if (nsteps < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of time steps %D must be positive",nsteps);
+  if (nsteps > 1 && da->dim > 1 && dd->stencil_type == DMDA_STENCIL_STAR) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Temporal blocking needs the corner ghost points of DMDA_STENCIL_BOX");
+  if (nsteps > 1 && dd->s < nsteps) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Stencil width %D must be at least the number of time steps %D",dd->s,nsteps);
+  ierr = DMDAGetLocalInfo(da,info);CHKERRQ(ierr);
+  it->nsteps = nsteps;
+  it->r      = dd->s/nsteps;
+  it->ts[0]  = dd->tilesize[0] ? dd->tilesize[0] : (info->dim == 1 ? 1024 : info->xm);
+  it->ts[1]  = dd->tilesize[1] ? dd->tilesize[1] : 16;
+  it->ts[2]  = dd->tilesize[2] ? dd->tilesize[2] : 16;
+  lo[0] = info->xs; hi[0] = info->xs+info->xm; m[0] = info->mx; bd[0] = info->bx;
+  lo[1] = info->ys; hi[1] = info->ys+info->ym; m[1] = info->my; bd[1] = info->by;
+  lo[2] = info->zs; hi[2] = info->zs+info->zm; m[2] = info->mz; bd[2] = info->bz;
+  for (d=0; d<3; d++) {
+    if (d >= info->dim) it->ts[d] = 1;
+    it->ts[d] = PetscMax(it->ts[d],1);
+    /* the ghost points hold values of neighbors, not physical boundary values, on the sides with neighbors */
+    it->ext[0][d] = (d < info->dim && nsteps > 1 && (lo[d] > 0 || bd[d] == DM_BOUNDARY_PERIODIC)) ? 1 : 0;
+    it->ext[1][d] = (d < info->dim && nsteps > 1 && (hi[d] < m[d] || bd[d] == DM_BOUNDARY_PERIODIC)) ? 1 : 0;
+  }
+  /* The layers of tiles along the last dimension, from the start of the first step to the end of the last one */
+  D = info->dim-1;
+  {
+    PetscInt start = lo[D]-it->ext[0][D]*(nsteps-1)*it->r,end = hi[D],lag = (nsteps-1)*it->r;
+
+    it->nfronts = (end-start+lag+it->ts[D]-1)/it->ts[D];
+  }
+  it->front = 0;
+  it->step  = 0;
+  it->tile  = 0;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   DMDATileIteratorNext - Gets the next tile of an iteration started with DMDATileIteratorBegin()
+
+   Not Collective
+
+   Input Parameter:
+.  it - the iterator
+
+   Output Parameters:
++  tile - the tile, a DMDALocalInfo whose xs, xm, ys, ym, zs and zm describe the tile (the other fields are those of the subdomain)
+.  step - the time step of the tile, 0 <= step < nsteps, pass NULL if not needed
+-  more - PETSC_FALSE when the iteration is over, tile and step then being unset
+
+   Level: intermediate
+
+.seealso: DMDATileIteratorBegin()
+@*/
+PetscErrorCode DMDATileIteratorNext(DMDATileIterator *it,DMDALocalInfo *tile,PetscInt *step,PetscBool *more)
+{
+  const DMDALocalInfo *info = &it->info;
+  PetscInt            D = info->dim-1,d,lo[3],hi[3],s[3],e[3],nt[3],t,ext;
+
+  PetscFunctionBegin;
+  PetscValidPointer(tile,2);
+  PetscValidPointer(more,4);
+  lo[0] = info->xs; hi[0] = info->xs+info->xm;
+  lo[1] = info->ys; hi[1] = info->ys+info->ym;
+  lo[2] = info->zs; hi[2] = info->zs+info->zm;
+  while (it->front < it->nfronts) {
+    /* The range of the current step, then the part of its range in the current layer along the last dimension */
+    ext = (it->nsteps-1-it->step)*it->r;
+    for (d=0; d<3; d++) {
+      s[d] = lo[d]-it->ext[0][d]*ext;
+      e[d] = hi[d]+it->ext[1][d]*ext;
+    }
+    {
+      PetscInt start = lo[D]-it->ext[0][D]*(it->nsteps-1)*it->r+it->front*it->ts[D]-it->step*it->r;
+
+      s[D] = PetscMax(s[D],start);
+      e[D] = PetscMin(e[D],start+it->ts[D]);
+    }
+    for (t=1,d=0; d<3; d++) {
+      nt[d] = d == D ? 1 : (e[d]-s[d]+it->ts[d]-1)/it->ts[d];
+      t    *= nt[d];
+    }
+    if (e[D] <= s[D] || it->tile >= t) {
+      it->tile = 0;
+      if (++it->step == it->nsteps) {it->step = 0; it->front++;}
+      continue;
+    }
+    *tile = *info;
+    t     = it->tile++;
+    for (d=0; d<3; d++) {
+      if (d != D) {
+        s[d] = s[d]+(t % nt[d])*it->ts[d];
+        e[d] = PetscMin(e[d],s[d]+it->ts[d]);
+        t   /= nt[d];
+      }
+    }
+    tile->xs = s[0]; tile->xm = e[0]-s[0];
+    tile->ys = s[1]; tile->ym = e[1]-s[1];
+    tile->zs = s[2]; tile->zm = e[2]-s[2];
+    if (step) *step = it->step;
+    *more = PETSC_TRUE;
+    PetscFunctionReturn(0);
+  }
+  *more = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   DMDAStencilApply - Applies a constant coefficient stencil to a vector of a DMDA, without assembling a matrix
+
+   Collective on da
+
+   Input Parameters:
++  da   - the DMDA
+.  coef - the (2*s+1)^dim coefficients of the stencil, s being the stencil width, the x offset varying fastest
+-  x    - the global vector the stencil is applied to
+
+   Output Parameter:
+.  y - the global vector y_i = sum_o coef[o] x_{i+o}, for all the offsets o of the stencil
+
+   Notes:
+   The coefficient of the offset (ox,oy,oz) is coef[((oz+s)*(2*s+1)+oy+s)*(2*s+1)+ox+s]. With DMDA_STENCIL_STAR only
+   the coefficients of the offsets along the axes are used. The same stencil is applied to each of the dof, which are
+   not coupled. Terms reaching beyond the ghost points (at nonperiodic DM_BOUNDARY_NONE boundaries) are dropped, and
+   those reaching ghost points at DM_BOUNDARY_GHOSTED boundaries use the values the local vector holds there, that is 0.
+
+   The stencil is applied tile by tile with DMDATileIterator, each row of a tile being updated for one offset at a
+   time with contiguous accesses.
+
+   Level: intermediate
+
+.seealso: DMDATileIteratorBegin(), DMDASetTileSize(), MatCreateShell()
+@*/
+PetscErrorCode DMDAStencilApply(DM da,const PetscScalar coef[],Vec x,Vec y)
+{
+  PetscErrorCode    ierr;
+  DM_DA             *dd = (DM_DA*)da->data;
+  DMDALocalInfo     tile,*info;
+  DMDATileIterator  it;
+  Vec               xloc;
+  const PetscScalar *xa,*c;
+  PetscScalar       *ya,*cs;
+  PetscInt          dim = da->dim,w = dd->s,n = 2*dd->s+1,no = 0,ncoef = 1,o,d,i,j,k,*off;
+  PetscBool         more;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecificType(da,DM_CLASSID,1,DMDA);
+  PetscValidScalarPointer(coef,2);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,3);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,4);
+  for (d=0; d<dim; d++) ncoef *= n;
+
+  /* The nonzero coefficients and their offsets */
+  ierr = PetscMalloc2(3*ncoef,&off,ncoef,&cs);CHKERRQ(ierr);
+  for (o=0; o<ncoef; o++) {
+    PetscInt ox = o%n-w,oy = dim > 1 ? (o/n)%n-w : 0,oz = dim > 2 ? o/(n*n)-w : 0;
+
+    if (coef[o] == (PetscScalar)0.0) continue;
+    if (dd->stencil_type == DMDA_STENCIL_STAR && ((ox != 0) + (oy != 0) + (oz != 0)) > 1) continue;
+    off[3*no] = ox; off[3*no+1] = oy; off[3*no+2] = oz;
+    cs[no++]  = coef[o];
+  }
+
+  ierr = DMGetLocalVector(da,&xloc);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(da,x,INSERT_VALUES,xloc);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(da,x,INSERT_VALUES,xloc);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xloc,&xa);CHKERRQ(ierr);
+  ierr = VecGetArray(y,&ya);CHKERRQ(ierr);
+  ierr = DMDATileIteratorBegin(da,1,&it);CHKERRQ(ierr);
+  info = &it.info;
+  while (1) {
+    ierr = DMDATileIteratorNext(&it,&tile,NULL,&more);CHKERRQ(ierr);
+    if (!more) break;
+    for (k=tile.zs; k<tile.zs+tile.zm; k++) {
+      for (j=tile.ys; j<tile.ys+tile.ym; j++) {
+        PetscScalar *yrow = ya+(((k-info->zs)*info->ym+j-info->ys)*info->xm-info->xs)*info->dof;
+
+        for (i=tile.xs*info->dof; i<(tile.xs+tile.xm)*info->dof; i++) yrow[i] = 0.0;
+        for (o=0; o<no; o++) {
+          PetscInt kk = k+off[3*o+2],jj = j+off[3*o+1],is,ie;
+
+          if (kk < info->gzs || kk >= info->gzs+info->gzm || jj < info->gys || jj >= info->gys+info->gym) continue;
+          /* the points of the tile whose neighbor at this offset is in the local array */
+          is = PetscMax(tile.xs,info->gxs-off[3*o]);
+          ie = PetscMin(tile.xs+tile.xm,info->gxs+info->gxm-off[3*o]);
+          c  = xa+(((kk-info->gzs)*info->gym+jj-info->gys)*info->gxm+off[3*o]-info->gxs)*info->dof;
+          for (i=is*info->dof; i<ie*info->dof; i++) yrow[i] += cs[o]*c[i];
+        }
+      }
+    }
+  }
+  ierr = PetscLogFlops(2.0*no*info->xm*info->ym*info->zm*info->dof);CHKERRQ(ierr);
+  ierr = VecRestoreArray(y,&ya);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xloc,&xa);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(da,&xloc);CHKERRQ(ierr);
+  ierr = PetscFree2(off,cs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
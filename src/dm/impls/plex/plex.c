@@ -8,7 +8,7 @@
 #include <petscdmfield.h>
 
 /* Logging support */
-PetscLogEvent DMPLEX_Interpolate, DMPLEX_Partition, DMPLEX_Distribute, DMPLEX_DistributeCones, DMPLEX_DistributeLabels, DMPLEX_DistributeSF, DMPLEX_DistributeOverlap, DMPLEX_DistributeField, DMPLEX_DistributeData, DMPLEX_Migrate, DMPLEX_InterpolateSF, DMPLEX_GlobalToNaturalBegin, DMPLEX_GlobalToNaturalEnd, DMPLEX_NaturalToGlobalBegin, DMPLEX_NaturalToGlobalEnd, DMPLEX_Stratify, DMPLEX_Symmetrize, DMPLEX_Preallocate, DMPLEX_ResidualFEM, DMPLEX_JacobianFEM, DMPLEX_InterpolatorFEM, DMPLEX_InjectorFEM, DMPLEX_IntegralFEM, DMPLEX_CreateGmsh, DMPLEX_RebalanceSharedPoints, DMPLEX_PartSelf, DMPLEX_PartLabelInvert, DMPLEX_PartLabelCreateSF, DMPLEX_PartStratSF, DMPLEX_CreatePointSF,DMPLEX_LocatePoints;
+PetscLogEvent DMPLEX_Interpolate, DMPLEX_Partition, DMPLEX_Distribute, DMPLEX_DistributeCones, DMPLEX_DistributeLabels, DMPLEX_DistributeSF, DMPLEX_DistributeOverlap, DMPLEX_DistributeField, DMPLEX_DistributeData, DMPLEX_Migrate, DMPLEX_InterpolateSF, DMPLEX_GlobalToNaturalBegin, DMPLEX_GlobalToNaturalEnd, DMPLEX_NaturalToGlobalBegin, DMPLEX_NaturalToGlobalEnd, DMPLEX_Stratify, DMPLEX_Symmetrize, DMPLEX_Preallocate, DMPLEX_ResidualFEM, DMPLEX_JacobianFEM, DMPLEX_InterpolatorFEM, DMPLEX_InjectorFEM, DMPLEX_IntegralFEM, DMPLEX_CreateGmsh, DMPLEX_RebalanceSharedPoints, DMPLEX_RebalanceMesh, DMPLEX_PartSelf, DMPLEX_PartLabelInvert, DMPLEX_PartLabelCreateSF, DMPLEX_PartStratSF, DMPLEX_CreatePointSF,DMPLEX_LocatePoints;
 
 PETSC_EXTERN PetscErrorCode VecView_MPI(Vec, PetscViewer);
 
@@ -1508,6 +1508,12 @@ PetscErrorCode DMCreateMatrix_Plex(DM dm, Mat *J)
     ierr = PetscCalloc4(localSize/bs, &dnz, localSize/bs, &onz, localSize/bs, &dnzu, localSize/bs, &onzu);CHKERRQ(ierr);
     ierr = DMPlexPreallocateOperator(dm, bs, dnz, onz, dnzu, onzu, *J, fillMatrix);CHKERRQ(ierr);
     ierr = PetscFree4(dnz, onz, dnzu, onzu);CHKERRQ(ierr);
+  } else {
+    PetscBool supported;
+
+    /* Apply the Jacobian of the PetscDS without assembly when the discretization allows it, otherwise the user sets the operations */
+    ierr = DMPlexSetUpMatrixFree_Internal(dm, *J, &supported);CHKERRQ(ierr);
+    if (!supported) {ierr = PetscInfo(dm, "Matrix-free application needs a single scalar Lagrange field on tensor product cells, returning an empty MATSHELL\n");CHKERRQ(ierr);}
   }
   ierr = MatSetDM(*J, dm);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -1600,6 +1606,8 @@ PetscErrorCode DMPlexSetChart(DM dm, PetscInt pStart, PetscInt pEnd)
   PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
   ierr = PetscSectionSetChart(mesh->coneSection, pStart, pEnd);CHKERRQ(ierr);
   ierr = PetscSectionSetChart(mesh->supportSection, pStart, pEnd);CHKERRQ(ierr);
+  mesh->numConeRuns = 0;
+  ierr = DMPlexDestroyClosureDofCache(dm);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1622,11 +1630,13 @@ PetscErrorCode DMPlexSetChart(DM dm, PetscInt pStart, PetscInt pEnd)
 PetscErrorCode DMPlexGetConeSize(DM dm, PetscInt p, PetscInt *size)
 {
   DM_Plex       *mesh = (DM_Plex*) dm->data;
+  PetscInt       off;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
   PetscValidPointer(size, 3);
+  if (DMPlexGetConeRun_Private(mesh, p, size, &off)) PetscFunctionReturn(0);
   ierr = PetscSectionGetDof(mesh->coneSection, p, size);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1660,6 +1670,7 @@ PetscErrorCode DMPlexSetConeSize(DM dm, PetscInt p, PetscInt size)
   ierr = PetscSectionSetDof(mesh->coneSection, p, size);CHKERRQ(ierr);
 
   mesh->maxConeSize = PetscMax(mesh->maxConeSize, size);
+  mesh->numConeRuns = 0;
   PetscFunctionReturn(0);
 }
 
@@ -1694,6 +1705,7 @@ PetscErrorCode DMPlexAddConeSize(DM dm, PetscInt p, PetscInt size)
   ierr = PetscSectionGetDof(mesh->coneSection, p, &csize);CHKERRQ(ierr);
 
   mesh->maxConeSize = PetscMax(mesh->maxConeSize, csize);
+  mesh->numConeRuns = 0;
   PetscFunctionReturn(0);
 }
 
@@ -1722,13 +1734,13 @@ PetscErrorCode DMPlexAddConeSize(DM dm, PetscInt p, PetscInt size)
 PetscErrorCode DMPlexGetCone(DM dm, PetscInt p, const PetscInt *cone[])
 {
   DM_Plex       *mesh = (DM_Plex*) dm->data;
-  PetscInt       off;
+  PetscInt       size, off;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
   PetscValidPointer(cone, 3);
-  ierr  = PetscSectionGetOffset(mesh->coneSection, p, &off);CHKERRQ(ierr);
+  if (!DMPlexGetConeRun_Private(mesh, p, &size, &off)) {ierr = PetscSectionGetOffset(mesh->coneSection, p, &off);CHKERRQ(ierr);}
   *cone = &mesh->cones[off];
   PetscFunctionReturn(0);
 }
@@ -2011,7 +2023,7 @@ PetscErrorCode DMPlexSetCone(DM dm, PetscInt p, const PetscInt cone[])
 PetscErrorCode DMPlexGetConeOrientation(DM dm, PetscInt p, const PetscInt *coneOrientation[])
 {
   DM_Plex       *mesh = (DM_Plex*) dm->data;
-  PetscInt       off;
+  PetscInt       size, off;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -2021,7 +2033,7 @@ PetscErrorCode DMPlexGetConeOrientation(DM dm, PetscInt p, const PetscInt *coneO
     ierr = PetscSectionGetDof(mesh->coneSection, p, &dof);CHKERRQ(ierr);
     if (dof) PetscValidPointer(coneOrientation, 3);
   }
-  ierr = PetscSectionGetOffset(mesh->coneSection, p, &off);CHKERRQ(ierr);
+  if (!DMPlexGetConeRun_Private(mesh, p, &size, &off)) {ierr = PetscSectionGetOffset(mesh->coneSection, p, &off);CHKERRQ(ierr);}
 
   *coneOrientation = &mesh->coneOrientations[off];
   PetscFunctionReturn(0);
@@ -2310,6 +2322,22 @@ PetscErrorCode DMPlexInsertSupport(DM dm, PetscInt p, PetscInt supportPos, Petsc
   PetscFunctionReturn(0);
 }
 
+/* The cone and cone orientations of p, found through the fixed-width cone runs when they cover p */
+PETSC_STATIC_INLINE PetscErrorCode DMPlexGetOrientedCone_Private(DM_Plex *mesh, PetscInt p, PetscInt *size, const PetscInt *cone[], const PetscInt *ornt[])
+{
+  PetscInt       off;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!DMPlexGetConeRun_Private(mesh, p, size, &off)) {
+    ierr = PetscSectionGetDof(mesh->coneSection, p, size);CHKERRQ(ierr);
+    ierr = PetscSectionGetOffset(mesh->coneSection, p, &off);CHKERRQ(ierr);
+  }
+  *cone = &mesh->cones[off];
+  *ornt = &mesh->coneOrientations[off];
+  PetscFunctionReturn(0);
+}
+
 /*@C
   DMPlexGetTransitiveClosure - Return the points on the transitive closure of the in-edges or out-edges for this point in the DAG
 
@@ -2353,9 +2381,7 @@ PetscErrorCode DMPlexGetTransitiveClosure(DM dm, PetscInt p, PetscBool useCone,
   ierr    = DMPlexGetDepth(dm, &depth);CHKERRQ(ierr);
   /* This is only 1-level */
   if (useCone) {
-    ierr = DMPlexGetConeSize(dm, p, &tmpSize);CHKERRQ(ierr);
-    ierr = DMPlexGetCone(dm, p, &tmp);CHKERRQ(ierr);
-    ierr = DMPlexGetConeOrientation(dm, p, &tmpO);CHKERRQ(ierr);
+    ierr = DMPlexGetOrientedCone_Private(mesh, p, &tmpSize, &tmp, &tmpO);CHKERRQ(ierr);
   } else {
     ierr = DMPlexGetSupportSize(dm, p, &tmpSize);CHKERRQ(ierr);
     ierr = DMPlexGetSupport(dm, p, &tmp);CHKERRQ(ierr);
@@ -2409,9 +2435,7 @@ PetscErrorCode DMPlexGetTransitiveClosure(DM dm, PetscInt p, PetscBool useCone,
     const PetscInt off = rev ? -(o+1) : o;
 
     if (useCone) {
-      ierr = DMPlexGetConeSize(dm, q, &tmpSize);CHKERRQ(ierr);
-      ierr = DMPlexGetCone(dm, q, &tmp);CHKERRQ(ierr);
-      ierr = DMPlexGetConeOrientation(dm, q, &tmpO);CHKERRQ(ierr);
+      ierr = DMPlexGetOrientedCone_Private(mesh, q, &tmpSize, &tmp, &tmpO);CHKERRQ(ierr);
     } else {
       ierr = DMPlexGetSupportSize(dm, q, &tmpSize);CHKERRQ(ierr);
       ierr = DMPlexGetSupport(dm, q, &tmp);CHKERRQ(ierr);
@@ -2497,9 +2521,7 @@ PetscErrorCode DMPlexGetTransitiveClosure_Internal(DM dm, PetscInt p, PetscInt o
   ierr    = DMPlexGetDepth(dm, &depth);CHKERRQ(ierr);
   /* This is only 1-level */
   if (useCone) {
-    ierr = DMPlexGetConeSize(dm, p, &tmpSize);CHKERRQ(ierr);
-    ierr = DMPlexGetCone(dm, p, &tmp);CHKERRQ(ierr);
-    ierr = DMPlexGetConeOrientation(dm, p, &tmpO);CHKERRQ(ierr);
+    ierr = DMPlexGetOrientedCone_Private(mesh, p, &tmpSize, &tmp, &tmpO);CHKERRQ(ierr);
   } else {
     ierr = DMPlexGetSupportSize(dm, p, &tmpSize);CHKERRQ(ierr);
     ierr = DMPlexGetSupport(dm, p, &tmp);CHKERRQ(ierr);
@@ -2561,9 +2583,7 @@ PetscErrorCode DMPlexGetTransitiveClosure_Internal(DM dm, PetscInt p, PetscInt o
     const PetscInt off = rev ? -(o+1) : o;
 
     if (useCone) {
-      ierr = DMPlexGetConeSize(dm, q, &tmpSize);CHKERRQ(ierr);
-      ierr = DMPlexGetCone(dm, q, &tmp);CHKERRQ(ierr);
-      ierr = DMPlexGetConeOrientation(dm, q, &tmpO);CHKERRQ(ierr);
+      ierr = DMPlexGetOrientedCone_Private(mesh, q, &tmpSize, &tmp, &tmpO);CHKERRQ(ierr);
     } else {
       ierr = DMPlexGetSupportSize(dm, q, &tmpSize);CHKERRQ(ierr);
       ierr = DMPlexGetSupport(dm, q, &tmp);CHKERRQ(ierr);
@@ -2678,6 +2698,8 @@ PetscErrorCode DMSetUp_Plex(DM dm)
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  mesh->numConeRuns = 0;
+  ierr = DMPlexDestroyClosureDofCache(dm);CHKERRQ(ierr);
   ierr = PetscSectionSetUp(mesh->coneSection);CHKERRQ(ierr);
   ierr = PetscSectionGetStorageSize(mesh->coneSection, &size);CHKERRQ(ierr);
   ierr = PetscMalloc1(size, &mesh->cones);CHKERRQ(ierr);
@@ -2973,10 +2995,44 @@ PetscErrorCode DMPlexStratify(DM dm)
     }
   }
   ierr = PetscObjectStateGet((PetscObject) label, &mesh->depthState);CHKERRQ(ierr);
+  ierr = DMPlexSetUpConeRuns_Internal(dm);CHKERRQ(ierr);
   ierr = PetscLogEventEnd(DMPLEX_Stratify,dm,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
+/*
+  DMPlexSetUpConeRuns_Internal - Split the chart into runs of consecutive points with the same cone size and contiguous
+  cones. When the cell types are uniform in each stratum, as for a mesh of only tetrahedra or only hexahedra, there is
+  one run per stratum, and cone queries then compute the cone offset from the point number instead of reading it from
+  the cone section. Meshes needing more than DMPLEX_MAX_CONE_RUNS runs keep using the section.
+*/
+PetscErrorCode DMPlexSetUpConeRuns_Internal(DM dm)
+{
+  DM_Plex       *mesh = (DM_Plex*) dm->data;
+  DMPlexConeRun *runs = mesh->coneRuns;
+  PetscInt       pStart, pEnd, p, n = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  mesh->numConeRuns = 0;
+  ierr = PetscSectionGetChart(mesh->coneSection, &pStart, &pEnd);CHKERRQ(ierr);
+  for (p = pStart; p < pEnd; ++p) {
+    PetscInt dof, off;
+
+    ierr = PetscSectionGetDof(mesh->coneSection, p, &dof);CHKERRQ(ierr);
+    ierr = PetscSectionGetOffset(mesh->coneSection, p, &off);CHKERRQ(ierr);
+    if (n && dof == runs[n-1].size && off == runs[n-1].offset + (p - runs[n-1].pStart)*dof) {runs[n-1].pEnd = p+1; continue;}
+    if (n == DMPLEX_MAX_CONE_RUNS) PetscFunctionReturn(0);
+    runs[n].pStart = p;
+    runs[n].pEnd   = p+1;
+    runs[n].size   = dof;
+    runs[n].offset = off;
+    ++n;
+  }
+  mesh->numConeRuns = n;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode DMPlexComputeCellType_Internal(DM dm, PetscInt p, PetscInt pdepth, DMPolytopeType *pt)
 {
   DMPolytopeType ct = DM_POLYTOPE_UNKNOWN;
@@ -4816,10 +4872,11 @@ $  PetscFree(values);
 
   Level: intermediate
 
-.seealso DMPlexVecRestoreClosure(), DMPlexVecSetClosure(), DMPlexMatSetClosure()
+.seealso: DMPlexVecRestoreClosure(), DMPlexVecSetClosure(), DMPlexMatSetClosure(), DMPlexCreateClosureDofCache()
 @*/
 PetscErrorCode DMPlexVecGetClosure(DM dm, PetscSection section, Vec v, PetscInt point, PetscInt *csize, PetscScalar *values[])
 {
+  DMPlexClosureDofCache *cache;
   PetscSection       clSection;
   IS                 clPoints;
   PetscInt          *points = NULL;
@@ -4832,6 +4889,22 @@ PetscErrorCode DMPlexVecGetClosure(DM dm, PetscSection section, Vec v, PetscInt
   if (!section) {ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);}
   PetscValidHeaderSpecific(section, PETSC_SECTION_CLASSID, 2);
   PetscValidHeaderSpecific(v, VEC_CLASSID, 3);
+  cache = DMPlexGetClosureDofCache_Private(dm, section);
+  if (cache && point >= cache->pStart && point < cache->pEnd) {
+    asize = cache->offsets[point-cache->pStart+1] - cache->offsets[point-cache->pStart];
+    if (values) {
+      const PetscScalar *vArray;
+
+      if (*values) {
+        if (PetscUnlikely(*csize < asize)) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Provided array size %D not sufficient to hold closure size %D", *csize, asize);
+      } else {ierr = DMGetWorkArray(dm, asize, MPIU_SCALAR, values);CHKERRQ(ierr);}
+      ierr = VecGetArrayRead(v, &vArray);CHKERRQ(ierr);
+      ierr = DMPlexClosureDofCacheGather_Internal(cache, point, point+1, vArray, *values);CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(v, &vArray);CHKERRQ(ierr);
+    }
+    if (csize) *csize = asize;
+    PetscFunctionReturn(0);
+  }
   ierr = DMPlexGetDepth(dm, &depth);CHKERRQ(ierr);
   ierr = PetscSectionGetNumFields(section, &numFields);CHKERRQ(ierr);
   if (depth == 1 && numFields < 2) {
@@ -5313,6 +5386,7 @@ PETSC_STATIC_INLINE PetscErrorCode DMPlexVecSetClosure_Depth1_Static(DM dm, Pets
 @*/
 PetscErrorCode DMPlexVecSetClosure(DM dm, PetscSection section, Vec v, PetscInt point, const PetscScalar values[], InsertMode mode)
 {
+  DMPlexClosureDofCache *cache;
   PetscSection    clSection;
   IS              clPoints;
   PetscScalar    *array;
@@ -5326,6 +5400,13 @@ PetscErrorCode DMPlexVecSetClosure(DM dm, PetscSection section, Vec v, PetscInt
   if (!section) {ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);}
   PetscValidHeaderSpecific(section, PETSC_SECTION_CLASSID, 2);
   PetscValidHeaderSpecific(v, VEC_CLASSID, 3);
+  cache = DMPlexGetClosureDofCache_Private(dm, section);
+  if (cache && point >= cache->pStart && point < cache->pEnd) {
+    ierr = VecGetArray(v, &array);CHKERRQ(ierr);
+    ierr = DMPlexClosureDofCacheScatter_Internal(cache, point, point+1, values, mode, array);CHKERRQ(ierr);
+    ierr = VecRestoreArray(v, &array);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = DMPlexGetDepth(dm, &depth);CHKERRQ(ierr);
   ierr = PetscSectionGetNumFields(section, &numFields);CHKERRQ(ierr);
   if (depth == 1 && numFields < 2 && mode == ADD_VALUES) {
@@ -6595,6 +6676,18 @@ PetscErrorCode DMPlexMatSetClosure(DM dm, PetscSection section, PetscSection glo
   if (!globalSection) {ierr = DMGetGlobalSection(dm, &globalSection);CHKERRQ(ierr);}
   PetscValidHeaderSpecific(globalSection, PETSC_SECTION_CLASSID, 3);
   PetscValidHeaderSpecific(A, MAT_CLASSID, 4);
+  /* Without sign flips the cached global indices are used as they are */
+  if (!mesh->printSetValues && mesh->printFEM < 2) {
+    const DMPlexClosureDofCache *cache = DMPlexGetClosureDofCache_Private(dm, section);
+
+    if (cache && !cache->flips && cache->globalSection == globalSection && point >= cache->pStart && point < cache->pEnd) {
+      const PetscInt start = cache->offsets[point-cache->pStart];
+
+      numIndices = cache->offsets[point-cache->pStart+1] - start;
+      ierr = MatSetValues(A, numIndices, &cache->gidx[start], numIndices, &cache->gidx[start], values, mode);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+  }
 
   ierr = DMPlexGetClosureIndices(dm, section, globalSection, point, PETSC_TRUE, &numIndices, &indices, NULL, (PetscScalar **) &values);CHKERRQ(ierr);
 
@@ -8104,7 +8197,7 @@ PetscErrorCode DMCreateInterpolation_Plex(DM dmCoarse, DM dmFine, Mat *interpola
   PetscInt       m, n;
   void          *ctx;
   DM             cdm;
-  PetscBool      regular, ismatis, isRefined = dmCoarse->data == dmFine->data ? PETSC_FALSE : PETSC_TRUE;
+  PetscBool      regular, ismatis, isshell, isRefined = dmCoarse->data == dmFine->data ? PETSC_FALSE : PETSC_TRUE;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -8114,9 +8207,10 @@ PetscErrorCode DMCreateInterpolation_Plex(DM dmCoarse, DM dmFine, Mat *interpola
   ierr = PetscSectionGetConstrainedStorageSize(gsc, &n);CHKERRQ(ierr);
 
   ierr = PetscStrcmp(dmCoarse->mattype, MATIS, &ismatis);CHKERRQ(ierr);
+  ierr = PetscStrcmp(dmCoarse->mattype, MATSHELL, &isshell);CHKERRQ(ierr);
   ierr = MatCreate(PetscObjectComm((PetscObject) dmCoarse), interpolation);CHKERRQ(ierr);
   ierr = MatSetSizes(*interpolation, m, n, PETSC_DETERMINE, PETSC_DETERMINE);CHKERRQ(ierr);
-  ierr = MatSetType(*interpolation, ismatis ? MATAIJ : dmCoarse->mattype);CHKERRQ(ierr);
+  ierr = MatSetType(*interpolation, ismatis || isshell ? MATAIJ : dmCoarse->mattype);CHKERRQ(ierr);
   ierr = DMGetApplicationContext(dmFine, &ctx);CHKERRQ(ierr);
 
   ierr = DMGetCoarseDM(dmFine, &cdm);CHKERRQ(ierr);
@@ -29,3 +29,77 @@ PetscErrorCode DMCoarsenHierarchy_Plex(DM dm, PetscInt nlevels, DM dmCoarsened[]
   }
   PetscFunctionReturn(0);
 }
+
+/*@
+  DMPlexCreatePCoarseDM - Create a DM on the same mesh whose Lagrange fields have lower polynomial degree, and set it as the coarse DM
+
+  Collective on dm
+
+  Input Parameters:
++ dm     - The DMPlex
+- degree - The polynomial degree of the fields on the coarse DM
+
+  Output Parameter:
+. cdm    - The coarse DM
+
+  Notes:
+  The coarse DM shares the mesh with dm, and copies its equations, constants, and boundary conditions, so that PCMG can
+  build a p-multigrid hierarchy from DMCoarsen(). The interpolation between the levels is computed by
+  DMPlexComputeInterpolatorNested(). If dm uses MATSHELL, DMCoarsen() propagates it, so that the operators on all levels
+  are matrix-free, see DMPlexCreateMatrixFree(). The coarse solver should then only need MatMult() and MatGetDiagonal(),
+  for example -mg_coarse_ksp_type cg -mg_coarse_pc_type jacobi.
+
+  Level: intermediate
+
+.seealso: DMPlexCreateMatrixFree(), DMCoarsen(), DMSetCoarseDM(), PetscFECreateLagrange()
+@*/
+PetscErrorCode DMPlexCreatePCoarseDM(DM dm, PetscInt degree, DM *cdm)
+{
+  PetscDS        ds, cds;
+  PetscInt       dim, Nf, f, cStart, cEnd, coneSize = 0;
+  PetscBool      isSimplex;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(dm, degree, 2);
+  PetscValidPointer(cdm, 3);
+  if (degree < 1) SETERRQ1(PetscObjectComm((PetscObject) dm), PETSC_ERR_ARG_OUTOFRANGE, "Coarse degree %D must be positive", degree);
+  ierr = DMGetDimension(dm, &dim);CHKERRQ(ierr);
+  ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  if (cEnd > cStart) {ierr = DMPlexGetConeSize(dm, cStart, &coneSize);CHKERRQ(ierr);}
+  isSimplex = coneSize == dim+1 ? PETSC_TRUE : PETSC_FALSE;
+  ierr = MPIU_Allreduce(MPI_IN_PLACE, &isSimplex, 1, MPIU_BOOL, MPI_LOR, PetscObjectComm((PetscObject) dm));CHKERRQ(ierr);
+  ierr = DMClone(dm, cdm);CHKERRQ(ierr);
+  ierr = DMGetNumFields(dm, &Nf);CHKERRQ(ierr);
+  for (f = 0; f < Nf; ++f) {
+    PetscObject  obj;
+    PetscClassId id;
+    DMLabel      label;
+
+    ierr = DMGetField(dm, f, &label, &obj);CHKERRQ(ierr);
+    ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+    if (id == PETSCFE_CLASSID) {
+      PetscFE     fe = (PetscFE) obj, cfe;
+      const char *name;
+      PetscInt    Nc;
+
+      ierr = PetscFEGetNumComponents(fe, &Nc);CHKERRQ(ierr);
+      ierr = PetscFECreateLagrange(PetscObjectComm((PetscObject) dm), dim, Nc, isSimplex, degree, PETSC_DETERMINE, &cfe);CHKERRQ(ierr);
+      ierr = PetscObjectGetName(obj, &name);CHKERRQ(ierr);
+      ierr = PetscObjectSetName((PetscObject) cfe, name);CHKERRQ(ierr);
+      ierr = DMSetField(*cdm, f, label, (PetscObject) cfe);CHKERRQ(ierr);
+      ierr = PetscFEDestroy(&cfe);CHKERRQ(ierr);
+    } else {
+      ierr = DMSetField(*cdm, f, label, obj);CHKERRQ(ierr);
+    }
+  }
+  ierr = DMCreateDS(*cdm);CHKERRQ(ierr);
+  ierr = DMGetDS(dm, &ds);CHKERRQ(ierr);
+  ierr = DMGetDS(*cdm, &cds);CHKERRQ(ierr);
+  ierr = PetscDSCopyEquations(ds, cds);CHKERRQ(ierr);
+  ierr = PetscDSCopyConstants(ds, cds);CHKERRQ(ierr);
+  ierr = DMCopyBoundary(dm, *cdm);CHKERRQ(ierr);
+  ierr = DMSetCoarseDM(dm, *cdm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -2392,6 +2392,15 @@ PetscErrorCode DMSetFromOptions_NonRefinement_Plex(PetscOptionItems *PetscOption
   ierr = PetscOptionsBool("-dm_plex_remesh_bd", "Allow changes to the boundary on remeshing", "DMAdapt", PETSC_FALSE, &mesh->remeshBd, NULL);CHKERRQ(ierr);
   /* Projection behavior */
   ierr = PetscOptionsBoundedInt("-dm_plex_max_projection_height", "Maxmimum mesh point height used to project locally", "DMPlexSetMaxProjectionHeight", 0, &mesh->maxProjectionHeight, NULL,0);CHKERRQ(ierr);
+  /* Residual evaluation */
+  {
+    PetscBool cache = mesh->cacheElemMat;
+
+    /* The setter invalidates matrices cached before the flag was turned off */
+    ierr = PetscOptionsBool("-dm_plex_cache_element_matrices", "Cache element matrices of an affine residual", "DMPlexSetCacheElementMatrices", cache, &cache, &flg);CHKERRQ(ierr);
+    if (flg && cache != mesh->cacheElemMat) {ierr = DMPlexSetCacheElementMatrices(dm, cache);CHKERRQ(ierr);}
+  }
+  ierr = PetscOptionsBool("-dm_plex_closure_dof_cache", "Assemble through flattened closure dof indices", "DMPlexCreateClosureDofCache", mesh->useClDofCache, &mesh->useClDofCache, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-dm_plex_regular_refinement", "Use special nested projection algorithm for regular refinement", "DMPlexSetRegularRefinement", mesh->regularRefinement, &mesh->regularRefinement, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnum("-dm_plex_cell_refiner", "Strategy for cell refinment", "ex40.c", DMPlexCellRefinerTypes, (PetscEnum) mesh->cellRefiner, (PetscEnum *) &mesh->cellRefiner, NULL);CHKERRQ(ierr);
   /* Checking structure */
@@ -2419,11 +2428,27 @@ PetscErrorCode DMSetFromOptions_NonRefinement_Plex(PetscOptionItems *PetscOption
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode DMPlexViewOrderingBandwidth_Static(DM dm, const char stage[])
+{
+  PetscInt       depth, lbw[2], gbw[2], lpr[2], gpr[2];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexGetDepth(dm, &depth);CHKERRQ(ierr);
+  ierr = DMPlexComputeStratumBandwidth(dm, depth, &lbw[0], &lpr[0]);CHKERRQ(ierr);
+  ierr = DMPlexComputeStratumBandwidth(dm, 0, &lbw[1], &lpr[1]);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(lbw, gbw, 2, MPIU_INT, MPI_MAX, PetscObjectComm((PetscObject) dm));CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(lpr, gpr, 2, MPIU_INT, MPI_SUM, PetscObjectComm((PetscObject) dm));CHKERRQ(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject) dm), "Local ordering %s: cell bandwidth %D profile %D, vertex bandwidth %D profile %D\n", stage, gbw[0], gpr[0], gbw[1], gpr[1]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode DMSetFromOptions_Plex(PetscOptionItems *PetscOptionsObject,DM dm)
 {
   PetscReal      volume = -1.0;
   PetscInt       prerefine = 0, refine = 0, r, coarsen = 0, overlap = 0;
-  PetscBool      uniformOrig, uniform = PETSC_TRUE, distribute = PETSC_FALSE, isHierarchy, flg;
+  PetscBool      uniformOrig, uniform = PETSC_TRUE, distribute = PETSC_FALSE, reorderView = PETSC_FALSE, isHierarchy, flg;
+  char           ordering[256] = MATORDERINGRCM;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -2467,6 +2492,21 @@ static PetscErrorCode DMSetFromOptions_Plex(PetscOptionItems *PetscOptionsObject
       ierr = DMDestroy(&pdm);CHKERRQ(ierr);
     }
   }
+  /* Handle DMPlex reordering for locality, after distribution but before refinement so that regular refinement stays nested */
+  ierr = PetscOptionsString("-dm_plex_reorder", "Reorder the local mesh points for locality", "DMPlexGetOrdering", ordering, ordering, sizeof(ordering), &flg);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-dm_plex_reorder_view", "View the bandwidth and profile of the local mesh ordering", "DMPlexComputeStratumBandwidth", reorderView, &reorderView, NULL);CHKERRQ(ierr);
+  if (flg) {
+    DM pdm;
+    IS perm;
+
+    if (reorderView) {ierr = DMPlexViewOrderingBandwidth_Static(dm, "before");CHKERRQ(ierr);}
+    ierr = DMPlexGetOrdering(dm, ordering, NULL, &perm);CHKERRQ(ierr);
+    ierr = DMPlexPermute(dm, perm, &pdm);CHKERRQ(ierr);
+    ierr = ISDestroy(&perm);CHKERRQ(ierr);
+    ierr = DMPlexReplace_Static(dm, pdm);CHKERRQ(ierr);
+    ierr = DMDestroy(&pdm);CHKERRQ(ierr);
+    if (reorderView) {ierr = DMPlexViewOrderingBandwidth_Static(dm, "after");CHKERRQ(ierr);}
+  }
   /* Handle DMPlex refinement */
   ierr = PetscOptionsBoundedInt("-dm_refine", "The number of uniform refinements", "DMCreate", refine, &refine, NULL,0);CHKERRQ(ierr);
   ierr = PetscOptionsBoundedInt("-dm_refine_hierarchy", "The number of uniform refinements", "DMCreate", refine, &refine, &isHierarchy,0);CHKERRQ(ierr);
@@ -2698,11 +2738,15 @@ PETSC_INTERN PetscErrorCode DMClone_Plex(DM dm, DM *newdm)
 + -dm_refine_volume_limit_pre        - Cell volume limit after pre-refinement using generator
 . -dm_distribute                     - Distribute mesh across processes
 . -dm_distribute_overlap             - Number of cells to overlap for distribution
+. -dm_plex_reorder <order>           - Reorder the local mesh points after distribution, e.g. rcm, hilbert, or morton
+. -dm_plex_reorder_view              - View the cell and vertex bandwidth and profile before and after reordering
 . -dm_refine                         - Refine mesh after distribution
 . -dm_plex_hash_location             - Use grid hashing for point location
 . -dm_plex_partition_balance         - Attempt to evenly divide points on partition boundary between processes
 . -dm_plex_remesh_bd                 - Allow changes to the boundary on remeshing
 . -dm_plex_max_projection_height     - Maxmimum mesh point height used to project locally
+. -dm_plex_cache_element_matrices    - Cache element matrices of an affine residual
+. -dm_plex_closure_dof_cache         - Assemble residuals and Jacobians through flattened closure dof indices, with OpenMP threads adding the residual cell vectors by color
 . -dm_plex_regular_refinement        - Use special nested projection algorithm for regular refinement
 . -dm_plex_check_all                 - Perform all shecks below
 . -dm_plex_check_symmetry            - Check that the adjacency information in the mesh is symmetric
@@ -2775,6 +2819,9 @@ PETSC_EXTERN PetscErrorCode DMCreate_Plex(DM dm)
   mesh->useAnchors          = PETSC_FALSE;
 
   mesh->maxProjectionHeight = 0;
+  mesh->cacheElemMat        = PETSC_FALSE;
+  mesh->useClDofCache       = PETSC_FALSE;
+  mesh->elemMatState        = 0;
 
   mesh->neighbors           = NULL;
 
@@ -1560,6 +1560,52 @@ PetscErrorCode DMPlexMigrate(DM dm, PetscSF sf, DM targetDM)
   PetscFunctionReturn(0);
 }
 
+/* Add the partition overlap to a non-overlapping migrated mesh, and compose the migration SF so that it maps the original points to the overlapped points */
+static PetscErrorCode DMPlexDistributeOverlapMigration_Static(PetscInt overlap, PetscBool view, DM *dmParallel, PetscSF *sfMigration)
+{
+  MPI_Comm           comm;
+  DM                 dmOverlap;
+  PetscInt           nroots, nleaves, noldleaves, l;
+  const PetscInt    *oldLeaves;
+  PetscSFNode       *newRemote, *permRemote;
+  const PetscSFNode *oldRemote;
+  PetscSF            sfOverlap, sfOverlapPoint;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject) *dmParallel, &comm);CHKERRQ(ierr);
+  /* Add the partition overlap to the distributed DM */
+  ierr = DMPlexDistributeOverlap(*dmParallel, overlap, &sfOverlap, &dmOverlap);CHKERRQ(ierr);
+  ierr = DMDestroy(dmParallel);CHKERRQ(ierr);
+  *dmParallel = dmOverlap;
+  if (view) {
+    ierr = PetscPrintf(comm, "Overlap Migration SF:\n");CHKERRQ(ierr);
+    ierr = PetscSFView(sfOverlap, NULL);CHKERRQ(ierr);
+  }
+
+  /* Re-map the migration SF to establish the full migration pattern */
+  ierr = PetscSFGetGraph(*sfMigration, &nroots, &noldleaves, &oldLeaves, &oldRemote);CHKERRQ(ierr);
+  ierr = PetscSFGetGraph(sfOverlap, NULL, &nleaves, NULL, NULL);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nleaves, &newRemote);CHKERRQ(ierr);
+  /* oldRemote: original root point mapping to original leaf point
+     newRemote: original leaf point mapping to overlapped leaf point */
+  if (oldLeaves) {
+    /* After stratification, the migration remotes may not be in root (canonical) order, so we reorder using the leaf numbering */
+    ierr = PetscMalloc1(noldleaves, &permRemote);CHKERRQ(ierr);
+    for (l = 0; l < noldleaves; ++l) permRemote[oldLeaves[l]] = oldRemote[l];
+    oldRemote = permRemote;
+  }
+  ierr = PetscSFBcastBegin(sfOverlap, MPIU_2INT, oldRemote, newRemote);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sfOverlap, MPIU_2INT, oldRemote, newRemote);CHKERRQ(ierr);
+  if (oldLeaves) {ierr = PetscFree(oldRemote);CHKERRQ(ierr);}
+  ierr = PetscSFCreate(comm, &sfOverlapPoint);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(sfOverlapPoint, nroots, nleaves, NULL, PETSC_OWN_POINTER, newRemote, PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sfOverlap);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(sfMigration);CHKERRQ(ierr);
+  *sfMigration = sfOverlapPoint;
+  PetscFunctionReturn(0);
+}
+
 /*@C
   DMPlexDistribute - Distributes the mesh and any associated sections.
 
@@ -1680,44 +1726,7 @@ PetscErrorCode DMPlexDistribute(DM dm, PetscInt overlap, PetscSF *sf, DM *dmPara
   if (dmCoord) {ierr = DMSetPointSF(dmCoord, sfPoint);CHKERRQ(ierr);}
   if (flg) {ierr = PetscSFView(sfPoint, NULL);CHKERRQ(ierr);}
 
-  if (overlap > 0) {
-    DM                 dmOverlap;
-    PetscInt           nroots, nleaves, noldleaves, l;
-    const PetscInt    *oldLeaves;
-    PetscSFNode       *newRemote, *permRemote;
-    const PetscSFNode *oldRemote;
-    PetscSF            sfOverlap, sfOverlapPoint;
-
-    /* Add the partition overlap to the distributed DM */
-    ierr = DMPlexDistributeOverlap(*dmParallel, overlap, &sfOverlap, &dmOverlap);CHKERRQ(ierr);
-    ierr = DMDestroy(dmParallel);CHKERRQ(ierr);
-    *dmParallel = dmOverlap;
-    if (flg) {
-      ierr = PetscPrintf(comm, "Overlap Migration SF:\n");CHKERRQ(ierr);
-      ierr = PetscSFView(sfOverlap, NULL);CHKERRQ(ierr);
-    }
-
-    /* Re-map the migration SF to establish the full migration pattern */
-    ierr = PetscSFGetGraph(sfMigration, &nroots, &noldleaves, &oldLeaves, &oldRemote);CHKERRQ(ierr);
-    ierr = PetscSFGetGraph(sfOverlap, NULL, &nleaves, NULL, NULL);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nleaves, &newRemote);CHKERRQ(ierr);
-    /* oldRemote: original root point mapping to original leaf point
-       newRemote: original leaf point mapping to overlapped leaf point */
-    if (oldLeaves) {
-      /* After stratification, the migration remotes may not be in root (canonical) order, so we reorder using the leaf numbering */
-      ierr = PetscMalloc1(noldleaves, &permRemote);CHKERRQ(ierr);
-      for (l = 0; l < noldleaves; ++l) permRemote[oldLeaves[l]] = oldRemote[l];
-      oldRemote = permRemote;
-    }
-    ierr = PetscSFBcastBegin(sfOverlap, MPIU_2INT, oldRemote, newRemote);CHKERRQ(ierr);
-    ierr = PetscSFBcastEnd(sfOverlap, MPIU_2INT, oldRemote, newRemote);CHKERRQ(ierr);
-    if (oldLeaves) {ierr = PetscFree(oldRemote);CHKERRQ(ierr);}
-    ierr = PetscSFCreate(comm, &sfOverlapPoint);CHKERRQ(ierr);
-    ierr = PetscSFSetGraph(sfOverlapPoint, nroots, nleaves, NULL, PETSC_OWN_POINTER, newRemote, PETSC_OWN_POINTER);CHKERRQ(ierr);
-    ierr = PetscSFDestroy(&sfOverlap);CHKERRQ(ierr);
-    ierr = PetscSFDestroy(&sfMigration);CHKERRQ(ierr);
-    sfMigration = sfOverlapPoint;
-  }
+  if (overlap > 0) {ierr = DMPlexDistributeOverlapMigration_Static(overlap, flg, dmParallel, &sfMigration);CHKERRQ(ierr);}
   /* Cleanup Partition */
   ierr = DMLabelDestroy(&lblPartition);CHKERRQ(ierr);
   ierr = DMLabelDestroy(&lblMigration);CHKERRQ(ierr);
@@ -1741,6 +1750,264 @@ PetscErrorCode DMPlexDistribute(DM dm, PetscInt overlap, PetscSF *sf, DM *dmPara
   PetscFunctionReturn(0);
 }
 
+/* Compute the flows between neighboring processes which balance the loads by first order diffusion, see
+   Cybenko, Dynamic load balancing for distributed memory multiprocessors, JPDC 7(2), 1989. The resulting flow
+   minimizes the Euclidean norm of the migration among all balancing flows on the process graph. */
+static PetscErrorCode DMPlexRebalanceDiffuse_Static(PetscInt size, const PetscInt off[], const PetscInt adj[], PetscReal tol, PetscReal load[], PetscReal flow[])
+{
+  PetscReal     *delta, total = 0.0, avg;
+  PetscInt       maxIt = 100*size, it, i, e;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i = 0; i < size; ++i) total += load[i];
+  avg  = total/size;
+  ierr = PetscMalloc1(off[size], &delta);CHKERRQ(ierr);
+  for (e = 0; e < off[size]; ++e) flow[e] = 0.0;
+  for (it = 0; it < maxIt; ++it) {
+    PetscReal imbalance = 0.0;
+
+    for (i = 0; i < size; ++i) imbalance = PetscMax(imbalance, PetscAbsReal(load[i] - avg));
+    if (imbalance <= 0.5*tol*avg) break;
+    for (i = 0; i < size; ++i) {
+      for (e = off[i]; e < off[i+1]; ++e) {
+        const PetscInt j = adj[e];
+
+        delta[e] = (load[i] - load[j])/(PetscMax(off[i+1]-off[i], off[j+1]-off[j]) + 1);
+      }
+    }
+    for (i = 0; i < size; ++i) {
+      for (e = off[i]; e < off[i+1]; ++e) {load[i] -= delta[e]; flow[e] += delta[e];}
+    }
+  }
+  ierr = PetscFree(delta);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  DMPlexRebalance - Incrementally repartition an already distributed mesh, moving cells only between neighboring processes
+
+  Collective on dm
+
+  Input Parameters:
++ dm  - The distributed DMPlex object
+- tol - The accepted load imbalance, so that the mesh is left alone if the largest process has at most (1 + tol) times the average number of cells
+
+  Output Parameters:
++ sf - The PetscSF used for point migration, or NULL if not needed
+- dmBalanced - The rebalanced DMPlex object, or NULL if the mesh was already balanced
+
+  Notes:
+  The number of owned cells on each process is balanced by diffusion over the graph of processes sharing mesh points,
+  which determines how many cells each process sends to each of its neighbors while keeping the migration volume small.
+  Each process then picks the cells it sends by growing layers from the points it shares with the receiving process,
+  so that partitions stay compact. This is much cheaper than a complete repartitioning with DMPlexDistribute(), and
+  suited to the small drift in load caused by adaptive refinement or coarsening. Large imbalances may need several calls.
+
+  Labels and coordinates are migrated along with the mesh, and the partition overlap of dm is recreated. Fields are
+  carried over with DMPlexDistributeField() using the returned sf, as after DMPlexDistribute(). The natural ordering
+  of dm is not carried over.
+
+  The process graph and its flows are computed redundantly on all processes, and so cost O(P) memory for P processes.
+
+  Level: intermediate
+
+.seealso: DMPlexDistribute(), DMPlexDistributeField(), DMPlexGetOverlap(), DMPlexRebalanceSharedPoints()
+@*/
+PetscErrorCode DMPlexRebalance(DM dm, PetscReal tol, PetscSF *sf, DM *dmBalanced)
+{
+  MPI_Comm           comm;
+  DM                 dmCoord;
+  DMLabel            lblPartition, lblMigration;
+  PetscSF            sfPoint, sfMigration, sfStratified, sfNew;
+  const PetscSFNode *remotes;
+  const PetscInt    *leaves, *degree;
+  PetscInt          *owner, *target, *leafRank, *multiRank, *multiOff, *start = NULL, *adjacency = NULL, *queue, *send, *off, *adj, *ei, *ej;
+  PetscReal         *load, *flow, maxLoad = 0.0, avgLoad = 0.0, nout = 0.0;
+  PetscInt           overlap, nroots, nleaves, pStart, pEnd, cStart, cEnd, numCells, numOwned = 0, nmulti, nnbr, nedges, p, c, e, i, l;
+  PetscMPIInt        rank, size, *counts, *displs;
+  PetscBool          balance, *touch, *visited;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidLogicalCollectiveReal(dm, tol, 2);
+  if (sf) PetscValidPointer(sf, 3);
+  PetscValidPointer(dmBalanced, 4);
+  if (sf) *sf = NULL;
+  *dmBalanced = NULL;
+  ierr = PetscObjectGetComm((PetscObject) dm, &comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm, &rank);CHKERRMPI(ierr);
+  ierr = MPI_Comm_size(comm, &size);CHKERRMPI(ierr);
+  if (size == 1) PetscFunctionReturn(0);
+  ierr = PetscLogEventBegin(DMPLEX_RebalanceMesh, dm, 0, 0, 0);CHKERRQ(ierr);
+  ierr = DMPlexGetOverlap(dm, &overlap);CHKERRQ(ierr);
+  ierr = DMPlexGetChart(dm, &pStart, &pEnd);CHKERRQ(ierr);
+  ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  ierr = DMGetPointSF(dm, &sfPoint);CHKERRQ(ierr);
+  ierr = PetscSFGetGraph(sfPoint, &nroots, &nleaves, &leaves, &remotes);CHKERRQ(ierr);
+  ierr = PetscMalloc4(pEnd-pStart, &owner, pEnd-pStart, &leafRank, pEnd-pStart, &touch, cEnd-cStart, &target);CHKERRQ(ierr);
+  for (p = pStart; p < pEnd; ++p) {owner[p-pStart] = rank; leafRank[p-pStart] = rank;}
+  for (l = 0; l < nleaves; ++l) owner[(leaves ? leaves[l] : l)-pStart] = remotes[l].rank;
+  for (c = cStart; c < cEnd; ++c) {
+    target[c-cStart] = owner[c-pStart] == rank ? rank : -1;
+    if (target[c-cStart] == rank) ++numOwned;
+  }
+  /* Gather the loads and the process graph, made of the owners of our leaves, and symmetrize it */
+  ierr = PetscMalloc1(size, &send);CHKERRQ(ierr);
+  for (i = 0; i < size; ++i) send[i] = 0;
+  for (l = 0; l < nleaves; ++l) send[remotes[l].rank] = 1;
+  for (i = 0, nnbr = 0; i < size; ++i) if (send[i] && i != rank) send[nnbr++] = i;
+  ierr = PetscMalloc3(size, &load, size, &counts, size+1, &displs);CHKERRQ(ierr);
+  {
+    PetscInt lc[2], *gc;
+
+    lc[0] = numOwned; lc[1] = nnbr;
+    ierr = PetscMalloc1(2*size, &gc);CHKERRQ(ierr);
+    ierr = MPI_Allgather(lc, 2, MPIU_INT, gc, 2, MPIU_INT, comm);CHKERRMPI(ierr);
+    for (i = 0, displs[0] = 0; i < size; ++i) {
+      load[i]     = (PetscReal) gc[2*i];
+      counts[i]   = (PetscMPIInt) gc[2*i+1];
+      displs[i+1] = displs[i] + counts[i];
+      avgLoad    += load[i]/size;
+      maxLoad     = PetscMax(maxLoad, load[i]);
+    }
+    ierr = PetscFree(gc);CHKERRQ(ierr);
+  }
+  if (maxLoad <= (1.0 + tol)*avgLoad) {
+    ierr = PetscFree(send);CHKERRQ(ierr);
+    ierr = PetscFree3(load, counts, displs);CHKERRQ(ierr);
+    ierr = PetscFree4(owner, leafRank, touch, target);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(DMPLEX_RebalanceMesh, dm, 0, 0, 0);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  nedges = displs[size];
+  ierr = PetscMalloc2(2*nedges, &ei, 2*nedges, &ej);CHKERRQ(ierr);
+  ierr = MPI_Allgatherv(send, nnbr, MPIU_INT, ej, counts, displs, MPIU_INT, comm);CHKERRMPI(ierr);
+  for (i = 0; i < size; ++i) for (e = displs[i]; e < displs[i+1]; ++e) {ei[e] = i; ei[nedges+e] = ej[e]; ej[nedges+e] = i;}
+  ierr = PetscSortIntWithArray(2*nedges, ei, ej);CHKERRQ(ierr);
+  ierr = PetscMalloc2(size+1, &off, 2*nedges, &adj);CHKERRQ(ierr);
+  for (i = 0, e = 0, off[0] = 0; i < size; ++i) {
+    PetscInt n = 0;
+
+    for (; e < 2*nedges && ei[e] == i; ++e) adj[off[i]+n++] = ej[e];
+    ierr = PetscSortRemoveDupsInt(&n, &adj[off[i]]);CHKERRQ(ierr);
+    off[i+1] = off[i] + n;
+  }
+  ierr = PetscFree2(ei, ej);CHKERRQ(ierr);
+  ierr = PetscMalloc1(off[size], &flow);CHKERRQ(ierr);
+  ierr = DMPlexRebalanceDiffuse_Static(size, off, adj, tol, load, flow);CHKERRQ(ierr);
+  /* The number of cells to send to each neighbor, keeping at least one cell */
+  for (e = off[rank]; e < off[rank+1]; ++e) nout += PetscMax(flow[e], 0.0);
+  for (e = off[rank]; e < off[rank+1]; ++e) {
+    PetscReal f = PetscMax(flow[e], 0.0);
+
+    if (nout > numOwned-1) f *= (numOwned-1)/nout;
+    flow[e] = PetscFloorReal(f + 0.5);
+  }
+  /* Find the processes sharing each of our roots */
+  ierr = PetscSFComputeDegreeBegin(sfPoint, &degree);CHKERRQ(ierr);
+  ierr = PetscSFComputeDegreeEnd(sfPoint, &degree);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nroots+1, &multiOff);CHKERRQ(ierr);
+  for (p = 0, multiOff[0] = 0; p < nroots; ++p) multiOff[p+1] = multiOff[p] + degree[p];
+  nmulti = multiOff[nroots];
+  ierr = PetscMalloc1(nmulti, &multiRank);CHKERRQ(ierr);
+  ierr = PetscSFGatherBegin(sfPoint, MPIU_INT, leafRank, multiRank);CHKERRQ(ierr);
+  ierr = PetscSFGatherEnd(sfPoint, MPIU_INT, leafRank, multiRank);CHKERRQ(ierr);
+  /* Grow the cells sent to each neighbor in layers from the points we share with it */
+  ierr = DMPlexCreateNeighborCSR(dm, 0, &numCells, &start, &adjacency);CHKERRQ(ierr);
+  ierr = PetscMalloc2(numCells, &queue, numCells, &visited);CHKERRQ(ierr);
+  for (e = off[rank]; e < off[rank+1]; ++e) {
+    const PetscInt nbr = adj[e], nsend = (PetscInt) flow[e];
+    PetscInt       qhead = 0, qtail = 0, nsent = 0;
+
+    if (nsend <= 0) continue;
+    for (p = pStart; p < pEnd; ++p) touch[p-pStart] = PETSC_FALSE;
+    for (p = pStart; p < pEnd; ++p) {
+      if (owner[p-pStart] == nbr) touch[p-pStart] = PETSC_TRUE;
+      else if (p < nroots) for (i = multiOff[p]; i < multiOff[p+1]; ++i) if (multiRank[i] == nbr) touch[p-pStart] = PETSC_TRUE;
+    }
+    for (c = 0; c < numCells; ++c) {
+      PetscInt *closure = NULL, clSize, cl;
+
+      visited[c] = PETSC_FALSE;
+      if (target[c] != rank) continue;
+      ierr = DMPlexGetTransitiveClosure(dm, c+cStart, PETSC_TRUE, &clSize, &closure);CHKERRQ(ierr);
+      for (cl = 0; cl < clSize*2; cl += 2) if (touch[closure[cl]-pStart]) break;
+      if (cl < clSize*2) {queue[qtail++] = c; visited[c] = PETSC_TRUE;}
+      ierr = DMPlexRestoreTransitiveClosure(dm, c+cStart, PETSC_TRUE, &clSize, &closure);CHKERRQ(ierr);
+    }
+    while (qhead < qtail && nsent < nsend) {
+      const PetscInt cell = queue[qhead++];
+
+      target[cell] = nbr;
+      ++nsent;
+      for (i = start[cell]; i < start[cell+1]; ++i) {
+        const PetscInt neighbor = adjacency[i];
+
+        if (visited[neighbor] || target[neighbor] != rank) continue;
+        visited[neighbor] = PETSC_TRUE;
+        queue[qtail++]    = neighbor;
+      }
+    }
+  }
+  ierr = PetscFree(start);CHKERRQ(ierr);
+  ierr = PetscFree(adjacency);CHKERRQ(ierr);
+  ierr = PetscFree2(queue, visited);CHKERRQ(ierr);
+  ierr = PetscFree(multiOff);CHKERRQ(ierr);
+  ierr = PetscFree(multiRank);CHKERRQ(ierr);
+  ierr = PetscFree(flow);CHKERRQ(ierr);
+  ierr = PetscFree2(off, adj);CHKERRQ(ierr);
+  ierr = PetscFree(send);CHKERRQ(ierr);
+  ierr = PetscFree3(load, counts, displs);CHKERRQ(ierr);
+  /* Label the closures of the owned cells with their target process */
+  ierr = DMLabelCreate(PETSC_COMM_SELF, "Point Partition", &lblPartition);CHKERRQ(ierr);
+  {
+    PetscInt *cells, *coff, *ccnt, nt;
+
+    ierr = PetscCalloc3(size+1, &coff, size, &ccnt, numOwned, &cells);CHKERRQ(ierr);
+    for (c = 0; c < cEnd-cStart; ++c) if (target[c] >= 0) ++coff[target[c]+1];
+    for (i = 0; i < size; ++i) coff[i+1] += coff[i];
+    for (c = 0; c < cEnd-cStart; ++c) if (target[c] >= 0) {nt = target[c]; cells[coff[nt]+ccnt[nt]++] = c+cStart;}
+    for (i = 0; i < size; ++i) {
+      IS is;
+
+      if (!ccnt[i]) continue;
+      ierr = DMPlexClosurePoints_Private(dm, ccnt[i], cells+coff[i], &is);CHKERRQ(ierr);
+      ierr = DMLabelSetStratumIS(lblPartition, i, is);CHKERRQ(ierr);
+      ierr = ISDestroy(&is);CHKERRQ(ierr);
+    }
+    ierr = PetscFree3(coff, ccnt, cells);CHKERRQ(ierr);
+  }
+  ierr = PetscFree4(owner, leafRank, touch, target);CHKERRQ(ierr);
+  /* Migrate as in DMPlexDistribute() */
+  ierr = DMLabelCreate(PETSC_COMM_SELF, "Point migration", &lblMigration);CHKERRQ(ierr);
+  ierr = DMPlexPartitionLabelInvert(dm, lblPartition, NULL, lblMigration);CHKERRQ(ierr);
+  ierr = DMPlexPartitionLabelCreateSF(dm, lblMigration, &sfMigration);CHKERRQ(ierr);
+  ierr = DMPlexStratifyMigrationSF(dm, sfMigration, &sfStratified);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sfMigration);CHKERRQ(ierr);
+  sfMigration = sfStratified;
+  ierr = PetscSFSetUp(sfMigration);CHKERRQ(ierr);
+  ierr = DMLabelDestroy(&lblPartition);CHKERRQ(ierr);
+  ierr = DMLabelDestroy(&lblMigration);CHKERRQ(ierr);
+  ierr = DMPlexCreate(comm, dmBalanced);CHKERRQ(ierr);
+  ierr = PetscObjectSetName((PetscObject) *dmBalanced, "Parallel Mesh");CHKERRQ(ierr);
+  ierr = DMPlexMigrate(dm, sfMigration, *dmBalanced);CHKERRQ(ierr);
+  ierr = DMPlexGetPartitionBalance(dm, &balance);CHKERRQ(ierr);
+  ierr = DMPlexSetPartitionBalance(*dmBalanced, balance);CHKERRQ(ierr);
+  ierr = DMPlexCreatePointSF(*dmBalanced, sfMigration, PETSC_TRUE, &sfNew);CHKERRQ(ierr);
+  ierr = DMSetPointSF(*dmBalanced, sfNew);CHKERRQ(ierr);
+  ierr = DMGetCoordinateDM(*dmBalanced, &dmCoord);CHKERRQ(ierr);
+  if (dmCoord) {ierr = DMSetPointSF(dmCoord, sfNew);CHKERRQ(ierr);}
+  ierr = PetscSFDestroy(&sfNew);CHKERRQ(ierr);
+  if (overlap > 0) {ierr = DMPlexDistributeOverlapMigration_Static(overlap, PETSC_FALSE, dmBalanced, &sfMigration);CHKERRQ(ierr);}
+  ierr = DMCopyBoundary(dm, *dmBalanced);CHKERRQ(ierr);
+  if (sf) {*sf = sfMigration;}
+  else    {ierr = PetscSFDestroy(&sfMigration);CHKERRQ(ierr);}
+  ierr = PetscLogEventEnd(DMPLEX_RebalanceMesh, dm, 0, 0, 0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
   DMPlexDistributeOverlap - Add partition overlap to a distributed non-overlapping DM.
 
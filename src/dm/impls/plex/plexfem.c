@@ -4,6 +4,7 @@
 #include <petsc/private/hashsetij.h>
 #include <petsc/private/petscfeimpl.h>
 #include <petsc/private/petscfvimpl.h>
+#include <petsc/private/dmfieldimpl.h>
 
 static PetscErrorCode DMPlexConvertPlex(DM dm, DM *plex, PetscBool copy)
 {
@@ -44,37 +45,87 @@ static PetscErrorCode DMPlexConvertPlex(DM dm, DM *plex, PetscBool copy)
   PetscFunctionReturn(0);
 }
 
+typedef struct {
+  PetscFEGeom     *geom;
+  PetscObjectId    fieldId;    /* The coordinate field used to compute the geometry */
+  PetscObjectId    coordId;    /* The local coordinate vector used to compute the geometry */
+  PetscObjectState coordState; /* Its state, so that moving the mesh invalidates the geometry */
+} DMPlexFEGeomCache;
+
 static PetscErrorCode PetscContainerUserDestroy_PetscFEGeom (void *ctx)
 {
-  PetscFEGeom *geom = (PetscFEGeom *) ctx;
+  DMPlexFEGeomCache *cache = (DMPlexFEGeomCache *) ctx;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFEGeomDestroy(&cache->geom);CHKERRQ(ierr);
+  ierr = PetscFree(cache);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexGetCoordinateState_Private(DMField coordField, PetscObjectId *id, PetscObjectState *state)
+{
+  Vec            coordinates;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = PetscFEGeomDestroy(&geom);CHKERRQ(ierr);
+  *id    = 0;
+  *state = 0;
+  ierr = DMFieldDSGetVec_Internal(coordField, &coordinates);CHKERRQ(ierr);
+  if (coordinates) {
+    ierr = PetscObjectGetId((PetscObject) coordinates, id);CHKERRQ(ierr);
+    ierr = PetscObjectStateGet((PetscObject) coordinates, state);CHKERRQ(ierr);
+  }
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode DMPlexGetFEGeom(DMField coordField, IS pointIS, PetscQuadrature quad, PetscBool faceData, PetscFEGeom **geom)
+/* The geometry is cached on pointIS for each quadrature, and recomputed when the coordinate field or coordinates change */
+static PetscErrorCode DMPlexGetFEGeomCached_Private(const char prefix[], DMField coordField, IS pointIS, PetscQuadrature quad, PetscBool faceData, PetscFEGeom **geom)
 {
-  char            composeStr[33] = {0};
-  PetscObjectId   id;
-  PetscContainer  container;
-  PetscErrorCode  ierr;
+  char               composeStr[65] = {0};
+  PetscObjectId      qid, fid, coordId;
+  PetscObjectState   coordState;
+  PetscContainer     container;
+  DMPlexFEGeomCache *cache;
+  PetscErrorCode     ierr;
 
   PetscFunctionBegin;
-  ierr = PetscObjectGetId((PetscObject)quad,&id);CHKERRQ(ierr);
-  ierr = PetscSNPrintf(composeStr, 32, "DMPlexGetFEGeom_%x\n", id);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject) quad, &qid);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject) coordField, &fid);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(composeStr, 64, "%s_%x\n", prefix, qid);CHKERRQ(ierr);
+  ierr = DMPlexGetCoordinateState_Private(coordField, &coordId, &coordState);CHKERRQ(ierr);
   ierr = PetscObjectQuery((PetscObject) pointIS, composeStr, (PetscObject *) &container);CHKERRQ(ierr);
   if (container) {
-    ierr = PetscContainerGetPointer(container, (void **) geom);CHKERRQ(ierr);
+    ierr = PetscContainerGetPointer(container, (void **) &cache);CHKERRQ(ierr);
+    if (cache->fieldId != fid || cache->coordId != coordId || cache->coordState != coordState) {
+      ierr = PetscFEGeomDestroy(&cache->geom);CHKERRQ(ierr);
+      ierr = DMFieldCreateFEGeom(coordField, pointIS, quad, faceData, &cache->geom);CHKERRQ(ierr);
+      cache->fieldId    = fid;
+      cache->coordId    = coordId;
+      cache->coordState = coordState;
+    }
   } else {
-    ierr = DMFieldCreateFEGeom(coordField, pointIS, quad, faceData, geom);CHKERRQ(ierr);
+    ierr = PetscNew(&cache);CHKERRQ(ierr);
+    ierr = DMFieldCreateFEGeom(coordField, pointIS, quad, faceData, &cache->geom);CHKERRQ(ierr);
+    cache->fieldId    = fid;
+    cache->coordId    = coordId;
+    cache->coordState = coordState;
     ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
-    ierr = PetscContainerSetPointer(container, (void *) *geom);CHKERRQ(ierr);
+    ierr = PetscContainerSetPointer(container, (void *) cache);CHKERRQ(ierr);
     ierr = PetscContainerSetUserDestroy(container, PetscContainerUserDestroy_PetscFEGeom);CHKERRQ(ierr);
     ierr = PetscObjectCompose((PetscObject) pointIS, composeStr, (PetscObject) container);CHKERRQ(ierr);
     ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
   }
+  *geom = cache->geom;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexGetFEGeom(DMField coordField, IS pointIS, PetscQuadrature quad, PetscBool faceData, PetscFEGeom **geom)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexGetFEGeomCached_Private("DMPlexGetFEGeom", coordField, pointIS, quad, faceData, geom);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -356,6 +407,67 @@ PetscErrorCode DMPlexGetMaxProjectionHeight(DM dm, PetscInt *height)
   PetscFunctionReturn(0);
 }
 
+/*@
+  DMPlexSetCacheElementMatrices - Cache the element matrices of the residual, and evaluate it as an element matrix-vector product
+
+  Logically collective on dm
+
+  Input Parameters:
++ dm    - the DMPlex object
+- cache - PETSC_TRUE to cache the element matrices
+
+  Options Database Key:
+. -dm_plex_cache_element_matrices - Cache the element matrices
+
+  Notes:
+  This is only valid when the residual is affine in the solution, F(u) = K u + F(0), since K is taken from the PetscDS Jacobian
+  integrated once. The element matrices and F(0) are recomputed when the coordinates change. They are used for SNES residuals on
+  implicit FEM fields without an auxiliary vector; all other evaluations integrate the pointwise residual as usual.
+
+  Calling this function again invalidates the cached matrices, which should be done after changing pointwise functions or constants.
+
+  Level: advanced
+
+.seealso: DMPlexGetCacheElementMatrices(), DMPlexSNESComputeResidualFEM(), PetscDSSetJacobian()
+@*/
+PetscErrorCode DMPlexSetCacheElementMatrices(DM dm, PetscBool cache)
+{
+  DM_Plex *plex = (DM_Plex *) dm->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidLogicalCollectiveBool(dm, cache, 2);
+  plex->cacheElemMat = cache;
+  ++plex->elemMatState;
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMPlexGetCacheElementMatrices - Determine whether element matrices of the residual are cached
+
+  Not collective
+
+  Input Parameter:
+. dm - the DMPlex object
+
+  Output Parameter:
+. cache - PETSC_TRUE if the element matrices are cached
+
+  Level: advanced
+
+.seealso: DMPlexSetCacheElementMatrices()
+@*/
+PetscErrorCode DMPlexGetCacheElementMatrices(DM dm, PetscBool *cache)
+{
+  DM_Plex *plex = (DM_Plex *) dm->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidBoolPointer(cache, 2);
+  *cache = plex->cacheElemMat;
+  PetscFunctionReturn(0);
+}
+
 typedef struct {
   PetscReal    alpha; /* The first Euler angle, and in 2D the only one */
   PetscReal    beta;  /* The second Euler angle */
@@ -3122,7 +3234,7 @@ PetscErrorCode DMPlexComputeInjectorFEM(DM dmc, DM dmf, VecScatter *sc, void *us
   PetscSection   fsection, fglobalSection, csection, cglobalSection;
   PetscInt      *cmap, *cellCIndices, *cellFIndices, *cindices, *findices;
   PetscInt       cTotDim, fTotDim = 0, Nf, f, field, cStart, cEnd, c, dim, d, startC, endC, offsetC, offsetF, m;
-  PetscBool     *needAvg;
+  PetscBool     *needAvg, isRefined = dmc->data == dmf->data ? PETSC_FALSE : PETSC_TRUE;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -3148,7 +3260,15 @@ PetscErrorCode DMPlexComputeInjectorFEM(DM dmc, DM dmf, VecScatter *sc, void *us
       PetscSpace sp;
       PetscInt   maxDegree;
 
-      ierr = PetscFERefine(fe, &feRef[f]);CHKERRQ(ierr);
+      if (isRefined) {ierr = PetscFERefine(fe, &feRef[f]);CHKERRQ(ierr);}
+      else {
+        PetscDS fprob;
+
+        /* The meshes are the same, so match the functionals of the fine space itself, as in p-coarsening */
+        ierr = DMGetDS(dmf, &fprob);CHKERRQ(ierr);
+        ierr = PetscDSGetDiscretization(fprob, f, (PetscObject *) &feRef[f]);CHKERRQ(ierr);
+        ierr = PetscObjectReference((PetscObject) feRef[f]);CHKERRQ(ierr);
+      }
       ierr = PetscFEGetDimension(feRef[f], &fNb);CHKERRQ(ierr);
       ierr = PetscFEGetNumComponents(fe, &Nc);CHKERRQ(ierr);
       ierr = PetscFEGetBasisSpace(fe, &sp);CHKERRQ(ierr);
@@ -3243,7 +3363,17 @@ PetscErrorCode DMPlexComputeInjectorFEM(DM dmc, DM dmf, VecScatter *sc, void *us
   ierr = PetscMalloc1(m,&findices);CHKERRQ(ierr);
   for (d = 0; d < m; ++d) cindices[d] = findices[d] = -1;
   for (c = cStart; c < cEnd; ++c) {
-    ierr = DMPlexMatGetClosureIndicesRefined(dmf, fsection, fglobalSection, dmc, csection, cglobalSection, c, cellCIndices, cellFIndices);CHKERRQ(ierr);
+    if (isRefined) {ierr = DMPlexMatGetClosureIndicesRefined(dmf, fsection, fglobalSection, dmc, csection, cglobalSection, c, cellCIndices, cellFIndices);CHKERRQ(ierr);}
+    else {
+      PetscInt *cidx, *fidx, Nci, Nfi;
+
+      ierr = DMPlexGetClosureIndices(dmc, csection, cglobalSection, c, PETSC_TRUE, &Nci, &cidx, NULL, NULL);CHKERRQ(ierr);
+      ierr = DMPlexGetClosureIndices(dmf, fsection, fglobalSection, c, PETSC_TRUE, &Nfi, &fidx, NULL, NULL);CHKERRQ(ierr);
+      ierr = PetscArraycpy(cellCIndices, cidx, cTotDim);CHKERRQ(ierr);
+      ierr = PetscArraycpy(cellFIndices, fidx, fTotDim);CHKERRQ(ierr);
+      ierr = DMPlexRestoreClosureIndices(dmc, csection, cglobalSection, c, PETSC_TRUE, &Nci, &cidx, NULL, NULL);CHKERRQ(ierr);
+      ierr = DMPlexRestoreClosureIndices(dmf, fsection, fglobalSection, c, PETSC_TRUE, &Nfi, &fidx, NULL, NULL);CHKERRQ(ierr);
+    }
     for (d = 0; d < cTotDim; ++d) {
       if ((cellCIndices[d] < startC) || (cellCIndices[d] >= endC)) continue;
       if ((findices[cellCIndices[d]-startC] >= 0) && (findices[cellCIndices[d]-startC] != cellFIndices[cmap[d]])) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Coarse dof %D maps to both %D and %D", cindices[cellCIndices[d]-startC], findices[cellCIndices[d]-startC], cellFIndices[cmap[d]]);
@@ -3674,25 +3804,10 @@ PetscErrorCode DMPlexRestoreFaceGeometry(DM dm, PetscInt fStart, PetscInt fEnd,
 
 PetscErrorCode DMSNESGetFEGeom(DMField coordField, IS pointIS, PetscQuadrature quad, PetscBool faceData, PetscFEGeom **geom)
 {
-  char            composeStr[33] = {0};
-  PetscObjectId   id;
-  PetscContainer  container;
-  PetscErrorCode  ierr;
+  PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = PetscObjectGetId((PetscObject)quad,&id);CHKERRQ(ierr);
-  ierr = PetscSNPrintf(composeStr, 32, "DMSNESGetFEGeom_%x\n", id);CHKERRQ(ierr);
-  ierr = PetscObjectQuery((PetscObject) pointIS, composeStr, (PetscObject *) &container);CHKERRQ(ierr);
-  if (container) {
-    ierr = PetscContainerGetPointer(container, (void **) geom);CHKERRQ(ierr);
-  } else {
-    ierr = DMFieldCreateFEGeom(coordField, pointIS, quad, faceData, geom);CHKERRQ(ierr);
-    ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
-    ierr = PetscContainerSetPointer(container, (void *) *geom);CHKERRQ(ierr);
-    ierr = PetscContainerSetUserDestroy(container, PetscContainerUserDestroy_PetscFEGeom);CHKERRQ(ierr);
-    ierr = PetscObjectCompose((PetscObject) pointIS, composeStr, (PetscObject) container);CHKERRQ(ierr);
-    ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
-  }
+  ierr = DMPlexGetFEGeomCached_Private("DMSNESGetFEGeom", coordField, pointIS, quad, faceData, geom);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -3703,9 +3818,83 @@ PetscErrorCode DMSNESRestoreFEGeom(DMField coordField, IS pointIS, PetscQuadratu
   PetscFunctionReturn(0);
 }
 
+/*
+  Add the element vectors of the cells [cS, cE) into locF, skipping ghost cells. When the closure dof cache covers the
+  cells, the closures are added through its index lists, color by color, so that the cells of one color never write the
+  same dof. With OpenMP only this addition is threaded, over the cells of each color, while the element vectors
+  themselves are still integrated serially by the caller.
+*/
+static PetscErrorCode DMPlexAddCellVectors_Private(DM dm, PetscSection section, DMLabel ghostLabel, const char name[], const PetscInt cells[], PetscInt cStart, PetscInt cS, PetscInt cE, PetscInt totDim, const PetscScalar elemVec[], Vec locF)
+{
+  DM_Plex               *mesh  = (DM_Plex *) dm->data;
+  DMPlexClosureDofCache *cache = DMPlexGetClosureDofCache_Private(dm, section);
+  PetscInt               c;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  if (!cells && cache && cS >= cache->pStart && cE <= cache->pEnd) {
+    PetscScalar *fa;
+    PetscBool   *ghost = NULL;
+
+    /* The label is read before the threaded region, which only looks at the flags */
+    if (ghostLabel) {ierr = PetscCalloc1(cE-cS, &ghost);CHKERRQ(ierr);}
+    for (c = cS; c < cE; ++c) {
+      if (mesh->printFEM > 1) {ierr = DMPrintCellVector(c, name, totDim, &elemVec[(c-cStart)*totDim]);CHKERRQ(ierr);}
+      if (ghostLabel) {
+        PetscInt ghostVal;
+
+        ierr = DMLabelGetValue(ghostLabel, c, &ghostVal);CHKERRQ(ierr);
+        ghost[c-cS] = ghostVal > 0 ? PETSC_TRUE : PETSC_FALSE;
+      }
+    }
+    ierr = VecGetArray(locF, &fa);CHKERRQ(ierr);
+    {
+      const PetscInt *colorOffsets, *colorPoints;
+      PetscInt        numColors, k;
+
+      ierr = DMPlexGetClosureDofCacheColoring(dm, &numColors, &colorOffsets, &colorPoints);CHKERRQ(ierr);
+      for (k = 0; k < numColors; ++k) {
+        const PetscInt  n = colorOffsets[k+1] - colorOffsets[k];
+        const PetscInt *points = &colorPoints[colorOffsets[k]];
+        PetscInt        lo, hi, i;
+
+        /* The points of a color are sorted, so those of the chunk are a contiguous range */
+        ierr = PetscFindInt(cS, n, points, &lo);CHKERRQ(ierr);
+        if (lo < 0) lo = -(lo+1);
+        ierr = PetscFindInt(cE, n, points, &hi);CHKERRQ(ierr);
+        if (hi < 0) hi = -(hi+1);
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for
+#endif
+        for (i = lo; i < hi; ++i) {
+          const PetscInt cell = points[i];
+
+          if (!ghost || !ghost[cell-cS]) DMPlexClosureDofCacheAddPoint_Private(cache, cell, &elemVec[(cell-cStart)*totDim], fa);
+        }
+      }
+    }
+    ierr = VecRestoreArray(locF, &fa);CHKERRQ(ierr);
+    ierr = PetscFree(ghost);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  for (c = cS; c < cE; ++c) {
+    const PetscInt cell = cells ? cells[c] : c;
+    const PetscInt cind = c - cStart;
+
+    if (mesh->printFEM > 1) {ierr = DMPrintCellVector(cell, name, totDim, &elemVec[cind*totDim]);CHKERRQ(ierr);}
+    if (ghostLabel) {
+      PetscInt ghostVal;
+
+      ierr = DMLabelGetValue(ghostLabel,cell,&ghostVal);CHKERRQ(ierr);
+      if (ghostVal > 0) continue;
+    }
+    ierr = DMPlexVecSetClosure(dm, section, locF, cell, &elemVec[cind*totDim], ADD_ALL_VALUES);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode DMPlexComputeResidual_Patch_Internal(DM dm, PetscSection section, IS cellIS, PetscReal t, Vec locX, Vec locX_t, Vec locF, void *user)
 {
-  DM_Plex         *mesh       = (DM_Plex *) dm->data;
   const char      *name       = "Residual";
   DM               dmAux      = NULL;
   DMLabel          ghostLabel = NULL;
@@ -3851,19 +4040,7 @@ PetscErrorCode DMPlexComputeResidual_Patch_Internal(DM dm, PetscSection section,
     /* Loop over domain */
     if (useFEM) {
       /* Add elemVec to locX */
-      for (c = cS; c < cE; ++c) {
-        const PetscInt cell = cells ? cells[c] : c;
-        const PetscInt cind = c - cStart;
-
-        if (mesh->printFEM > 1) {ierr = DMPrintCellVector(cell, name, totDim, &elemVec[cind*totDim]);CHKERRQ(ierr);}
-        if (ghostLabel) {
-          PetscInt ghostVal;
-
-          ierr = DMLabelGetValue(ghostLabel,cell,&ghostVal);CHKERRQ(ierr);
-          if (ghostVal > 0) continue;
-        }
-        ierr = DMPlexVecSetClosure(dm, section, locF, cell, &elemVec[cind*totDim], ADD_ALL_VALUES);CHKERRQ(ierr);
-      }
+      ierr = DMPlexAddCellVectors_Private(dm, section, ghostLabel, name, cells, cStart, cS, cE, totDim, elemVec, locF);CHKERRQ(ierr);
     }
     /* Handle time derivative */
     if (locX_t) {
@@ -4413,6 +4590,104 @@ PetscErrorCode DMPlexComputeBdResidual_Internal(DM dm, Vec locX, Vec locX_t, Pet
   PetscFunctionReturn(0);
 }
 
+typedef struct {
+  PetscInt          numCells, totDim;
+  PetscObjectId     dsId, fieldId, coordId;
+  PetscObjectState  coordState, elemMatState;
+  PetscScalar      *elemMat;  /* The element matrices K, numCells x totDim x totDim */
+  PetscScalar      *elemVec0; /* The element residuals F(0), numCells x totDim */
+} DMPlexElemMatCache;
+
+static PetscErrorCode PetscContainerUserDestroy_DMPlexElemMatCache(void *ctx)
+{
+  DMPlexElemMatCache *cache = (DMPlexElemMatCache *) ctx;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(cache->elemMat, cache->elemVec0);CHKERRQ(ierr);
+  ierr = PetscFree(cache);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  For an affine residual F(u) = K u + F(0), the element matrices K and F(0) are integrated once and cached on cellIS. They are
+  recomputed if the cells, discretization, coordinates, or the DM flag state change.
+*/
+static PetscErrorCode DMPlexGetElementMatrixCache_Private(DM dm, IS cellIS, PetscInt numCells, PetscDS prob, DMField coordField, PetscFEGeom *affineGeom, PetscFEGeom **geoms, PetscReal t, DMPlexElemMatCache **elemCache)
+{
+  DM_Plex            *mesh = (DM_Plex *) dm->data;
+  DMPlexElemMatCache *cache;
+  PetscContainer      container;
+  PetscObjectId       dsId, fieldId, coordId;
+  PetscObjectState    coordState;
+  PetscScalar        *u;
+  PetscInt            Nf, totDim, fieldI, fieldJ;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscDSGetNumFields(prob, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(prob, &totDim);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject) prob, &dsId);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject) coordField, &fieldId);CHKERRQ(ierr);
+  ierr = DMPlexGetCoordinateState_Private(coordField, &coordId, &coordState);CHKERRQ(ierr);
+  ierr = PetscObjectQuery((PetscObject) cellIS, "DMPlexElemMatCache", (PetscObject *) &container);CHKERRQ(ierr);
+  if (container) {
+    ierr = PetscContainerGetPointer(container, (void **) &cache);CHKERRQ(ierr);
+    if (cache->numCells == numCells && cache->totDim == totDim && cache->dsId == dsId && cache->fieldId == fieldId &&
+        cache->coordId == coordId && cache->coordState == coordState && cache->elemMatState == mesh->elemMatState) {
+      *elemCache = cache;
+      PetscFunctionReturn(0);
+    }
+    ierr = PetscFree2(cache->elemMat, cache->elemVec0);CHKERRQ(ierr);
+  } else {
+    ierr = PetscNew(&cache);CHKERRQ(ierr);
+    ierr = PetscContainerCreate(PETSC_COMM_SELF, &container);CHKERRQ(ierr);
+    ierr = PetscContainerSetPointer(container, (void *) cache);CHKERRQ(ierr);
+    ierr = PetscContainerSetUserDestroy(container, PetscContainerUserDestroy_DMPlexElemMatCache);CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject) cellIS, "DMPlexElemMatCache", (PetscObject) container);CHKERRQ(ierr);
+    ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  }
+  cache->numCells     = numCells;
+  cache->totDim       = totDim;
+  cache->dsId         = dsId;
+  cache->fieldId      = fieldId;
+  cache->coordId      = coordId;
+  cache->coordState   = coordState;
+  cache->elemMatState = mesh->elemMatState;
+  ierr = PetscCalloc2(numCells*totDim*totDim, &cache->elemMat, numCells*totDim, &cache->elemVec0);CHKERRQ(ierr);
+  ierr = PetscCalloc1(numCells*totDim, &u);CHKERRQ(ierr);
+  for (fieldI = 0; fieldI < Nf; ++fieldI) {
+    PetscFE      fe;
+    PetscFEGeom *geom = affineGeom ? affineGeom : geoms[fieldI];
+    PetscFEGeom *chunkGeom = NULL, *remGeom = NULL;
+    PetscInt     Nb, numChunks, numBatches, numBlocks, Ne, Nr, offset, blockSize, batchSize;
+
+    ierr = PetscDSGetDiscretization(prob, fieldI, (PetscObject *) &fe);CHKERRQ(ierr);
+    ierr = PetscFEGetDimension(fe, &Nb);CHKERRQ(ierr);
+    ierr = PetscFEGetTileSizes(fe, NULL, &numBlocks, NULL, &numBatches);CHKERRQ(ierr);
+    blockSize = Nb;
+    batchSize = numBlocks * blockSize;
+    ierr = PetscFESetTileSizes(fe, blockSize, numBlocks, batchSize, numBatches);CHKERRQ(ierr);
+    numChunks = numCells / (numBatches*batchSize);
+    Ne        = numChunks*numBatches*batchSize;
+    Nr        = numCells % (numBatches*batchSize);
+    offset    = numCells - Nr;
+    ierr = PetscFEGeomGetChunk(geom,0,offset,&chunkGeom);CHKERRQ(ierr);
+    ierr = PetscFEGeomGetChunk(geom,offset,numCells,&remGeom);CHKERRQ(ierr);
+    ierr = PetscFEIntegrateResidual(prob, fieldI, Ne, chunkGeom, u, NULL, NULL, NULL, t, cache->elemVec0);CHKERRQ(ierr);
+    ierr = PetscFEIntegrateResidual(prob, fieldI, Nr, remGeom, &u[offset*totDim], NULL, NULL, NULL, t, &cache->elemVec0[offset*totDim]);CHKERRQ(ierr);
+    for (fieldJ = 0; fieldJ < Nf; ++fieldJ) {
+      ierr = PetscFEIntegrateJacobian(prob, PETSCFE_JACOBIAN, fieldI, fieldJ, Ne, chunkGeom, u, NULL, NULL, NULL, t, 0.0, cache->elemMat);CHKERRQ(ierr);
+      ierr = PetscFEIntegrateJacobian(prob, PETSCFE_JACOBIAN, fieldI, fieldJ, Nr, remGeom, &u[offset*totDim], NULL, NULL, NULL, t, 0.0, &cache->elemMat[offset*totDim*totDim]);CHKERRQ(ierr);
+    }
+    ierr = PetscFEGeomRestoreChunk(geom,offset,numCells,&remGeom);CHKERRQ(ierr);
+    ierr = PetscFEGeomRestoreChunk(geom,0,offset,&chunkGeom);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(u);CHKERRQ(ierr);
+  *elemCache = cache;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode DMPlexComputeResidual_Internal(DM dm, IS cellIS, PetscReal time, Vec locX, Vec locX_t, PetscReal t, Vec locF, void *user)
 {
   DM_Plex         *mesh       = (DM_Plex *) dm->data;
@@ -4439,6 +4714,7 @@ PetscErrorCode DMPlexComputeResidual_Internal(DM dm, IS cellIS, PetscReal time,
   PetscInt         maxDegree = PETSC_MAX_INT;
   PetscQuadrature  affineQuad = NULL, *quads = NULL;
   PetscFEGeom     *affineGeom = NULL, **geoms = NULL;
+  DMPlexElemMatCache *elemCache = NULL;
   PetscErrorCode   ierr;
 
   PetscFunctionBegin;
@@ -4449,6 +4725,7 @@ PetscErrorCode DMPlexComputeResidual_Internal(DM dm, IS cellIS, PetscReal time,
   ierr = ISGetPointRange(cellIS, &cStart, &cEnd, &cells);CHKERRQ(ierr);
   ierr = DMPlexGetHeightStratum(dm, 1, &fStart, &fEnd);CHKERRQ(ierr);
   /* 1: Get sizes from dm and dmAux */
+  ierr = DMPlexSetUpClosureDofCache_Internal(dm);CHKERRQ(ierr);
   ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
   ierr = DMGetLabel(dm, "ghost", &ghostLabel);CHKERRQ(ierr);
   ierr = DMGetCellDS(dm, cells ? cells[cStart] : cStart, &prob);CHKERRQ(ierr);
@@ -4504,6 +4781,23 @@ PetscErrorCode DMPlexComputeResidual_Internal(DM dm, IS cellIS, PetscReal time,
       }
     }
   }
+  /* The cached element matrices only reproduce SNES residuals of implicit FEM fields without auxiliary data */
+  if (mesh->cacheElemMat && useFEM && !useFVM && !locA && !locX_t && time == PETSC_MIN_REAL) {
+    PetscBool useCache;
+
+    ierr = PetscDSHasJacobian(prob, &useCache);CHKERRQ(ierr);
+    for (f = 0; f < Nf; ++f) {
+      PetscObject  obj;
+      PetscClassId id;
+      PetscBool    fimp;
+
+      ierr = PetscDSGetImplicit(prob, f, &fimp);CHKERRQ(ierr);
+      ierr = PetscDSGetDiscretization(prob, f, &obj);CHKERRQ(ierr);
+      ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+      if (!fimp || id != PETSCFE_CLASSID) useCache = PETSC_FALSE;
+    }
+    if (useCache) {ierr = DMPlexGetElementMatrixCache_Private(dm, cellIS, cEnd - cStart, prob, coordField, affineGeom, geoms, t, &elemCache);CHKERRQ(ierr);}
+  }
   if (useFVM) {
     ierr = DMPlexGetGeometryFVM(dm, &faceGeometryFVM, &cellGeometryFVM, NULL);CHKERRQ(ierr);
     ierr = VecGetArrayRead(faceGeometryFVM, (const PetscScalar **) &fgeomFVM);CHKERRQ(ierr);
@@ -4552,9 +4846,29 @@ PetscErrorCode DMPlexComputeResidual_Internal(DM dm, IS cellIS, PetscReal time,
       ierr = PetscArrayzero(fluxL, numFaces*totDim);CHKERRQ(ierr);
       ierr = PetscArrayzero(fluxR, numFaces*totDim);CHKERRQ(ierr);
     }
+    /* Apply cached element matrices, elemVec = K u + F(0) */
+    if (elemCache) {
+      const PetscInt N = totDim;
+
+      for (c = 0; c < numCells; ++c) {
+        const PetscScalar *K  = &elemCache->elemMat[(cS-cStart+c)*N*N];
+        const PetscScalar *f0 = &elemCache->elemVec0[(cS-cStart+c)*N];
+        const PetscScalar *uc = &u[c*N];
+        PetscScalar       *fc = &elemVec[c*N];
+        PetscInt           i, j;
+
+        for (i = 0; i < N; ++i) {
+          PetscScalar sum = f0[i];
+
+          for (j = 0; j < N; ++j) sum += K[i*N+j]*uc[j];
+          fc[i] = sum;
+        }
+      }
+      ierr = PetscLogFlops(2.0*numCells*totDim*totDim);CHKERRQ(ierr);
+    }
     /* TODO We will interlace both our field coefficients (u, u_t, uL, uR, etc.) and our output (elemVec, fL, fR). I think this works */
     /* Loop over fields */
-    for (f = 0; f < Nf; ++f) {
+    for (f = 0; f < Nf && !elemCache; ++f) {
       PetscObject  obj;
       PetscClassId id;
       PetscBool    fimp;
@@ -4600,19 +4914,7 @@ PetscErrorCode DMPlexComputeResidual_Internal(DM dm, IS cellIS, PetscReal time,
     /* Loop over domain */
     if (useFEM) {
       /* Add elemVec to locX */
-      for (c = cS; c < cE; ++c) {
-        const PetscInt cell = cells ? cells[c] : c;
-        const PetscInt cind = c - cStart;
-
-        if (mesh->printFEM > 1) {ierr = DMPrintCellVector(cell, name, totDim, &elemVec[cind*totDim]);CHKERRQ(ierr);}
-        if (ghostLabel) {
-          PetscInt ghostVal;
-
-          ierr = DMLabelGetValue(ghostLabel,cell,&ghostVal);CHKERRQ(ierr);
-          if (ghostVal > 0) continue;
-        }
-        ierr = DMPlexVecSetClosure(dm, section, locF, cell, &elemVec[cind*totDim], ADD_ALL_VALUES);CHKERRQ(ierr);
-      }
+      ierr = DMPlexAddCellVectors_Private(dm, section, ghostLabel, name, cells, cStart, cS, cE, totDim, elemVec, locF);CHKERRQ(ierr);
     }
     if (useFVM) {
       PetscScalar *fa;
@@ -5153,6 +5455,7 @@ PetscErrorCode DMPlexComputeJacobian_Internal(DM dm, IS cellIS, PetscReal t, Pet
   ierr = DMHasBasisTransform(dm, &transform);CHKERRQ(ierr);
   ierr = DMGetBasisTransformDM_Internal(dm, &tdm);CHKERRQ(ierr);
   ierr = DMGetBasisTransformVec_Internal(dm, &tv);CHKERRQ(ierr);
+  ierr = DMPlexSetUpClosureDofCache_Internal(dm);CHKERRQ(ierr);
   ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
   ierr = PetscObjectTypeCompare((PetscObject) JacP, MATIS, &isMatISP);CHKERRQ(ierr);
   ierr = DMGetGlobalSection(dm, &globalSection);CHKERRQ(ierr);
@@ -5292,7 +5595,7 @@ PetscErrorCode DMPlexComputeJacobian_Internal(DM dm, IS cellIS, PetscReal t, Pet
     /* No allocated space for FV stuff, so ignore the zero entries */
     ierr = MatSetOption(JacP, MAT_IGNORE_ZERO_ENTRIES, PETSC_TRUE);CHKERRQ(ierr);
   }
-  /* Insert values into matrix */
+  /* Insert values into matrix, serially since MatSetValues() is not thread safe */
   isMatIS = PETSC_FALSE;
   if (hasPrec && hasJac) {
     ierr = PetscObjectTypeCompare((PetscObject) JacP, MATIS, &isMatIS);CHKERRQ(ierr);
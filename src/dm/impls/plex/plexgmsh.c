@@ -199,8 +199,54 @@ typedef struct {
   PetscInt     nodeStart;
   PetscInt     nodeEnd;
   PetscInt    *nodeMap;
+  PetscBool    chunk;      /* Keep only the share of this process of the nodes and elements */
+  PetscMPIInt  rank;
+  PetscMPIInt  size;
+  PetscInt     vStart;     /* The nodes kept have tags in [nodeStart+vStart, nodeStart+vEnd) */
+  PetscInt     vEnd;
 } GmshFile;
 
+/* The share [start,end) of this process of count items, all of them unless reading in parallel */
+static PetscErrorCode GmshChunkRange(GmshFile *gmsh, PetscInt count, PetscInt *start, PetscInt *end)
+{
+  PetscFunctionBegin;
+  if (!gmsh->chunk) {*start = 0; *end = count; PetscFunctionReturn(0);}
+  *start = gmsh->rank*(count/gmsh->size) + PetscMin(gmsh->rank, count%gmsh->size);
+  *end   = *start + count/gmsh->size + (gmsh->rank < count%gmsh->size ? 1 : 0);
+  PetscFunctionReturn(0);
+}
+
+/* Sets up the nodes kept when reading in parallel, whose tags must then be tagStart, ..., tagStart+count-1 */
+static PetscErrorCode GmshNodesChunkSetUp(GmshFile *gmsh, PetscInt count, PetscInt tagStart, PetscInt *numLocal)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = GmshChunkRange(gmsh, count, &gmsh->vStart, &gmsh->vEnd);CHKERRQ(ierr);
+  if (gmsh->chunk) {
+    gmsh->nodeStart = tagStart;
+    gmsh->nodeEnd   = tagStart+count;
+  }
+  *numLocal = gmsh->vEnd - gmsh->vStart;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode GmshNodeKeep(GmshFile *gmsh, PetscInt tag, PetscBool *keep)
+{
+  PetscFunctionBegin;
+  *keep = PETSC_TRUE;
+  if (!gmsh->chunk) PetscFunctionReturn(0);
+  if (tag < gmsh->nodeStart || tag >= gmsh->nodeEnd) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_SUP, "Node tag %D out of [%D, %D): reading in parallel needs contiguous node tags", tag, gmsh->nodeStart, gmsh->nodeEnd);
+  *keep = (tag >= gmsh->nodeStart+gmsh->vStart && tag < gmsh->nodeStart+gmsh->vEnd) ? PETSC_TRUE : PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/* The index of a node, the global vertex number when reading in parallel */
+PETSC_STATIC_INLINE PetscInt GmshNodeIndex(GmshFile *gmsh, PetscInt tag)
+{
+  return gmsh->nodeMap ? gmsh->nodeMap[tag] : tag - gmsh->nodeStart;
+}
+
 static PetscErrorCode GmshBufferGet(GmshFile *gmsh, size_t count, size_t eltsize, void *buf)
 {
   size_t         size = count * eltsize;
@@ -509,6 +555,9 @@ static PetscErrorCode GmshReadNodes_v22(GmshFile *gmsh, GmshMesh *mesh)
   PetscBool      byteSwap = gmsh->byteSwap;
   char           line[PETSC_MAX_PATH_LEN];
   int            n, num, nid, snum;
+  PetscInt       numLocal, k;
+  double         xyz[3];
+  PetscBool      keep;
   GmshNodes      *nodes;
   PetscErrorCode ierr;
 
@@ -516,17 +565,22 @@ static PetscErrorCode GmshReadNodes_v22(GmshFile *gmsh, GmshMesh *mesh)
   ierr = PetscViewerRead(viewer, line, 1, NULL, PETSC_STRING);CHKERRQ(ierr);
   snum = sscanf(line, "%d", &num);
   if (snum != 1) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED, "File is not a valid Gmsh file");
-  ierr = GmshNodesCreate(num, &nodes);CHKERRQ(ierr);
-  mesh->numNodes = num;
+  ierr = GmshNodesChunkSetUp(gmsh, num, 1, &numLocal);CHKERRQ(ierr);
+  ierr = GmshNodesCreate(numLocal, &nodes);CHKERRQ(ierr);
+  mesh->numNodes = numLocal;
   mesh->nodelist = nodes;
-  for (n = 0; n < num; ++n) {
-    double *xyz = nodes->xyz + n*3;
+  for (n = 0, k = 0; n < num; ++n) {
     ierr = PetscViewerRead(viewer, &nid, 1, NULL, PETSC_ENUM);CHKERRQ(ierr);
     ierr = PetscViewerRead(viewer, xyz, 3, NULL, PETSC_DOUBLE);CHKERRQ(ierr);
     if (byteSwap) {ierr = PetscByteSwap(&nid, PETSC_ENUM, 1);CHKERRQ(ierr);}
     if (byteSwap) {ierr = PetscByteSwap(xyz, PETSC_DOUBLE, 3);CHKERRQ(ierr);}
-    nodes->id[n] = nid;
+    ierr = GmshNodeKeep(gmsh, nid, &keep);CHKERRQ(ierr);
+    if (!keep) continue;
+    if (k == numLocal) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED, "Repeated node tag %d", nid);
+    ierr = PetscArraycpy(nodes->xyz + k*3, xyz, 3);CHKERRQ(ierr);
+    nodes->id[k++] = nid;
   }
+  if (k != numLocal) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED, "Read %D nodes, expected %D", k, numLocal);
   PetscFunctionReturn(0);
 }
 
@@ -542,16 +596,17 @@ static PetscErrorCode GmshReadElements_v22(GmshFile* gmsh, GmshMesh *mesh)
   char           line[PETSC_MAX_PATH_LEN];
   int            i, c, p, num, ibuf[1+4+1000], snum;
   int            cellType, numElem, numVerts, numNodes, numTags;
+  PetscInt       eStart, eEnd;
   GmshElement   *elements;
-  PetscInt      *nodeMap = gmsh->nodeMap;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   ierr = PetscViewerRead(viewer, line, 1, NULL, PETSC_STRING);CHKERRQ(ierr);
   snum = sscanf(line, "%d", &num);
   if (snum != 1) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED, "File is not a valid Gmsh file");
-  ierr = GmshElementsCreate(num, &elements);CHKERRQ(ierr);
-  mesh->numElems = num;
+  ierr = GmshChunkRange(gmsh, num, &eStart, &eEnd);CHKERRQ(ierr);
+  ierr = GmshElementsCreate(eEnd-eStart, &elements);CHKERRQ(ierr);
+  mesh->numElems = eEnd-eStart;
   mesh->elements = elements;
   for (c = 0; c < num;) {
     ierr = PetscViewerRead(viewer, ibuf, 3, NULL, PETSC_ENUM);CHKERRQ(ierr);
@@ -566,11 +621,12 @@ static PetscErrorCode GmshReadElements_v22(GmshFile* gmsh, GmshMesh *mesh)
     numNodes = GmshCellMap[cellType].numNodes;
 
     for (i = 0; i < numElem; ++i, ++c) {
-      GmshElement *element = elements + c;
+      GmshElement *element = elements + c - eStart;
       const int off = binary ? 0 : 1, nint = 1 + numTags + numNodes - off;
       const int *id = ibuf, *nodes = ibuf + 1 + numTags, *tags = ibuf + 1;
       ierr = PetscViewerRead(viewer, ibuf+off, nint, NULL, PETSC_ENUM);CHKERRQ(ierr);
       if (byteSwap) {ierr = PetscByteSwap(ibuf+off, PETSC_ENUM, nint);CHKERRQ(ierr);}
+      if (c < eStart || c >= eEnd) continue;
       element->id  = id[0];
       element->dim = GmshCellMap[cellType].dim;
       element->cellType = cellType;
@@ -578,7 +634,7 @@ static PetscErrorCode GmshReadElements_v22(GmshFile* gmsh, GmshMesh *mesh)
       element->numNodes = numNodes;
       element->numTags  = PetscMin(numTags, 4);
       ierr = PetscSegBufferGet(mesh->segbuf, (size_t)element->numNodes, &element->nodes);CHKERRQ(ierr);
-      for (p = 0; p < element->numNodes; p++) element->nodes[p] = nodeMap[nodes[p]];
+      for (p = 0; p < element->numNodes; p++) element->nodes[p] = GmshNodeIndex(gmsh, nodes[p]);
       for (p = 0; p < element->numTags;  p++) element->tags[p]  = tags[p];
     }
   }
@@ -667,8 +723,11 @@ static PetscErrorCode GmshReadNodes_v40(GmshFile *gmsh, GmshMesh *mesh)
 {
   PetscViewer    viewer = gmsh->viewer;
   PetscBool      byteSwap = gmsh->byteSwap;
-  long           block, node, n, numEntityBlocks, numTotalNodes, numNodes;
+  long           block, node, piece, numEntityBlocks, numTotalNodes, numNodes, numPiece;
   int            info[3], nid;
+  PetscInt       numLocal, k = 0;
+  double         xyz[3];
+  PetscBool      keep;
   GmshNodes      *nodes;
   PetscErrorCode ierr;
 
@@ -677,40 +736,46 @@ static PetscErrorCode GmshReadNodes_v40(GmshFile *gmsh, GmshMesh *mesh)
   if (byteSwap) {ierr = PetscByteSwap(&numEntityBlocks, PETSC_LONG, 1);CHKERRQ(ierr);}
   ierr = PetscViewerRead(viewer, &numTotalNodes, 1, NULL, PETSC_LONG);CHKERRQ(ierr);
   if (byteSwap) {ierr = PetscByteSwap(&numTotalNodes, PETSC_LONG, 1);CHKERRQ(ierr);}
-  ierr = GmshNodesCreate(numTotalNodes, &nodes);CHKERRQ(ierr);
-  mesh->numNodes = numTotalNodes;
+  ierr = GmshNodesChunkSetUp(gmsh, numTotalNodes, 1, &numLocal);CHKERRQ(ierr);
+  ierr = GmshNodesCreate(numLocal, &nodes);CHKERRQ(ierr);
+  mesh->numNodes = numLocal;
   mesh->nodelist = nodes;
-  for (n = 0, block = 0; block < numEntityBlocks; ++block) {
+  for (block = 0; block < numEntityBlocks; ++block) {
     ierr = PetscViewerRead(viewer, info, 3, NULL, PETSC_ENUM);CHKERRQ(ierr);
     ierr = PetscViewerRead(viewer, &numNodes, 1, NULL, PETSC_LONG);CHKERRQ(ierr);
     if (byteSwap) {ierr = PetscByteSwap(&numNodes, PETSC_LONG, 1);CHKERRQ(ierr);}
-    if (gmsh->binary) {
+    /* Binary nodes are read in pieces, so that the buffer does not grow with the size of the block */
+    for (piece = 0; piece < numNodes; piece += numPiece) {
       size_t nbytes = sizeof(int) + 3*sizeof(double);
       char   *cbuf = NULL; /* dummy value to prevent warning from compiler about possible unitilized value */
-      ierr = GmshBufferGet(gmsh, numNodes, nbytes, &cbuf);CHKERRQ(ierr);
-      ierr = PetscViewerRead(viewer, cbuf, numNodes*nbytes, NULL, PETSC_CHAR);CHKERRQ(ierr);
-      for (node = 0; node < numNodes; ++node, ++n) {
-        char   *cnid = cbuf + node*nbytes, *cxyz = cnid + sizeof(int);
-        double *xyz = nodes->xyz + n*3;
-        if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(cnid, PETSC_ENUM, 1);CHKERRQ(ierr);}
-        if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(cxyz, PETSC_DOUBLE, 3);CHKERRQ(ierr);}
-        ierr = PetscMemcpy(&nid, cnid, sizeof(int));CHKERRQ(ierr);
-        ierr = PetscMemcpy(xyz, cxyz, 3*sizeof(double));CHKERRQ(ierr);
-        if (byteSwap) {ierr = PetscByteSwap(&nid, PETSC_ENUM, 1);CHKERRQ(ierr);}
-        if (byteSwap) {ierr = PetscByteSwap(xyz, PETSC_DOUBLE, 3);CHKERRQ(ierr);}
-        nodes->id[n] = nid;
+
+      numPiece = gmsh->binary ? PetscMin(numNodes-piece, 1024) : 1;
+      if (gmsh->binary) {
+        ierr = GmshBufferGet(gmsh, numPiece, nbytes, &cbuf);CHKERRQ(ierr);
+        ierr = PetscViewerRead(viewer, cbuf, numPiece*nbytes, NULL, PETSC_CHAR);CHKERRQ(ierr);
       }
-    } else {
-      for (node = 0; node < numNodes; ++node, ++n) {
-        double *xyz = nodes->xyz + n*3;
-        ierr = PetscViewerRead(viewer, &nid, 1, NULL, PETSC_ENUM);CHKERRQ(ierr);
-        ierr = PetscViewerRead(viewer, xyz, 3, NULL, PETSC_DOUBLE);CHKERRQ(ierr);
+      for (node = 0; node < numPiece; ++node) {
+        if (gmsh->binary) {
+          char *cnid = cbuf + node*nbytes, *cxyz = cnid + sizeof(int);
+          if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(cnid, PETSC_ENUM, 1);CHKERRQ(ierr);}
+          if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(cxyz, PETSC_DOUBLE, 3);CHKERRQ(ierr);}
+          ierr = PetscMemcpy(&nid, cnid, sizeof(int));CHKERRQ(ierr);
+          ierr = PetscMemcpy(xyz, cxyz, 3*sizeof(double));CHKERRQ(ierr);
+        } else {
+          ierr = PetscViewerRead(viewer, &nid, 1, NULL, PETSC_ENUM);CHKERRQ(ierr);
+          ierr = PetscViewerRead(viewer, xyz, 3, NULL, PETSC_DOUBLE);CHKERRQ(ierr);
+        }
         if (byteSwap) {ierr = PetscByteSwap(&nid, PETSC_ENUM, 1);CHKERRQ(ierr);}
         if (byteSwap) {ierr = PetscByteSwap(xyz, PETSC_DOUBLE, 3);CHKERRQ(ierr);}
-        nodes->id[n] = nid;
+        ierr = GmshNodeKeep(gmsh, nid, &keep);CHKERRQ(ierr);
+        if (!keep) continue;
+        if (k == numLocal) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED, "Repeated node tag %d", nid);
+        ierr = PetscArraycpy(nodes->xyz + k*3, xyz, 3);CHKERRQ(ierr);
+        nodes->id[k++] = nid;
       }
     }
   }
+  if (k != numLocal) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED, "Read %D nodes, expected %D", k, numLocal);
   PetscFunctionReturn(0);
 }
 
@@ -727,12 +792,12 @@ static PetscErrorCode GmshReadElements_v40(GmshFile *gmsh, GmshMesh *mesh)
 {
   PetscViewer    viewer = gmsh->viewer;
   PetscBool      byteSwap = gmsh->byteSwap;
-  long           c, block, numEntityBlocks, numTotalElements, elem, numElements;
+  long           c, block, numEntityBlocks, numTotalElements, elem, piece, numElements, numPiece;
   int            p, info[3], *ibuf = NULL;
   int            eid, dim, cellType, numVerts, numNodes, numTags;
+  PetscInt       eStart, eEnd;
   GmshEntity     *entity = NULL;
   GmshElement    *elements;
-  PetscInt       *nodeMap = gmsh->nodeMap;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -740,8 +805,9 @@ static PetscErrorCode GmshReadElements_v40(GmshFile *gmsh, GmshMesh *mesh)
   if (byteSwap) {ierr = PetscByteSwap(&numEntityBlocks, PETSC_LONG, 1);CHKERRQ(ierr);}
   ierr = PetscViewerRead(viewer, &numTotalElements, 1, NULL, PETSC_LONG);CHKERRQ(ierr);
   if (byteSwap) {ierr = PetscByteSwap(&numTotalElements, PETSC_LONG, 1);CHKERRQ(ierr);}
-  ierr = GmshElementsCreate(numTotalElements, &elements);CHKERRQ(ierr);
-  mesh->numElems = numTotalElements;
+  ierr = GmshChunkRange(gmsh, numTotalElements, &eStart, &eEnd);CHKERRQ(ierr);
+  ierr = GmshElementsCreate(eEnd-eStart, &elements);CHKERRQ(ierr);
+  mesh->numElems = eEnd-eStart;
   mesh->elements = elements;
   for (c = 0, block = 0; block < numEntityBlocks; ++block) {
     ierr = PetscViewerRead(viewer, info, 3, NULL, PETSC_ENUM);CHKERRQ(ierr);
@@ -754,21 +820,25 @@ static PetscErrorCode GmshReadElements_v40(GmshFile *gmsh, GmshMesh *mesh)
     numTags  = entity->numTags;
     ierr = PetscViewerRead(viewer, &numElements, 1, NULL, PETSC_LONG);CHKERRQ(ierr);
     if (byteSwap) {ierr = PetscByteSwap(&numElements, PETSC_LONG, 1);CHKERRQ(ierr);}
-    ierr = GmshBufferGet(gmsh, (1+numNodes)*numElements, sizeof(int), &ibuf);CHKERRQ(ierr);
-    ierr = PetscViewerRead(viewer, ibuf, (1+numNodes)*numElements, NULL, PETSC_ENUM);CHKERRQ(ierr);
-    if (byteSwap) {ierr = PetscByteSwap(ibuf, PETSC_ENUM, (1+numNodes)*numElements);CHKERRQ(ierr);}
-    for (elem = 0; elem < numElements; ++elem, ++c) {
-      GmshElement *element = elements + c;
-      const int *id = ibuf + elem*(1+numNodes), *nodes = id + 1;
-      element->id  = id[0];
-      element->dim = dim;
-      element->cellType = cellType;
-      element->numVerts = numVerts;
-      element->numNodes = numNodes;
-      element->numTags  = numTags;
-      ierr = PetscSegBufferGet(mesh->segbuf, (size_t)element->numNodes, &element->nodes);CHKERRQ(ierr);
-      for (p = 0; p < element->numNodes; p++) element->nodes[p] = nodeMap[nodes[p]];
-      for (p = 0; p < element->numTags;  p++) element->tags[p]  = entity->tags[p];
+    for (piece = 0; piece < numElements; piece += numPiece) {
+      numPiece = PetscMin(numElements-piece, 1024);
+      ierr = GmshBufferGet(gmsh, (1+numNodes)*numPiece, sizeof(int), &ibuf);CHKERRQ(ierr);
+      ierr = PetscViewerRead(viewer, ibuf, (1+numNodes)*numPiece, NULL, PETSC_ENUM);CHKERRQ(ierr);
+      if (byteSwap) {ierr = PetscByteSwap(ibuf, PETSC_ENUM, (1+numNodes)*numPiece);CHKERRQ(ierr);}
+      for (elem = 0; elem < numPiece; ++elem, ++c) {
+        GmshElement *element = elements + c - eStart;
+        const int *id = ibuf + elem*(1+numNodes), *nodes = id + 1;
+        if (c < eStart || c >= eEnd) continue;
+        element->id  = id[0];
+        element->dim = dim;
+        element->cellType = cellType;
+        element->numVerts = numVerts;
+        element->numNodes = numNodes;
+        element->numTags  = numTags;
+        ierr = PetscSegBufferGet(mesh->segbuf, (size_t)element->numNodes, &element->nodes);CHKERRQ(ierr);
+        for (p = 0; p < element->numNodes; p++) element->nodes[p] = GmshNodeIndex(gmsh, nodes[p]);
+        for (p = 0; p < element->numTags;  p++) element->tags[p]  = entity->tags[p];
+      }
     }
   }
   PetscFunctionReturn(0);
@@ -917,23 +987,55 @@ $EndNodes
 static PetscErrorCode GmshReadNodes_v41(GmshFile *gmsh, GmshMesh *mesh)
 {
   int            info[3];
-  PetscInt       sizes[4], numEntityBlocks, numNodes, numNodesBlock = 0, block, node;
+  PetscInt       sizes[4], numEntityBlocks, numNodes, numNodesBlock = 0, numLocal, numPiece, block, node, piece, k, n, *pos = NULL, *tags = NULL;
+  double         *xyz = NULL;
+  PetscBool      keep;
   GmshNodes      *nodes;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   ierr = GmshReadSize(gmsh, sizes, 4);CHKERRQ(ierr);
   numEntityBlocks = sizes[0]; numNodes = sizes[1];
-  ierr = GmshNodesCreate(numNodes, &nodes);CHKERRQ(ierr);
-  mesh->numNodes = numNodes;
+  if (gmsh->chunk && sizes[3]-sizes[2]+1 != numNodes) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_SUP, "Node tags [%D, %D] are not contiguous for %D nodes: cannot read in parallel", sizes[2], sizes[3], numNodes);
+  ierr = GmshNodesChunkSetUp(gmsh, numNodes, sizes[2], &numLocal);CHKERRQ(ierr);
+  ierr = GmshNodesCreate(numLocal, &nodes);CHKERRQ(ierr);
+  mesh->numNodes = numLocal;
   mesh->nodelist = nodes;
-  for (block = 0, node = 0; block < numEntityBlocks; ++block, node += numNodesBlock) {
+  if (gmsh->chunk) {ierr = PetscMalloc1(numLocal, &pos);CHKERRQ(ierr);}
+  for (block = 0, node = 0; block < numEntityBlocks; ++block) {
     ierr = GmshReadInt(gmsh, info, 3);CHKERRQ(ierr);
     if (info[2] != 0) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "Parametric coordinates not supported");
     ierr = GmshReadSize(gmsh, &numNodesBlock, 1);CHKERRQ(ierr);
-    ierr = GmshReadSize(gmsh, nodes->id+node, numNodesBlock);CHKERRQ(ierr);
-    ierr = GmshReadDouble(gmsh, nodes->xyz+node*3, numNodesBlock*3);CHKERRQ(ierr);
+    if (!gmsh->chunk) {
+      ierr = GmshReadSize(gmsh, nodes->id+node, numNodesBlock);CHKERRQ(ierr);
+      ierr = GmshReadDouble(gmsh, nodes->xyz+node*3, numNodesBlock*3);CHKERRQ(ierr);
+      node += numNodesBlock;
+      continue;
+    }
+    /* The tags of the block, then their coordinates, read in pieces and keeping the positions in the block of the nodes kept */
+    for (piece = 0, k = node; piece < numNodesBlock; piece += numPiece) {
+      numPiece = PetscMin(numNodesBlock-piece, 1024);
+      ierr = GmshBufferGet(gmsh, numPiece, sizeof(PetscInt), &tags);CHKERRQ(ierr);
+      ierr = GmshReadSize(gmsh, tags, numPiece);CHKERRQ(ierr);
+      for (n = 0; n < numPiece; ++n) {
+        ierr = GmshNodeKeep(gmsh, tags[n], &keep);CHKERRQ(ierr);
+        if (!keep) continue;
+        if (k == numLocal) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED, "Repeated node tag %D", tags[n]);
+        nodes->id[k] = tags[n];
+        pos[k++]     = piece+n;
+      }
+    }
+    for (piece = 0; piece < numNodesBlock; piece += numPiece) {
+      numPiece = PetscMin(numNodesBlock-piece, 1024);
+      ierr = GmshBufferGet(gmsh, 3*numPiece, sizeof(double), &xyz);CHKERRQ(ierr);
+      ierr = GmshReadDouble(gmsh, xyz, 3*numPiece);CHKERRQ(ierr);
+      for (; node < k && pos[node] < piece+numPiece; ++node) {
+        ierr = PetscArraycpy(nodes->xyz+node*3, xyz+(pos[node]-piece)*3, 3);CHKERRQ(ierr);
+      }
+    }
   }
+  if (node != numLocal) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED, "Read %D nodes, expected %D", node, numLocal);
+  ierr = PetscFree(pos);CHKERRQ(ierr);
   gmsh->nodeStart = sizes[2];
   gmsh->nodeEnd   = sizes[3]+1;
   PetscFunctionReturn(0);
@@ -952,17 +1054,18 @@ $EndElements
 static PetscErrorCode GmshReadElements_v41(GmshFile *gmsh, GmshMesh *mesh)
 {
   int            info[3], eid, dim, cellType;
-  PetscInt       sizes[4], *ibuf = NULL, numEntityBlocks, numElements, numBlockElements, numVerts, numNodes, numTags, block, elem, c, p;
+  PetscInt       sizes[4], *ibuf = NULL, numEntityBlocks, numElements, numBlockElements, numPiece, numVerts, numNodes, numTags, block, piece, elem, c, p;
+  PetscInt       eStart, eEnd;
   GmshEntity     *entity = NULL;
   GmshElement    *elements;
-  PetscInt       *nodeMap = gmsh->nodeMap;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   ierr = GmshReadSize(gmsh, sizes, 4);CHKERRQ(ierr);
   numEntityBlocks = sizes[0]; numElements = sizes[1];
-  ierr = GmshElementsCreate(numElements, &elements);CHKERRQ(ierr);
-  mesh->numElems = numElements;
+  ierr = GmshChunkRange(gmsh, numElements, &eStart, &eEnd);CHKERRQ(ierr);
+  ierr = GmshElementsCreate(eEnd-eStart, &elements);CHKERRQ(ierr);
+  mesh->numElems = eEnd-eStart;
   mesh->elements = elements;
   for (c = 0, block = 0; block < numEntityBlocks; ++block) {
     ierr = GmshReadInt(gmsh, info, 3);CHKERRQ(ierr);
@@ -973,20 +1076,24 @@ static PetscErrorCode GmshReadElements_v41(GmshFile *gmsh, GmshMesh *mesh)
     numNodes = GmshCellMap[cellType].numNodes;
     numTags  = entity->numTags;
     ierr = GmshReadSize(gmsh, &numBlockElements, 1);CHKERRQ(ierr);
-    ierr = GmshBufferGet(gmsh, (1+numNodes)*numBlockElements, sizeof(PetscInt), &ibuf);CHKERRQ(ierr);
-    ierr = GmshReadSize(gmsh, ibuf, (1+numNodes)*numBlockElements);CHKERRQ(ierr);
-    for (elem = 0; elem < numBlockElements; ++elem, ++c) {
-      GmshElement *element = elements + c;
-      const PetscInt *id = ibuf + elem*(1+numNodes), *nodes = id + 1;
-      element->id  = id[0];
-      element->dim = dim;
-      element->cellType = cellType;
-      element->numVerts = numVerts;
-      element->numNodes = numNodes;
-      element->numTags  = numTags;
-      ierr = PetscSegBufferGet(mesh->segbuf, (size_t)element->numNodes, &element->nodes);CHKERRQ(ierr);
-      for (p = 0; p < element->numNodes; p++) element->nodes[p] = nodeMap[nodes[p]];
-      for (p = 0; p < element->numTags;  p++) element->tags[p]  = entity->tags[p];
+    for (piece = 0; piece < numBlockElements; piece += numPiece) {
+      numPiece = PetscMin(numBlockElements-piece, 1024);
+      ierr = GmshBufferGet(gmsh, (1+numNodes)*numPiece, sizeof(PetscInt), &ibuf);CHKERRQ(ierr);
+      ierr = GmshReadSize(gmsh, ibuf, (1+numNodes)*numPiece);CHKERRQ(ierr);
+      for (elem = 0; elem < numPiece; ++elem, ++c) {
+        GmshElement *element = elements + c - eStart;
+        const PetscInt *id = ibuf + elem*(1+numNodes), *nodes = id + 1;
+        if (c < eStart || c >= eEnd) continue;
+        element->id  = id[0];
+        element->dim = dim;
+        element->cellType = cellType;
+        element->numVerts = numVerts;
+        element->numNodes = numNodes;
+        element->numTags  = numTags;
+        ierr = PetscSegBufferGet(mesh->segbuf, (size_t)element->numNodes, &element->nodes);CHKERRQ(ierr);
+        for (p = 0; p < element->numNodes; p++) element->nodes[p] = GmshNodeIndex(gmsh, nodes[p]);
+        for (p = 0; p < element->numTags;  p++) element->tags[p]  = entity->tags[p];
+      }
     }
   }
   PetscFunctionReturn(0);
@@ -1123,6 +1230,7 @@ static PetscErrorCode GmshReadNodes(GmshFile *gmsh, GmshMesh *mesh)
   case 40: ierr = GmshReadNodes_v40(gmsh, mesh);CHKERRQ(ierr); break;
   default: ierr = GmshReadNodes_v22(gmsh, mesh);CHKERRQ(ierr); break;
   }
+  if (gmsh->chunk) PetscFunctionReturn(0); /* node tags are then contiguous and give the vertex numbers */
 
   { /* Gmsh v2.2/v4.0 does not provide min/max node tags */
     if (mesh->numNodes > 0 && gmsh->nodeEnd >= gmsh->nodeStart) {
@@ -1196,6 +1304,7 @@ static PetscErrorCode GmshReadElements(GmshFile *gmsh, GmshMesh *mesh)
     mesh->dim   = elem ? GmshCellMap[elem->cellType].dim   : 0;
     mesh->order = elem ? GmshCellMap[elem->cellType].order : 0;
   }
+  if (gmsh->chunk) PetscFunctionReturn(0); /* the cells and vertices are then numbered globally */
 
   {
     PetscBT  vtx;
@@ -1350,6 +1459,70 @@ static PetscErrorCode GmshCreateFE(MPI_Comm comm, const char prefix[], PetscBool
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode GmshReadMesh(GmshFile *gmsh, PetscBool *periodic, GmshMesh **mesh)
+{
+  char           line[PETSC_MAX_PATH_LEN];
+  PetscBool      match;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = GmshMeshCreate(mesh);CHKERRQ(ierr);
+
+  /* Read mesh format */
+  ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
+  ierr = GmshExpect(gmsh, "$MeshFormat", line);CHKERRQ(ierr);
+  ierr = GmshReadMeshFormat(gmsh);CHKERRQ(ierr);
+  ierr = GmshReadEndSection(gmsh, "$EndMeshFormat", line);CHKERRQ(ierr);
+
+  /* OPTIONAL Read physical names */
+  ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
+  ierr = GmshMatch(gmsh, "$PhysicalNames", line, &match);CHKERRQ(ierr);
+  if (match) {
+    ierr = GmshExpect(gmsh, "$PhysicalNames", line);CHKERRQ(ierr);
+    ierr = GmshReadPhysicalNames(gmsh);CHKERRQ(ierr);
+    ierr = GmshReadEndSection(gmsh, "$EndPhysicalNames", line);CHKERRQ(ierr);
+    /* Initial read for entity section */
+    ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
+  }
+
+  /* Read entities */
+  if (gmsh->fileFormat >= 40) {
+    ierr = GmshExpect(gmsh, "$Entities", line);CHKERRQ(ierr);
+    ierr = GmshReadEntities(gmsh, *mesh);CHKERRQ(ierr);
+    ierr = GmshReadEndSection(gmsh, "$EndEntities", line);CHKERRQ(ierr);
+    /* Initial read for nodes section */
+    ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
+  }
+
+  /* Read nodes */
+  ierr = GmshExpect(gmsh, "$Nodes", line);CHKERRQ(ierr);
+  ierr = GmshReadNodes(gmsh, *mesh);CHKERRQ(ierr);
+  ierr = GmshReadEndSection(gmsh, "$EndNodes", line);CHKERRQ(ierr);
+
+  /* Read elements */
+  ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
+  ierr = GmshExpect(gmsh, "$Elements", line);CHKERRQ(ierr);
+  ierr = GmshReadElements(gmsh, *mesh);CHKERRQ(ierr);
+  ierr = GmshReadEndSection(gmsh, "$EndElements", line);CHKERRQ(ierr);
+
+  /* Read periodic section (OPTIONAL) */
+  if (*periodic) {
+    ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
+    ierr = GmshMatch(gmsh, "$Periodic", line, periodic);CHKERRQ(ierr);
+  }
+  if (*periodic) {
+    if (gmsh->chunk) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "Periodic Gmsh meshes cannot be read in parallel, use -dm_plex_gmsh_periodic 0 to ignore the periodicity");
+    ierr = GmshExpect(gmsh, "$Periodic", line);CHKERRQ(ierr);
+    ierr = GmshReadPeriodic(gmsh, *mesh);CHKERRQ(ierr);
+    ierr = GmshReadEndSection(gmsh, "$EndPeriodic", line);CHKERRQ(ierr);
+  }
+
+  ierr = PetscFree(gmsh->wbuf);CHKERRQ(ierr);
+  ierr = PetscFree(gmsh->sbuf);CHKERRQ(ierr);
+  ierr = PetscFree(gmsh->nbuf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
   DMPlexCreateGmshFromFile - Create a DMPlex mesh from a Gmsh file
 
@@ -1411,6 +1584,296 @@ PetscErrorCode DMPlexCreateGmshFromFile(MPI_Comm comm, const char filename[], Pe
   PetscFunctionReturn(0);
 }
 
+/* The star forest sending each of the n items to the owner in the layout of its global index key[i] */
+static PetscErrorCode GmshOwnerSFCreate(PetscLayout layout, PetscInt n, const PetscInt key[], PetscSF *sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFCreate(layout->comm, sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraphLayout(*sf, layout, n, NULL, PETSC_COPY_VALUES, key);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(*sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Face Sets of a distributed mesh: the facet elements read by this process, given as {numVerts, sorted global vertices
+   padded with -1, tag}, are sent to the owner of their first vertex, where the faces of all processes sent there the
+   same way pick up their tags */
+static PetscErrorCode GmshFaceSetsParallel(DM dm, PetscLayout vlayout, PetscSF sfVert, PetscInt numRecs, const PetscInt recs[])
+{
+  PetscSF            sfR, sfQ;
+  MPI_Datatype       rtype;
+  const PetscSFNode *iremote;
+  const PetscInt    *degR, *degQ;
+  PetscInt          *keys, *qrys, *tagQ, *multiR, *multiQ, *tagMQ;
+  PetscInt           fStart, fEnd, vStart, vEnd, numRoots, numQrys, nR, nQ, offR, offQ, f, r, q, i, k;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFGetGraph(sfVert, NULL, NULL, NULL, &iremote);CHKERRQ(ierr);
+  ierr = DMPlexGetHeightStratum(dm, 1, &fStart, &fEnd);CHKERRQ(ierr);
+  ierr = DMPlexGetDepthStratum(dm, 0, &vStart, &vEnd);CHKERRQ(ierr);
+  numQrys = fEnd - fStart;
+  ierr = PetscMalloc3(PetscMax(numRecs, numQrys), &keys, numQrys*6, &qrys, numQrys, &tagQ);CHKERRQ(ierr);
+  for (f = fStart; f < fEnd; ++f) {
+    PetscInt *closure = NULL, clSize, *qry = qrys + (f-fStart)*6, nv = 0;
+
+    ierr = DMPlexGetTransitiveClosure(dm, f, PETSC_TRUE, &clSize, &closure);CHKERRQ(ierr);
+    for (i = 0; i < 2*clSize; i += 2) {
+      const PetscInt v = closure[i];
+      if (v < vStart || v >= vEnd) continue;
+      if (nv == 4) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Face %D has more than 4 vertices", f);
+      qry[1+nv++] = vlayout->range[iremote[v-vStart].rank] + iremote[v-vStart].index;
+    }
+    ierr = DMPlexRestoreTransitiveClosure(dm, f, PETSC_TRUE, &clSize, &closure);CHKERRQ(ierr);
+    ierr = PetscSortInt(nv, qry+1);CHKERRQ(ierr);
+    for (qry[0] = nv; nv < 4; ++nv) qry[1+nv] = -1;
+    qry[5] = PETSC_MIN_INT;
+  }
+
+  /* Send records and queries to the owners of their first vertex */
+  ierr = MPI_Type_contiguous(6, MPIU_INT, &rtype);CHKERRMPI(ierr);
+  ierr = MPI_Type_commit(&rtype);CHKERRMPI(ierr);
+  for (r = 0; r < numRecs; ++r) keys[r] = recs[r*6+1];
+  ierr = GmshOwnerSFCreate(vlayout, numRecs, keys, &sfR);CHKERRQ(ierr);
+  for (q = 0; q < numQrys; ++q) keys[q] = qrys[q*6+1];
+  ierr = GmshOwnerSFCreate(vlayout, numQrys, keys, &sfQ);CHKERRQ(ierr);
+  ierr = PetscSFGetGraph(sfR, &numRoots, NULL, NULL, NULL);CHKERRQ(ierr);
+  ierr = PetscSFComputeDegreeBegin(sfR, &degR);CHKERRQ(ierr);
+  ierr = PetscSFComputeDegreeEnd(sfR, &degR);CHKERRQ(ierr);
+  ierr = PetscSFComputeDegreeBegin(sfQ, &degQ);CHKERRQ(ierr);
+  ierr = PetscSFComputeDegreeEnd(sfQ, &degQ);CHKERRQ(ierr);
+  for (i = 0, nR = 0, nQ = 0; i < numRoots; ++i) {nR += degR[i]; nQ += degQ[i];}
+  ierr = PetscMalloc3(nR*6, &multiR, nQ*6, &multiQ, nQ, &tagMQ);CHKERRQ(ierr);
+  ierr = PetscSFGatherBegin(sfR, rtype, recs, multiR);CHKERRQ(ierr);
+  ierr = PetscSFGatherEnd(sfR, rtype, recs, multiR);CHKERRQ(ierr);
+  ierr = PetscSFGatherBegin(sfQ, rtype, qrys, multiQ);CHKERRQ(ierr);
+  ierr = PetscSFGatherEnd(sfQ, rtype, qrys, multiQ);CHKERRQ(ierr);
+
+  /* Match, for each owned vertex, the faces against the records sent to it */
+  for (i = 0, offR = 0, offQ = 0; i < numRoots; offR += degR[i], offQ += degQ[i], ++i) {
+    for (q = offQ; q < offQ+degQ[i]; ++q) {
+      tagMQ[q] = PETSC_MIN_INT;
+      for (r = offR; r < offR+degR[i]; ++r) {
+        for (k = 0; k < 5; ++k) if (multiQ[q*6+k] != multiR[r*6+k]) break;
+        if (k == 5) {tagMQ[q] = multiR[r*6+5]; break;}
+      }
+    }
+  }
+  ierr = PetscSFScatterBegin(sfQ, MPIU_INT, tagMQ, tagQ);CHKERRQ(ierr);
+  ierr = PetscSFScatterEnd(sfQ, MPIU_INT, tagMQ, tagQ);CHKERRQ(ierr);
+  for (f = fStart; f < fEnd; ++f) {
+    if (tagQ[f-fStart] == PETSC_MIN_INT) continue;
+    ierr = DMSetLabelValue(dm, "Face Sets", f, tagQ[f-fStart]);CHKERRQ(ierr);
+  }
+
+  ierr = MPI_Type_free(&rtype);CHKERRMPI(ierr);
+  ierr = PetscSFDestroy(&sfR);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sfQ);CHKERRQ(ierr);
+  ierr = PetscFree3(multiR, multiQ, tagMQ);CHKERRQ(ierr);
+  ierr = PetscFree3(keys, qrys, tagQ);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Every process reads the file, keeping only a contiguous share of the elements and of the nodes, so that the mesh
+   is never held whole by a single process. The topology is then built with the naive distribution of the cells. */
+static PetscErrorCode DMPlexCreateGmsh_Parallel(MPI_Comm comm, PetscViewer viewer, PetscBool interpolate, PetscBool periodic, PetscBool usemarker, PetscInt coordDim, DM *dm)
+{
+  GmshFile        gmsh[1];
+  GmshMesh       *mesh = NULL;
+  PetscViewerType vtype;
+  const char     *filename;
+  PetscLayout     vlayout;
+  PetscSF         sfVert, sfSets;
+  PetscInt        dim, order, numCells = 0, numCorners = 0, numVerts, numRecs, numVtxRecs, cellType[2], flg[4];
+  PetscInt        e, c, v, d, vStart, vEnd, numLeaves;
+  PetscInt       *cells, *recs;
+  PetscReal      *coords;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = DMCreate(comm, dm);CHKERRQ(ierr);
+  ierr = DMSetType(*dm, DMPLEX);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(DMPLEX_CreateGmsh,*dm,NULL,NULL,NULL);CHKERRQ(ierr);
+
+  /* Every process reads through the file on its own */
+  ierr = PetscArrayzero(gmsh,1);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERBINARY, &gmsh->binary);CHKERRQ(ierr);
+  ierr = PetscViewerGetType(viewer, &vtype);CHKERRQ(ierr);
+  ierr = PetscViewerFileGetName(viewer, &filename);CHKERRQ(ierr);
+  ierr = PetscViewerCreate(PETSC_COMM_SELF, &gmsh->viewer);CHKERRQ(ierr);
+  ierr = PetscViewerSetType(gmsh->viewer, vtype);CHKERRQ(ierr);
+  ierr = PetscViewerFileSetMode(gmsh->viewer, FILE_MODE_READ);CHKERRQ(ierr);
+  ierr = PetscViewerFileSetName(gmsh->viewer, filename);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm, &gmsh->rank);CHKERRMPI(ierr);
+  ierr = MPI_Comm_size(comm, &gmsh->size);CHKERRMPI(ierr);
+  gmsh->chunk = PETSC_TRUE;
+  ierr = GmshReadMesh(gmsh, &periodic, &mesh);CHKERRQ(ierr);
+  ierr = PetscViewerDestroy(&gmsh->viewer);CHKERRQ(ierr);
+
+  {
+    PetscInt buf[2];
+
+    buf[0] = mesh->dim;
+    buf[1] = mesh->order;
+    ierr = MPIU_Allreduce(MPI_IN_PLACE, buf, 2, MPIU_INT, MPI_MAX, comm);CHKERRQ(ierr);
+    dim   = buf[0];
+    order = buf[1];
+  }
+  if (!dim) SETERRQ(comm, PETSC_ERR_FILE_UNEXPECTED, "Gmsh file has no cells");
+  if (order > 1) SETERRQ1(comm, PETSC_ERR_SUP, "Reading Gmsh meshes of order %D in parallel is not supported", order);
+
+  /* The cells read by this process, which must all be of the same type */
+  cellType[0] = PETSC_MIN_INT; cellType[1] = PETSC_MIN_INT;
+  for (e = 0; e < mesh->numElems; ++e) {
+    GmshElement *elem = mesh->elements + e;
+    if (elem->dim != dim) continue;
+    numCells++;
+    cellType[0] = PetscMax(cellType[0], -elem->cellType);
+    cellType[1] = PetscMax(cellType[1],  elem->cellType);
+  }
+  ierr = MPIU_Allreduce(MPI_IN_PLACE, cellType, 2, MPIU_INT, MPI_MAX, comm);CHKERRQ(ierr);
+  if (-cellType[0] != cellType[1]) SETERRQ(comm, PETSC_ERR_SUP, "Reading hybrid Gmsh meshes in parallel is not supported");
+  numCorners = GmshCellMap[cellType[1]].numVerts;
+  ierr = PetscMalloc1(numCells*numCorners, &cells);CHKERRQ(ierr);
+  for (e = 0, c = 0; e < mesh->numElems; ++e) {
+    GmshElement *elem = mesh->elements + e;
+    if (elem->dim != dim) continue;
+    ierr = PetscArraycpy(cells + c*numCorners, elem->nodes, numCorners);CHKERRQ(ierr);
+    ierr = DMPlexInvertCell(DMPolytopeTypeFromGmsh(elem->cellType), cells + c*numCorners);CHKERRQ(ierr);
+    c++;
+  }
+
+  /* The coordinates of the vertices owned by this process, the nodes it kept */
+  numVerts = gmsh->vEnd - gmsh->vStart;
+  if (coordDim < 0) coordDim = dim;
+  ierr = PetscMalloc1(numVerts*coordDim, &coords);CHKERRQ(ierr);
+  for (v = 0; v < numVerts; ++v) {
+    const PetscInt n = mesh->nodelist->id[v] - gmsh->nodeStart - gmsh->vStart;
+    for (d = 0; d < coordDim; ++d) coords[n*coordDim+d] = (PetscReal) mesh->nodelist->xyz[v*3+d];
+  }
+
+  ierr = DMSetDimension(*dm, dim);CHKERRQ(ierr);
+  ierr = DMPlexBuildFromCellListParallel(*dm, numCells, numVerts, gmsh->nodeEnd - gmsh->nodeStart, numCorners, cells, &sfVert);CHKERRQ(ierr);
+  if (interpolate) {
+    DM idm;
+
+    ierr = DMPlexInterpolate(*dm, &idm);CHKERRQ(ierr);
+    ierr = DMDestroy(dm);CHKERRQ(ierr);
+    *dm  = idm;
+  }
+  ierr = DMPlexBuildCoordinatesFromCellListParallel(*dm, coordDim, sfVert, coords);CHKERRQ(ierr);
+  ierr = PetscFree(cells);CHKERRQ(ierr);
+  ierr = PetscFree(coords);CHKERRQ(ierr);
+
+  /* Labels: create them on every process if any process has values for them */
+  numRecs = numVtxRecs = 0;
+  flg[0] = flg[1] = flg[2] = 0;
+  for (e = 0; e < mesh->numElems; ++e) {
+    GmshElement *elem = mesh->elements + e;
+    if (elem->dim == dim && elem->numTags > 0) flg[0] = 1;
+    if (interpolate && elem->dim == dim-1) {flg[1] = 1; numRecs++;}
+    if (elem->dim == 0 && elem->numTags > 0) {flg[2] = 1; numVtxRecs++;}
+  }
+  flg[3] = usemarker ? 1 : 0;
+  ierr = MPIU_Allreduce(MPI_IN_PLACE, flg, 4, MPIU_INT, MPI_MAX, comm);CHKERRQ(ierr);
+  if (flg[0]) {ierr = DMCreateLabel(*dm, "Cell Sets");CHKERRQ(ierr);}
+  if (flg[1]) {ierr = DMCreateLabel(*dm, "Face Sets");CHKERRQ(ierr);}
+  if (flg[2]) {ierr = DMCreateLabel(*dm, "Vertex Sets");CHKERRQ(ierr);}
+  ierr = PetscLayoutCreate(comm, &vlayout);CHKERRQ(ierr);
+  ierr = PetscLayoutSetLocalSize(vlayout, numVerts);CHKERRQ(ierr);
+  ierr = PetscLayoutSetBlockSize(vlayout, 1);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(vlayout);CHKERRQ(ierr);
+
+  /* Create cell sets */
+  for (e = 0, c = 0; e < mesh->numElems; ++e) {
+    GmshElement *elem = mesh->elements + e;
+    if (elem->dim != dim) continue;
+    if (elem->numTags > 0) {ierr = DMSetLabelValue(*dm, "Cell Sets", c, elem->tags[0]);CHKERRQ(ierr);}
+    c++;
+  }
+
+  /* Create face sets */
+  if (flg[1]) {
+    ierr = PetscMalloc1(numRecs*6, &recs);CHKERRQ(ierr);
+    for (e = 0, c = 0; e < mesh->numElems; ++e) {
+      GmshElement *elem = mesh->elements + e;
+      PetscInt    *rec  = recs + c*6;
+      if (elem->dim != dim-1) continue;
+      if (elem->numVerts > 4) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Gmsh element %D has more than 4 vertices", elem->id);
+      rec[0] = elem->numVerts;
+      for (v = 0; v < 4; ++v) rec[1+v] = v < elem->numVerts ? elem->nodes[v] : -1;
+      ierr = PetscSortInt(elem->numVerts, rec+1);CHKERRQ(ierr);
+      rec[5] = elem->tags[0];
+      c++;
+    }
+    ierr = GmshFaceSetsParallel(*dm, vlayout, sfVert, numRecs, recs);CHKERRQ(ierr);
+    ierr = PetscFree(recs);CHKERRQ(ierr);
+  }
+
+  /* Create vertex sets: the tags go to the owners of the vertices, and from them to every copy of the vertices */
+  if (flg[2]) {
+    PetscInt *keys, *etags, *otags, *ltags;
+
+    ierr = PetscSFGetGraph(sfVert, NULL, &numLeaves, NULL, NULL);CHKERRQ(ierr);
+    ierr = PetscMalloc4(numVtxRecs, &keys, numVtxRecs, &etags, numVerts, &otags, numLeaves, &ltags);CHKERRQ(ierr);
+    for (e = 0, c = 0; e < mesh->numElems; ++e) {
+      GmshElement *elem = mesh->elements + e;
+      if (elem->dim != 0 || elem->numTags <= 0) continue;
+      keys[c]    = elem->nodes[0];
+      etags[c++] = elem->tags[0];
+    }
+    for (v = 0; v < numVerts; ++v) otags[v] = PETSC_MIN_INT;
+    ierr = GmshOwnerSFCreate(vlayout, numVtxRecs, keys, &sfSets);CHKERRQ(ierr);
+    ierr = PetscSFReduceBegin(sfSets, MPIU_INT, etags, otags, MPI_MAX);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(sfSets, MPIU_INT, etags, otags, MPI_MAX);CHKERRQ(ierr);
+    ierr = PetscSFDestroy(&sfSets);CHKERRQ(ierr);
+    ierr = PetscSFBcastBegin(sfVert, MPIU_INT, otags, ltags);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sfVert, MPIU_INT, otags, ltags);CHKERRQ(ierr);
+    ierr = DMPlexGetDepthStratum(*dm, 0, &vStart, &vEnd);CHKERRQ(ierr);
+    for (v = 0; v < numLeaves; ++v) {
+      if (ltags[v] == PETSC_MIN_INT) continue;
+      ierr = DMSetLabelValue(*dm, "Vertex Sets", vStart + v, ltags[v]);CHKERRQ(ierr);
+    }
+    ierr = PetscFree4(keys, etags, otags, ltags);CHKERRQ(ierr);
+  }
+
+  /* Create the marker label from the faces on the boundary of the whole mesh, not on the boundary between processes */
+  if (usemarker && !interpolate && dim > 1) SETERRQ(comm,PETSC_ERR_SUP,"Cannot create marker label without interpolation");
+  if (usemarker) {
+    DMLabel         marker;
+    PetscSF         sfPoint;
+    const PetscInt *degree, *ilocal;
+    PetscInt        f, fStart, fEnd, l, numRoots, numPointLeaves;
+    PetscBT         shared;
+
+    ierr = DMCreateLabel(*dm, "marker");CHKERRQ(ierr);
+    ierr = DMGetLabel(*dm, "marker", &marker);CHKERRQ(ierr);
+    ierr = DMGetPointSF(*dm, &sfPoint);CHKERRQ(ierr);
+    ierr = PetscSFGetGraph(sfPoint, &numRoots, &numPointLeaves, &ilocal, NULL);CHKERRQ(ierr);
+    ierr = PetscSFComputeDegreeBegin(sfPoint, &degree);CHKERRQ(ierr);
+    ierr = PetscSFComputeDegreeEnd(sfPoint, &degree);CHKERRQ(ierr);
+    ierr = PetscBTCreate(numRoots, &shared);CHKERRQ(ierr);
+    for (l = 0; l < numPointLeaves; ++l) {ierr = PetscBTSet(shared, ilocal ? ilocal[l] : l);CHKERRQ(ierr);}
+    for (l = 0; l < numRoots; ++l) if (degree[l]) {ierr = PetscBTSet(shared, l);CHKERRQ(ierr);}
+    ierr = DMPlexGetHeightStratum(*dm, 1, &fStart, &fEnd);CHKERRQ(ierr);
+    for (f = fStart; f < fEnd; ++f) {
+      PetscInt suppSize;
+
+      ierr = DMPlexGetSupportSize(*dm, f, &suppSize);CHKERRQ(ierr);
+      if (suppSize == 1 && !PetscBTLookup(shared, f)) {ierr = DMLabelSetValue(marker, f, 1);CHKERRQ(ierr);}
+    }
+    ierr = PetscBTDestroy(&shared);CHKERRQ(ierr);
+    ierr = DMPlexLabelComplete(*dm, marker);CHKERRQ(ierr);
+  }
+
+  ierr = PetscLayoutDestroy(&vlayout);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sfVert);CHKERRQ(ierr);
+  ierr = GmshMeshDestroy(&mesh);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(DMPLEX_CreateGmsh,*dm,NULL,NULL,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
   DMPlexCreateGmsh - Create a DMPlex mesh from a Gmsh file viewer
 
@@ -1424,11 +1887,20 @@ PetscErrorCode DMPlexCreateGmshFromFile(MPI_Comm comm, const char filename[], Pe
   Output Parameter:
 . dm  - The DM object representing the mesh
 
-  Note: http://gmsh.info/doc/texinfo/gmsh.html#MSH-file-format
+  Options Database Keys:
+. -dm_plex_gmsh_parallel - Every process reads its share of the cells and vertices, instead of process 0 reading the whole mesh
+
+  Notes:
+  http://gmsh.info/doc/texinfo/gmsh.html#MSH-file-format
+
+  With -dm_plex_gmsh_parallel the mesh is never held whole by a single process: each process keeps a contiguous range
+  of the elements and of the nodes of the file, and the mesh is returned with this naive distribution of the cells.
+  DMPlexDistribute() then partitions it and migrates it once. This requires linear cells of a single type, node tags
+  numbered contiguously and no periodicity.
 
   Level: beginner
 
-.seealso: DMPLEX, DMCreate()
+.seealso: DMPLEX, DMCreate(), DMPlexDistribute()
 @*/
 PetscErrorCode DMPlexCreateGmsh(MPI_Comm comm, PetscViewer viewer, PetscBool interpolate, DM *dm)
 {
@@ -1446,11 +1918,13 @@ PetscErrorCode DMPlexCreateGmsh(MPI_Comm comm, PetscViewer viewer, PetscBool int
   PetscBool      hybrid = interpolate, periodic = PETSC_TRUE;
   PetscBool      highOrder = PETSC_TRUE, highOrderSet, project = PETSC_FALSE;
   PetscBool      isSimplex = PETSC_FALSE, isHybrid = PETSC_FALSE, hasTetra = PETSC_FALSE;
-  PetscMPIInt    rank;
+  PetscBool      parallel = PETSC_FALSE;
+  PetscMPIInt    rank, size;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   ierr = MPI_Comm_rank(comm, &rank);CHKERRMPI(ierr);
+  ierr = MPI_Comm_size(comm, &size);CHKERRMPI(ierr);
   ierr = PetscObjectOptionsBegin((PetscObject)viewer);CHKERRQ(ierr);
   ierr = PetscOptionsHead(PetscOptionsObject,"DMPlex Gmsh options");CHKERRQ(ierr);
   ierr = PetscOptionsBool("-dm_plex_gmsh_hybrid", "Generate hybrid cell bounds", "DMPlexCreateGmsh", hybrid, &hybrid, NULL);CHKERRQ(ierr);
@@ -1459,11 +1933,18 @@ PetscErrorCode DMPlexCreateGmsh(MPI_Comm comm, PetscViewer viewer, PetscBool int
   ierr = PetscOptionsBool("-dm_plex_gmsh_project", "Project high-order coordinates to a different space", "DMPlexCreateGmsh", project, &project, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-dm_plex_gmsh_use_marker", "Generate marker label", "DMPlexCreateGmsh", usemarker, &usemarker, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBoundedInt("-dm_plex_gmsh_spacedim", "Embedding space dimension", "DMPlexCreateGmsh", coordDim, &coordDim, NULL, PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-dm_plex_gmsh_parallel", "Read the mesh in parallel", "DMPlexCreateGmsh", parallel, &parallel, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
 
   ierr = GmshCellInfoSetUp();CHKERRQ(ierr);
 
+  if (parallel && size > 1) {
+    if (highOrderSet && highOrder) SETERRQ(comm, PETSC_ERR_SUP, "Cannot read high-order coordinates in parallel");
+    ierr = DMPlexCreateGmsh_Parallel(comm, viewer, interpolate, periodic, usemarker, coordDim, dm);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
   ierr = DMCreate(comm, dm);CHKERRQ(ierr);
   ierr = DMSetType(*dm, DMPLEX);CHKERRQ(ierr);
   ierr = PetscLogEventBegin(DMPLEX_CreateGmsh,*dm,NULL,NULL,NULL);CHKERRQ(ierr);
@@ -1477,67 +1958,12 @@ PetscErrorCode DMPlexCreateGmsh(MPI_Comm comm, PetscViewer viewer, PetscBool int
   }
 
   if (!rank) {
-    GmshFile  gmsh[1];
-    char      line[PETSC_MAX_PATH_LEN];
-    PetscBool match;
+    GmshFile gmsh[1];
 
     ierr = PetscArrayzero(gmsh,1);CHKERRQ(ierr);
     gmsh->viewer = viewer;
     gmsh->binary = binary;
-
-    ierr = GmshMeshCreate(&mesh);CHKERRQ(ierr);
-
-    /* Read mesh format */
-    ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
-    ierr = GmshExpect(gmsh, "$MeshFormat", line);CHKERRQ(ierr);
-    ierr = GmshReadMeshFormat(gmsh);CHKERRQ(ierr);
-    ierr = GmshReadEndSection(gmsh, "$EndMeshFormat", line);CHKERRQ(ierr);
-
-    /* OPTIONAL Read physical names */
-    ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
-    ierr = GmshMatch(gmsh, "$PhysicalNames", line, &match);CHKERRQ(ierr);
-    if (match) {
-      ierr = GmshExpect(gmsh, "$PhysicalNames", line);CHKERRQ(ierr);
-      ierr = GmshReadPhysicalNames(gmsh);CHKERRQ(ierr);
-      ierr = GmshReadEndSection(gmsh, "$EndPhysicalNames", line);CHKERRQ(ierr);
-      /* Initial read for entity section */
-      ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
-    }
-
-    /* Read entities */
-    if (gmsh->fileFormat >= 40) {
-      ierr = GmshExpect(gmsh, "$Entities", line);CHKERRQ(ierr);
-      ierr = GmshReadEntities(gmsh, mesh);CHKERRQ(ierr);
-      ierr = GmshReadEndSection(gmsh, "$EndEntities", line);CHKERRQ(ierr);
-      /* Initial read for nodes section */
-      ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
-    }
-
-    /* Read nodes */
-    ierr = GmshExpect(gmsh, "$Nodes", line);CHKERRQ(ierr);
-    ierr = GmshReadNodes(gmsh, mesh);CHKERRQ(ierr);
-    ierr = GmshReadEndSection(gmsh, "$EndNodes", line);CHKERRQ(ierr);
-
-    /* Read elements */
-    ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
-    ierr = GmshExpect(gmsh, "$Elements", line);CHKERRQ(ierr);
-    ierr = GmshReadElements(gmsh, mesh);CHKERRQ(ierr);
-    ierr = GmshReadEndSection(gmsh, "$EndElements", line);CHKERRQ(ierr);
-
-    /* Read periodic section (OPTIONAL) */
-    if (periodic) {
-      ierr = GmshReadSection(gmsh, line);CHKERRQ(ierr);
-      ierr = GmshMatch(gmsh, "$Periodic", line, &periodic);CHKERRQ(ierr);
-    }
-    if (periodic) {
-      ierr = GmshExpect(gmsh, "$Periodic", line);CHKERRQ(ierr);
-      ierr = GmshReadPeriodic(gmsh, mesh);CHKERRQ(ierr);
-      ierr = GmshReadEndSection(gmsh, "$EndPeriodic", line);CHKERRQ(ierr);
-    }
-
-    ierr = PetscFree(gmsh->wbuf);CHKERRQ(ierr);
-    ierr = PetscFree(gmsh->sbuf);CHKERRQ(ierr);
-    ierr = PetscFree(gmsh->nbuf);CHKERRQ(ierr);
+    ierr = GmshReadMesh(gmsh, &periodic, &mesh);CHKERRQ(ierr);
 
     dim       = mesh->dim;
     order     = mesh->order;
@@ -1,4 +1,5 @@
 #include <petsc/private/dmpleximpl.h>   /*I      "petscdmplex.h"   I*/
+#include <petscbt.h>
 
 /*@
   DMPlexCreateClosureIndex - Calculate an index for the given PetscSection for the closure operation on the DM
@@ -73,3 +74,494 @@ PetscErrorCode DMPlexCreateClosureIndex(DM dm, PetscSection section)
   ierr = ISDestroy(&closureIS);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
+
+/*@
+  DMPlexCreateClosureDofCache - Calculate and store the flattened dof indices of the closure of each point in a range, for both the local and global sections of the DM
+
+  Not collective
+
+  Input Parameters:
++ dm     - The DM
+. pStart - The first point whose closure is cached, or PETSC_DETERMINE for the first cell
+- pEnd   - One past the last point whose closure is cached, or PETSC_DETERMINE for one past the last cell
+
+  Notes:
+  For each point, the cache holds the local vector indices of its closure dofs in the order returned by DMPlexVecGetClosure(),
+  so including the dof permutations and sign flips of the section symmetries and the closure permutation, and the global
+  indices returned by DMPlexGetClosureIndices(). DMPlexVecGetClosure() and DMPlexVecSetClosure() then gather and scatter
+  through the index list of the point instead of traversing its transitive closure, and DMPlexVecGetClosures() and
+  DMPlexVecSetClosures() do so for a whole range of points.
+
+  The cache is attached to the local section of the DM, as the closure index is, so that DMs sharing the mesh keep a
+  cache for each of their local sections. It is used only by this DM while its global section is the one it was built
+  with, and it is discarded when the topology of the mesh is rebuilt, and when a closure permutation or closure index is
+  set on the section. A section which is otherwise modified in place requires the cache to be created again. Meshes with
+  anchors (hanging node constraints) are not supported.
+
+  Level: intermediate
+
+.seealso: DMPlexDestroyClosureDofCache(), DMPlexGetClosureDofCache(), DMPlexVecGetClosures(), DMPlexVecSetClosures(), DMPlexCreateClosureIndex()
+@*/
+static PetscErrorCode DMPlexClosureDofCacheDestroy_Private(void *ctx)
+{
+  DMPlexClosureDofCache *cache = (DMPlexClosureDofCache *) ctx;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSectionDestroy(&cache->globalSection);CHKERRQ(ierr);
+  ierr = PetscFree(cache->offsets);CHKERRQ(ierr);
+  ierr = PetscFree2(cache->lidx, cache->gidx);CHKERRQ(ierr);
+  ierr = PetscFree(cache->flips);CHKERRQ(ierr);
+  ierr = PetscFree2(cache->colorOffsets, cache->colorPoints);CHKERRQ(ierr);
+  ierr = PetscFree(cache);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode DMPlexCreateClosureDofCache(DM dm, PetscInt pStart, PetscInt pEnd)
+{
+  DMPlexClosureDofCache *cache;
+  PetscSection           section, globalSection, anchorSection, clSection;
+  IS                     clPoints;
+  const PetscInt        *clp;
+  PetscInt              *points = NULL;
+  PetscInt               depth, Nf, Ncl, n, p, q, f;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  ierr = DMPlexDestroyClosureDofCache(dm);CHKERRQ(ierr);
+  if (pStart == PETSC_DETERMINE || pEnd == PETSC_DETERMINE) {
+    PetscInt cStart, cEnd;
+
+    ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+    if (pStart == PETSC_DETERMINE) pStart = cStart;
+    if (pEnd   == PETSC_DETERMINE) pEnd   = cEnd;
+  }
+  if (pEnd < pStart) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Invalid point range [%D, %D)", pStart, pEnd);
+  ierr = DMPlexGetAnchors(dm, &anchorSection, NULL);CHKERRQ(ierr);
+  if (anchorSection) SETERRQ(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "Closure dof cache does not support meshes with anchors");
+  ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
+  ierr = DMGetGlobalSection(dm, &globalSection);CHKERRQ(ierr);
+  ierr = PetscSectionGetNumFields(section, &Nf);CHKERRQ(ierr);
+  ierr = DMPlexGetDepth(dm, &depth);CHKERRQ(ierr);
+  ierr = PetscNew(&cache);CHKERRQ(ierr);
+  ierr = PetscObjectReference((PetscObject) globalSection);CHKERRQ(ierr);
+  cache->dmId          = ((PetscObject) dm)->id;
+  cache->globalSection = globalSection;
+  cache->pStart        = pStart;
+  cache->pEnd          = pEnd;
+  /* Closure sizes */
+  ierr = PetscMalloc1(pEnd-pStart+1, &cache->offsets);CHKERRQ(ierr);
+  cache->offsets[0] = 0;
+  for (p = pStart; p < pEnd; ++p) {
+    PetscInt size = 0;
+
+    ierr = DMPlexGetCompressedClosure(dm, section, p, &Ncl, &points, &clSection, &clPoints, &clp);CHKERRQ(ierr);
+    for (q = 0; q < Ncl; ++q) {
+      PetscInt dof;
+
+      ierr = PetscSectionGetDof(section, points[2*q], &dof);CHKERRQ(ierr);
+      size += dof;
+    }
+    ierr = DMPlexRestoreCompressedClosure(dm, section, p, &Ncl, &points, &clSection, &clPoints, &clp);CHKERRQ(ierr);
+    cache->offsets[p-pStart+1] = cache->offsets[p-pStart] + size;
+  }
+  n    = cache->offsets[pEnd-pStart];
+  ierr = PetscMalloc2(n, &cache->lidx, n, &cache->gidx);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject) dm, (pEnd-pStart+1 + 2*n)*sizeof(PetscInt));CHKERRQ(ierr);
+  /* Closure indices, placed as DMPlexVecGetClosure() places the closure values */
+  for (p = pStart; p < pEnd; ++p) {
+    const PetscInt  start = cache->offsets[p-pStart];
+    const PetscInt  size  = cache->offsets[p-pStart+1] - start;
+    PetscInt       *lidx  = &cache->lidx[start];
+    PetscInt       *idx;
+    const PetscInt *clperm;
+    PetscInt        offset = 0, Ni;
+
+    ierr = DMPlexGetCompressedClosure(dm, section, p, &Ncl, &points, &clSection, &clPoints, &clp);CHKERRQ(ierr);
+    ierr = PetscSectionGetClosureInversePermutation_Internal(section, (PetscObject) dm, depth, size, &clperm);CHKERRQ(ierr);
+    for (f = 0; f < PetscMax(1, Nf); ++f) {
+      const PetscInt    **perms = NULL;
+      const PetscScalar **flips = NULL;
+
+      if (Nf) {ierr = PetscSectionGetFieldPointSyms(section, f, Ncl, points, &perms, &flips);CHKERRQ(ierr);}
+      else    {ierr = PetscSectionGetPointSyms(section, Ncl, points, &perms, &flips);CHKERRQ(ierr);}
+      for (q = 0; q < Ncl; ++q) {
+        const PetscInt     pnt  = points[2*q];
+        const PetscInt    *perm = perms ? perms[q] : NULL;
+        const PetscScalar *flip = flips ? flips[q] : NULL;
+        const PetscInt    *cdofs = NULL;
+        PetscInt           dof, cdof, off, d, cind = 0;
+
+        if (Nf) {
+          ierr = PetscSectionGetFieldDof(section, pnt, f, &dof);CHKERRQ(ierr);
+          ierr = PetscSectionGetFieldOffset(section, pnt, f, &off);CHKERRQ(ierr);
+          ierr = PetscSectionGetFieldConstraintDof(section, pnt, f, &cdof);CHKERRQ(ierr);
+          if (cdof) {ierr = PetscSectionGetFieldConstraintIndices(section, pnt, f, &cdofs);CHKERRQ(ierr);}
+        } else {
+          ierr = PetscSectionGetDof(section, pnt, &dof);CHKERRQ(ierr);
+          ierr = PetscSectionGetOffset(section, pnt, &off);CHKERRQ(ierr);
+          ierr = PetscSectionGetConstraintDof(section, pnt, &cdof);CHKERRQ(ierr);
+          if (cdof) {ierr = PetscSectionGetConstraintIndices(section, pnt, &cdofs);CHKERRQ(ierr);}
+        }
+        for (d = 0; d < dof; ++d) {
+          const PetscInt preind = perm ? offset+perm[d] : offset+d;
+          const PetscInt ind    = clperm ? clperm[preind] : preind;
+
+          if ((cind < cdof) && (d == cdofs[cind])) {lidx[ind] = -(off+d+1); ++cind;}
+          else                                     {lidx[ind] = off+d;}
+        }
+        if (flip) {
+          if (!cache->flips) {
+            PetscInt i;
+
+            ierr = PetscMalloc1(n, &cache->flips);CHKERRQ(ierr);
+            ierr = PetscLogObjectMemory((PetscObject) dm, n*sizeof(PetscScalar));CHKERRQ(ierr);
+            for (i = 0; i < n; ++i) cache->flips[i] = 1.0;
+          }
+          for (d = 0; d < dof; ++d) cache->flips[start + (clperm ? clperm[offset+d] : offset+d)] = flip[d];
+        }
+        offset += dof;
+      }
+      if (Nf) {ierr = PetscSectionRestoreFieldPointSyms(section, f, Ncl, points, &perms, &flips);CHKERRQ(ierr);}
+      else    {ierr = PetscSectionRestorePointSyms(section, Ncl, points, &perms, &flips);CHKERRQ(ierr);}
+    }
+    ierr = DMPlexRestoreCompressedClosure(dm, section, p, &Ncl, &points, &clSection, &clPoints, &clp);CHKERRQ(ierr);
+    if (offset != size) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Invalid closure size %D for point %D should be %D", offset, p, size);
+    ierr = DMPlexGetClosureIndices(dm, section, globalSection, p, PETSC_TRUE, &Ni, &idx, NULL, NULL);CHKERRQ(ierr);
+    if (Ni != size) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Invalid number of closure indices %D for point %D should be %D", Ni, p, size);
+    ierr = PetscArraycpy(&cache->gidx[start], idx, Ni);CHKERRQ(ierr);
+    ierr = DMPlexRestoreClosureIndices(dm, section, globalSection, p, PETSC_TRUE, &Ni, &idx, NULL, NULL);CHKERRQ(ierr);
+  }
+  ierr = PetscSectionSetClosureDofCache_Internal(section, cache, DMPlexClosureDofCacheDestroy_Private);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMPlexDestroyClosureDofCache - Free the closure dof indices stored by DMPlexCreateClosureDofCache()
+
+  Not collective
+
+  Input Parameter:
+. dm - The DM
+
+  Note:
+  Only a cache built for this DM on its current local section is freed.
+
+  Level: intermediate
+
+.seealso: DMPlexCreateClosureDofCache()
+@*/
+PetscErrorCode DMPlexDestroyClosureDofCache(DM dm)
+{
+  PetscSection   section = dm->localSection;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  if (!section || !section->clDofCache || ((DMPlexClosureDofCache *) section->clDofCache)->dmId != ((PetscObject) dm)->id) PetscFunctionReturn(0);
+  ierr = PetscSectionSetClosureDofCache_Internal(section, NULL, NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  DMPlexGetClosureDofCache - Get the closure dof indices stored by DMPlexCreateClosureDofCache()
+
+  Not collective
+
+  Input Parameter:
+. dm - The DM
+
+  Output Parameters:
++ pStart  - The first point with a cached closure
+. pEnd    - One past the last point with a cached closure
+. offsets - The closure of point p has indices offsets[p-pStart] through offsets[p-pStart+1]-1, or NULL
+. lidx    - The local vector indices, where constrained dofs are given as -(idx+1), or NULL
+- gidx    - The global indices, with the semantics of DMPlexGetClosureIndices(), or NULL
+
+  Note:
+  The arrays belong to the local section of the DM and must not be freed. The point range is empty if there is no cache,
+  or if the local or global section of the DM has changed since it was built.
+
+  Level: advanced
+
+.seealso: DMPlexCreateClosureDofCache(), DMPlexGetClosureIndices(), DMPlexVecGetClosures()
+@*/
+PetscErrorCode DMPlexGetClosureDofCache(DM dm, PetscInt *pStart, PetscInt *pEnd, const PetscInt *offsets[], const PetscInt *lidx[], const PetscInt *gidx[])
+{
+  DMPlexClosureDofCache *cache;
+  PetscBool              valid;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  cache = DMPlexGetClosureDofCache_Private(dm, dm->localSection);
+  valid = cache ? PETSC_TRUE : PETSC_FALSE;
+  if (pStart)  *pStart  = valid ? cache->pStart  : 0;
+  if (pEnd)    *pEnd    = valid ? cache->pEnd    : 0;
+  if (offsets) *offsets = valid ? cache->offsets : NULL;
+  if (lidx)    *lidx    = valid ? cache->lidx    : NULL;
+  if (gidx)    *gidx    = valid ? cache->gidx    : NULL;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  DMPlexGetClosureDofCacheColoring - Get a coloring of the points of the closure dof cache such that points of the same color share no closure dof
+
+  Not collective
+
+  Input Parameter:
+. dm - The DM
+
+  Output Parameters:
++ numColors    - The number of colors
+. colorOffsets - The points of color k are colorPoints[colorOffsets[k]] through colorPoints[colorOffsets[k+1]-1], or NULL
+- colorPoints  - The points sorted by color, in increasing order within each color, or NULL
+
+  Notes:
+  The closures of the points of one color may be updated concurrently, for instance by threads adding element vectors
+  into a local vector. This does not extend to matrices, since MatSetValues() is not thread safe, so DMPlexMatSetClosure()
+  only uses the cached global indices. The coloring is computed greedily on first use and kept with the cache. The arrays
+  belong to the local section of the DM and must not be freed. There are no colors if there is no valid cache, see
+  DMPlexGetClosureDofCache().
+
+  Level: advanced
+
+.seealso: DMPlexCreateClosureDofCache(), DMPlexGetClosureDofCache()
+@*/
+PetscErrorCode DMPlexGetClosureDofCacheColoring(DM dm, PetscInt *numColors, const PetscInt *colorOffsets[], const PetscInt *colorPoints[])
+{
+  DMPlexClosureDofCache *cache;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  cache = DMPlexGetClosureDofCache_Private(dm, dm->localSection);
+  if (!cache) {
+    if (numColors)    *numColors    = 0;
+    if (colorOffsets) *colorOffsets = NULL;
+    if (colorPoints)  *colorPoints  = NULL;
+    PetscFunctionReturn(0);
+  }
+  if (!cache->numColors && cache->pEnd > cache->pStart) {
+    const PetscInt  Np = cache->pEnd - cache->pStart;
+    const PetscInt  n  = cache->offsets[Np];
+    PetscBT         used;
+    PetscInt       *color;
+    PetscInt        nloc = 0, numColored = 0, p, i, k;
+
+    for (i = 0; i < n; ++i) nloc = PetscMax(nloc, (cache->lidx[i] < 0 ? -(cache->lidx[i]+1) : cache->lidx[i]) + 1);
+    ierr = PetscBTCreate(nloc, &used);CHKERRQ(ierr);
+    ierr = PetscMalloc1(Np, &color);CHKERRQ(ierr);
+    for (p = 0; p < Np; ++p) color[p] = -1;
+    /* Each sweep gives the next color to every uncolored point whose closure has no dof marked in this sweep */
+    for (k = 0; numColored < Np; ++k) {
+      ierr = PetscBTMemzero(nloc, used);CHKERRQ(ierr);
+      for (p = 0; p < Np; ++p) {
+        PetscBool isFree = PETSC_TRUE;
+
+        if (color[p] >= 0) continue;
+        for (i = cache->offsets[p]; i < cache->offsets[p+1]; ++i) {
+          const PetscInt l = cache->lidx[i] < 0 ? -(cache->lidx[i]+1) : cache->lidx[i];
+
+          if (PetscBTLookup(used, l)) {isFree = PETSC_FALSE; break;}
+        }
+        if (!isFree) continue;
+        for (i = cache->offsets[p]; i < cache->offsets[p+1]; ++i) {
+          ierr = PetscBTSet(used, cache->lidx[i] < 0 ? -(cache->lidx[i]+1) : cache->lidx[i]);CHKERRQ(ierr);
+        }
+        color[p] = k;
+        ++numColored;
+      }
+    }
+    cache->numColors = k;
+    ierr = PetscCalloc2(k+1, &cache->colorOffsets, Np, &cache->colorPoints);CHKERRQ(ierr);
+    for (p = 0; p < Np; ++p) ++cache->colorOffsets[color[p]+1];
+    for (k = 0; k < cache->numColors; ++k) cache->colorOffsets[k+1] += cache->colorOffsets[k];
+    for (p = 0; p < Np; ++p) cache->colorPoints[cache->colorOffsets[color[p]]++] = cache->pStart + p;
+    for (k = cache->numColors; k > 0; --k) cache->colorOffsets[k] = cache->colorOffsets[k-1];
+    cache->colorOffsets[0] = 0;
+    ierr = PetscFree(color);CHKERRQ(ierr);
+    ierr = PetscBTDestroy(&used);CHKERRQ(ierr);
+  }
+  if (numColors)    *numColors    = cache->numColors;
+  if (colorOffsets) *colorOffsets = cache->colorOffsets;
+  if (colorPoints)  *colorPoints  = cache->colorPoints;
+  PetscFunctionReturn(0);
+}
+
+/* Create the closure dof cache over the cells when it is requested for assembly and missing or out of date */
+PetscErrorCode DMPlexSetUpClosureDofCache_Internal(DM dm)
+{
+  DM_Plex               *mesh = (DM_Plex *) dm->data;
+  PetscSection           section, globalSection, anchorSection;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  if (!mesh->useClDofCache) PetscFunctionReturn(0);
+  ierr = DMPlexGetAnchors(dm, &anchorSection, NULL);CHKERRQ(ierr);
+  if (anchorSection) PetscFunctionReturn(0);
+  ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
+  ierr = DMGetGlobalSection(dm, &globalSection);CHKERRQ(ierr);
+  if (DMPlexGetClosureDofCache_Private(dm, section)) PetscFunctionReturn(0);
+  ierr = DMPlexCreateClosureDofCache(dm, PETSC_DETERMINE, PETSC_DETERMINE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode DMPlexClosureDofCacheGather_Internal(DMPlexClosureDofCache *cache, PetscInt pStart, PetscInt pEnd, const PetscScalar vArray[], PetscScalar values[])
+{
+  const PetscInt     start = cache->offsets[pStart-cache->pStart];
+  const PetscInt     n     = cache->offsets[pEnd-cache->pStart] - start;
+  const PetscInt    *lidx  = &cache->lidx[start];
+  const PetscScalar *flips = cache->flips ? &cache->flips[start] : NULL;
+  PetscInt           i;
+
+  PetscFunctionBeginHot;
+  if (flips) {
+    for (i = 0; i < n; ++i) values[i] = vArray[lidx[i] < 0 ? -(lidx[i]+1) : lidx[i]] * flips[i];
+  } else {
+    for (i = 0; i < n; ++i) values[i] = vArray[lidx[i] < 0 ? -(lidx[i]+1) : lidx[i]];
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode DMPlexClosureDofCacheScatter_Internal(DMPlexClosureDofCache *cache, PetscInt pStart, PetscInt pEnd, const PetscScalar values[], InsertMode mode, PetscScalar array[])
+{
+  const PetscInt     start = cache->offsets[pStart-cache->pStart];
+  const PetscInt     n     = cache->offsets[pEnd-cache->pStart] - start;
+  const PetscInt    *lidx  = &cache->lidx[start];
+  const PetscScalar *flips = cache->flips ? &cache->flips[start] : NULL;
+  PetscInt           i;
+
+  PetscFunctionBeginHot;
+  switch (mode) {
+  case INSERT_VALUES:
+    for (i = 0; i < n; ++i) if (lidx[i] >= 0) array[lidx[i]] = flips ? values[i]*flips[i] : values[i];
+    break;
+  case ADD_VALUES:
+    for (i = 0; i < n; ++i) if (lidx[i] >= 0) array[lidx[i]] += flips ? values[i]*flips[i] : values[i];
+    break;
+  case INSERT_ALL_VALUES:
+    for (i = 0; i < n; ++i) array[lidx[i] < 0 ? -(lidx[i]+1) : lidx[i]] = flips ? values[i]*flips[i] : values[i];
+    break;
+  case ADD_ALL_VALUES:
+    for (i = 0; i < n; ++i) array[lidx[i] < 0 ? -(lidx[i]+1) : lidx[i]] += flips ? values[i]*flips[i] : values[i];
+    break;
+  case INSERT_BC_VALUES:
+    for (i = 0; i < n; ++i) if (lidx[i] < 0) array[-(lidx[i]+1)] = flips ? values[i]*flips[i] : values[i];
+    break;
+  case ADD_BC_VALUES:
+    for (i = 0; i < n; ++i) if (lidx[i] < 0) array[-(lidx[i]+1)] += flips ? values[i]*flips[i] : values[i];
+    break;
+  default:
+    SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Invalid insert mode %d", mode);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMPlexVecGetClosures - Get the values on the closures of a range of points, one after the other
+
+  Not collective
+
+  Input Parameters:
++ dm     - The DM
+. v      - The local vector
+. pStart - The first point
+- pEnd   - One past the last point
+
+  Output Parameter:
+. values - The closure values of pStart, followed by those of pStart+1, and so on, in the layout of DMPlexVecGetClosure()
+
+  Note:
+  When the range lies within the closure dof cache of the DM, the values are gathered through its index list in a single
+  sweep. Otherwise, each closure is obtained with DMPlexVecGetClosure() using the local section of the DM.
+
+  Level: intermediate
+
+.seealso: DMPlexCreateClosureDofCache(), DMPlexVecSetClosures(), DMPlexVecGetClosure()
+@*/
+PetscErrorCode DMPlexVecGetClosures(DM dm, Vec v, PetscInt pStart, PetscInt pEnd, PetscScalar values[])
+{
+  DMPlexClosureDofCache *cache;
+  const PetscScalar     *vArray;
+  PetscSection           section;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidHeaderSpecific(v, VEC_CLASSID, 2);
+  if (pStart >= pEnd) PetscFunctionReturn(0);
+  PetscValidScalarPointer(values, 5);
+  ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
+  cache = DMPlexGetClosureDofCache_Private(dm, section);
+  if (cache && pStart >= cache->pStart && pEnd <= cache->pEnd) {
+    ierr = VecGetArrayRead(v, &vArray);CHKERRQ(ierr);
+    ierr = DMPlexClosureDofCacheGather_Internal(cache, pStart, pEnd, vArray, values);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(v, &vArray);CHKERRQ(ierr);
+  } else {
+    PetscInt p, off = 0;
+
+    for (p = pStart; p < pEnd; ++p) {
+      PetscScalar *clValues = &values[off];
+      PetscInt     clSize   = PETSC_MAX_INT;
+
+      ierr = DMPlexVecGetClosure(dm, section, v, p, &clSize, &clValues);CHKERRQ(ierr);
+      off += clSize;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMPlexVecSetClosures - Set the values on the closures of a range of points, one after the other
+
+  Not collective
+
+  Input Parameters:
++ dm     - The DM
+. v      - The local vector
+. pStart - The first point
+. pEnd   - One past the last point
+. values - The closure values of pStart, followed by those of pStart+1, and so on, in the layout of DMPlexVecGetClosure()
+- mode   - The insert mode, as for DMPlexVecSetClosure()
+
+  Note:
+  When the range lies within the closure dof cache of the DM, the values are scattered through its index list in a single
+  sweep. Otherwise, each closure is set with DMPlexVecSetClosure() using the local section of the DM. Closures are
+  processed in order, so with INSERT_VALUES a dof shared by several closures receives its value from the last of them.
+
+  Level: intermediate
+
+.seealso: DMPlexCreateClosureDofCache(), DMPlexVecGetClosures(), DMPlexVecSetClosure()
+@*/
+PetscErrorCode DMPlexVecSetClosures(DM dm, Vec v, PetscInt pStart, PetscInt pEnd, const PetscScalar values[], InsertMode mode)
+{
+  DMPlexClosureDofCache *cache;
+  PetscScalar           *array;
+  PetscSection           section;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidHeaderSpecific(v, VEC_CLASSID, 2);
+  if (pStart >= pEnd) PetscFunctionReturn(0);
+  PetscValidScalarPointer(values, 5);
+  ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
+  cache = DMPlexGetClosureDofCache_Private(dm, section);
+  if (cache && pStart >= cache->pStart && pEnd <= cache->pEnd) {
+    ierr = VecGetArray(v, &array);CHKERRQ(ierr);
+    ierr = DMPlexClosureDofCacheScatter_Internal(cache, pStart, pEnd, values, mode, array);CHKERRQ(ierr);
+    ierr = VecRestoreArray(v, &array);CHKERRQ(ierr);
+  } else {
+    PetscInt p, off = 0;
+
+    for (p = pStart; p < pEnd; ++p) {
+      PetscInt clSize;
+
+      ierr = DMPlexVecGetClosure(dm, section, v, p, &clSize, NULL);CHKERRQ(ierr);
+      ierr = DMPlexVecSetClosure(dm, section, v, p, &values[off], mode);CHKERRQ(ierr);
+      off += clSize;
+    }
+  }
+  PetscFunctionReturn(0);
+}
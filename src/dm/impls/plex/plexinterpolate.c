@@ -326,21 +326,61 @@ PetscErrorCode DMPlexRestoreRawFaces_Internal(DM dm, DMPolytopeType ct, const Pe
   PetscFunctionReturn(0);
 }
 
-/* This interpolates faces for cells at some stratum */
-static PetscErrorCode DMPlexInterpolateFaces_Internal(DM dm, PetscInt cellDepth, DM idm)
+/* The hash key of a face is its sorted vertex tuple, padded with PETSC_MAX_INT */
+PETSC_STATIC_INLINE PetscErrorCode DMPlexGetFaceKey_Private(PetscInt faceSize, const PetscInt face[], PetscHashIJKLKey *key)
 {
-  DMLabel        ctLabel;
-  PetscHashIJKL  faceTable;
-  PetscInt       faceTypeNum[DM_NUM_POLYTOPES];
-  PetscInt       depth, d, Np, cStart, cEnd, c, fStart, fEnd;
   PetscErrorCode ierr;
 
+  PetscFunctionBeginHot;
+  if (faceSize > 4) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Do not support faces of size %D > 4", faceSize);
+  key->i = face[0];
+  key->j = faceSize > 1 ? face[1] : PETSC_MAX_INT;
+  key->k = faceSize > 2 ? face[2] : PETSC_MAX_INT;
+  key->l = faceSize > 3 ? face[3] : PETSC_MAX_INT;
+  ierr = PetscSortInt(faceSize, (PetscInt *) key);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  This interpolates faces for cells at some stratum.
+
+  The faces are matched in a single pass over the cells, which records the face of every (cell, local face) pair, so that the
+  hash table can be released before the interpolated mesh is allocated and the later passes only index into that array.
+*/
+static PetscErrorCode DMPlexInterpolateFaces_Internal(DM dm, PetscInt cellDepth, DM idm)
+{
+  DMLabel         ctLabel;
+  PetscHashIJKL   faceTable;
+  PetscInt        faceTypeNum[DM_NUM_POLYTOPES];
+  PetscInt       *cellFaceOff, *cellFaces;
+  DMPolytopeType *faceTypeOf;
+  PetscInt        depth, d, Np, cStart, cEnd, c, fStart, fEnd, Ncf;
+  PetscErrorCode  ierr;
+
   PetscFunctionBegin;
   ierr = DMPlexGetDepth(dm, &depth);CHKERRQ(ierr);
-  ierr = PetscHashIJKLCreate(&faceTable);CHKERRQ(ierr);
   ierr = PetscArrayzero(faceTypeNum, DM_NUM_POLYTOPES);CHKERRQ(ierr);
   ierr = DMPlexGetDepthStratum(dm, cellDepth, &cStart, &cEnd);CHKERRQ(ierr);
-  /* Number new faces and save face vertices in hash table */
+  /* Count the faces of each cell */
+  ierr = PetscMalloc1(cEnd-cStart+1, &cellFaceOff);CHKERRQ(ierr);
+  cellFaceOff[0] = 0;
+  for (c = cStart; c < cEnd; ++c) {
+    const PetscInt       *cone, *faceSizes, *faces;
+    const DMPolytopeType *faceTypes;
+    DMPolytopeType        ct;
+    PetscInt              numFaces;
+
+    ierr = DMPlexGetCellType(dm, c, &ct);CHKERRQ(ierr);
+    ierr = DMPlexGetCone(dm, c, &cone);CHKERRQ(ierr);
+    ierr = DMPlexGetRawFaces_Internal(dm, ct, cone, &numFaces, &faceTypes, &faceSizes, &faces);CHKERRQ(ierr);
+    cellFaceOff[c-cStart+1] = cellFaceOff[c-cStart] + numFaces;
+    ierr = DMPlexRestoreRawFaces_Internal(dm, ct, cone, &numFaces, &faceTypes, &faceSizes, &faces);CHKERRQ(ierr);
+  }
+  Ncf  = cellFaceOff[cEnd-cStart];
+  ierr = PetscMalloc2(Ncf, &cellFaces, Ncf, &faceTypeOf);CHKERRQ(ierr);
+  /* Number new faces in order of first appearance, sizing the table for faces shared by two cells */
+  ierr = PetscHashIJKLCreate(&faceTable);CHKERRQ(ierr);
+  ierr = PetscHashIJKLResize(faceTable, Ncf/2+1);CHKERRQ(ierr);
   ierr = DMPlexGetDepthStratum(dm, depth > cellDepth ? cellDepth : 0, NULL, &fStart);CHKERRQ(ierr);
   fEnd = fStart;
   for (c = cStart; c < cEnd; ++c) {
@@ -353,67 +393,43 @@ static PetscErrorCode DMPlexInterpolateFaces_Internal(DM dm, PetscInt cellDepth,
     ierr = DMPlexGetCone(dm, c, &cone);CHKERRQ(ierr);
     ierr = DMPlexGetRawFaces_Internal(dm, ct, cone, &numFaces, &faceTypes, &faceSizes, &faces);CHKERRQ(ierr);
     for (cf = 0; cf < numFaces; foff += faceSizes[cf], ++cf) {
-      const PetscInt       faceSize = faceSizes[cf];
-      const DMPolytopeType faceType = faceTypes[cf];
-      const PetscInt      *face     = &faces[foff];
-      PetscHashIJKLKey     key;
-      PetscHashIter        iter;
-      PetscBool            missing;
-
-      if (faceSize > 4) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Do not support faces of size %D > 4", faceSize);
-      key.i = face[0];
-      key.j = faceSize > 1 ? face[1] : PETSC_MAX_INT;
-      key.k = faceSize > 2 ? face[2] : PETSC_MAX_INT;
-      key.l = faceSize > 3 ? face[3] : PETSC_MAX_INT;
-      ierr = PetscSortInt(faceSize, (PetscInt *) &key);CHKERRQ(ierr);
+      PetscHashIJKLKey key;
+      PetscHashIter    iter;
+      PetscBool        missing;
+      PetscInt         f;
+
+      ierr = DMPlexGetFaceKey_Private(faceSizes[cf], &faces[foff], &key);CHKERRQ(ierr);
       ierr = PetscHashIJKLPut(faceTable, key, &iter, &missing);CHKERRQ(ierr);
       if (missing) {
-        ierr = PetscHashIJKLIterSet(faceTable, iter, fEnd++);CHKERRQ(ierr);
-        ++faceTypeNum[faceType];
+        f    = fEnd++;
+        ierr = PetscHashIJKLIterSet(faceTable, iter, f);CHKERRQ(ierr);
+        faceTypeOf[f-fStart] = faceTypes[cf];
+        ++faceTypeNum[faceTypes[cf]];
+      } else {
+        ierr = PetscHashIJKLIterGet(faceTable, iter, &f);CHKERRQ(ierr);
       }
+      cellFaces[cellFaceOff[c-cStart]+cf] = f;
     }
     ierr = DMPlexRestoreRawFaces_Internal(dm, ct, cone, &numFaces, &faceTypes, &faceSizes, &faces);CHKERRQ(ierr);
   }
-  /* We need to number faces contiguously among types */
+  ierr = PetscHashIJKLDestroy(&faceTable);CHKERRQ(ierr);
+  /* We need to number faces contiguously among types, keeping the order of first appearance within each type */
   {
-    PetscInt faceTypeStart[DM_NUM_POLYTOPES], ct, numFT = 0;
+    PetscInt faceTypeStart[DM_NUM_POLYTOPES], ct, numFT = 0, f;
 
     for (ct = 0; ct < DM_NUM_POLYTOPES; ++ct) {if (faceTypeNum[ct]) ++numFT; faceTypeStart[ct] = 0;}
     if (numFT > 1) {
-      ierr = PetscHashIJKLClear(faceTable);CHKERRQ(ierr);
+      PetscInt *faceNew;
+
+      ierr = PetscMalloc1(fEnd-fStart, &faceNew);CHKERRQ(ierr);
       faceTypeStart[0] = fStart;
       for (ct = 1; ct < DM_NUM_POLYTOPES; ++ct) faceTypeStart[ct] = faceTypeStart[ct-1] + faceTypeNum[ct-1];
-      for (c = cStart; c < cEnd; ++c) {
-        const PetscInt       *cone, *faceSizes, *faces;
-        const DMPolytopeType *faceTypes;
-        DMPolytopeType        ct;
-        PetscInt              numFaces, cf, foff = 0;
-
-        ierr = DMPlexGetCellType(dm, c, &ct);CHKERRQ(ierr);
-        ierr = DMPlexGetCone(dm, c, &cone);CHKERRQ(ierr);
-        ierr = DMPlexGetRawFaces_Internal(dm, ct, cone, &numFaces, &faceTypes, &faceSizes, &faces);CHKERRQ(ierr);
-        for (cf = 0; cf < numFaces; foff += faceSizes[cf], ++cf) {
-          const PetscInt       faceSize = faceSizes[cf];
-          const DMPolytopeType faceType = faceTypes[cf];
-          const PetscInt      *face     = &faces[foff];
-          PetscHashIJKLKey     key;
-          PetscHashIter        iter;
-          PetscBool            missing;
-
-          if (faceSize > 4) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Do not support faces of size %D > 4", faceSize);
-          key.i = face[0];
-          key.j = faceSize > 1 ? face[1] : PETSC_MAX_INT;
-          key.k = faceSize > 2 ? face[2] : PETSC_MAX_INT;
-          key.l = faceSize > 3 ? face[3] : PETSC_MAX_INT;
-          ierr = PetscSortInt(faceSize, (PetscInt *) &key);CHKERRQ(ierr);
-          ierr = PetscHashIJKLPut(faceTable, key, &iter, &missing);CHKERRQ(ierr);
-          if (missing) {ierr = PetscHashIJKLIterSet(faceTable, iter, faceTypeStart[faceType]++);CHKERRQ(ierr);}
-        }
-        ierr = DMPlexRestoreRawFaces_Internal(dm, ct, cone, &numFaces, &faceTypes, &faceSizes, &faces);CHKERRQ(ierr);
-      }
+      for (f = fStart; f < fEnd; ++f) faceNew[f-fStart] = faceTypeStart[faceTypeOf[f-fStart]]++;
       for (ct = 1; ct < DM_NUM_POLYTOPES; ++ct) {
         if (faceTypeStart[ct] != faceTypeStart[ct-1] + faceTypeNum[ct]) SETERRQ4(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Inconsistent numbering for cell type %s, %D != %D + %D", DMPolytopeTypes[ct], faceTypeStart[ct], faceTypeStart[ct-1], faceTypeNum[ct]);
       }
+      for (f = 0; f < Ncf; ++f) cellFaces[f] = faceNew[cellFaces[f]-fStart];
+      ierr = PetscFree(faceNew);CHKERRQ(ierr);
     }
   }
   /* Add new points, always at the end of the numbering */
@@ -440,33 +456,18 @@ static PetscErrorCode DMPlexInterpolateFaces_Internal(DM dm, PetscInt cellDepth,
     const PetscInt       *cone, *faceSizes, *faces;
     const DMPolytopeType *faceTypes;
     DMPolytopeType        ct;
-    PetscInt              numFaces, cf, foff = 0;
+    PetscInt              numFaces, cf;
 
     ierr = DMPlexGetCellType(dm, c, &ct);CHKERRQ(ierr);
     ierr = DMPlexGetCone(dm, c, &cone);CHKERRQ(ierr);
     ierr = DMPlexGetRawFaces_Internal(dm, ct, cone, &numFaces, &faceTypes, &faceSizes, &faces);CHKERRQ(ierr);
     ierr = DMPlexSetCellType(idm, c, ct);CHKERRQ(ierr);
     ierr = DMPlexSetConeSize(idm, c, numFaces);CHKERRQ(ierr);
-    for (cf = 0; cf < numFaces; foff += faceSizes[cf], ++cf) {
-      const PetscInt       faceSize = faceSizes[cf];
-      const DMPolytopeType faceType = faceTypes[cf];
-      const PetscInt      *face     = &faces[foff];
-      PetscHashIJKLKey     key;
-      PetscHashIter        iter;
-      PetscBool            missing;
-      PetscInt             f;
-
-      if (faceSize > 4) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Do not support faces of size %D > 4", faceSize);
-      key.i = face[0];
-      key.j = faceSize > 1 ? face[1] : PETSC_MAX_INT;
-      key.k = faceSize > 2 ? face[2] : PETSC_MAX_INT;
-      key.l = faceSize > 3 ? face[3] : PETSC_MAX_INT;
-      ierr = PetscSortInt(faceSize, (PetscInt *) &key);CHKERRQ(ierr);
-      ierr = PetscHashIJKLPut(faceTable, key, &iter, &missing);CHKERRQ(ierr);
-      if (missing) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Missing face (cell %D, lf %D)", c, cf);
-      ierr = PetscHashIJKLIterGet(faceTable, iter, &f);CHKERRQ(ierr);
-      ierr = DMPlexSetConeSize(idm, f, faceSize);CHKERRQ(ierr);
-      ierr = DMPlexSetCellType(idm, f, faceType);CHKERRQ(ierr);
+    for (cf = 0; cf < numFaces; ++cf) {
+      const PetscInt f = cellFaces[cellFaceOff[c-cStart]+cf];
+
+      ierr = DMPlexSetConeSize(idm, f, faceSizes[cf]);CHKERRQ(ierr);
+      ierr = DMPlexSetCellType(idm, f, faceTypes[cf]);CHKERRQ(ierr);
     }
     ierr = DMPlexRestoreRawFaces_Internal(dm, ct, cone, &numFaces, &faceTypes, &faceSizes, &faces);CHKERRQ(ierr);
   }
@@ -505,23 +506,12 @@ static PetscErrorCode DMPlexInterpolateFaces_Internal(DM dm, PetscInt cellDepth,
     ierr = DMPlexGetCone(dm, c, &cone);CHKERRQ(ierr);
     ierr = DMPlexGetRawFaces_Internal(dm, ct, cone, &numFaces, &faceTypes, &faceSizes, &faces);CHKERRQ(ierr);
     for (cf = 0; cf < numFaces; foff += faceSizes[cf], ++cf) {
-      DMPolytopeType   faceType = faceTypes[cf];
-      const PetscInt   faceSize = faceSizes[cf];
-      const PetscInt  *face     = &faces[foff];
-      const PetscInt  *fcone;
-      PetscHashIJKLKey key;
-      PetscHashIter    iter;
-      PetscBool        missing;
-      PetscInt         f;
+      DMPolytopeType  faceType = faceTypes[cf];
+      const PetscInt  faceSize = faceSizes[cf];
+      const PetscInt *face     = &faces[foff];
+      const PetscInt  f        = cellFaces[cellFaceOff[c-cStart]+cf];
+      const PetscInt *fcone;
 
-      if (faceSize > 4) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Do not support faces of size %D > 4", faceSize);
-      key.i = face[0];
-      key.j = faceSize > 1 ? face[1] : PETSC_MAX_INT;
-      key.k = faceSize > 2 ? face[2] : PETSC_MAX_INT;
-      key.l = faceSize > 3 ? face[3] : PETSC_MAX_INT;
-      ierr = PetscSortInt(faceSize, (PetscInt *) &key);CHKERRQ(ierr);
-      ierr = PetscHashIJKLPut(faceTable, key, &iter, &missing);CHKERRQ(ierr);
-      ierr = PetscHashIJKLIterGet(faceTable, iter, &f);CHKERRQ(ierr);
       ierr = DMPlexInsertCone(idm, c, cf, f);CHKERRQ(ierr);
       ierr = DMPlexGetCone(idm, f, &fcone);CHKERRQ(ierr);
       if (fcone[0] < 0) {ierr = DMPlexSetCone(idm, f, face);CHKERRQ(ierr);}
@@ -576,7 +566,8 @@ static PetscErrorCode DMPlexInterpolateFaces_Internal(DM dm, PetscInt cellDepth,
     }
     ierr = DMPlexRestoreRawFaces_Internal(dm, ct, cone, &numFaces, &faceTypes, &faceSizes, &faces);CHKERRQ(ierr);
   }
-  ierr = PetscHashIJKLDestroy(&faceTable);CHKERRQ(ierr);
+  ierr = PetscFree(cellFaceOff);CHKERRQ(ierr);
+  ierr = PetscFree2(cellFaces, faceTypeOf);CHKERRQ(ierr);
   ierr = DMPlexSymmetrize(idm);CHKERRQ(ierr);
   ierr = DMPlexStratify(idm);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -611,8 +602,8 @@ PetscErrorCode DMPlexOrientInterface_Internal(DM dm)
 {
   /* Here we only compare first 2 points of the cone. Full cone size would lead to stronger self-checking. */
   PetscInt          masterCone[2];
-  PetscInt          (*roots)[2], (*leaves)[2];
-  PetscMPIInt       (*rootsRanks)[2], (*leavesRanks)[2];
+  PetscSFNode       (*roots)[2], (*leaves)[2];
+  MPI_Datatype       nodePairType;
 
   PetscSF           sf=NULL;
   const PetscInt    *locals=NULL;
@@ -638,7 +629,7 @@ PetscErrorCode DMPlexOrientInterface_Internal(DM dm)
   ierr = DMViewFromOptions(dm, NULL, "-before_fix_dm_view");CHKERRQ(ierr);
   if (PetscDefined(USE_DEBUG)) {ierr = DMPlexCheckPointSF(dm);CHKERRQ(ierr);}
   ierr = SortRmineRremoteByRemote_Private(sf, &rmine1, &rremote1);CHKERRQ(ierr);
-  ierr = PetscMalloc4(nroots, &roots, nroots, &leaves, nroots, &rootsRanks, nroots, &leavesRanks);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nroots, &roots, nroots, &leaves);CHKERRQ(ierr);
   ierr = PetscObjectGetComm((PetscObject) dm, &comm);CHKERRQ(ierr);
   ierr = MPI_Comm_rank(comm, &rank);CHKERRMPI(ierr);
   ierr = MPI_Comm_size(comm, &size);CHKERRMPI(ierr);
@@ -647,8 +638,8 @@ PetscErrorCode DMPlexOrientInterface_Internal(DM dm)
     ierr = DMPlexGetCone(dm, p, &cone);CHKERRQ(ierr);
     if (coneSize < 2) {
       for (c = 0; c < 2; c++) {
-        roots[p][c] = -1;
-        rootsRanks[p][c] = -1;
+        roots[p][c].index = -1;
+        roots[p][c].rank  = -1;
       }
       continue;
     }
@@ -656,49 +647,50 @@ PetscErrorCode DMPlexOrientInterface_Internal(DM dm)
     for (c = 0; c < 2; c++) {
       ierr = PetscFindInt(cone[c], nleaves, locals, &ind0);CHKERRQ(ierr);
       if (ind0 < 0) {
-        roots[p][c] = cone[c];
-        rootsRanks[p][c] = rank;
+        roots[p][c].index = cone[c];
+        roots[p][c].rank  = rank;
       } else {
-        roots[p][c] = remotes[ind0].index;
-        rootsRanks[p][c] = remotes[ind0].rank;
+        roots[p][c] = remotes[ind0];
       }
     }
   }
   for (p = 0; p < nroots; ++p) {
     for (c = 0; c < 2; c++) {
-      leaves[p][c] = -2;
-      leavesRanks[p][c] = -2;
+      leaves[p][c].index = -2;
+      leaves[p][c].rank  = -2;
     }
   }
-  ierr = PetscSFBcastBegin(sf, MPIU_2INT, roots, leaves);CHKERRQ(ierr);
-  ierr = PetscSFBcastBegin(sf, MPI_2INT, rootsRanks, leavesRanks);CHKERRQ(ierr);
-  ierr = PetscSFBcastEnd(sf, MPIU_2INT, roots, leaves);CHKERRQ(ierr);
-  ierr = PetscSFBcastEnd(sf, MPI_2INT, rootsRanks, leavesRanks);CHKERRQ(ierr);
+  /* Send both cone points with their owners in a single round */
+  ierr = MPI_Type_contiguous(2, MPIU_2INT, &nodePairType);CHKERRMPI(ierr);
+  ierr = MPI_Type_commit(&nodePairType);CHKERRMPI(ierr);
+  ierr = PetscSFBcastBegin(sf, nodePairType, roots, leaves);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sf, nodePairType, roots, leaves);CHKERRQ(ierr);
+  ierr = MPI_Type_free(&nodePairType);CHKERRMPI(ierr);
   if (debug) {ierr = PetscSynchronizedFlush(comm, NULL);CHKERRQ(ierr);}
   if (debug && rank == 0) {ierr = PetscSynchronizedPrintf(comm, "Referenced roots\n");CHKERRQ(ierr);}
   for (p = 0; p < nroots; ++p) {
-    if (leaves[p][0] < 0) continue;
+    if (leaves[p][0].index < 0) continue;
     ierr = DMPlexGetConeSize(dm, p, &coneSize);CHKERRQ(ierr);
     ierr = DMPlexGetCone(dm, p, &cone);CHKERRQ(ierr);
-    if (debug) {ierr = PetscSynchronizedPrintf(comm, "[%d]  %4D: cone=[%4D %4D] roots=[(%d,%4D) (%d,%4D)] leaves=[(%d,%4D) (%d,%4D)]", rank, p, cone[0], cone[1], rootsRanks[p][0], roots[p][0], rootsRanks[p][1], roots[p][1], leavesRanks[p][0], leaves[p][0], leavesRanks[p][1], leaves[p][1]);CHKERRQ(ierr);}
-    if ((leaves[p][0] != roots[p][0]) || (leaves[p][1] != roots[p][1]) || (leavesRanks[p][0] != rootsRanks[p][0]) || (leavesRanks[p][1] != rootsRanks[p][1])) {
+    if (debug) {ierr = PetscSynchronizedPrintf(comm, "[%d]  %4D: cone=[%4D %4D] roots=[(%D,%4D) (%D,%4D)] leaves=[(%D,%4D) (%D,%4D)]", rank, p, cone[0], cone[1], roots[p][0].rank, roots[p][0].index, roots[p][1].rank, roots[p][1].index, leaves[p][0].rank, leaves[p][0].index, leaves[p][1].rank, leaves[p][1].index);CHKERRQ(ierr);}
+    if ((leaves[p][0].index != roots[p][0].index) || (leaves[p][1].index != roots[p][1].index) || (leaves[p][0].rank != roots[p][0].rank) || (leaves[p][1].rank != roots[p][1].rank)) {
       /* Translate these two leaves to my cone points; masterCone means desired order p's cone points */
       for (c = 0; c < 2; c++) {
-        if (leavesRanks[p][c] == rank) {
+        if (leaves[p][c].rank == rank) {
           /* A local leave is just taken as it is */
-          masterCone[c] = leaves[p][c];
+          masterCone[c] = leaves[p][c].index;
           continue;
         }
-        /* Find index of rank leavesRanks[p][c] among remote ranks */
+        /* Find index of rank leaves[p][c].rank among remote ranks */
         /* No need for PetscMPIIntCast because these integers were originally cast from PetscMPIInt. */
-        ierr = PetscFindMPIInt((PetscMPIInt)leavesRanks[p][c], nranks, ranks, &r);CHKERRQ(ierr);
-        if (PetscUnlikely(r < 0)) SETERRQ7(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Point %D cone[%D]=%D root (%d,%D) leave (%d,%D): leave rank not found among remote ranks",p,c,cone[c],rootsRanks[p][c],roots[p][c],leavesRanks[p][c],leaves[p][c]);
+        ierr = PetscFindMPIInt((PetscMPIInt)leaves[p][c].rank, nranks, ranks, &r);CHKERRQ(ierr);
+        if (PetscUnlikely(r < 0)) SETERRQ7(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Point %D cone[%D]=%D root (%D,%D) leave (%D,%D): leave rank not found among remote ranks",p,c,cone[c],roots[p][c].rank,roots[p][c].index,leaves[p][c].rank,leaves[p][c].index);
         if (PetscUnlikely(ranks[r] < 0 || ranks[r] >= size)) SETERRQ5(PETSC_COMM_SELF, PETSC_ERR_PLIB, "p=%D c=%D commsize=%d: ranks[%D] = %d makes no sense",p,c,size,r,ranks[r]);
-        /* Find point leaves[p][c] among remote points aimed at rank leavesRanks[p][c] */
+        /* Find point leaves[p][c].index among remote points aimed at rank leaves[p][c].rank */
         o = roffset[r];
         n = roffset[r+1] - o;
-        ierr = PetscFindInt(leaves[p][c], n, &rremote1[o], &ind0);CHKERRQ(ierr);
-        if (PetscUnlikely(ind0 < 0)) SETERRQ7(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Point %D cone[%D]=%D root (%d,%D) leave (%d,%D): corresponding remote point not found - it seems there is missing connection in point SF!",p,c,cone[c],rootsRanks[p][c],roots[p][c],leavesRanks[p][c],leaves[p][c]);
+        ierr = PetscFindInt(leaves[p][c].index, n, &rremote1[o], &ind0);CHKERRQ(ierr);
+        if (PetscUnlikely(ind0 < 0)) SETERRQ7(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Point %D cone[%D]=%D root (%D,%D) leave (%D,%D): corresponding remote point not found - it seems there is missing connection in point SF!",p,c,cone[c],roots[p][c].rank,roots[p][c].index,leaves[p][c].rank,leaves[p][c].index);
         /* Get the corresponding local point */
         masterCone[c] = rmine1[o+ind0];CHKERRQ(ierr);
       }
@@ -713,7 +705,7 @@ PetscErrorCode DMPlexOrientInterface_Internal(DM dm)
     ierr = MPI_Barrier(comm);CHKERRMPI(ierr);
   }
   ierr = DMViewFromOptions(dm, NULL, "-after_fix_dm_view");CHKERRQ(ierr);
-  ierr = PetscFree4(roots, leaves, rootsRanks, leavesRanks);CHKERRQ(ierr);
+  ierr = PetscFree2(roots, leaves);CHKERRQ(ierr);
   ierr = PetscFree2(rmine1, rremote1);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
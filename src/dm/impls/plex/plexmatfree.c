@@ -0,0 +1,628 @@
+#include <petsc/private/dmpleximpl.h>   /*I      "petscdmplex.h"   I*/
+#include <petscds.h>
+
+/*
+  Matrix-free application of the PetscDS Jacobian for a single scalar Lagrange field on tensor product cells.
+
+  The element basis is the tensor product of n1 one dimensional Lagrange polynomials, and the element quadrature
+  is the tensor product of Nq1 Gauss points, so that the basis can be applied one direction at a time (sum
+  factorization). The pointwise Jacobian g0-g3, the geometry, and the quadrature weights are folded into
+  reference space quadrature data when the linearization point is set:
+
+    c0    = w |J| g0
+    c1_j  = w |J| g1_i  invJ_ji
+    c2_j  = w |J| g2_i  invJ_ji
+    c3_jl = w |J| invJ_ji g3_ik invJ_lk
+
+  so that the action on a cell only needs the reference values and gradients of the input at the quadrature points.
+*/
+typedef struct {
+  DM               dm;
+  PetscInt         dim;        /* Spatial dimension */
+  PetscInt         cStart;     /* First cell */
+  PetscInt         cEnd;       /* Last cell + 1 */
+  PetscInt         Nb;         /* Number of element basis functions, n1^dim */
+  PetscInt         n1;         /* Number of 1D basis functions */
+  PetscInt         Nq1;        /* Number of 1D quadrature points */
+  PetscInt         Nq;         /* Number of element quadrature points, Nq1^dim */
+  PetscInt         Nd;         /* Size of the quadrature data at a point, 1 + 2 dim + dim^2 */
+  PetscInt        *perm;       /* perm[b] is the lexicographic index of closure basis function b */
+  PetscReal       *B, *D;      /* 1D basis values and derivatives, B[q*n1+i] = l_i(x_q) */
+  PetscQuadrature  quad;       /* Tensor Gauss quadrature, with direction 0 fastest */
+  PetscScalar     *qdata;      /* Quadrature data [cell][q][Nd] */
+  PetscBool        setup;      /* The quadrature data has been computed */
+  PetscScalar     *work;       /* Element work arrays */
+  Vec              locX, locY; /* Local work vectors */
+} DMPlexMatFreeCtx;
+
+static PetscErrorCode DMPlexMatFreeDestroy_Private(void *ptr)
+{
+  DMPlexMatFreeCtx *ctx = (DMPlexMatFreeCtx *) ptr;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(ctx->perm);CHKERRQ(ierr);
+  ierr = PetscFree2(ctx->B, ctx->D);CHKERRQ(ierr);
+  ierr = PetscQuadratureDestroy(&ctx->quad);CHKERRQ(ierr);
+  ierr = PetscFree(ctx->qdata);CHKERRQ(ierr);
+  ierr = PetscFree(ctx->work);CHKERRQ(ierr);
+  ierr = VecDestroy(&ctx->locX);CHKERRQ(ierr);
+  ierr = VecDestroy(&ctx->locY);CHKERRQ(ierr);
+  ierr = PetscFree(ctx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Apply the 1D operator M along direction d of the tensor x, whose extents are n[], so that n[d] becomes nout in y.
+   M is stored as [Nq1][n1], and is applied transposed when mapping quadrature points back to basis functions. */
+PETSC_STATIC_INLINE void DMPlexMatFreeContract_Private(PetscInt dim, const PetscInt n[], PetscInt d, PetscInt nout, const PetscReal M[], PetscBool transpose, const PetscScalar x[], PetscScalar y[])
+{
+  const PetscInt nin = n[d];
+  PetscInt       pre = 1, post = 1, e, i, o, k, p;
+
+  for (e = 0; e < d; ++e)       pre  *= n[e];
+  for (e = d+1; e < dim; ++e)   post *= n[e];
+  for (i = 0; i < post; ++i) {
+    for (o = 0; o < nout; ++o) {
+      PetscScalar *yo = &y[(i*nout+o)*pre];
+
+      for (p = 0; p < pre; ++p) yo[p] = 0.0;
+      for (k = 0; k < nin; ++k) {
+        const PetscReal    m  = transpose ? M[k*nout+o] : M[o*nin+k];
+        const PetscScalar *xk = &x[(i*nin+k)*pre];
+
+        for (p = 0; p < pre; ++p) yo[p] += m*xk[p];
+      }
+    }
+  }
+}
+
+/* Interpolate lexicographic element coefficients u[] to the quadrature points: values uq[] and, for each direction j, reference derivatives duq[j*Nq+q] */
+static void DMPlexMatFreeInterpolate_Private(DMPlexMatFreeCtx *ctx, const PetscScalar u[], PetscScalar uq[], PetscScalar duq[], PetscScalar w0[], PetscScalar w1[])
+{
+  const PetscInt dim = ctx->dim;
+  PetscInt       j, d, n[3];
+
+  for (j = -1; j < dim; ++j) {
+    const PetscScalar *in  = u;
+    PetscScalar       *out = w0, *res = j < 0 ? uq : &duq[j*ctx->Nq];
+
+    for (d = 0; d < dim; ++d) n[d] = ctx->n1;
+    for (d = 0; d < dim; ++d) {
+      if (d == dim-1) out = res;
+      DMPlexMatFreeContract_Private(dim, n, d, ctx->Nq1, d == j ? ctx->D : ctx->B, PETSC_FALSE, in, out);
+      n[d] = ctx->Nq1;
+      in   = out;
+      out  = out == w0 ? w1 : w0;
+    }
+  }
+}
+
+/* Accumulate the transpose interpolation of fq[] (values) and dfq[] (reference derivatives) into lexicographic element coefficients f[] */
+static void DMPlexMatFreeIntegrate_Private(DMPlexMatFreeCtx *ctx, const PetscScalar fq[], const PetscScalar dfq[], PetscScalar f[], PetscScalar w0[], PetscScalar w1[])
+{
+  const PetscInt dim = ctx->dim;
+  PetscInt       j, d, b, n[3];
+
+  for (b = 0; b < ctx->Nb; ++b) f[b] = 0.0;
+  for (j = -1; j < dim; ++j) {
+    const PetscScalar *in  = j < 0 ? fq : &dfq[j*ctx->Nq];
+    PetscScalar       *out = w0;
+
+    for (d = 0; d < dim; ++d) n[d] = ctx->Nq1;
+    for (d = 0; d < dim; ++d) {
+      DMPlexMatFreeContract_Private(dim, n, d, ctx->n1, d == j ? ctx->D : ctx->B, PETSC_TRUE, in, out);
+      n[d] = ctx->n1;
+      in   = out;
+      out  = out == w0 ? w1 : w0;
+    }
+    for (b = 0; b < ctx->Nb; ++b) f[b] += in[b];
+  }
+}
+
+/* Flops for one cell: (dim+1) passes in each direction, each way */
+static PetscLogDouble DMPlexMatFreeCellFlops_Private(DMPlexMatFreeCtx *ctx)
+{
+  PetscLogDouble flops = 0.0, size = 1.0;
+  PetscInt       d;
+
+  for (d = 0; d < ctx->dim; ++d) size *= ctx->n1;
+  for (d = 0; d < ctx->dim; ++d) {
+    flops += 2.0*size*ctx->Nq1;
+    size   = size/ctx->n1*ctx->Nq1;
+  }
+  return 2.0*(ctx->dim+1)*flops + 2.0*ctx->Nq*ctx->Nd;
+}
+
+/* Determine whether the discretization is supported, and if so create the 1D tabulation and the basis permutation */
+static PetscErrorCode DMPlexMatFreeCreate_Private(DM dm, DMPlexMatFreeCtx **mfctx)
+{
+  DMPlexMatFreeCtx *ctx;
+  DM                dmAux;
+  PetscDS           ds;
+  PetscObject       obj;
+  PetscClassId      id;
+  PetscFE           fe;
+  PetscDualSpace    sp;
+  PetscQuadrature   q;
+  PetscTabulation   T;
+  PetscSection      anchorSection;
+  PetscReal        *nodes, *x1, *w1, *points, *qpoints, *weights;
+  PetscInt          dim, cdim, Nds, Nf, Nc, Nb, Nq, Nq1, n1 = 0, b, d, i, k, m;
+  PetscBool         isPlex, hasBd, valid = PETSC_TRUE;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  *mfctx = NULL;
+  ierr = PetscObjectTypeCompare((PetscObject) dm, DMPLEX, &isPlex);CHKERRQ(ierr);
+  if (!isPlex) PetscFunctionReturn(0);
+  ierr = DMGetDimension(dm, &dim);CHKERRQ(ierr);
+  ierr = DMGetCoordinateDim(dm, &cdim);CHKERRQ(ierr);
+  if (dim < 1 || dim > 3 || cdim != dim) PetscFunctionReturn(0);
+  ierr = DMGetNumDS(dm, &Nds);CHKERRQ(ierr);
+  if (Nds != 1) PetscFunctionReturn(0);
+  ierr = DMGetDS(dm, &ds);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  if (Nf != 1) PetscFunctionReturn(0);
+  ierr = PetscDSHasBdJacobian(ds, &hasBd);CHKERRQ(ierr);
+  if (hasBd) PetscFunctionReturn(0);
+  ierr = PetscObjectQuery((PetscObject) dm, "dmAux", (PetscObject *) &dmAux);CHKERRQ(ierr);
+  if (dmAux) PetscFunctionReturn(0);
+  ierr = DMPlexGetAnchors(dm, &anchorSection, NULL);CHKERRQ(ierr);
+  if (anchorSection) PetscFunctionReturn(0);
+  ierr = PetscDSGetDiscretization(ds, 0, &obj);CHKERRQ(ierr);
+  ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+  if (id != PETSCFE_CLASSID) PetscFunctionReturn(0);
+  fe   = (PetscFE) obj;
+  ierr = PetscFEGetNumComponents(fe, &Nc);CHKERRQ(ierr);
+  if (Nc != 1) PetscFunctionReturn(0);
+  ierr = PetscFEGetDimension(fe, &Nb);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(fe, &q);CHKERRQ(ierr);
+  ierr = PetscQuadratureGetData(q, NULL, NULL, &Nq, NULL, NULL);CHKERRQ(ierr);
+  for (Nq1 = 1; (PetscInt) PetscPowInt(Nq1, dim) < Nq; ++Nq1);
+  if (PetscPowInt(Nq1, dim) != Nq) PetscFunctionReturn(0);
+  /* The nodes of the 1D basis are the distinct coordinates of the point evaluation functionals */
+  ierr = PetscFEGetDualSpace(fe, &sp);CHKERRQ(ierr);
+  ierr = PetscMalloc1(Nb*dim, &nodes);CHKERRQ(ierr);
+  for (b = 0; b < Nb; ++b) {
+    PetscQuadrature  f;
+    const PetscReal *fp;
+    PetscInt         Np;
+
+    ierr = PetscDualSpaceGetFunctional(sp, b, &f);CHKERRQ(ierr);
+    ierr = PetscQuadratureGetData(f, NULL, NULL, &Np, &fp, NULL);CHKERRQ(ierr);
+    if (Np != 1) {ierr = PetscFree(nodes);CHKERRQ(ierr); PetscFunctionReturn(0);}
+    for (d = 0; d < dim; ++d) nodes[b*dim+d] = fp[d];
+  }
+  ierr = PetscNew(&ctx);CHKERRQ(ierr);
+  ierr = PetscMalloc1(Nb, &x1);CHKERRQ(ierr);
+  for (b = 0; b < Nb; ++b) {
+    for (i = 0; i < n1; ++i) if (PetscAbsReal(x1[i] - nodes[b*dim]) < PETSC_SMALL) break;
+    if (i == n1) x1[n1++] = nodes[b*dim];
+  }
+  ierr = PetscSortReal(n1, x1);CHKERRQ(ierr);
+  if (PetscPowInt(n1, dim) != Nb) valid = PETSC_FALSE;
+  ierr = PetscMalloc1(Nb, &ctx->perm);CHKERRQ(ierr);
+  for (b = 0; b < Nb && valid; ++b) ctx->perm[b] = -1;
+  for (b = 0; b < Nb && valid; ++b) {
+    PetscInt lex = 0;
+
+    for (d = dim-1; d >= 0; --d) {
+      for (i = 0; i < n1; ++i) if (PetscAbsReal(x1[i] - nodes[b*dim+d]) < PETSC_SMALL) break;
+      if (i == n1) {valid = PETSC_FALSE; break;}
+      lex = lex*n1 + i;
+    }
+    if (!valid) break;
+    for (i = 0; i < b; ++i) if (ctx->perm[i] == lex) {valid = PETSC_FALSE; break;}
+    ctx->perm[b] = lex;
+  }
+  ierr = PetscFree(nodes);CHKERRQ(ierr);
+  if (!valid) {
+    ierr = PetscFree(x1);CHKERRQ(ierr);
+    ierr = DMPlexMatFreeDestroy_Private(ctx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  /* Tabulate the 1D Lagrange basis at the Gauss points */
+  ctx->dm  = dm;
+  ctx->dim = dim;
+  ctx->Nb  = Nb;
+  ctx->n1  = n1;
+  ctx->Nq1 = Nq1;
+  ctx->Nq  = Nq;
+  ctx->Nd  = 1 + 2*dim + dim*dim;
+  ierr = PetscMalloc2(Nq1, &points, Nq1, &w1);CHKERRQ(ierr);
+  ierr = PetscDTGaussQuadrature(Nq1, -1.0, 1.0, points, w1);CHKERRQ(ierr);
+  ierr = PetscMalloc2(Nq1*n1, &ctx->B, Nq1*n1, &ctx->D);CHKERRQ(ierr);
+  for (k = 0; k < Nq1; ++k) {
+    for (i = 0; i < n1; ++i) {
+      PetscReal val = 1.0, der = 0.0;
+      PetscInt  l;
+
+      for (m = 0; m < n1; ++m) if (m != i) val *= (points[k] - x1[m])/(x1[i] - x1[m]);
+      for (l = 0; l < n1; ++l) {
+        PetscReal prod;
+
+        if (l == i) continue;
+        prod = 1.0/(x1[i] - x1[l]);
+        for (m = 0; m < n1; ++m) if (m != i && m != l) prod *= (points[k] - x1[m])/(x1[i] - x1[m]);
+        der += prod;
+      }
+      ctx->B[k*n1+i] = val;
+      ctx->D[k*n1+i] = der;
+    }
+  }
+  ierr = PetscFree(x1);CHKERRQ(ierr);
+  /* Tensor quadrature, direction 0 fastest */
+  ierr = PetscMalloc1(Nq*dim, &qpoints);CHKERRQ(ierr);
+  ierr = PetscMalloc1(Nq, &weights);CHKERRQ(ierr);
+  for (k = 0; k < Nq; ++k) {
+    PetscInt r = k;
+
+    weights[k] = 1.0;
+    for (d = 0; d < dim; ++d, r /= Nq1) {
+      qpoints[k*dim+d] = points[r%Nq1];
+      weights[k] *= w1[r%Nq1];
+    }
+  }
+  ierr = PetscFree2(points, w1);CHKERRQ(ierr);
+  ierr = PetscQuadratureCreate(PETSC_COMM_SELF, &ctx->quad);CHKERRQ(ierr);
+  ierr = PetscQuadratureSetData(ctx->quad, dim, 1, Nq, qpoints, weights);CHKERRQ(ierr);
+  /* Check that the tensor basis reproduces the tabulation of the PetscFE */
+  ierr = PetscFECreateTabulation(fe, 1, Nq, qpoints, 1, &T);CHKERRQ(ierr);
+  for (k = 0; k < Nq && valid; ++k) {
+    for (b = 0; b < Nb && valid; ++b) {
+      PetscReal val = 1.0, der[3] = {1.0, 1.0, 1.0};
+      PetscInt  r = k, s = ctx->perm[b], j;
+
+      for (d = 0; d < dim; ++d, r /= Nq1, s /= n1) {
+        for (j = 0; j < dim; ++j) der[j] *= (j == d ? ctx->D : ctx->B)[(r%Nq1)*n1 + s%n1];
+        val *= ctx->B[(r%Nq1)*n1 + s%n1];
+      }
+      if (PetscAbsReal(val - T->T[0][k*Nb+b]) > PETSC_SQRT_MACHINE_EPSILON) valid = PETSC_FALSE;
+      for (j = 0; j < dim; ++j) if (PetscAbsReal(der[j] - T->T[1][(k*Nb+b)*dim+j]) > PETSC_SQRT_MACHINE_EPSILON*PetscMax(1.0, PetscAbsReal(der[j]))) valid = PETSC_FALSE;
+    }
+  }
+  ierr = PetscTabulationDestroy(&T);CHKERRQ(ierr);
+  if (!valid) {ierr = DMPlexMatFreeDestroy_Private(ctx);CHKERRQ(ierr); PetscFunctionReturn(0);}
+  ierr = DMPlexGetSimplexOrBoxCells(dm, 0, &ctx->cStart, &ctx->cEnd);CHKERRQ(ierr);
+  m    = PetscMax(n1, Nq1);
+  ierr = PetscMalloc1(2*PetscPowInt(m, dim) + 2*Nb + 2*(dim+1)*Nq, &ctx->work);CHKERRQ(ierr);
+  *mfctx = ctx;
+  PetscFunctionReturn(0);
+}
+
+/* Compute the quadrature data at the linearization point given by the local vector locX, which may be NULL */
+static PetscErrorCode DMPlexMatFreeSetUpQuadratureData_Private(DMPlexMatFreeCtx *ctx, Vec locX)
+{
+  DM                 dm = ctx->dm;
+  const PetscInt     dim = ctx->dim, Nq = ctx->Nq, Nb = ctx->Nb, Nd = ctx->Nd;
+  PetscDS            ds;
+  PetscSection       section;
+  PetscScalar       *u, *uq, *duq, *w0, *w1, g0[1], g1[3], g2[3], g3[9], u0[1], u0_x[3];
+  PetscReal         *v, *J, *invJ, *detJ;
+  const PetscReal   *weights;
+  const PetscScalar *constants;
+  PetscInt          *uOff, *uOff_x, numConstants, c, q, i, j, k, l, b;
+  PetscPointJac      g0_func, g1_func, g2_func, g3_func;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = DMGetDS(dm, &ds);CHKERRQ(ierr);
+  ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
+  ierr = PetscDSGetJacobian(ds, 0, 0, &g0_func, &g1_func, &g2_func, &g3_func);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  ierr = PetscQuadratureGetData(ctx->quad, NULL, NULL, NULL, NULL, &weights);CHKERRQ(ierr);
+  if (!ctx->qdata) {ierr = PetscMalloc1((ctx->cEnd-ctx->cStart)*Nq*Nd, &ctx->qdata);CHKERRQ(ierr);}
+  ierr = PetscMalloc4(Nq*dim, &v, Nq*dim*dim, &J, Nq*dim*dim, &invJ, Nq, &detJ);CHKERRQ(ierr);
+  w0   = ctx->work;
+  w1   = &w0[PetscPowInt(PetscMax(ctx->n1, ctx->Nq1), dim)];
+  u    = &w1[PetscPowInt(PetscMax(ctx->n1, ctx->Nq1), dim)];
+  uq   = &u[2*Nb];
+  duq  = &uq[Nq];
+  for (c = ctx->cStart; c < ctx->cEnd; ++c) {
+    PetscScalar *qd = &ctx->qdata[(c-ctx->cStart)*Nq*Nd];
+
+    ierr = DMPlexComputeCellGeometryFEM(dm, c, ctx->quad, v, J, invJ, detJ);CHKERRQ(ierr);
+    if (locX) {
+      PetscScalar *x = NULL;
+      PetscInt     csize;
+
+      ierr = DMPlexVecGetClosure(dm, section, locX, c, &csize, &x);CHKERRQ(ierr);
+      if (csize != Nb) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Closure size %D for cell %D != %D basis functions", csize, c, Nb);
+      for (b = 0; b < Nb; ++b) u[ctx->perm[b]] = x[b];
+      ierr = DMPlexVecRestoreClosure(dm, section, locX, c, &csize, &x);CHKERRQ(ierr);
+    } else {
+      for (b = 0; b < Nb; ++b) u[b] = 0.0;
+    }
+    DMPlexMatFreeInterpolate_Private(ctx, u, uq, duq, w0, w1);
+    for (q = 0; q < Nq; ++q) {
+      const PetscReal *iJ = &invJ[q*dim*dim];
+      const PetscReal  wdetJ = weights[q]*detJ[q];
+      PetscScalar     *d0 = &qd[q*Nd], *d1 = &d0[1], *d2 = &d1[dim], *d3 = &d2[dim];
+
+      u0[0] = uq[q];
+      for (i = 0; i < dim; ++i) {
+        u0_x[i] = 0.0;
+        for (j = 0; j < dim; ++j) u0_x[i] += duq[j*Nq+q]*iJ[j*dim+i];
+      }
+      ierr = PetscArrayzero(g0, 1);CHKERRQ(ierr);
+      ierr = PetscArrayzero(g1, dim);CHKERRQ(ierr);
+      ierr = PetscArrayzero(g2, dim);CHKERRQ(ierr);
+      ierr = PetscArrayzero(g3, dim*dim);CHKERRQ(ierr);
+      if (g0_func) g0_func(dim, 1, 0, uOff, uOff_x, u0, NULL, u0_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &v[q*dim], numConstants, constants, g0);
+      if (g1_func) g1_func(dim, 1, 0, uOff, uOff_x, u0, NULL, u0_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &v[q*dim], numConstants, constants, g1);
+      if (g2_func) g2_func(dim, 1, 0, uOff, uOff_x, u0, NULL, u0_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &v[q*dim], numConstants, constants, g2);
+      if (g3_func) g3_func(dim, 1, 0, uOff, uOff_x, u0, NULL, u0_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &v[q*dim], numConstants, constants, g3);
+      d0[0] = wdetJ*g0[0];
+      for (j = 0; j < dim; ++j) {
+        d1[j] = d2[j] = 0.0;
+        for (i = 0; i < dim; ++i) {
+          d1[j] += wdetJ*g1[i]*iJ[j*dim+i];
+          d2[j] += wdetJ*g2[i]*iJ[j*dim+i];
+        }
+        for (l = 0; l < dim; ++l) {
+          d3[j*dim+l] = 0.0;
+          for (i = 0; i < dim; ++i) for (k = 0; k < dim; ++k) d3[j*dim+l] += wdetJ*iJ[j*dim+i]*g3[i*dim+k]*iJ[l*dim+k];
+        }
+      }
+    }
+  }
+  ierr = PetscFree4(v, J, invJ, detJ);CHKERRQ(ierr);
+  ctx->setup = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexMatFreeGetContext_Private(Mat A, DMPlexMatFreeCtx **ctx)
+{
+  PetscContainer container;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectQuery((PetscObject) A, "DMPlexMatFreeCtx", (PetscObject *) &container);CHKERRQ(ierr);
+  if (!container) SETERRQ(PetscObjectComm((PetscObject) A), PETSC_ERR_ARG_WRONG, "Matrix was not created by DMPlexCreateMatrixFree()");
+  ierr = PetscContainerGetPointer(container, (void **) ctx);CHKERRQ(ierr);
+  if (!(*ctx)->setup) {ierr = DMPlexMatFreeSetUpQuadratureData_Private(*ctx, NULL);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexMatFreeMult_Private(Mat A, Vec X, Vec Y, PetscBool transpose)
+{
+  DMPlexMatFreeCtx *ctx;
+  DM                dm;
+  PetscSection      section;
+  PetscScalar      *w0, *w1, *u, *f, *uq, *duq, *fq, *dfq;
+  PetscInt          dim, Nq, Nb, Nd, c, q, j, l, b;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexMatFreeGetContext_Private(A, &ctx);CHKERRQ(ierr);
+  dm   = ctx->dm;
+  dim  = ctx->dim; Nq = ctx->Nq; Nb = ctx->Nb; Nd = ctx->Nd;
+  ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
+  if (!ctx->locX) {ierr = DMCreateLocalVector(dm, &ctx->locX);CHKERRQ(ierr);}
+  if (!ctx->locY) {ierr = DMCreateLocalVector(dm, &ctx->locY);CHKERRQ(ierr);}
+  /* Constrained dofs stay zero, so that the action is that of the operator on the free dofs */
+  ierr = VecZeroEntries(ctx->locX);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(dm, X, INSERT_VALUES, ctx->locX);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(dm, X, INSERT_VALUES, ctx->locX);CHKERRQ(ierr);
+  ierr = VecZeroEntries(ctx->locY);CHKERRQ(ierr);
+  w0   = ctx->work;
+  w1   = &w0[PetscPowInt(PetscMax(ctx->n1, ctx->Nq1), dim)];
+  u    = &w1[PetscPowInt(PetscMax(ctx->n1, ctx->Nq1), dim)];
+  f    = &u[Nb];
+  uq   = &f[Nb];
+  duq  = &uq[Nq];
+  fq   = &duq[dim*Nq];
+  dfq  = &fq[Nq];
+  for (c = ctx->cStart; c < ctx->cEnd; ++c) {
+    const PetscScalar *qd = &ctx->qdata[(c-ctx->cStart)*Nq*Nd];
+    PetscScalar       *x  = NULL;
+    PetscInt           csize;
+
+    ierr = DMPlexVecGetClosure(dm, section, ctx->locX, c, &csize, &x);CHKERRQ(ierr);
+    for (b = 0; b < Nb; ++b) u[ctx->perm[b]] = x[b];
+    ierr = DMPlexVecRestoreClosure(dm, section, ctx->locX, c, &csize, &x);CHKERRQ(ierr);
+    DMPlexMatFreeInterpolate_Private(ctx, u, uq, duq, w0, w1);
+    for (q = 0; q < Nq; ++q) {
+      const PetscScalar *d0 = &qd[q*Nd], *d1 = &d0[1], *d2 = &d1[dim], *d3 = &d2[dim];
+      const PetscScalar *dv = transpose ? d2 : d1, *dd = transpose ? d1 : d2;
+
+      fq[q] = d0[0]*uq[q];
+      for (j = 0; j < dim; ++j) {
+        fq[q]        += dv[j]*duq[j*Nq+q];
+        dfq[j*Nq+q]   = dd[j]*uq[q];
+        for (l = 0; l < dim; ++l) dfq[j*Nq+q] += (transpose ? d3[l*dim+j] : d3[j*dim+l])*duq[l*Nq+q];
+      }
+    }
+    DMPlexMatFreeIntegrate_Private(ctx, fq, dfq, u, w0, w1);
+    for (b = 0; b < Nb; ++b) f[b] = u[ctx->perm[b]];
+    ierr = DMPlexVecSetClosure(dm, section, ctx->locY, c, f, ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = VecZeroEntries(Y);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalBegin(dm, ctx->locY, ADD_VALUES, Y);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalEnd(dm, ctx->locY, ADD_VALUES, Y);CHKERRQ(ierr);
+  ierr = PetscLogFlops((ctx->cEnd-ctx->cStart)*DMPlexMatFreeCellFlops_Private(ctx));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMult_Plex_MatFree(Mat A, Vec X, Vec Y)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexMatFreeMult_Private(A, X, Y, PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultTranspose_Plex_MatFree(Mat A, Vec X, Vec Y)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexMatFreeMult_Private(A, X, Y, PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* The diagonal is integrated directly from the tensor product basis, without forming element matrices */
+static PetscErrorCode MatGetDiagonal_Plex_MatFree(Mat A, Vec D)
+{
+  DMPlexMatFreeCtx *ctx;
+  DM                dm;
+  PetscSection      section;
+  PetscScalar      *f;
+  PetscInt          dim, Nq, Nb, Nd, n1, Nq1, c, q, j, l, b, d;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexMatFreeGetContext_Private(A, &ctx);CHKERRQ(ierr);
+  dm   = ctx->dm;
+  dim  = ctx->dim; Nq = ctx->Nq; Nb = ctx->Nb; Nd = ctx->Nd; n1 = ctx->n1; Nq1 = ctx->Nq1;
+  ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
+  if (!ctx->locY) {ierr = DMCreateLocalVector(dm, &ctx->locY);CHKERRQ(ierr);}
+  ierr = VecZeroEntries(ctx->locY);CHKERRQ(ierr);
+  f    = ctx->work;
+  for (c = ctx->cStart; c < ctx->cEnd; ++c) {
+    const PetscScalar *qd = &ctx->qdata[(c-ctx->cStart)*Nq*Nd];
+
+    for (b = 0; b < Nb; ++b) {
+      const PetscInt lex = ctx->perm[b];
+
+      f[b] = 0.0;
+      for (q = 0; q < Nq; ++q) {
+        const PetscScalar *d0 = &qd[q*Nd], *d1 = &d0[1], *d2 = &d1[dim], *d3 = &d2[dim];
+        PetscReal          phi = 1.0, dphi[3] = {1.0, 1.0, 1.0};
+        PetscInt           r = q, s = lex;
+
+        for (d = 0; d < dim; ++d, r /= Nq1, s /= n1) {
+          for (j = 0; j < dim; ++j) dphi[j] *= (j == d ? ctx->D : ctx->B)[(r%Nq1)*n1 + s%n1];
+          phi *= ctx->B[(r%Nq1)*n1 + s%n1];
+        }
+        f[b] += d0[0]*phi*phi;
+        for (j = 0; j < dim; ++j) {
+          f[b] += (d1[j] + d2[j])*phi*dphi[j];
+          for (l = 0; l < dim; ++l) f[b] += dphi[j]*d3[j*dim+l]*dphi[l];
+        }
+      }
+    }
+    ierr = DMPlexVecSetClosure(dm, section, ctx->locY, c, f, ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = VecZeroEntries(D);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalBegin(dm, ctx->locY, ADD_VALUES, D);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalEnd(dm, ctx->locY, ADD_VALUES, D);CHKERRQ(ierr);
+  ierr = PetscLogFlops((ctx->cEnd-ctx->cStart)*Nb*Nq*(4.0*dim + 3.0*dim*dim + 3.0));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexMatrixFreeSetSolution_Plex(Mat A, Vec locX)
+{
+  DMPlexMatFreeCtx *ctx;
+  PetscContainer    container;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectQuery((PetscObject) A, "DMPlexMatFreeCtx", (PetscObject *) &container);CHKERRQ(ierr);
+  ierr = PetscContainerGetPointer(container, (void **) &ctx);CHKERRQ(ierr);
+  ierr = DMPlexMatFreeSetUpQuadratureData_Private(ctx, locX);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Turn the shell matrix J into a matrix-free operator if the discretization of dm is supported */
+PetscErrorCode DMPlexSetUpMatrixFree_Internal(DM dm, Mat J, PetscBool *supported)
+{
+  DMPlexMatFreeCtx *ctx;
+  PetscContainer    container;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexMatFreeCreate_Private(dm, &ctx);CHKERRQ(ierr);
+  *supported = ctx ? PETSC_TRUE : PETSC_FALSE;
+  if (!ctx) PetscFunctionReturn(0);
+  ierr = MatSetUp(J);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF, &container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container, ctx);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container, DMPlexMatFreeDestroy_Private);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject) J, "DMPlexMatFreeCtx", (PetscObject) container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(J, MATOP_MULT, (void (*)(void)) MatMult_Plex_MatFree);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(J, MATOP_MULT_TRANSPOSE, (void (*)(void)) MatMultTranspose_Plex_MatFree);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(J, MATOP_GET_DIAGONAL, (void (*)(void)) MatGetDiagonal_Plex_MatFree);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject) J, "DMPlexMatrixFreeSetSolution_C", DMPlexMatrixFreeSetSolution_Plex);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMPlexCreateMatrixFree - Create a matrix-free operator which applies the Jacobian of the PetscDS using sum factorization
+
+  Collective on dm
+
+  Input Parameter:
+. dm - The DMPlex, with a single scalar Lagrange PetscFE field on tensor product cells
+
+  Output Parameter:
+. J  - The MATSHELL operator
+
+  Options Database Keys:
+. -dm_mat_type shell - DMCreateMatrix() on such a DMPlex returns this operator
+
+  Notes:
+  The element basis is applied one direction at a time, so that the action on a cell of degree k costs O(k^{d+1}) rather
+  than the O(k^{2d}) of an element matrix, and no matrix is stored. The quadrature is the tensor Gauss rule with the
+  same number of points as the quadrature of the PetscFE. The pointwise Jacobian, evaluated at the linearization point
+  given with DMPlexMatrixFreeSetSolution(), is folded together with the cell geometry into data stored at each
+  quadrature point. The operator supports MatMult(), MatMultTranspose(), and MatGetDiagonal(), so that it can be
+  smoothed with Jacobi or Chebyshev-Jacobi.
+
+  Combined with DMPlexCreatePCoarseDM(), this gives a matrix-free p-multigrid for PCMG.
+
+  Level: intermediate
+
+.seealso: DMPlexMatrixFreeSetSolution(), DMPlexCreatePCoarseDM(), DMCreateMatrix(), DMPlexSNESComputeJacobianFEM()
+@*/
+PetscErrorCode DMPlexCreateMatrixFree(DM dm, Mat *J)
+{
+  PetscSection   sectionGlobal;
+  PetscInt       localSize;
+  PetscBool      supported;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidPointer(J, 2);
+  ierr = DMGetGlobalSection(dm, &sectionGlobal);CHKERRQ(ierr);
+  ierr = PetscSectionGetConstrainedStorageSize(sectionGlobal, &localSize);CHKERRQ(ierr);
+  ierr = MatCreate(PetscObjectComm((PetscObject) dm), J);CHKERRQ(ierr);
+  ierr = MatSetSizes(*J, localSize, localSize, PETSC_DETERMINE, PETSC_DETERMINE);CHKERRQ(ierr);
+  ierr = MatSetType(*J, MATSHELL);CHKERRQ(ierr);
+  ierr = DMPlexSetUpMatrixFree_Internal(dm, *J, &supported);CHKERRQ(ierr);
+  if (!supported) SETERRQ(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "Matrix-free application needs a single scalar Lagrange field on tensor product cells");
+  ierr = MatSetDM(*J, dm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMPlexMatrixFreeSetSolution - Set the linearization point of a matrix-free operator
+
+  Logically collective on J
+
+  Input Parameters:
++ J    - The operator from DMPlexCreateMatrixFree()
+- locX - The local solution vector, with boundary values inserted, or NULL for the zero state
+
+  Note:
+  This is called by DMPlexSNESComputeJacobianFEM(), and does nothing for other matrices.
+
+  Level: intermediate
+
+.seealso: DMPlexCreateMatrixFree()
+@*/
+PetscErrorCode DMPlexMatrixFreeSetSolution(Mat J, Vec locX)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(J, MAT_CLASSID, 1);
+  if (locX) PetscValidHeaderSpecific(locX, VEC_CLASSID, 2);
+  ierr = PetscTryMethod(J, "DMPlexMatrixFreeSetSolution_C", (Mat, Vec), (J, locX));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
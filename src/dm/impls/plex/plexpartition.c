@@ -4,15 +4,55 @@
 
 PETSC_STATIC_INLINE PetscInt DMPlex_GlobalID(PetscInt point) { return point >= 0 ? point : -(point+1); }
 
-static PetscErrorCode DMPlexCreatePartitionerGraph_Native(DM dm, PetscInt height, PetscInt *numVertices, PetscInt **offsets, PetscInt **adjacency, IS *globalNumbering)
+/* The weight of a graph edge is the number of dofs in the closure of the face it crosses, which are exchanged if the edge is cut */
+static PetscErrorCode DMPlexGetFaceWeight_Private(DM dm, PetscSection section, PetscInt face, PetscInt *weight)
+{
+  PetscInt      *closure = NULL;
+  PetscInt       clSize, cl, dof;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *weight = 0;
+  if (section) {
+    ierr = DMPlexGetTransitiveClosure(dm, face, PETSC_TRUE, &clSize, &closure);CHKERRQ(ierr);
+    for (cl = 0; cl < clSize*2; cl += 2) {
+      ierr = PetscSectionGetDof(section, closure[cl], &dof);CHKERRQ(ierr);
+      *weight += dof;
+    }
+    ierr = DMPlexRestoreTransitiveClosure(dm, face, PETSC_TRUE, &clSize, &closure);CHKERRQ(ierr);
+  }
+  *weight = PetscMax(*weight, 1);
+  PetscFunctionReturn(0);
+}
+
+/* Find the face of cell shared with the adjacent cell neighbor, or -1 if there is none, as for non-conforming meshes */
+static PetscErrorCode DMPlexGetSharedFace_Private(DM dm, PetscInt cell, PetscInt neighbor, PetscInt *face)
+{
+  const PetscInt *cone, *support;
+  PetscInt        coneSize, supportSize, c, s;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  *face = -1;
+  ierr = DMPlexGetConeSize(dm, cell, &coneSize);CHKERRQ(ierr);
+  ierr = DMPlexGetCone(dm, cell, &cone);CHKERRQ(ierr);
+  for (c = 0; c < coneSize; ++c) {
+    ierr = DMPlexGetSupportSize(dm, cone[c], &supportSize);CHKERRQ(ierr);
+    ierr = DMPlexGetSupport(dm, cone[c], &support);CHKERRQ(ierr);
+    for (s = 0; s < supportSize; ++s) if (support[s] == neighbor) {*face = cone[c]; PetscFunctionReturn(0);}
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexCreatePartitionerGraph_Native(DM dm, PetscInt height, PetscInt *numVertices, PetscInt **offsets, PetscInt **adjacency, PetscInt **edgeWeights, IS *globalNumbering)
 {
   PetscInt       dim, depth, p, pStart, pEnd, a, adjSize, idx, size;
-  PetscInt      *adj = NULL, *vOffsets = NULL, *graph = NULL;
+  PetscInt      *adj = NULL, *vOffsets = NULL, *graph = NULL, *wgts = NULL;
   IS             cellNumbering;
   const PetscInt *cellNum;
   PetscBool      useCone, useClosure;
-  PetscSection   section;
-  PetscSegBuffer adjBuffer;
+  PetscSection   section, dofSection = NULL;
+  PetscSegBuffer adjBuffer, wgtBuffer = NULL;
   PetscSF        sfPoint;
   PetscInt       *adjCells = NULL, *remoteCells = NULL;
   const PetscInt *local;
@@ -21,11 +61,12 @@ static PetscErrorCode DMPlexCreatePartitionerGraph_Native(DM dm, PetscInt height
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  if (edgeWeights) *edgeWeights = NULL;
   ierr = MPI_Comm_rank(PetscObjectComm((PetscObject) dm), &rank);CHKERRMPI(ierr);
   ierr = DMGetDimension(dm, &dim);CHKERRQ(ierr);
   ierr = DMPlexGetDepth(dm, &depth);CHKERRQ(ierr);
   if (dim != depth) {
-    /* We do not handle the uninterpolated case here */
+    /* We do not handle the uninterpolated case here, and leave its edges unweighted */
     ierr = DMPlexCreateNeighborCSR(dm, height, numVertices, offsets, adjacency);CHKERRQ(ierr);
     /* DMPlexCreateNeighborCSR does not make a numbering */
     if (globalNumbering) {ierr = DMPlexCreateCellNumbering_Internal(dm, PETSC_TRUE, globalNumbering);CHKERRQ(ierr);}
@@ -44,6 +85,10 @@ static PetscErrorCode DMPlexCreatePartitionerGraph_Native(DM dm, PetscInt height
   ierr = PetscSectionCreate(PetscObjectComm((PetscObject) dm), &section);CHKERRQ(ierr);
   ierr = PetscSectionSetChart(section, pStart, pEnd);CHKERRQ(ierr);
   ierr = PetscSegBufferCreate(sizeof(PetscInt),1000,&adjBuffer);CHKERRQ(ierr);
+  if (edgeWeights) {
+    dofSection = dm->localSection;
+    ierr = PetscSegBufferCreate(sizeof(PetscInt),1000,&wgtBuffer);CHKERRQ(ierr);
+  }
   /* Always use FVM adjacency to create partitioner graph */
   ierr = DMGetBasicAdjacency(dm, &useCone, &useClosure);CHKERRQ(ierr);
   ierr = DMSetBasicAdjacency(dm, PETSC_TRUE, PETSC_FALSE);CHKERRQ(ierr);
@@ -123,6 +168,10 @@ static PetscErrorCode DMPlexCreatePartitionerGraph_Native(DM dm, PetscInt height
           ierr = PetscSectionAddDof(section, p, 1);CHKERRQ(ierr);
           ierr = PetscSegBufferGetInts(adjBuffer, 1, &pBuf);CHKERRQ(ierr);
           *pBuf = remoteCells[point];
+          if (wgtBuffer) {
+            ierr = PetscSegBufferGetInts(wgtBuffer, 1, &pBuf);CHKERRQ(ierr);
+            ierr = DMPlexGetFaceWeight_Private(dm, dofSection, point, pBuf);CHKERRQ(ierr);
+          }
         }
         /* Handle non-conforming meshes */
         ierr = DMPlexGetTreeChildren(dm, point, &numChildren, &children);CHKERRQ(ierr);
@@ -133,6 +182,10 @@ static PetscErrorCode DMPlexCreatePartitionerGraph_Native(DM dm, PetscInt height
             ierr = PetscSectionAddDof(section, p, 1);CHKERRQ(ierr);
             ierr = PetscSegBufferGetInts(adjBuffer, 1, &pBuf);CHKERRQ(ierr);
             *pBuf = remoteCells[child];
+            if (wgtBuffer) {
+              ierr = PetscSegBufferGetInts(wgtBuffer, 1, &pBuf);CHKERRQ(ierr);
+              ierr = DMPlexGetFaceWeight_Private(dm, dofSection, child, pBuf);CHKERRQ(ierr);
+            }
           }
         }
       }
@@ -147,6 +200,14 @@ static PetscErrorCode DMPlexCreatePartitionerGraph_Native(DM dm, PetscInt height
         ierr = PetscSectionAddDof(section, p, 1);CHKERRQ(ierr);
         ierr = PetscSegBufferGetInts(adjBuffer, 1, &pBuf);CHKERRQ(ierr);
         *pBuf = DMPlex_GlobalID(cellNum[point]);
+        if (wgtBuffer) {
+          PetscInt face;
+
+          ierr = PetscSegBufferGetInts(wgtBuffer, 1, &pBuf);CHKERRQ(ierr);
+          ierr = DMPlexGetSharedFace_Private(dm, p, point, &face);CHKERRQ(ierr);
+          if (face >= 0) {ierr = DMPlexGetFaceWeight_Private(dm, dofSection, face, pBuf);CHKERRQ(ierr);}
+          else *pBuf = 1;
+        }
       }
     }
     (*numVertices)++;
@@ -165,6 +226,7 @@ static PetscErrorCode DMPlexCreatePartitionerGraph_Native(DM dm, PetscInt height
   }
   vOffsets[*numVertices] = size;
   ierr = PetscSegBufferExtractAlloc(adjBuffer, &graph);CHKERRQ(ierr);
+  if (wgtBuffer) {ierr = PetscSegBufferExtractAlloc(wgtBuffer, &wgts);CHKERRQ(ierr);}
 
   if (nroots >= 0) {
     /* Filter out duplicate edges using section/segbuffer */
@@ -173,13 +235,33 @@ static PetscErrorCode DMPlexCreatePartitionerGraph_Native(DM dm, PetscInt height
     for (p = 0; p < *numVertices; p++) {
       PetscInt start = vOffsets[p], end = vOffsets[p+1];
       PetscInt numEdges = end-start, *PETSC_RESTRICT edges;
-      ierr = PetscSortRemoveDupsInt(&numEdges, &graph[start]);CHKERRQ(ierr);
+      if (wgts) {
+        PetscInt e, n;
+
+        /* An edge found through several faces keeps its largest weight */
+        ierr = PetscSortIntWithArray(numEdges, &graph[start], &wgts[start]);CHKERRQ(ierr);
+        for (e = start, n = 0; e < end; ++e) {
+          if (n && graph[start+n-1] == graph[e]) {wgts[start+n-1] = PetscMax(wgts[start+n-1], wgts[e]); continue;}
+          graph[start+n] = graph[e];
+          wgts[start+n]  = wgts[e];
+          ++n;
+        }
+        numEdges = n;
+        ierr = PetscSegBufferGetInts(wgtBuffer, numEdges, &edges);CHKERRQ(ierr);
+        ierr = PetscArraycpy(edges, &wgts[start], numEdges);CHKERRQ(ierr);
+      } else {
+        ierr = PetscSortRemoveDupsInt(&numEdges, &graph[start]);CHKERRQ(ierr);
+      }
       ierr = PetscSectionSetDof(section, p, numEdges);CHKERRQ(ierr);
       ierr = PetscSegBufferGetInts(adjBuffer, numEdges, &edges);CHKERRQ(ierr);
       ierr = PetscArraycpy(edges, &graph[start], numEdges);CHKERRQ(ierr);
     }
     ierr = PetscFree(vOffsets);CHKERRQ(ierr);
     ierr = PetscFree(graph);CHKERRQ(ierr);
+    if (wgts) {
+      ierr = PetscFree(wgts);CHKERRQ(ierr);
+      ierr = PetscSegBufferExtractAlloc(wgtBuffer, &wgts);CHKERRQ(ierr);
+    }
     /* Derive CSR graph from section/segbuffer */
     ierr = PetscSectionSetUp(section);CHKERRQ(ierr);
     ierr = PetscSectionGetStorageSize(section, &size);CHKERRQ(ierr);
@@ -193,15 +275,18 @@ static PetscErrorCode DMPlexCreatePartitionerGraph_Native(DM dm, PetscInt height
     /* Sort adjacencies (not strictly necessary) */
     for (p = 0; p < *numVertices; p++) {
       PetscInt start = vOffsets[p], end = vOffsets[p+1];
-      ierr = PetscSortInt(end-start, &graph[start]);CHKERRQ(ierr);
+      if (wgts) {ierr = PetscSortIntWithArray(end-start, &graph[start], &wgts[start]);CHKERRQ(ierr);}
+      else      {ierr = PetscSortInt(end-start, &graph[start]);CHKERRQ(ierr);}
     }
   }
 
   if (offsets) *offsets = vOffsets;
   if (adjacency) *adjacency = graph;
+  if (edgeWeights) *edgeWeights = wgts;
 
   /* Cleanup */
   ierr = PetscSegBufferDestroy(&adjBuffer);CHKERRQ(ierr);
+  ierr = PetscSegBufferDestroy(&wgtBuffer);CHKERRQ(ierr);
   ierr = PetscSectionDestroy(&section);CHKERRQ(ierr);
   ierr = ISRestoreIndices(cellNumbering, &cellNum);CHKERRQ(ierr);
   ierr = ISDestroy(&cellNumbering);CHKERRQ(ierr);
@@ -372,6 +457,23 @@ static PetscErrorCode DMPlexCreatePartitionerGraph_ViaMat(DM dm, PetscInt height
   PetscFunctionReturn(0);
 }
 
+/* Only the native graph carries edge weights, the graph built through a Mat leaves them NULL */
+static PetscErrorCode DMPlexCreatePartitionerGraph_Private(DM dm, PetscInt height, PetscInt *numVertices, PetscInt **offsets, PetscInt **adjacency, PetscInt **edgeWeights, IS *globalNumbering)
+{
+  PetscErrorCode ierr;
+  PetscBool      usemat = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsGetBool(((PetscObject) dm)->options,((PetscObject) dm)->prefix, "-dm_plex_csr_via_mat", &usemat, NULL);CHKERRQ(ierr);
+  if (usemat) {
+    if (edgeWeights) *edgeWeights = NULL;
+    ierr = DMPlexCreatePartitionerGraph_ViaMat(dm, height, numVertices, offsets, adjacency, globalNumbering);CHKERRQ(ierr);
+  } else {
+    ierr = DMPlexCreatePartitionerGraph_Native(dm, height, numVertices, offsets, adjacency, edgeWeights, globalNumbering);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@C
   DMPlexCreatePartitionerGraph - Create a CSR graph of point connections for the partitioner
 
@@ -395,15 +497,9 @@ static PetscErrorCode DMPlexCreatePartitionerGraph_ViaMat(DM dm, PetscInt height
 PetscErrorCode DMPlexCreatePartitionerGraph(DM dm, PetscInt height, PetscInt *numVertices, PetscInt **offsets, PetscInt **adjacency, IS *globalNumbering)
 {
   PetscErrorCode ierr;
-  PetscBool      usemat = PETSC_FALSE;
 
   PetscFunctionBegin;
-  ierr = PetscOptionsGetBool(((PetscObject) dm)->options,((PetscObject) dm)->prefix, "-dm_plex_csr_via_mat", &usemat, NULL);CHKERRQ(ierr);
-  if (usemat) {
-    ierr = DMPlexCreatePartitionerGraph_ViaMat(dm, height, numVertices, offsets, adjacency, globalNumbering);CHKERRQ(ierr);
-  } else {
-    ierr = DMPlexCreatePartitionerGraph_Native(dm, height, numVertices, offsets, adjacency, globalNumbering);CHKERRQ(ierr);
-  }
+  ierr = DMPlexCreatePartitionerGraph_Private(dm, height, numVertices, offsets, adjacency, NULL, globalNumbering);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -620,10 +716,19 @@ PetscErrorCode DMPlexCreateNeighborCSR(DM dm, PetscInt cellHeight, PetscInt *num
 + partSection     - The PetscSection giving the division of points by partition
 - partition       - The list of points by partition
 
+  Options Database:
++ -petscpartitioner_use_vertex_weights   - Weight each point by the number of dofs in its closure
+. -petscpartitioner_use_assembly_weights - Add the assembly cost of each point as a second weight
+- -petscpartitioner_use_edge_weights     - Weight each edge of the graph by the number of dofs on the face it crosses
+
   Notes:
     If the DM has a local section associated, each point to be partitioned will be weighted by the total number of dofs identified
     by the section in the transitive closure of the point.
 
+    With assembly weights, each point gets a second weight, the sum over the fields of the closure dofs of the field times the number
+    of quadrature points of its discretization, so that partitioners supporting multiple constraints balance both the solver and the
+    assembly work. With assembly or edge weights the local section is created from the discretization if it has not been yet.
+
   Level: developer
 
 .seealso DMPlexDistribute(), PetscPartitionerCreate(), PetscSectionCreate(), PetscSectionSetChart(), PetscPartitionerPartition()
@@ -662,10 +767,18 @@ PetscErrorCode PetscPartitionerDMPlexPartition(PetscPartitioner part, DM dm, Pet
     PetscInt numVertices = 0;
     PetscInt *start     = NULL;
     PetscInt *adjacency = NULL;
+    PetscInt *edgeWeights = NULL;
     IS       globalNumbering;
 
+    if ((part->useawgt || part->useewgt) && !dm->localSection) {
+      PetscSection section;
+      PetscInt     Nf;
+
+      ierr = DMGetNumFields(dm, &Nf);CHKERRQ(ierr);
+      if (Nf) {ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);}
+    }
     if (!part->noGraph || part->viewGraph) {
-      ierr = DMPlexCreatePartitionerGraph(dm, part->height, &numVertices, &start, &adjacency, &globalNumbering);CHKERRQ(ierr);
+      ierr = DMPlexCreatePartitionerGraph_Private(dm, part->height, &numVertices, &start, &adjacency, part->useewgt ? &edgeWeights : NULL, &globalNumbering);CHKERRQ(ierr);
     } else { /* only compute the number of owned local vertices */
       const PetscInt *idxs;
       PetscInt       p, pStart, pEnd;
@@ -676,11 +789,11 @@ PetscErrorCode PetscPartitionerDMPlexPartition(PetscPartitioner part, DM dm, Pet
       for (p = 0; p < pEnd - pStart; p++) numVertices += idxs[p] < 0 ? 0 : 1;
       ierr = ISRestoreIndices(globalNumbering, &idxs);CHKERRQ(ierr);
     }
-    if (part->usevwgt) {
+    if (part->usevwgt || part->useawgt) {
       PetscSection   section = dm->localSection, clSection = NULL;
       IS             clPoints = NULL;
       const PetscInt *gid,*clIdx;
-      PetscInt       v, p, pStart, pEnd;
+      PetscInt       v, p, pStart, pEnd, Nf = 0, f, *Nq = NULL;
 
       /* dm->localSection encodes degrees of freedom per point, not per cell. We need to get the closure index to properly specify cell weights (aka dofs) */
       /* We do this only if the local section has been set */
@@ -692,14 +805,39 @@ PetscErrorCode PetscPartitionerDMPlexPartition(PetscPartitioner part, DM dm, Pet
         ierr = PetscSectionGetClosureIndex(section, (PetscObject)dm, &clSection, &clPoints);CHKERRQ(ierr);
         ierr = ISGetIndices(clPoints,&clIdx);CHKERRQ(ierr);
       }
+      /* The assembly cost of a field is proportional to its closure dofs times its quadrature points */
+      if (part->useawgt && section) {
+        PetscInt NfDM;
+
+        ierr = PetscSectionGetNumFields(section, &Nf);CHKERRQ(ierr);
+        ierr = DMGetNumFields(dm, &NfDM);CHKERRQ(ierr);
+        ierr = PetscMalloc1(Nf, &Nq);CHKERRQ(ierr);
+        for (f = 0; f < Nf; ++f) {
+          PetscObject     obj;
+          PetscClassId    id;
+          PetscQuadrature q = NULL;
+
+          Nq[f] = 1;
+          if (f >= NfDM) continue;
+          ierr = DMGetField(dm, f, NULL, &obj);CHKERRQ(ierr);
+          ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+          if (id == PETSCFE_CLASSID)      {ierr = PetscFEGetQuadrature((PetscFE) obj, &q);CHKERRQ(ierr);}
+          else if (id == PETSCFV_CLASSID) {ierr = PetscFVGetQuadrature((PetscFV) obj, &q);CHKERRQ(ierr);}
+          if (q) {
+            ierr = PetscQuadratureGetData(q, NULL, NULL, &Nq[f], NULL, NULL);CHKERRQ(ierr);
+            Nq[f] = PetscMax(Nq[f], 1);
+          }
+        }
+      }
       ierr = DMPlexGetHeightStratum(dm, part->height, &pStart, &pEnd);CHKERRQ(ierr);
       ierr = PetscSectionCreate(PETSC_COMM_SELF, &vertSection);CHKERRQ(ierr);
+      if (part->useawgt) {ierr = PetscSectionSetNumFields(vertSection, 2);CHKERRQ(ierr);}
       ierr = PetscSectionSetChart(vertSection, 0, numVertices);CHKERRQ(ierr);
       if (globalNumbering) {
         ierr = ISGetIndices(globalNumbering,&gid);CHKERRQ(ierr);
       } else gid = NULL;
       for (p = pStart, v = 0; p < pEnd; ++p) {
-        PetscInt dof = 1;
+        PetscInt dof = 1, cost = 1;
 
         /* skip cells in the overlap */
         if (gid && gid[p-pStart] < 0) continue;
@@ -708,6 +846,7 @@ PetscErrorCode PetscPartitionerDMPlexPartition(PetscPartitioner part, DM dm, Pet
           PetscInt cl, clSize, clOff;
 
           dof  = 0;
+          cost = 0;
           ierr = PetscSectionGetDof(clSection, p, &clSize);CHKERRQ(ierr);
           ierr = PetscSectionGetOffset(clSection, p, &clOff);CHKERRQ(ierr);
           for (cl = 0; cl < clSize; cl+=2) {
@@ -715,12 +854,27 @@ PetscErrorCode PetscPartitionerDMPlexPartition(PetscPartitioner part, DM dm, Pet
 
             ierr = PetscSectionGetDof(section, clPoint, &clDof);CHKERRQ(ierr);
             dof += clDof;
+            if (Nq) {
+              for (f = 0; f < Nf; ++f) {
+                ierr = PetscSectionGetFieldDof(section, clPoint, f, &clDof);CHKERRQ(ierr);
+                cost += clDof*Nq[f];
+              }
+            }
           }
+          if (!Nq) cost = dof;
         }
         if (!dof) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"Number of dofs for point %D in the local section should be positive",p);
-        ierr = PetscSectionSetDof(vertSection, v, dof);CHKERRQ(ierr);
+        if (part->useawgt) {
+          cost = PetscMax(cost, 1);
+          ierr = PetscSectionSetFieldDof(vertSection, v, 0, dof);CHKERRQ(ierr);
+          ierr = PetscSectionSetFieldDof(vertSection, v, 1, cost);CHKERRQ(ierr);
+          ierr = PetscSectionSetDof(vertSection, v, dof+cost);CHKERRQ(ierr);
+        } else {
+          ierr = PetscSectionSetDof(vertSection, v, dof);CHKERRQ(ierr);
+        }
         v++;
       }
+      ierr = PetscFree(Nq);CHKERRQ(ierr);
       if (globalNumbering) {
         ierr = ISRestoreIndices(globalNumbering,&gid);CHKERRQ(ierr);
       }
@@ -729,6 +883,7 @@ PetscErrorCode PetscPartitionerDMPlexPartition(PetscPartitioner part, DM dm, Pet
       }
       ierr = PetscSectionSetUp(vertSection);CHKERRQ(ierr);
     }
+    if (edgeWeights) {ierr = PetscPartitionerSetEdgeWeights(part, edgeWeights);CHKERRQ(ierr);}
     ierr = PetscPartitionerPartition(part, size, numVertices, start, adjacency, vertSection, targetSection, partSection, partition);CHKERRQ(ierr);
     ierr = PetscFree(start);CHKERRQ(ierr);
     ierr = PetscFree(adjacency);CHKERRQ(ierr);
@@ -3909,6 +3909,96 @@ PetscErrorCode DMPlexCreateProcessSF(DM dm, PetscSF sfPoint, IS *processRanks, P
   PetscFunctionReturn(0);
 }
 
+/* The cell type starts of each neighboring process in a refined mesh, cached on its point SF for the next refinement */
+typedef struct {
+  PetscInt  numNeighbors;
+  PetscInt *neighbors;
+  PetscInt *ctStart;
+} DMPlexRefineNeighborStarts;
+
+static PetscErrorCode PetscContainerUserDestroy_DMPlexRefineNeighborStarts(void *ctx)
+{
+  DMPlexRefineNeighborStarts *ns = (DMPlexRefineNeighborStarts *) ctx;
+  PetscErrorCode              ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(ns->neighbors, ns->ctStart);CHKERRQ(ierr);
+  ierr = PetscFree(ns);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Get the neighbor cell type starts cached on the point SF, if they were produced for exactly these neighbors */
+static PetscErrorCode DMPlexCellRefinerGetNeighborStarts_Private(PetscSF sf, PetscInt numNeighbors, const PetscInt neighbors[], PetscInt ctStartRem[], PetscBool *found)
+{
+  const PetscInt              ctSize = DM_NUM_POLYTOPES+1;
+  PetscContainer              container;
+  DMPlexRefineNeighborStarts *ns;
+  PetscBool                   same;
+  PetscErrorCode              ierr;
+
+  PetscFunctionBegin;
+  *found = PETSC_FALSE;
+  ierr = PetscObjectQuery((PetscObject) sf, "DMPlexRefineNeighborStarts", (PetscObject *) &container);CHKERRQ(ierr);
+  if (!container) PetscFunctionReturn(0);
+  ierr = PetscContainerGetPointer(container, (void **) &ns);CHKERRQ(ierr);
+  if (ns->numNeighbors != numNeighbors) PetscFunctionReturn(0);
+  ierr = PetscArraycmp(ns->neighbors, neighbors, numNeighbors, &same);CHKERRQ(ierr);
+  if (!same) PetscFunctionReturn(0);
+  ierr = PetscArraycpy(ctStartRem, ns->ctStart, ctSize*numNeighbors);CHKERRQ(ierr);
+  *found = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexCellRefinerSetNeighborStarts_Private(PetscSF sf, PetscInt numNeighbors, const PetscInt neighbors[], const PetscInt ctStartRem[])
+{
+  const PetscInt              ctSize = DM_NUM_POLYTOPES+1;
+  PetscContainer              container;
+  DMPlexRefineNeighborStarts *ns;
+  PetscErrorCode              ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNew(&ns);CHKERRQ(ierr);
+  ns->numNeighbors = numNeighbors;
+  ierr = PetscMalloc2(numNeighbors, &ns->neighbors, ctSize*numNeighbors, &ns->ctStart);CHKERRQ(ierr);
+  ierr = PetscArraycpy(ns->neighbors, neighbors, numNeighbors);CHKERRQ(ierr);
+  ierr = PetscArraycpy(ns->ctStart, ctStartRem, ctSize*numNeighbors);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF, &container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container, (void *) ns);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container, PetscContainerUserDestroy_DMPlexRefineNeighborStarts);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject) sf, "DMPlexRefineNeighborStarts", (PetscObject) container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Without a refine type, the number of new points of each type depends only on the number of old points of each type */
+static PetscErrorCode DMPlexCellRefinerComputeStartsNew_Private(DMPlexCellRefiner cr, const PetscInt ctStart[], PetscInt ctStartNew[])
+{
+  PetscInt       ctCN[DM_NUM_POLYTOPES+1], c;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscArrayzero(ctCN, DM_NUM_POLYTOPES+1);CHKERRQ(ierr);
+  for (c = 0; c < DM_NUM_POLYTOPES; ++c) {
+    const DMPolytopeType ct  = (DMPolytopeType) cr->ctOrder[c];
+    const PetscInt       ctn = cr->ctOrder[c+1];
+    DMPolytopeType      *rct;
+    PetscInt            *rsize, *cone, *ornt;
+    PetscInt             Nct, n;
+
+    if (ctStart[ctn] == ctStart[ct]) continue;
+    ierr = DMPlexCellRefinerRefine(cr, ct, PETSC_DETERMINE, NULL, &Nct, &rct, &rsize, &cone, &ornt);CHKERRQ(ierr);
+    for (n = 0; n < Nct; ++n) ctCN[rct[n]] += (ctStart[ctn] - ctStart[ct])*rsize[n];
+  }
+  ctStartNew[cr->ctOrder[0]] = 0;
+  for (c = 0; c < DM_NUM_POLYTOPES; ++c) ctStartNew[cr->ctOrder[c+1]] = ctStartNew[cr->ctOrder[c]] + ctCN[cr->ctOrder[c]];
+  PetscFunctionReturn(0);
+}
+
+/*
+  Without a refine type, the new numbering of each point is an arithmetic function of the cell type starts, so the new point SF
+  follows from the old one once the starts on each neighbor are known. Those are exchanged with the neighbors only when they are
+  not already cached on the point SF by a previous refinement, so refining a hierarchy communicates at most once.
+*/
 static PetscErrorCode DMPlexCellRefinerCreateSF(DMPlexCellRefiner cr, DM rdm)
 {
   DM                 dm = cr->dm;
@@ -4020,29 +4110,36 @@ static PetscErrorCode DMPlexCellRefinerCreateSF(DMPlexCellRefiner cr, DM rdm)
     ierr = PetscSectionDestroy(&s);CHKERRQ(ierr);
     ierr = PetscFree(rootPointsNew);CHKERRQ(ierr);
   } else {
-    /* Communicate ctStart and cStartNew for each remote rank */
-    ierr = DMPlexCreateProcessSF(dm, sf, &processRanks, &sfProcess);CHKERRQ(ierr);
+    PetscBool cached;
+
+    /* Get ctStart for each remote rank, communicating only if it was not cached by the refinement which produced this mesh */
+    ierr = DMPlexCreateProcessSF(dm, sf, &processRanks, NULL);CHKERRQ(ierr);
     ierr = ISGetLocalSize(processRanks, &numNeighbors);CHKERRQ(ierr);
+    ierr = ISGetIndices(processRanks, &neighbors);CHKERRQ(ierr);
     ierr = PetscMalloc2(ctSize*numNeighbors, &ctStartRem, ctSize*numNeighbors, &ctStartNewRem);CHKERRQ(ierr);
-    ierr = MPI_Type_contiguous(ctSize, MPIU_INT, &ctType);CHKERRMPI(ierr);
-    ierr = MPI_Type_commit(&ctType);CHKERRMPI(ierr);
-    ierr = PetscSFBcastBegin(sfProcess, ctType, cr->ctStart, ctStartRem);CHKERRQ(ierr);
-    ierr = PetscSFBcastEnd(sfProcess, ctType, cr->ctStart, ctStartRem);CHKERRQ(ierr);
-    ierr = PetscSFBcastBegin(sfProcess, ctType, cr->ctStartNew, ctStartNewRem);CHKERRQ(ierr);
-    ierr = PetscSFBcastEnd(sfProcess, ctType, cr->ctStartNew, ctStartNewRem);CHKERRQ(ierr);
-    ierr = MPI_Type_free(&ctType);CHKERRMPI(ierr);
-    ierr = PetscSFDestroy(&sfProcess);CHKERRQ(ierr);
+    ierr = DMPlexCellRefinerGetNeighborStarts_Private(sf, numNeighbors, neighbors, ctStartRem, &cached);CHKERRQ(ierr);
+    if (!cached) {
+      ierr = DMPlexCreateProcessSF(dm, sf, NULL, &sfProcess);CHKERRQ(ierr);
+      ierr = MPI_Type_contiguous(ctSize, MPIU_INT, &ctType);CHKERRMPI(ierr);
+      ierr = MPI_Type_commit(&ctType);CHKERRMPI(ierr);
+      ierr = PetscSFBcastBegin(sfProcess, ctType, cr->ctStart, ctStartRem);CHKERRQ(ierr);
+      ierr = PetscSFBcastEnd(sfProcess, ctType, cr->ctStart, ctStartRem);CHKERRQ(ierr);
+      ierr = MPI_Type_free(&ctType);CHKERRMPI(ierr);
+      ierr = PetscSFDestroy(&sfProcess);CHKERRQ(ierr);
+    }
+    ierr = PetscInfo2(dm, "Refining point SF with %D neighbors, %s cell type starts\n", numNeighbors, cached ? "cached" : "communicated");CHKERRQ(ierr);
     ierr = PetscMalloc1(numNeighbors, &crRem);CHKERRQ(ierr);
     for (n = 0; n < numNeighbors; ++n) {
+      ierr = DMPlexCellRefinerComputeStartsNew_Private(cr, &ctStartRem[n*ctSize], &ctStartNewRem[n*ctSize]);CHKERRQ(ierr);
       ierr = DMPlexCellRefinerCreate(dm, &crRem[n]);CHKERRQ(ierr);
-      ierr = DMPlexCellRefinerSetStarts(crRem[n], &ctStartRem[n*ctSize], &ctStartNewRem[n*ctSize]);
+      ierr = DMPlexCellRefinerSetStarts(crRem[n], &ctStartRem[n*ctSize], &ctStartNewRem[n*ctSize]);CHKERRQ(ierr);
       ierr = DMPlexCellRefinerSetUp(crRem[n]);CHKERRQ(ierr);
     }
+    ierr = DMPlexCellRefinerSetNeighborStarts_Private(sfNew, numNeighbors, neighbors, ctStartNewRem);CHKERRQ(ierr);
     ierr = PetscFree2(ctStartRem, ctStartNewRem);CHKERRQ(ierr);
     /* Calculate new point SF */
     ierr = PetscMalloc1(numLeavesNew, &localPointsNew);CHKERRQ(ierr);
     ierr = PetscMalloc1(numLeavesNew, &remotePointsNew);CHKERRQ(ierr);
-    ierr = ISGetIndices(processRanks, &neighbors);CHKERRQ(ierr);
     for (l = 0, m = 0; l < numLeaves; ++l) {
       PetscInt        p       = localPoints[l];
       PetscInt        pRem    = remotePoints[l].index;
@@ -4203,8 +4300,9 @@ PetscErrorCode DMPlexRefineUniform(DM dm, DMPlexCellRefiner cr, DM *dmRefined)
   ierr = DMSetUp(rdm);CHKERRQ(ierr);
   /* Step 4: Set cones and supports (automatically symmetrizes) */
   ierr = DMPlexCellRefinerSetCones(cr, rdm);CHKERRQ(ierr);
-  /* Step 5: Create pointSF */
+  /* Step 5: Create pointSF, whose overlap is the refinement of the original overlap */
   ierr = DMPlexCellRefinerCreateSF(cr, rdm);CHKERRQ(ierr);
+  ((DM_Plex *) rdm->data)->overlap = ((DM_Plex *) dm->data)->overlap;
   /* Step 6: Create labels */
   ierr = DMPlexCellRefinerCreateLabels(cr, rdm);CHKERRQ(ierr);
   /* Step 7: Set coordinates */
@@ -45,6 +45,95 @@ static PetscErrorCode DMPlexCreateOrderingClosure_Static(DM dm, PetscInt numPoin
   PetscFunctionReturn(0);
 }
 
+typedef struct {
+  PetscInt64 key;  /* Position along the curve */
+  PetscInt   cell; /* Local cell number */
+} DMPlexCurveKey;
+
+static int DMPlexCompareCurveKeys_Private(const void *a, const void *b, void *ctx)
+{
+  const PetscInt64 ka = ((const DMPlexCurveKey *) a)->key, kb = ((const DMPlexCurveKey *) b)->key;
+
+  return ka < kb ? -1 : (ka > kb ? 1 : 0);
+}
+
+/* Map integer coordinates X[] with bits bits each to their position along the Hilbert curve, using the
+   transpose algorithm of Skilling, AIP Conference Proceedings 707, 2004. A Morton key is the plain bit interleave. */
+static PetscInt64 DMPlexGetCurveKey_Private(PetscInt dim, PetscInt bits, PetscBool hilbert, PetscInt64 X[])
+{
+  PetscInt64 key = 0, Q, P, t;
+  PetscInt   i, b;
+
+  if (hilbert) {
+    for (Q = ((PetscInt64) 1) << (bits-1); Q > 1; Q >>= 1) {
+      P = Q - 1;
+      for (i = 0; i < dim; ++i) {
+        if (X[i] & Q) X[0] ^= P;
+        else {t = (X[0] ^ X[i]) & P; X[0] ^= t; X[i] ^= t;}
+      }
+    }
+    for (i = 1; i < dim; ++i) X[i] ^= X[i-1];
+    t = 0;
+    for (Q = ((PetscInt64) 1) << (bits-1); Q > 1; Q >>= 1) if (X[dim-1] & Q) t ^= Q - 1;
+    for (i = 0; i < dim; ++i) X[i] ^= t;
+  }
+  for (b = bits-1; b >= 0; --b) for (i = 0; i < dim; ++i) key = (key << 1) | ((X[i] >> b) & 1);
+  return key;
+}
+
+/* Order the cells along a space filling curve through their vertex centroids */
+static PetscErrorCode DMPlexCreateCurveOrdering_Static(DM dm, PetscBool hilbert, PetscInt numCells, PetscInt cperm[])
+{
+  DM              cdm;
+  PetscSection    csection;
+  Vec             coordinates;
+  DMPlexCurveKey *keys;
+  PetscReal      *centroids, lower[3], upper[3], h = 0.0;
+  PetscInt64      X[3];
+  PetscInt        cdim, bits, sStart, sEnd, c, d;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = DMGetCoordinateDim(dm, &cdim);CHKERRQ(ierr);
+  if (cdim > 3) SETERRQ1(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "Space filling curve orderings not supported in dimension %D", cdim);
+  ierr = DMGetCoordinateDM(dm, &cdm);CHKERRQ(ierr);
+  ierr = DMGetLocalSection(cdm, &csection);CHKERRQ(ierr);
+  ierr = PetscSectionGetChart(csection, &sStart, &sEnd);CHKERRQ(ierr);
+  ierr = DMGetCoordinatesLocal(dm, &coordinates);CHKERRQ(ierr);
+  ierr = PetscMalloc2(numCells*cdim, &centroids, numCells, &keys);CHKERRQ(ierr);
+  for (d = 0; d < cdim; ++d) {lower[d] = PETSC_MAX_REAL; upper[d] = PETSC_MIN_REAL;}
+  for (c = 0; c < numCells; ++c) {
+    PetscScalar *coords = NULL;
+    PetscInt     csize, cdof = 0, n, v;
+
+    /* Localized coordinates on the cell take precedence over the vertex coordinates */
+    if (c >= sStart && c < sEnd) {ierr = PetscSectionGetDof(csection, c, &cdof);CHKERRQ(ierr);}
+    ierr = DMPlexVecGetClosure(cdm, csection, coordinates, c, &csize, &coords);CHKERRQ(ierr);
+    n    = (cdof ? cdof : csize)/cdim;
+    for (d = 0; d < cdim; ++d) {
+      PetscReal x = 0.0;
+
+      for (v = 0; v < n; ++v) x += PetscRealPart(coords[v*cdim+d]);
+      centroids[c*cdim+d] = n ? x/n : 0.0;
+      lower[d] = PetscMin(lower[d], centroids[c*cdim+d]);
+      upper[d] = PetscMax(upper[d], centroids[c*cdim+d]);
+    }
+    ierr = DMPlexVecRestoreClosure(cdm, csection, coordinates, c, &csize, &coords);CHKERRQ(ierr);
+  }
+  /* Scale isotropically so that the curve follows the shape of the local domain */
+  for (d = 0; d < cdim; ++d) h = PetscMax(h, upper[d] - lower[d]);
+  bits = 62/cdim;
+  for (c = 0; c < numCells; ++c) {
+    for (d = 0; d < cdim; ++d) X[d] = h > 0.0 ? (PetscInt64) (((centroids[c*cdim+d] - lower[d])/h)*(PetscReal) ((((PetscInt64) 1) << bits) - 1)) : 0;
+    keys[c].key  = DMPlexGetCurveKey_Private(cdim, bits, hilbert, X);
+    keys[c].cell = c;
+  }
+  ierr = PetscTimSort(numCells, keys, sizeof(DMPlexCurveKey), DMPlexCompareCurveKeys_Private, NULL);CHKERRQ(ierr);
+  for (c = 0; c < numCells; ++c) cperm[c] = keys[c].cell;
+  ierr = PetscFree2(centroids, keys);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
   DMPlexGetOrdering - Calculate a reordering of the mesh
 
@@ -58,40 +147,60 @@ $     MATORDERINGND - Nested Dissection
 $     MATORDERING1WD - One-way Dissection
 $     MATORDERINGRCM - Reverse Cuthill-McKee
 $     MATORDERINGQMD - Quotient Minimum Degree
+$     DMPLEXORDERINGHILBERT - Hilbert space filling curve through the cell centroids
+$     DMPLEXORDERINGMORTON - Morton (Z-order) space filling curve through the cell centroids
 - label - [Optional] Label used to segregate ordering into sets, or NULL
 
 
   Output Parameter:
 . perm - The point permutation as an IS, perm[old point number] = new point number
 
-  Note: The label is used to group sets of points together by label value. This makes it easy to reorder a mesh which
+  Notes:
+  The label is used to group sets of points together by label value. This makes it easy to reorder a mesh which
   has different types of cells, and then loop over each set of reordered cells for assembly.
 
+  Only the cells are ordered by the chosen method; the remaining points in each stratum are numbered in the order
+  they are first reached from the cones of the reordered points one stratum up, so that the faces, edges, and
+  vertices of a cell end up close together. Graph orderings other than MATORDERINGNATURAL use Reverse Cuthill-McKee
+  on the cell dual graph.
+
   Level: intermediate
 
-.seealso: MatGetOrdering()
+.seealso: MatGetOrdering(), DMPlexPermute(), DMPlexComputeStratumBandwidth()
 @*/
 PetscErrorCode DMPlexGetOrdering(DM dm, MatOrderingType otype, DMLabel label, IS *perm)
 {
   PetscInt       numCells = 0;
   PetscInt      *start = NULL, *adjacency = NULL, *cperm, *clperm = NULL, *invclperm = NULL, *mask, *xls, pStart, pEnd, c, i;
+  PetscBool      isNatural, isHilbert, isMorton;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
   PetscValidPointer(perm, 3);
-  ierr = DMPlexCreateNeighborCSR(dm, 0, &numCells, &start, &adjacency);CHKERRQ(ierr);
+  ierr = PetscStrcmp(otype, MATORDERINGNATURAL, &isNatural);CHKERRQ(ierr);
+  ierr = PetscStrcmp(otype, DMPLEXORDERINGHILBERT, &isHilbert);CHKERRQ(ierr);
+  ierr = PetscStrcmp(otype, DMPLEXORDERINGMORTON, &isMorton);CHKERRQ(ierr);
+  ierr = DMPlexGetHeightStratum(dm, 0, &pStart, &pEnd);CHKERRQ(ierr);
+  numCells = pEnd - pStart;
   ierr = PetscMalloc3(numCells,&cperm,numCells,&mask,numCells*2,&xls);CHKERRQ(ierr);
-  if (numCells) {
+  if (isNatural) {
+    for (c = 0; c < numCells; ++c) cperm[c] = c;
+  } else if (isHilbert || isMorton) {
+    ierr = DMPlexCreateCurveOrdering_Static(dm, isHilbert, numCells, cperm);CHKERRQ(ierr);
+  } else {
+    ierr = DMPlexCreateNeighborCSR(dm, 0, &numCells, &start, &adjacency);CHKERRQ(ierr);
+    if (numCells) {
+      /* Shift for Fortran numbering */
+      for (i = 0; i < start[numCells]; ++i) ++adjacency[i];
+      for (i = 0; i <= numCells; ++i)       ++start[i];
+      ierr = SPARSEPACKgenrcm(&numCells, start, adjacency, cperm, mask, xls);CHKERRQ(ierr);
+    }
+    ierr = PetscFree(start);CHKERRQ(ierr);
+    ierr = PetscFree(adjacency);CHKERRQ(ierr);
     /* Shift for Fortran numbering */
-    for (i = 0; i < start[numCells]; ++i) ++adjacency[i];
-    for (i = 0; i <= numCells; ++i)       ++start[i];
-    ierr = SPARSEPACKgenrcm(&numCells, start, adjacency, cperm, mask, xls);CHKERRQ(ierr);
+    for (c = 0; c < numCells; ++c) --cperm[c];
   }
-  ierr = PetscFree(start);CHKERRQ(ierr);
-  ierr = PetscFree(adjacency);CHKERRQ(ierr);
-  /* Shift for Fortran numbering */
-  for (c = 0; c < numCells; ++c) --cperm[c];
   /* Segregate */
   if (label) {
     IS              valueIS;
@@ -138,6 +247,71 @@ PetscErrorCode DMPlexGetOrdering(DM dm, MatOrderingType otype, DMLabel label, IS
   PetscFunctionReturn(0);
 }
 
+/*@
+  DMPlexComputeStratumBandwidth - Compute the bandwidth and profile of the local coupling between points in a stratum
+
+  Not collective
+
+  Input Parameters:
++ dm    - The DMPlex object
+- depth - The depth of the stratum
+
+  Output Parameters:
++ bandwidth - The largest distance in point numbers between two coupled points, or NULL
+- profile   - The sum over the points of the distance to the lowest numbered point coupled to them, or NULL
+
+  Note: Two cells are coupled when they share a face, and two points of a lower stratum are coupled when they lie in
+  the closure of a common cell. These are the sizes of the lower triangle of an operator with one unknown on each point
+  in the stratum, so they measure how well a point ordering localizes vector accesses during assembly and MatMult().
+
+  Level: intermediate
+
+.seealso: DMPlexGetOrdering(), DMPlexPermute(), MatComputeBandwidth()
+@*/
+PetscErrorCode DMPlexComputeStratumBandwidth(DM dm, PetscInt depth, PetscInt *bandwidth, PetscInt *profile)
+{
+  PetscInt      *rmin, dStart, dEnd, cStart, cEnd, meshDepth, bw = 0, pr = 0, p;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  ierr = DMPlexGetDepth(dm, &meshDepth);CHKERRQ(ierr);
+  if (depth < 0 || depth > meshDepth) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Depth %D not in [0, %D]", depth, meshDepth);
+  ierr = DMPlexGetDepthStratum(dm, depth, &dStart, &dEnd);CHKERRQ(ierr);
+  ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  ierr = PetscMalloc1(dEnd-dStart, &rmin);CHKERRQ(ierr);
+  for (p = dStart; p < dEnd; ++p) rmin[p-dStart] = p;
+  if (depth == meshDepth) {
+    PetscInt *start = NULL, *adjacency = NULL, numCells, c, i;
+
+    ierr = DMPlexCreateNeighborCSR(dm, 0, &numCells, &start, &adjacency);CHKERRQ(ierr);
+    for (c = 0; c < numCells; ++c) {
+      for (i = start[c]; i < start[c+1]; ++i) rmin[c] = PetscMin(rmin[c], adjacency[i]+cStart);
+    }
+    ierr = PetscFree(start);CHKERRQ(ierr);
+    ierr = PetscFree(adjacency);CHKERRQ(ierr);
+  } else {
+    PetscInt *closure = NULL, c;
+
+    for (c = cStart; c < cEnd; ++c) {
+      PetscInt clSize, cmin = PETSC_MAX_INT, cl;
+
+      ierr = DMPlexGetTransitiveClosure(dm, c, PETSC_TRUE, &clSize, &closure);CHKERRQ(ierr);
+      for (cl = 0; cl < clSize*2; cl += 2) if (closure[cl] >= dStart && closure[cl] < dEnd) cmin = PetscMin(cmin, closure[cl]);
+      for (cl = 0; cl < clSize*2; cl += 2) if (closure[cl] >= dStart && closure[cl] < dEnd) rmin[closure[cl]-dStart] = PetscMin(rmin[closure[cl]-dStart], cmin);
+    }
+    if (closure) {ierr = DMPlexRestoreTransitiveClosure(dm, cStart, PETSC_TRUE, NULL, &closure);CHKERRQ(ierr);}
+  }
+  for (p = dStart; p < dEnd; ++p) {
+    bw  = PetscMax(bw, p - rmin[p-dStart]);
+    pr += p - rmin[p-dStart];
+  }
+  ierr = PetscFree(rmin);CHKERRQ(ierr);
+  if (bandwidth) *bandwidth = bw;
+  if (profile)   *profile   = pr;
+  PetscFunctionReturn(0);
+}
+
 /*@
   DMPlexPermute - Reorder the mesh according to the input permutation
 
@@ -150,15 +324,19 @@ PetscErrorCode DMPlexGetOrdering(DM dm, MatOrderingType otype, DMLabel label, IS
   Output Parameter:
 . pdm - The permuted DM
 
+  Note: For a distributed mesh the point SF is renumbered on both ends, so perm must be computed on each process for
+  its own local points.
+
   Level: intermediate
 
-.seealso: MatPermute()
+.seealso: MatPermute(), DMPlexGetOrdering()
 @*/
 PetscErrorCode DMPlexPermute(DM dm, IS perm, DM *pdm)
 {
   DM_Plex       *plex = (DM_Plex *) dm->data, *plexNew;
   PetscSection   section, sectionNew;
   PetscInt       dim;
+  PetscBool      useAnchors;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -178,8 +356,45 @@ PetscErrorCode DMPlexPermute(DM dm, IS perm, DM *pdm)
   }
   plexNew = (DM_Plex *) (*pdm)->data;
   /* Ignore ltogmap, ltogmapb */
-  /* Ignore sf, sectionSF */
-  /* Ignore globalVertexNumbers, globalCellNumbers */
+  /* Ignore sectionSF */
+  /* Renumber the point SF */
+  {
+    PetscSF            sfPoint, sfPointNew;
+    const PetscInt    *pperm, *ilocal;
+    const PetscSFNode *iremote;
+    PetscInt          *rootNew, *leafNew, *ilocalNew, nroots, nleaves, pStart, pEnd, p, l;
+    PetscSFNode       *iremoteNew;
+
+    ierr = DMGetPointSF(dm, &sfPoint);CHKERRQ(ierr);
+    ierr = PetscSFGetGraph(sfPoint, &nroots, &nleaves, &ilocal, &iremote);CHKERRQ(ierr);
+    if (nroots >= 0) {
+      ierr = DMPlexGetChart(dm, &pStart, &pEnd);CHKERRQ(ierr);
+      ierr = ISGetIndices(perm, &pperm);CHKERRQ(ierr);
+      ierr = PetscMalloc2(pEnd-pStart, &rootNew, pEnd-pStart, &leafNew);CHKERRQ(ierr);
+      ierr = PetscSFBcastBegin(sfPoint, MPIU_INT, pperm, rootNew);CHKERRQ(ierr);
+      ierr = PetscSFBcastEnd(sfPoint, MPIU_INT, pperm, rootNew);CHKERRQ(ierr);
+      for (p = pStart; p < pEnd; ++p) leafNew[p] = -1;
+      for (l = 0; l < nleaves; ++l) leafNew[pperm[ilocal ? ilocal[l] : l]] = l;
+      /* Keep the leaves sorted by their new local number */
+      ierr = PetscMalloc1(nleaves, &ilocalNew);CHKERRQ(ierr);
+      ierr = PetscMalloc1(nleaves, &iremoteNew);CHKERRQ(ierr);
+      for (p = pStart, l = 0; p < pEnd; ++p) {
+        const PetscInt leaf = leafNew[p];
+
+        if (leaf < 0) continue;
+        ilocalNew[l]        = p;
+        iremoteNew[l].rank  = iremote[leaf].rank;
+        iremoteNew[l].index = rootNew[ilocal ? ilocal[leaf] : leaf];
+        ++l;
+      }
+      ierr = ISRestoreIndices(perm, &pperm);CHKERRQ(ierr);
+      ierr = PetscFree2(rootNew, leafNew);CHKERRQ(ierr);
+      ierr = PetscSFCreate(PetscObjectComm((PetscObject) dm), &sfPointNew);CHKERRQ(ierr);
+      ierr = PetscSFSetGraph(sfPointNew, nroots, nleaves, ilocalNew, PETSC_OWN_POINTER, iremoteNew, PETSC_OWN_POINTER);CHKERRQ(ierr);
+      ierr = DMSetPointSF(*pdm, sfPointNew);CHKERRQ(ierr);
+      ierr = PetscSFDestroy(&sfPointNew);CHKERRQ(ierr);
+    }
+  }
   /* Reorder labels */
   {
     PetscInt numLabels, l;
@@ -193,6 +408,8 @@ PetscErrorCode DMPlexPermute(DM dm, IS perm, DM *pdm)
       ierr = DMLabelDestroy(&labelNew);CHKERRQ(ierr);
     }
     ierr = DMGetLabel(*pdm, "depth", &(*pdm)->depthLabel);CHKERRQ(ierr);
+    ierr = DMGetLabel(*pdm, "celltype", &(*pdm)->celltypeLabel);CHKERRQ(ierr);
+    plexNew->overlap = plex->overlap;
     if (plex->subpointMap) {ierr = DMLabelPermute(plex->subpointMap, perm, &plexNew->subpointMap);CHKERRQ(ierr);}
   }
   /* Reorder topology */
@@ -237,16 +454,21 @@ PetscErrorCode DMPlexPermute(DM dm, IS perm, DM *pdm)
       }
     }
     ierr = ISRestoreIndices(perm, &pperm);CHKERRQ(ierr);
+    ierr = DMPlexSetUpConeRuns_Internal(*pdm);CHKERRQ(ierr);
   }
   /* Remap coordinates */
   {
-    DM              cdm, cdmNew;
-    PetscSection    csection, csectionNew;
-    Vec             coordinates, coordinatesNew;
-    PetscScalar    *coords, *coordsNew;
-    const PetscInt *pperm;
-    PetscInt        pStart, pEnd, p;
-    const char     *name;
+    DM                    cdm, cdmNew;
+    PetscSF               sfPoint;
+    PetscSection          csection, csectionNew;
+    Vec                   coordinates, coordinatesNew;
+    const PetscReal      *maxCell, *L;
+    const DMBoundaryType *bd;
+    PetscBool             isper;
+    PetscScalar          *coords, *coordsNew;
+    const PetscInt       *pperm;
+    PetscInt              pStart, pEnd, p;
+    const char           *name;
 
     ierr = DMGetCoordinateDM(dm, &cdm);CHKERRQ(ierr);
     ierr = DMGetLocalSection(cdm, &csection);CHKERRQ(ierr);
@@ -262,7 +484,7 @@ PetscErrorCode DMPlexPermute(DM dm, IS perm, DM *pdm)
     for (p = pStart; p < pEnd; ++p) {
       PetscInt dof, off, offNew, d;
 
-      ierr = PetscSectionGetDof(csectionNew, p, &dof);CHKERRQ(ierr);
+      ierr = PetscSectionGetDof(csection, p, &dof);CHKERRQ(ierr);
       ierr = PetscSectionGetOffset(csection, p, &off);CHKERRQ(ierr);
       ierr = PetscSectionGetOffset(csectionNew, pperm[p], &offNew);CHKERRQ(ierr);
       for (d = 0; d < dof; ++d) coordsNew[offNew+d] = coords[off+d];
@@ -271,11 +493,17 @@ PetscErrorCode DMPlexPermute(DM dm, IS perm, DM *pdm)
     ierr = VecRestoreArray(coordinates, &coords);CHKERRQ(ierr);
     ierr = VecRestoreArray(coordinatesNew, &coordsNew);CHKERRQ(ierr);
     ierr = DMGetCoordinateDM(*pdm, &cdmNew);CHKERRQ(ierr);
+    ierr = DMGetPointSF(*pdm, &sfPoint);CHKERRQ(ierr);
+    ierr = DMSetPointSF(cdmNew, sfPoint);CHKERRQ(ierr);
     ierr = DMSetLocalSection(cdmNew, csectionNew);CHKERRQ(ierr);
     ierr = DMSetCoordinatesLocal(*pdm, coordinatesNew);CHKERRQ(ierr);
     ierr = PetscSectionDestroy(&csectionNew);CHKERRQ(ierr);
     ierr = VecDestroy(&coordinatesNew);CHKERRQ(ierr);
+    ierr = DMGetPeriodicity(dm, &isper, &maxCell, &L, &bd);CHKERRQ(ierr);
+    ierr = DMSetPeriodicity(*pdm, isper, maxCell, L, bd);CHKERRQ(ierr);
   }
+  ierr = DMPlexGetAdjacencyUseAnchors(dm, &useAnchors);CHKERRQ(ierr);
+  ierr = DMPlexSetAdjacencyUseAnchors(*pdm, useAnchors);CHKERRQ(ierr);
   (*pdm)->setupcalled = PETSC_TRUE;
   PetscFunctionReturn(0);
 }
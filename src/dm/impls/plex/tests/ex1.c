@@ -756,6 +756,35 @@ int main(int argc, char **argv)
       requires: define(PETSC_HAVE_MPIIO)
       args: -filename ${wPETSC_DIR}/share/petsc/datafiles/meshes/gmsh-3d-binary-64.msh -viewer_binary_mpiio
 
+  # Gmsh parallel reader tests
+  testset:
+    nsize: 3
+    requires: !single
+    args: -dm_plex_gmsh_parallel -petscpartitioner_type simple -interpolate 1 -dm_view -dm_plex_check_all
+    output_file: output/ex1_gmsh_par_2d.out
+    test:
+      suffix: gmsh_par_2d_ascii
+      args: -filename ${wPETSC_DIR}/share/petsc/datafiles/meshes/square.msh
+    test:
+      suffix: gmsh_par_2d_binary
+      args: -filename ${wPETSC_DIR}/share/petsc/datafiles/meshes/square_bin.msh
+  testset:
+    nsize: 2
+    args: -dm_plex_gmsh_parallel -dm_plex_gmsh_periodic 0 -dm_plex_gmsh_use_marker -petscpartitioner_type simple -interpolate 1 -dm_view -dm_plex_check_all
+    output_file: output/ex1_gmsh_par_3d.out
+    test:
+      suffix: gmsh_par_3d_ascii_v22
+      args: -filename ${wPETSC_DIR}/share/petsc/datafiles/meshes/gmsh-3d-ascii.msh2
+    test:
+      suffix: gmsh_par_3d_binary_v22
+      args: -filename ${wPETSC_DIR}/share/petsc/datafiles/meshes/gmsh-3d-binary.msh2
+    test:
+      suffix: gmsh_par_3d_ascii_v41
+      args: -filename ${wPETSC_DIR}/share/petsc/datafiles/meshes/gmsh-3d-ascii-64.msh
+    test:
+      suffix: gmsh_par_3d_binary_v41
+      args: -filename ${wPETSC_DIR}/share/petsc/datafiles/meshes/gmsh-3d-binary-64.msh
+
   # Fluent mesh reader tests
   # TODO: Geometry checks fail
   test:
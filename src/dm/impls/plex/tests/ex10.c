@@ -9,6 +9,7 @@ typedef struct {
   PetscInt *numComponents;     /* The number of field components */
   PetscInt *numDof;            /* The dof signature for the section */
   PetscInt  numGroups;         /* If greater than 1, use grouping in test */
+  char      order[256];        /* The mesh ordering method */
 } AppCtx;
 
 PetscErrorCode ProcessOptions(AppCtx *options)
@@ -24,6 +25,7 @@ PetscErrorCode ProcessOptions(AppCtx *options)
   options->numComponents     = NULL;
   options->numDof            = NULL;
   options->numGroups         = 0;
+  ierr = PetscStrcpy(options->order, MATORDERINGRCM);CHKERRQ(ierr);
 
   ierr = PetscOptionsBegin(PETSC_COMM_SELF, "", "Meshing Problem Options", "DMPLEX");CHKERRQ(ierr);
   ierr = PetscOptionsRangeInt("-dim", "The topological mesh dimension", "ex10.c", options->dim, &options->dim, NULL,1,3);CHKERRQ(ierr);
@@ -40,6 +42,7 @@ PetscErrorCode ProcessOptions(AppCtx *options)
   ierr = PetscOptionsIntArray("-num_dof", "The dof signature for the section", "ex10.c", options->numDof, &len, &flg);CHKERRQ(ierr);
   if (flg && (len != (options->dim+1) * PetscMax(1, options->numFields))) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Length of dof array is %D should be %D", len, (options->dim+1) * PetscMax(1, options->numFields));
   ierr = PetscOptionsBoundedInt("-num_groups", "Group permutation by this many label values", "ex10.c", options->numGroups, &options->numGroups, NULL,0);CHKERRQ(ierr);
+  ierr = PetscOptionsString("-order", "The mesh ordering method", "ex10.c", options->order, options->order, sizeof(options->order), NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -75,7 +78,7 @@ PetscErrorCode TestReordering(DM dm, AppCtx *user)
   IS              perm;
   Mat             A, pA;
   PetscInt        bw, pbw;
-  MatOrderingType order = MATORDERINGRCM;
+  MatOrderingType order = user->order;
   PetscErrorCode  ierr;
 
   PetscFunctionBegin;
@@ -226,7 +229,22 @@ int main(int argc, char **argv)
   test:
     suffix: 7
     args: -dim 3 -dm_plex_box_simplex 0 -dm_refine 1              -num_dof 1,0,0,0
+  # Space filling curve tests
+  test:
+    suffix: hilbert_2d
+    args: -dim 2 -dm_plex_box_simplex 0 -dm_refine 3 -num_dof 1,0,0 -order hilbert -dm_plex_check_all
+  test:
+    suffix: morton_3d
+    args: -dim 3 -dm_plex_box_simplex 0 -dm_refine 2 -num_dof 1,0,0,0 -order morton -dm_plex_check_all
   # Parallel tests
+  test:
+    suffix: dist_hilbert
+    nsize: 2
+    args: -dim 2 -dm_plex_box_simplex 0 -dm_refine_pre 3 -dm_distribute -petscpartitioner_type simple -dm_plex_reorder hilbert -dm_plex_reorder_view -dm_plex_check_all -num_dof 1,0,0 -order natural -perm_dm_plex_check_all
+  test:
+    suffix: dist_rcm_3d
+    nsize: 3
+    args: -dim 3 -dm_plex_box_simplex 0 -dm_refine_pre 2 -dm_distribute -dm_distribute_overlap 1 -petscpartitioner_type simple -dm_plex_reorder rcm -dm_plex_reorder_view -num_dof 1,0,0,0
   # Grouping tests
   test:
     suffix: group_1
@@ -35,6 +35,8 @@ typedef struct {
   PetscBool testPartition;                /* Use a fixed partitioning for testing */
   PetscBool testRedundant;                /* Use a redundant partitioning for testing */
   PetscBool loadBalance;                  /* Load balance via a second distribute step */
+  PetscBool rebalance;                    /* Load balance incrementally with DMPlexRebalance() */
+  PetscBool testUnbalanced;               /* Use an unbalanced partition for testing */
   PetscBool partitionBalance;             /* Balance shared point partition */
   PetscLogStage stages[4];
 } AppCtx;
@@ -55,6 +57,8 @@ PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   options->testPartition    = PETSC_FALSE;
   options->testRedundant    = PETSC_FALSE;
   options->loadBalance      = PETSC_FALSE;
+  options->rebalance        = PETSC_FALSE;
+  options->testUnbalanced   = PETSC_FALSE;
   options->partitionBalance = PETSC_FALSE;
 
   ierr = PetscOptionsBegin(comm, "", "Meshing Problem Options", "DMPLEX");CHKERRQ(ierr);
@@ -68,6 +72,8 @@ PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   ierr = PetscOptionsBool("-test_redundant", "Use a redundant partition for testing", "ex12.c", options->testRedundant, &options->testRedundant, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-load_balance", "Perform parallel load balancing in a second distribution step", "ex12.c", options->loadBalance, &options->loadBalance, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-partition_balance", "Balance the ownership of shared points", "ex12.c", options->partitionBalance, &options->partitionBalance, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-rebalance", "Load balance incrementally with DMPlexRebalance() instead of a second distribution", "ex12.c", options->rebalance, &options->rebalance, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-test_unbalanced", "Give process p a share of the cells proportional to p+1 for testing", "ex12.c", options->testUnbalanced, &options->testUnbalanced, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();
 
   ierr = PetscLogStageRegister("MeshLoad",         &options->stages[STAGE_LOAD]);CHKERRQ(ierr);
@@ -77,6 +83,67 @@ PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   PetscFunctionReturn(0);
 }
 
+/* A field with one dof per vertex, holding a function of its coordinates */
+static PetscErrorCode CreateVertexField(DM dm, PetscSection *s, Vec *v)
+{
+  DM             cdm;
+  PetscSection   cs;
+  Vec            coordinates;
+  PetscScalar   *a;
+  const PetscScalar *coords;
+  PetscInt       vStart, vEnd, vt, n, cdim, off, d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DMGetCoordinateDim(dm, &cdim);CHKERRQ(ierr);
+  ierr = DMGetCoordinateDM(dm, &cdm);CHKERRQ(ierr);
+  ierr = DMGetLocalSection(cdm, &cs);CHKERRQ(ierr);
+  ierr = DMGetCoordinatesLocal(dm, &coordinates);CHKERRQ(ierr);
+  ierr = DMPlexGetDepthStratum(dm, 0, &vStart, &vEnd);CHKERRQ(ierr);
+  ierr = PetscSectionCreate(PETSC_COMM_SELF, s);CHKERRQ(ierr);
+  ierr = PetscSectionSetChart(*s, vStart, vEnd);CHKERRQ(ierr);
+  for (vt = vStart; vt < vEnd; ++vt) {ierr = PetscSectionSetDof(*s, vt, 1);CHKERRQ(ierr);}
+  ierr = PetscSectionSetUp(*s);CHKERRQ(ierr);
+  ierr = PetscSectionGetStorageSize(*s, &n);CHKERRQ(ierr);
+  ierr = VecCreateSeq(PETSC_COMM_SELF, n, v);CHKERRQ(ierr);
+  ierr = VecGetArray(*v, &a);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(coordinates, &coords);CHKERRQ(ierr);
+  for (vt = vStart; vt < vEnd; ++vt) {
+    ierr = PetscSectionGetOffset(cs, vt, &off);CHKERRQ(ierr);
+    a[vt-vStart] = 0.0;
+    for (d = 0; d < cdim; ++d) a[vt-vStart] += PetscPowInt(10, d)*coords[off+d];
+  }
+  ierr = VecRestoreArrayRead(coordinates, &coords);CHKERRQ(ierr);
+  ierr = VecRestoreArray(*v, &a);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckVertexField(DM dm, PetscSection s, Vec v, PetscBool *valid)
+{
+  PetscSection   cs;
+  Vec            w;
+  PetscBool      lvalid = PETSC_TRUE;
+  PetscInt       n, nw;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = CreateVertexField(dm, &cs, &w);CHKERRQ(ierr);
+  ierr = VecGetSize(v, &n);CHKERRQ(ierr);
+  ierr = VecGetSize(w, &nw);CHKERRQ(ierr);
+  if (n != nw) lvalid = PETSC_FALSE;
+  else {
+    PetscReal norm;
+
+    ierr = VecAXPY(w, -1.0, v);CHKERRQ(ierr);
+    ierr = VecNorm(w, NORM_INFINITY, &norm);CHKERRQ(ierr);
+    if (norm > PETSC_SMALL) lvalid = PETSC_FALSE;
+  }
+  ierr = MPIU_Allreduce(&lvalid, valid, 1, MPIU_BOOL, MPI_LAND, PetscObjectComm((PetscObject) dm));CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&cs);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode CreateMesh(MPI_Comm comm, AppCtx *user, DM *dm)
 {
   DM             pdm             = NULL;
@@ -133,6 +200,19 @@ PetscErrorCode CreateMesh(MPI_Comm comm, AppCtx *user, DM *dm)
       }
       ierr = PetscPartitionerSetType(part, PETSCPARTITIONERSHELL);CHKERRQ(ierr);
       ierr = PetscPartitionerShellSetPartition(part, size, sizes, points);CHKERRQ(ierr);
+    } else if (user->testUnbalanced) {
+      PetscInt *sizes = NULL, *points = NULL, cStart, cEnd, c, p, n = 0;
+
+      if (!rank) {
+        ierr = DMPlexGetHeightStratum(*dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+        ierr = PetscMalloc2(size, &sizes, cEnd-cStart, &points);CHKERRQ(ierr);
+        for (p = 0; p < size; ++p) {sizes[p] = (2*(p+1)*(cEnd-cStart))/(size*(size+1)); n += sizes[p];}
+        sizes[size-1] += cEnd-cStart - n;
+        for (c = cStart; c < cEnd; ++c) points[c-cStart] = c;
+      }
+      ierr = PetscPartitionerSetType(part, PETSCPARTITIONERSHELL);CHKERRQ(ierr);
+      ierr = PetscPartitionerShellSetPartition(part, size, sizes, points);CHKERRQ(ierr);
+      ierr = PetscFree2(sizes, points);CHKERRQ(ierr);
     }
     ierr = DMPlexDistribute(*dm, overlap, NULL, &pdm);CHKERRQ(ierr);
   } else {
@@ -174,7 +254,29 @@ PetscErrorCode CreateMesh(MPI_Comm comm, AppCtx *user, DM *dm)
       ierr = PetscPartitionerShellSetPartition(part, size, reSizes_n2, rePoints_n2);CHKERRQ(ierr);
     }
     ierr = DMPlexSetPartitionBalance(*dm, user->partitionBalance);CHKERRQ(ierr);
-    ierr = DMPlexDistribute(*dm, overlap, NULL, &pdm);CHKERRQ(ierr);
+    if (user->rebalance) {
+      PetscSection s, ps;
+      Vec          v, pv;
+      PetscSF      sf;
+      PetscBool    valid;
+
+      ierr = CreateVertexField(*dm, &s, &v);CHKERRQ(ierr);
+      ierr = DMPlexRebalance(*dm, 0.05, &sf, &pdm);CHKERRQ(ierr);
+      if (pdm) {
+        ierr = PetscSectionCreate(comm, &ps);CHKERRQ(ierr);
+        ierr = VecCreate(PETSC_COMM_SELF, &pv);CHKERRQ(ierr);
+        ierr = DMPlexDistributeField(*dm, sf, s, v, ps, pv);CHKERRQ(ierr);
+        ierr = CheckVertexField(pdm, ps, pv, &valid);CHKERRQ(ierr);
+        ierr = PetscPrintf(comm, "Migrated vertex field is %s\n", valid ? "valid" : "INVALID");CHKERRQ(ierr);
+        ierr = PetscSectionDestroy(&ps);CHKERRQ(ierr);
+        ierr = VecDestroy(&pv);CHKERRQ(ierr);
+      }
+      ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+      ierr = PetscSectionDestroy(&s);CHKERRQ(ierr);
+      ierr = VecDestroy(&v);CHKERRQ(ierr);
+    } else {
+      ierr = DMPlexDistribute(*dm, overlap, NULL, &pdm);CHKERRQ(ierr);
+    }
     if (pdm) {
       ierr = DMDestroy(dm);CHKERRQ(ierr);
       *dm  = pdm;
@@ -258,6 +360,24 @@ int main(int argc, char **argv)
     requires: parmetis
     nsize: 4
     args: -cell_simplex 0 -cells 4,4 -petscpartitioner_type shell -petscpartitioner_shell_random -lb_petscpartitioner_type parmetis -load_balance -lb_petscpartitioner_view -prelb_dm_view ::load_balance -dm_view ::load_balance
+  # Parallel uniform refinement, deriving the refined point SF from the coarse one
+  test:
+    suffix: refine_hierarchy
+    nsize: 4
+    args: -cell_simplex 0 -dim 3 -cells 2,2,2 -petscpartitioner_type simple -dm_refine_hierarchy 3 -dm_plex_check_all -dm_view ::load_balance
+  test:
+    suffix: refine_overlap
+    nsize: 3
+    args: -cell_simplex 0 -cells 4,4 -overlap 1 -petscpartitioner_type simple -dm_refine 2 -dm_plex_check_symmetry -dm_plex_check_skeleton -dm_plex_check_faces -dm_view ::load_balance
+  # Incremental diffusive rebalancing of an unbalanced distribution
+  test:
+    suffix: rebalance_0
+    nsize: 3
+    args: -cell_simplex 0 -cells 6,6 -test_unbalanced -load_balance -rebalance -prelb_dm_view ::load_balance -dm_view ::load_balance -dm_plex_check_all
+  test:
+    suffix: rebalance_1
+    nsize: 4
+    args: -cell_simplex 0 -dim 3 -cells 4,4,4 -test_unbalanced -overlap 1 -load_balance -rebalance -prelb_dm_view ::load_balance -dm_view ::load_balance
 
   # Same tests as above, but with balancing of the shared point partition
   test:
@@ -0,0 +1,337 @@
+static char help[] = "Tests the closure dof cache of DMPlex against the traversal of the closure.\n\n";
+
+#include <petscdmplex.h>
+#include <petscds.h>
+#include <petscbt.h>
+
+typedef struct {
+  PetscInt  dim;       /* The topological mesh dimension */
+  PetscBool simplex;   /* Flag for simplices */
+  PetscInt  numFields; /* The number of fields, a vector field followed by a scalar field */
+  PetscBool bc;        /* Constrain the vector field on the boundary */
+  PetscBool spectral;  /* Use the tensor closure permutation */
+} AppCtx;
+
+static PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  options->dim       = 2;
+  options->simplex   = PETSC_TRUE;
+  options->numFields = 1;
+  options->bc        = PETSC_FALSE;
+  options->spectral  = PETSC_FALSE;
+
+  ierr = PetscOptionsBegin(comm, "", "Closure Dof Cache Test Options", "DMPLEX");CHKERRQ(ierr);
+  ierr = PetscOptionsRangeInt("-dim", "The topological mesh dimension", "ex42.c", options->dim, &options->dim, NULL, 1, 3);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-simplex", "Flag for simplices", "ex42.c", options->simplex, &options->simplex, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsRangeInt("-num_fields", "The number of fields", "ex42.c", options->numFields, &options->numFields, NULL, 1, 2);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-bc", "Constrain the vector field on the boundary", "ex42.c", options->bc, &options->bc, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-spectral", "Use the tensor closure permutation", "ex42.c", options->spectral, &options->spectral, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode zero(PetscInt dim, PetscReal time, const PetscReal x[], PetscInt Nc, PetscScalar *u, void *ctx)
+{
+  PetscInt c;
+  for (c = 0; c < Nc; ++c) u[c] = 0.0;
+  return 0;
+}
+
+static PetscErrorCode CreateMesh(MPI_Comm comm, AppCtx *user, DM *dm)
+{
+  DM             pdm = NULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexCreateBoxMesh(comm, user->dim, user->simplex, NULL, NULL, NULL, NULL, PETSC_TRUE, dm);CHKERRQ(ierr);
+  ierr = DMPlexDistribute(*dm, 0, NULL, &pdm);CHKERRQ(ierr);
+  if (pdm) {
+    ierr = DMDestroy(dm);CHKERRQ(ierr);
+    *dm  = pdm;
+  }
+  ierr = DMSetFromOptions(*dm);CHKERRQ(ierr);
+  ierr = DMViewFromOptions(*dm, NULL, "-dm_view");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode SetupDiscretization(DM dm, AppCtx *user)
+{
+  PetscFE        fe;
+  PetscInt       f;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (f = 0; f < user->numFields; ++f) {
+    ierr = PetscFECreateDefault(PETSC_COMM_SELF, user->dim, f ? 1 : user->dim, user->simplex, f ? "scalar_" : "vector_", -1, &fe);CHKERRQ(ierr);
+    ierr = DMSetField(dm, f, NULL, (PetscObject) fe);CHKERRQ(ierr);
+    ierr = PetscFEDestroy(&fe);CHKERRQ(ierr);
+  }
+  ierr = DMCreateDS(dm);CHKERRQ(ierr);
+  if (user->bc) {
+    const PetscInt id = 1;
+
+    ierr = DMAddBoundary(dm, DM_BC_ESSENTIAL, "wall", "marker", 0, 0, NULL, (void (*)(void)) zero, NULL, 1, &id, NULL);CHKERRQ(ierr);
+  }
+  if (user->spectral) {ierr = DMPlexSetClosurePermutationTensor(dm, PETSC_DETERMINE, NULL);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* Gather every cell closure one cell at a time, and apply the closures back to a vector with each insert mode */
+static PetscErrorCode ApplyClosures(DM dm, Vec u, PetscInt cStart, PetscInt cEnd, PetscScalar values[], Vec w[])
+{
+  const InsertMode modes[3] = {ADD_VALUES, INSERT_ALL_VALUES, ADD_BC_VALUES};
+  PetscInt         c, m, off;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  for (c = cStart, off = 0; c < cEnd; ++c) {
+    PetscScalar *clValues = &values[off];
+    PetscInt     clSize   = PETSC_MAX_INT;
+
+    ierr = DMPlexVecGetClosure(dm, NULL, u, c, &clSize, &clValues);CHKERRQ(ierr);
+    off += clSize;
+  }
+  for (m = 0; m < 3; ++m) {
+    ierr = VecSet(w[m], 0.0);CHKERRQ(ierr);
+    for (c = cStart, off = 0; c < cEnd; ++c) {
+      PetscInt clSize;
+
+      ierr = DMPlexVecGetClosure(dm, NULL, u, c, &clSize, NULL);CHKERRQ(ierr);
+      ierr = DMPlexVecSetClosure(dm, NULL, w[m], c, &values[off], modes[m]);CHKERRQ(ierr);
+      off += clSize;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CompareArrays(PetscInt n, const PetscScalar a[], const PetscScalar b[], PetscBool *same)
+{
+  PetscInt i;
+
+  PetscFunctionBegin;
+  for (i = 0; i < n; ++i) if (a[i] != b[i]) *same = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CompareVecs(Vec a, Vec b, PetscBool *same)
+{
+  const PetscScalar *aa, *ba;
+  PetscInt           n;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetLocalSize(a, &n);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(a, &aa);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(b, &ba);CHKERRQ(ierr);
+  ierr = CompareArrays(n, aa, ba, same);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(a, &aa);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(b, &ba);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Check that every cached point has exactly one color, and that points of one color share no closure dof */
+static PetscErrorCode CheckColoring(DM dm, PetscSection s, PetscBool *valid)
+{
+  const PetscInt *offsets, *lidx, *colorOffsets, *colorPoints;
+  PetscBT         used;
+  PetscInt       *count, pStart, pEnd, numColors, nloc, k, i, j;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexGetClosureDofCache(dm, &pStart, &pEnd, &offsets, &lidx, NULL);CHKERRQ(ierr);
+  ierr = DMPlexGetClosureDofCacheColoring(dm, &numColors, &colorOffsets, &colorPoints);CHKERRQ(ierr);
+  ierr = PetscSectionGetStorageSize(s, &nloc);CHKERRQ(ierr);
+  ierr = PetscBTCreate(nloc, &used);CHKERRQ(ierr);
+  ierr = PetscCalloc1(pEnd-pStart, &count);CHKERRQ(ierr);
+  if (numColors && colorOffsets[numColors] != pEnd-pStart) *valid = PETSC_FALSE;
+  for (k = 0; k < numColors; ++k) {
+    ierr = PetscBTMemzero(nloc, used);CHKERRQ(ierr);
+    for (i = colorOffsets[k]; i < colorOffsets[k+1]; ++i) {
+      const PetscInt p = colorPoints[i] - pStart;
+
+      ++count[p];
+      for (j = offsets[p]; j < offsets[p+1]; ++j) {
+        if (PetscBTLookupSet(used, lidx[j] < 0 ? -(lidx[j]+1) : lidx[j])) *valid = PETSC_FALSE;
+      }
+    }
+  }
+  for (i = 0; i < pEnd-pStart; ++i) if (count[i] != 1) *valid = PETSC_FALSE;
+  ierr = PetscFree(count);CHKERRQ(ierr);
+  ierr = PetscBTDestroy(&used);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TestClosureDofCache(DM dm, AppCtx *user)
+{
+  const InsertMode modes[3] = {ADD_VALUES, INSERT_ALL_VALUES, ADD_BC_VALUES};
+  PetscSection     s, gs;
+  PetscRandom      rand;
+  Vec              u, w[3], wc[3];
+  PetscScalar     *values, *valuesCached;
+  const PetscInt  *offsets, *lidx, *gidx;
+  PetscInt         cStart, cEnd, pStart, pEnd, c, m, n;
+  PetscBool        sameGet = PETSC_TRUE, sameSet = PETSC_TRUE, sameIdx = PETSC_TRUE, validColors = PETSC_TRUE;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = DMGetLocalSection(dm, &s);CHKERRQ(ierr);
+  ierr = DMGetGlobalSection(dm, &gs);CHKERRQ(ierr);
+  ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(dm, &u);CHKERRQ(ierr);
+  for (m = 0; m < 3; ++m) {
+    ierr = VecDuplicate(u, &w[m]);CHKERRQ(ierr);
+    ierr = VecDuplicate(u, &wc[m]);CHKERRQ(ierr);
+  }
+  ierr = PetscRandomCreate(PETSC_COMM_SELF, &rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(u, rand);CHKERRQ(ierr);
+  for (c = cStart, n = 0; c < cEnd; ++c) {
+    PetscInt clSize;
+
+    ierr = DMPlexVecGetClosure(dm, NULL, u, c, &clSize, NULL);CHKERRQ(ierr);
+    n   += clSize;
+  }
+  ierr = PetscMalloc2(n, &values, n, &valuesCached);CHKERRQ(ierr);
+  /* Reference closures from the traversal */
+  ierr = ApplyClosures(dm, u, cStart, cEnd, values, w);CHKERRQ(ierr);
+  /* Point by point closures through the cache */
+  ierr = DMPlexCreateClosureDofCache(dm, PETSC_DETERMINE, PETSC_DETERMINE);CHKERRQ(ierr);
+  ierr = DMPlexGetClosureDofCache(dm, &pStart, &pEnd, &offsets, &lidx, &gidx);CHKERRQ(ierr);
+  if ((pStart != cStart) || (pEnd != cEnd) || (offsets[pEnd-pStart] != n)) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Closure dof cache does not cover the cells");
+  ierr = ApplyClosures(dm, u, cStart, cEnd, valuesCached, wc);CHKERRQ(ierr);
+  ierr = CompareArrays(n, values, valuesCached, &sameGet);CHKERRQ(ierr);
+  for (m = 0; m < 3; ++m) {ierr = CompareVecs(w[m], wc[m], &sameSet);CHKERRQ(ierr);}
+  /* All closures at once */
+  ierr = PetscArrayzero(valuesCached, n);CHKERRQ(ierr);
+  ierr = DMPlexVecGetClosures(dm, u, cStart, cEnd, valuesCached);CHKERRQ(ierr);
+  ierr = CompareArrays(n, values, valuesCached, &sameGet);CHKERRQ(ierr);
+  for (m = 0; m < 3; ++m) {
+    ierr = VecSet(wc[m], 0.0);CHKERRQ(ierr);
+    ierr = DMPlexVecSetClosures(dm, wc[m], cStart, cEnd, values, modes[m]);CHKERRQ(ierr);
+    ierr = CompareVecs(w[m], wc[m], &sameSet);CHKERRQ(ierr);
+  }
+  /* Global indices */
+  for (c = cStart; c < cEnd; ++c) {
+    PetscInt *idx, Ni, i;
+
+    ierr = DMPlexGetClosureIndices(dm, s, gs, c, PETSC_TRUE, &Ni, &idx, NULL, NULL);CHKERRQ(ierr);
+    if (Ni != offsets[c-cStart+1] - offsets[c-cStart]) sameIdx = PETSC_FALSE;
+    else for (i = 0; i < Ni; ++i) if (idx[i] != gidx[offsets[c-cStart]+i]) sameIdx = PETSC_FALSE;
+    ierr = DMPlexRestoreClosureIndices(dm, s, gs, c, PETSC_TRUE, &Ni, &idx, NULL, NULL);CHKERRQ(ierr);
+  }
+  ierr = CheckColoring(dm, s, &validColors);CHKERRQ(ierr);
+  ierr = MPI_Allreduce(MPI_IN_PLACE, &sameGet, 1, MPIU_BOOL, MPI_LAND, PetscObjectComm((PetscObject) dm));CHKERRMPI(ierr);
+  ierr = MPI_Allreduce(MPI_IN_PLACE, &sameSet, 1, MPIU_BOOL, MPI_LAND, PetscObjectComm((PetscObject) dm));CHKERRMPI(ierr);
+  ierr = MPI_Allreduce(MPI_IN_PLACE, &sameIdx, 1, MPIU_BOOL, MPI_LAND, PetscObjectComm((PetscObject) dm));CHKERRMPI(ierr);
+  ierr = MPI_Allreduce(MPI_IN_PLACE, &validColors, 1, MPIU_BOOL, MPI_LAND, PetscObjectComm((PetscObject) dm));CHKERRMPI(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject) dm), "Cached closure values %s\n", sameGet ? "match" : "DO NOT match");CHKERRQ(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject) dm), "Cached closure updates %s\n", sameSet ? "match" : "DO NOT match");CHKERRQ(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject) dm), "Cached closure indices %s\n", sameIdx ? "match" : "DO NOT match");CHKERRQ(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject) dm), "Closure coloring is %s\n", validColors ? "valid" : "INVALID");CHKERRQ(ierr);
+  ierr = DMPlexDestroyClosureDofCache(dm);CHKERRQ(ierr);
+  ierr = PetscFree2(values, valuesCached);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  for (m = 0; m < 3; ++m) {
+    ierr = VecDestroy(&w[m]);CHKERRQ(ierr);
+    ierr = VecDestroy(&wc[m]);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&u);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* A clone with its own local section keeps its own cache, and setting a closure permutation on a section drops its cache */
+static PetscErrorCode TestClosureDofCacheKeys(DM dm, AppCtx *user)
+{
+  DM              cdm;
+  PetscSection    s, cs;
+  IS              perm;
+  const PetscInt *offsets;
+  PetscInt        depth, cStart, cEnd, pStart, pEnd, cpStart, cpEnd;
+  PetscBool       kept = PETSC_TRUE, dropped = PETSC_TRUE;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = DMClone(dm, &cdm);CHKERRQ(ierr);
+  ierr = DMGetLocalSection(dm, &s);CHKERRQ(ierr);
+  ierr = PetscSectionClone(s, &cs);CHKERRQ(ierr);
+  ierr = DMSetLocalSection(cdm, cs);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&cs);CHKERRQ(ierr);
+  ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  ierr = DMPlexCreateClosureDofCache(dm, PETSC_DETERMINE, PETSC_DETERMINE);CHKERRQ(ierr);
+  ierr = DMPlexCreateClosureDofCache(cdm, PETSC_DETERMINE, PETSC_DETERMINE);CHKERRQ(ierr);
+  ierr = DMPlexGetClosureDofCache(dm, &pStart, &pEnd, &offsets, NULL, NULL);CHKERRQ(ierr);
+  ierr = DMPlexGetClosureDofCache(cdm, &cpStart, &cpEnd, NULL, NULL, NULL);CHKERRQ(ierr);
+  if ((pStart != cStart) || (pEnd != cEnd) || (cpStart != cStart) || (cpEnd != cEnd)) kept = PETSC_FALSE;
+  /* The identity permutation of the cell closure */
+  if (pEnd > pStart) {
+    ierr = DMPlexGetDepth(dm, &depth);CHKERRQ(ierr);
+    ierr = ISCreateStride(PETSC_COMM_SELF, offsets[1] - offsets[0], 0, 1, &perm);CHKERRQ(ierr);
+    ierr = PetscSectionSetClosurePermutation(s, (PetscObject) dm, depth, perm);CHKERRQ(ierr);
+    ierr = ISDestroy(&perm);CHKERRQ(ierr);
+    ierr = DMPlexGetClosureDofCache(dm, &pStart, &pEnd, NULL, NULL, NULL);CHKERRQ(ierr);
+    if (pEnd > pStart) dropped = PETSC_FALSE;
+  }
+  ierr = MPI_Allreduce(MPI_IN_PLACE, &kept, 1, MPIU_BOOL, MPI_LAND, PetscObjectComm((PetscObject) dm));CHKERRMPI(ierr);
+  ierr = MPI_Allreduce(MPI_IN_PLACE, &dropped, 1, MPIU_BOOL, MPI_LAND, PetscObjectComm((PetscObject) dm));CHKERRMPI(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject) dm), "Caches for different sections are %s\n", kept ? "kept" : "NOT kept");CHKERRQ(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject) dm), "Closure permutation %s the cache\n", dropped ? "drops" : "DOES NOT drop");CHKERRQ(ierr);
+  ierr = DMDestroy(&cdm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc, char **argv)
+{
+  DM             dm;
+  AppCtx         user;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc, &argv, NULL, help);if (ierr) return ierr;
+  ierr = ProcessOptions(PETSC_COMM_WORLD, &user);CHKERRQ(ierr);
+  ierr = CreateMesh(PETSC_COMM_WORLD, &user, &dm);CHKERRQ(ierr);
+  ierr = SetupDiscretization(dm, &user);CHKERRQ(ierr);
+  ierr = TestClosureDofCache(dm, &user);CHKERRQ(ierr);
+  ierr = TestClosureDofCacheKeys(dm, &user);CHKERRQ(ierr);
+  ierr = DMDestroy(&dm);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+  testset:
+    output_file: output/ex42_0.out
+    args: -dm_refine 1
+    test:
+      suffix: tri_p1
+      requires: triangle
+    test:
+      suffix: tri_p3
+      requires: triangle
+      args: -vector_petscspace_degree 3 -num_fields 2 -scalar_petscspace_degree 2 -bc
+    test:
+      suffix: quad_p2_spectral
+      args: -simplex 0 -vector_petscspace_degree 2 -spectral -bc
+    test:
+      suffix: quad_p3_fields
+      args: -simplex 0 -vector_petscspace_degree 3 -num_fields 2 -scalar_petscspace_degree 2 -bc
+    test:
+      suffix: tet_p2
+      requires: ctetgen
+      args: -dim 3 -vector_petscspace_degree 2 -num_fields 2 -scalar_petscspace_degree 1 -bc
+    test:
+      suffix: hex_p2_parallel
+      nsize: 2
+      args: -dim 3 -simplex 0 -vector_petscspace_degree 2 -bc -petscpartitioner_type simple
+    test:
+      suffix: quad_p2_parallel
+      nsize: 3
+      args: -simplex 0 -vector_petscspace_degree 2 -num_fields 2 -scalar_petscspace_degree 1 -bc -petscpartitioner_type simple
+    test:
+      suffix: tri_p2_parallel
+      requires: triangle
+      nsize: 3
+      args: -vector_petscspace_degree 2 -num_fields 2 -scalar_petscspace_degree 1 -bc -petscpartitioner_type simple
+
+TEST*/
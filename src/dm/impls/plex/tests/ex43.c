@@ -0,0 +1,348 @@
+static char help[] = "Benchmarks the quality and cost of PetscPartitioner implementations on a DMPlex mesh.\n\n";
+
+#include <petscdmplex.h>
+#include <petscsf.h>
+
+/* Sample usage:
+
+Compare all available partitioners on a mesh file, 16 processes, and write the results as CSV:
+
+  make -f ./gmakefile test globsearch="dm_impls_plex_tests-ex43_0" EXTRA_OPTIONS="-filename $PETSC_DIR/share/petsc/datafiles/meshes/squaremotor-30.exo -format csv" NP=16
+
+Compare ParMETIS and PT-Scotch on a large box mesh, timing 100 products:
+
+  make -f ./gmakefile test globsearch="dm_impls_plex_tests-ex43_0" EXTRA_OPTIONS="-dim 3 -cells 64,64,64 -partitioners parmetis,ptscotch -num_matmult 100" NP=16
+
+*/
+
+#define MAX_PARTITIONERS 16
+
+typedef enum {FORMAT_TABLE, FORMAT_CSV} ReportFormat;
+static const char *const ReportFormats[] = {"table", "csv", "ReportFormat", "FORMAT_", NULL};
+
+typedef struct {
+  /* Domain and mesh definition */
+  PetscInt     dim;                          /* The topological mesh dimension */
+  PetscBool    cellSimplex;                  /* Use simplices or hexes */
+  PetscInt     cells[3];                     /* The initial domain division */
+  char         filename[PETSC_MAX_PATH_LEN]; /* Import mesh from file */
+  PetscBool    useFE;                        /* Discretize the serial mesh, so that partitioners can weight by its dofs */
+  /* Benchmark */
+  char        *partitioners[MAX_PARTITIONERS]; /* The partitioner types to compare */
+  PetscInt     numPartitioners;
+  PetscInt     numMatMult;                   /* The number of MatMult() and ghost exchanges to time */
+  PetscBool    reportTimes;                  /* Report timings, which are not reproducible */
+  ReportFormat format;                       /* Human readable or machine readable output */
+} AppCtx;
+
+/* Quality and cost of one partition */
+typedef struct {
+  PetscInt       edgeCut;       /* Number of faces between cells on different processes */
+  PetscReal      imbalance;     /* Maximum over average number of cells */
+  PetscInt       ghostDofs;     /* Total number of vertex dofs received in a ghost exchange */
+  PetscInt       maxGhostDofs;  /* Maximum number received by one process */
+  PetscReal      avgNeighbors;  /* Average number of neighbor processes */
+  PetscInt       maxNeighbors;
+  PetscLogDouble partTime, distTime, multTime, ghostTime;
+} PartitionMetrics;
+
+static PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
+{
+  const char    *defaults[] = {PETSCPARTITIONERSIMPLE, PETSCPARTITIONERPARMETIS, PETSCPARTITIONERPTSCOTCH, PETSCPARTITIONERCHACO, PETSCPARTITIONERMATPARTITIONING};
+  PetscInt       n, p, format = FORMAT_TABLE;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  options->dim             = 2;
+  options->cellSimplex     = PETSC_FALSE;
+  options->cells[0]        = 16;
+  options->cells[1]        = 16;
+  options->cells[2]        = 16;
+  options->filename[0]     = '\0';
+  options->useFE           = PETSC_FALSE;
+  options->numPartitioners = MAX_PARTITIONERS;
+  options->numMatMult      = 10;
+  options->reportTimes     = PETSC_TRUE;
+  options->format          = FORMAT_TABLE;
+
+  ierr = PetscOptionsBegin(comm, "", "Partitioner Benchmark Options", "DMPLEX");CHKERRQ(ierr);
+  ierr = PetscOptionsRangeInt("-dim", "The topological mesh dimension", "ex43.c", options->dim, &options->dim, NULL, 1, 3);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-cell_simplex", "Use simplices if true, otherwise hexes", "ex43.c", options->cellSimplex, &options->cellSimplex, NULL);CHKERRQ(ierr);
+  n    = 3;
+  ierr = PetscOptionsIntArray("-cells", "The initial mesh division", "ex43.c", options->cells, &n, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsString("-filename", "The mesh file", "ex43.c", options->filename, options->filename, sizeof(options->filename), NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-use_fe", "Discretize the mesh before partitioning it", "ex43.c", options->useFE, &options->useFE, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsStringArray("-partitioners", "The partitioner types to compare", "ex43.c", options->partitioners, &options->numPartitioners, &flg);CHKERRQ(ierr);
+  ierr = PetscOptionsBoundedInt("-num_matmult", "The number of MatMult() and ghost exchanges to time", "ex43.c", options->numMatMult, &options->numMatMult, NULL, 1);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-report_times", "Report timings", "ex43.c", options->reportTimes, &options->reportTimes, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEList("-format", "The report format", "ex43.c", ReportFormats, 2, ReportFormats[options->format], &format, NULL);CHKERRQ(ierr);
+  options->format = (ReportFormat) format;
+  ierr = PetscOptionsEnd();
+  if (!flg) {
+    options->numPartitioners = sizeof(defaults)/sizeof(defaults[0]);
+    for (p = 0; p < options->numPartitioners; ++p) {ierr = PetscStrallocpy(defaults[p], &options->partitioners[p]);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Partitioners wrapping an external package are registered even when the package is missing, and fail when called */
+static PetscErrorCode PartitionerIsAvailable(const char type[], PetscBool *available)
+{
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *available = PETSC_TRUE;
+#if !defined(PETSC_HAVE_PARMETIS)
+  ierr = PetscStrcmp(type, PETSCPARTITIONERPARMETIS, &flg);CHKERRQ(ierr);
+  if (flg) *available = PETSC_FALSE;
+#endif
+#if !defined(PETSC_HAVE_PTSCOTCH)
+  ierr = PetscStrcmp(type, PETSCPARTITIONERPTSCOTCH, &flg);CHKERRQ(ierr);
+  if (flg) *available = PETSC_FALSE;
+#endif
+#if !defined(PETSC_HAVE_CHACO)
+  ierr = PetscStrcmp(type, PETSCPARTITIONERCHACO, &flg);CHKERRQ(ierr);
+  if (flg) *available = PETSC_FALSE;
+#endif
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CreateSerialMesh(MPI_Comm comm, AppCtx *user, DM *dm)
+{
+  size_t         len;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscStrlen(user->filename, &len);CHKERRQ(ierr);
+  if (len) {ierr = DMPlexCreateFromFile(comm, user->filename, PETSC_TRUE, dm);CHKERRQ(ierr);}
+  else     {ierr = DMPlexCreateBoxMesh(comm, user->dim, user->cellSimplex, user->cells, NULL, NULL, NULL, PETSC_TRUE, dm);CHKERRQ(ierr);}
+  ierr = PetscObjectSetName((PetscObject) *dm, "Serial Mesh");CHKERRQ(ierr);
+  if (user->useFE) {
+    PetscFE  fe;
+    PetscInt dim;
+
+    ierr = DMGetDimension(*dm, &dim);CHKERRQ(ierr);
+    ierr = PetscFECreateDefault(comm, dim, 1, user->cellSimplex, NULL, -1, &fe);CHKERRQ(ierr);
+    ierr = DMSetField(*dm, 0, NULL, (PetscObject) fe);CHKERRQ(ierr);
+    ierr = DMCreateDS(*dm);CHKERRQ(ierr);
+    ierr = PetscFEDestroy(&fe);CHKERRQ(ierr);
+  }
+  ierr = DMViewFromOptions(*dm, NULL, "-orig_dm_view");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* A field with one dof per vertex stands in for the unknowns of a low order discretization */
+static PetscErrorCode SetVertexSection(DM dm)
+{
+  PetscSection   s;
+  PetscInt       pStart, pEnd, vStart, vEnd, v;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexGetChart(dm, &pStart, &pEnd);CHKERRQ(ierr);
+  ierr = DMPlexGetDepthStratum(dm, 0, &vStart, &vEnd);CHKERRQ(ierr);
+  ierr = PetscSectionCreate(PetscObjectComm((PetscObject) dm), &s);CHKERRQ(ierr);
+  ierr = PetscSectionSetChart(s, pStart, pEnd);CHKERRQ(ierr);
+  for (v = vStart; v < vEnd; ++v) {ierr = PetscSectionSetDof(s, v, 1);CHKERRQ(ierr);}
+  ierr = PetscSectionSetUp(s);CHKERRQ(ierr);
+  ierr = DMSetLocalSection(dm, s);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&s);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode ComputeMetrics(DM dm, AppCtx *user, PartitionMetrics *m)
+{
+  MPI_Comm           comm;
+  PetscSF            sfPoint, sfDof;
+  Mat                A;
+  Vec                x, y, xl;
+  const PetscInt    *leaves;
+  const PetscSFNode *remotes;
+  PetscInt           fStart, fEnd, cStart, cEnd, nleaves, l, it, numNeighbors;
+  PetscInt           lm[4], gm[4];
+  PetscMPIInt        size, rank;
+  PetscLogDouble     t0, t1, lt[2], gt[2];
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject) dm, &comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm, &size);CHKERRMPI(ierr);
+  ierr = MPI_Comm_rank(comm, &rank);CHKERRMPI(ierr);
+  /* Every face between cells on different processes is a leaf on exactly one of them */
+  ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  ierr = DMPlexGetHeightStratum(dm, 1, &fStart, &fEnd);CHKERRQ(ierr);
+  ierr = DMGetPointSF(dm, &sfPoint);CHKERRQ(ierr);
+  ierr = PetscSFGetGraph(sfPoint, NULL, &nleaves, &leaves, NULL);CHKERRQ(ierr);
+  lm[0] = 0;
+  for (l = 0; l < PetscMax(nleaves, 0); ++l) {
+    const PetscInt p = leaves ? leaves[l] : l;
+
+    if (p >= fStart && p < fEnd) ++lm[0];
+  }
+  ierr = SetVertexSection(dm);CHKERRQ(ierr);
+  ierr = DMGetSectionSF(dm, &sfDof);CHKERRQ(ierr);
+  /* The section SF also maps owned dofs, only those owned by another process are exchanged */
+  ierr = PetscSFGetGraph(sfDof, NULL, &nleaves, NULL, &remotes);CHKERRQ(ierr);
+  lm[2] = 0;
+  for (l = 0; l < PetscMax(nleaves, 0); ++l) if (remotes[l].rank != rank) ++lm[2];
+  ierr = DMGetNeighbors(dm, &numNeighbors, NULL);CHKERRQ(ierr);
+  lm[1] = cEnd - cStart;
+  lm[3] = numNeighbors;
+  ierr = MPIU_Allreduce(lm, gm, 4, MPIU_INT, MPI_SUM, comm);CHKERRQ(ierr);
+  m->edgeCut      = gm[0];
+  m->imbalance    = gm[1];
+  m->ghostDofs    = gm[2];
+  m->avgNeighbors = ((PetscReal) gm[3])/size;
+  ierr = MPIU_Allreduce(lm, gm, 4, MPIU_INT, MPI_MAX, comm);CHKERRQ(ierr);
+  m->imbalance    = m->imbalance > 0 ? gm[1]*((PetscReal) size)/m->imbalance : 1.0;
+  m->maxGhostDofs = gm[2];
+  m->maxNeighbors = gm[3];
+  /* Time the operator application and the ghost exchange the partition leads to */
+  ierr = DMCreateMatrix(dm, &A);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(dm, &x);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(dm, &xl);CHKERRQ(ierr);
+  ierr = VecDuplicate(x, &y);CHKERRQ(ierr);
+  ierr = VecSet(x, 1.0);CHKERRQ(ierr);
+  ierr = MatMult(A, x, y);CHKERRQ(ierr);
+  ierr = MPI_Barrier(comm);CHKERRMPI(ierr);
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  for (it = 0; it < user->numMatMult; ++it) {ierr = MatMult(A, x, y);CHKERRQ(ierr);}
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  lt[0] = (t1 - t0)/user->numMatMult;
+  ierr = MPI_Barrier(comm);CHKERRMPI(ierr);
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  for (it = 0; it < user->numMatMult; ++it) {
+    ierr = DMGlobalToLocalBegin(dm, x, INSERT_VALUES, xl);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalEnd(dm, x, INSERT_VALUES, xl);CHKERRQ(ierr);
+  }
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  lt[1] = (t1 - t0)/user->numMatMult;
+  ierr = MPIU_Allreduce(lt, gt, 2, MPIU_PETSCLOGDOUBLE, MPI_MAX, comm);CHKERRQ(ierr);
+  m->multTime  = gt[0];
+  m->ghostTime = gt[1];
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&xl);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode BenchmarkPartitioner(DM dm, const char type[], AppCtx *user, PartitionMetrics *m)
+{
+  MPI_Comm         comm;
+  PetscPartitioner part;
+  PetscSection     partSection;
+  IS               partition;
+  DM               pdm = NULL;
+  PetscLogDouble   t0, t1, lt[2], gt[2];
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject) dm, &comm);CHKERRQ(ierr);
+  ierr = DMPlexGetPartitioner(dm, &part);CHKERRQ(ierr);
+  ierr = PetscPartitionerSetType(part, type);CHKERRQ(ierr);
+  ierr = PetscPartitionerSetFromOptions(part);CHKERRQ(ierr);
+  /* Time the partitioner alone, and then the whole distribution */
+  ierr = PetscSectionCreate(comm, &partSection);CHKERRQ(ierr);
+  ierr = MPI_Barrier(comm);CHKERRMPI(ierr);
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  ierr = PetscPartitionerDMPlexPartition(part, dm, NULL, partSection, &partition);CHKERRQ(ierr);
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  lt[0] = t1 - t0;
+  ierr = ISDestroy(&partition);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&partSection);CHKERRQ(ierr);
+  ierr = MPI_Barrier(comm);CHKERRMPI(ierr);
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  ierr = DMPlexDistribute(dm, 0, NULL, &pdm);CHKERRQ(ierr);
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  lt[1] = t1 - t0;
+  ierr = MPIU_Allreduce(lt, gt, 2, MPIU_PETSCLOGDOUBLE, MPI_MAX, comm);CHKERRQ(ierr);
+  m->partTime = gt[0];
+  m->distTime = gt[1];
+  if (!pdm) {ierr = DMClone(dm, &pdm);CHKERRQ(ierr);}
+  ierr = PetscObjectSetName((PetscObject) pdm, type);CHKERRQ(ierr);
+  ierr = DMViewFromOptions(pdm, NULL, "-dm_view");CHKERRQ(ierr);
+  ierr = ComputeMetrics(pdm, user, m);CHKERRQ(ierr);
+  ierr = DMDestroy(&pdm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode ReportMetrics(MPI_Comm comm, const char type[], PartitionMetrics *m, AppCtx *user)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  switch (user->format) {
+  case FORMAT_TABLE:
+    ierr = PetscPrintf(comm, "Partitioner %s:\n", type);CHKERRQ(ierr);
+    ierr = PetscPrintf(comm, "  Edge cut: %D\n", m->edgeCut);CHKERRQ(ierr);
+    ierr = PetscPrintf(comm, "  Cell imbalance: %.3f\n", (double) m->imbalance);CHKERRQ(ierr);
+    ierr = PetscPrintf(comm, "  Ghost dofs: %D (max %D)\n", m->ghostDofs, m->maxGhostDofs);CHKERRQ(ierr);
+    ierr = PetscPrintf(comm, "  Neighbors: %.2f (max %D)\n", (double) m->avgNeighbors, m->maxNeighbors);CHKERRQ(ierr);
+    if (user->reportTimes) {
+      ierr = PetscPrintf(comm, "  Partition time: %g\n", m->partTime);CHKERRQ(ierr);
+      ierr = PetscPrintf(comm, "  Distribution time: %g\n", m->distTime);CHKERRQ(ierr);
+      ierr = PetscPrintf(comm, "  MatMult time: %g\n", m->multTime);CHKERRQ(ierr);
+      ierr = PetscPrintf(comm, "  Ghost exchange time: %g\n", m->ghostTime);CHKERRQ(ierr);
+    }
+    break;
+  case FORMAT_CSV:
+    ierr = PetscPrintf(comm, "%s,%D,%.3f,%D,%D,%.2f,%D", type, m->edgeCut, (double) m->imbalance, m->ghostDofs, m->maxGhostDofs, (double) m->avgNeighbors, m->maxNeighbors);CHKERRQ(ierr);
+    if (user->reportTimes) {ierr = PetscPrintf(comm, ",%g,%g,%g,%g", m->partTime, m->distTime, m->multTime, m->ghostTime);CHKERRQ(ierr);}
+    ierr = PetscPrintf(comm, "\n");CHKERRQ(ierr);
+    break;
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc, char **argv)
+{
+  DM             dm;
+  AppCtx         user;
+  PetscInt       p;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc, &argv, NULL, help);if (ierr) return ierr;
+  ierr = ProcessOptions(PETSC_COMM_WORLD, &user);CHKERRQ(ierr);
+  ierr = CreateSerialMesh(PETSC_COMM_WORLD, &user, &dm);CHKERRQ(ierr);
+  if (user.format == FORMAT_CSV) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "partitioner,edge_cut,imbalance,ghost_dofs,max_ghost_dofs,avg_neighbors,max_neighbors");CHKERRQ(ierr);
+    if (user.reportTimes) {ierr = PetscPrintf(PETSC_COMM_WORLD, ",partition_time,distribution_time,matmult_time,ghost_exchange_time");CHKERRQ(ierr);}
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "\n");CHKERRQ(ierr);
+  }
+  for (p = 0; p < user.numPartitioners; ++p) {
+    PartitionMetrics m;
+    PetscBool        available;
+
+    ierr = PartitionerIsAvailable(user.partitioners[p], &available);CHKERRQ(ierr);
+    if (available) {
+      ierr = BenchmarkPartitioner(dm, user.partitioners[p], &user, &m);CHKERRQ(ierr);
+      ierr = ReportMetrics(PETSC_COMM_WORLD, user.partitioners[p], &m, &user);CHKERRQ(ierr);
+    }
+    ierr = PetscFree(user.partitioners[p]);CHKERRQ(ierr);
+  }
+  ierr = DMDestroy(&dm);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+  test:
+    suffix: 0
+    nsize: 4
+    args: -partitioners simple,gather -report_times 0
+
+  test:
+    suffix: csv
+    nsize: 3
+    args: -dim 3 -cells 4,4,4 -partitioners simple,matpartitioning -mat_partitioning_type average -report_times 0 -format csv
+
+  test:
+    suffix: weights
+    nsize: 2
+    args: -cells 2,2 -use_fe -petscspace_degree 2 -partitioners simple -petscpartitioner_use_assembly_weights -petscpartitioner_use_edge_weights -petscpartitioner_view_graph -report_times 0
+
+TEST*/
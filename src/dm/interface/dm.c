@@ -2576,6 +2576,62 @@ PetscErrorCode  DMGlobalToLocalEnd(DM dm,Vec g,InsertMode mode,Vec l)
   PetscFunctionReturn(0);
 }
 
+/*@C
+    DMGlobalToLocalBatchAdd - Enqueues the update of a local vector from a global vector on a PetscSFBatch
+
+    Neighbor-wise Collective on dm
+
+    Input Parameters:
++   dm - the DM object
+.   batch - the batch, created with PetscSFBatchCreate() on the communicator of dm
+.   g - the global vector
+.   mode - INSERT_VALUES or ADD_VALUES
+-   l - the local vector
+
+    Notes:
+    The update is complete after PetscSFBatchEnd(). Updates of several vectors, possibly on different DMs, that are
+    enqueued on the same batch send one combined message to each neighbor process instead of one message per vector.
+
+    A DM whose update cannot be deferred, for example because hooks added with DMGlobalToLocalHookAdd() or constraints must
+    run after the communication, is updated immediately with DMGlobalToLocalBegin() and DMGlobalToLocalEnd().
+
+    Level: advanced
+
+.seealso: DMGlobalToLocalBegin(), DMGlobalToLocalEnd(), PetscSFBatchCreate(), PetscSFBatchBegin(), PetscSFBatchEnd()
+
+@*/
+PetscErrorCode DMGlobalToLocalBatchAdd(DM dm,PetscSFBatch batch,Vec g,InsertMode mode,Vec l)
+{
+  PetscSF        sf;
+  Mat            cMat = NULL;
+  PetscSection   cSec;
+  PetscBool      transform;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  PetscValidPointer(batch,2);
+  PetscValidHeaderSpecific(g,VEC_CLASSID,3);
+  PetscValidHeaderSpecific(l,VEC_CLASSID,5);
+  if (!dm->gtolhook) {
+    ierr = DMGetSectionSF(dm,&sf);CHKERRQ(ierr);
+    if (sf) {
+      ierr = DMHasBasisTransform(dm,&transform);CHKERRQ(ierr);
+      ierr = DMGetDefaultConstraints(dm,&cSec,&cMat);CHKERRQ(ierr);
+      if (mode == INSERT_VALUES && !transform && !cMat) {
+        ierr = VecScatterBatchAdd(sf,batch,g,l,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+        PetscFunctionReturn(0);
+      }
+    } else if (dm->ops->globaltolocalbatchadd) {
+      ierr = (*dm->ops->globaltolocalbatchadd)(dm,batch,g,mode == INSERT_ALL_VALUES ? INSERT_VALUES : (mode == ADD_ALL_VALUES ? ADD_VALUES : mode),l);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+  }
+  ierr = DMGlobalToLocalBegin(dm,g,mode,l);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(dm,g,mode,l);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
    DMLocalToGlobalHookAdd - adds a callback to be run when a local to global is called
 
@@ -5927,6 +5983,7 @@ PetscErrorCode DMSetCoordinates(DM dm, Vec c)
   ierr            = VecDestroy(&dm->coordinates);CHKERRQ(ierr);
   dm->coordinates = c;
   ierr            = VecDestroy(&dm->coordinatesLocal);CHKERRQ(ierr);
+  ierr            = DMFieldDestroy(&dm->coordinateField);CHKERRQ(ierr);
   ierr            = DMCoarsenHookAdd(dm,DMRestrictHook_Coordinates,NULL,NULL);CHKERRQ(ierr);
   ierr            = DMSubDomainHookAdd(dm,DMSubDomainHook_Coordinates,NULL,NULL);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -5965,6 +6022,7 @@ PetscErrorCode DMSetCoordinatesLocal(DM dm, Vec c)
   dm->coordinatesLocal = c;
 
   ierr = VecDestroy(&dm->coordinates);CHKERRQ(ierr);
+  ierr = DMFieldDestroy(&dm->coordinateField);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -139,6 +139,7 @@ PetscErrorCode PetscDualSpaceRegisterAll(void)
 PETSC_EXTERN PetscErrorCode PetscFECreate_Basic(PetscFE);
 PETSC_EXTERN PetscErrorCode PetscFECreate_Nonaffine(PetscFE);
 PETSC_EXTERN PetscErrorCode PetscFECreate_Composite(PetscFE);
+PETSC_EXTERN PetscErrorCode PetscFECreate_Batch(PetscFE);
 #if defined(PETSC_HAVE_OPENCL)
 PETSC_EXTERN PetscErrorCode PetscFECreate_OpenCL(PetscFE);
 #endif
@@ -165,6 +166,7 @@ PetscErrorCode PetscFERegisterAll(void)
 
   ierr = PetscFERegister(PETSCFEBASIC,     PetscFECreate_Basic);CHKERRQ(ierr);
   ierr = PetscFERegister(PETSCFECOMPOSITE, PetscFECreate_Composite);CHKERRQ(ierr);
+  ierr = PetscFERegister(PETSCFEBATCH,     PetscFECreate_Batch);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_OPENCL)
   ierr = PetscFERegister(PETSCFEOPENCL, PetscFECreate_OpenCL);CHKERRQ(ierr);
 #endif
@@ -97,7 +97,7 @@ static PetscErrorCode PetscPartitionerPartition_MatPartitioning(PetscPartitioner
   IS                                is1, is2, is3;
   PetscReal                         *tpwgts = NULL;
   PetscInt                          numVerticesGlobal, numEdges;
-  PetscInt                          *i, *j, *vwgt = NULL;
+  PetscInt                          *i, *j, *vwgt = NULL, *ewgt = NULL;
   MPI_Comm                          comm;
   PetscErrorCode                    ierr;
 
@@ -115,10 +115,15 @@ static PetscErrorCode PetscPartitionerPartition_MatPartitioning(PetscPartitioner
   ierr = PetscMalloc1(numEdges, &j);CHKERRQ(ierr);
   ierr = PetscArraycpy(i, start, numVertices+1);CHKERRQ(ierr);
   ierr = PetscArraycpy(j, adjacency, numEdges);CHKERRQ(ierr);
+  if (part->edgeWeights) {
+    ierr = PetscMalloc1(numEdges, &ewgt);CHKERRQ(ierr);
+    ierr = PetscArraycpy(ewgt, part->edgeWeights, numEdges);CHKERRQ(ierr);
+  }
 
-  /* construct the adjacency matrix */
-  ierr = MatCreateMPIAdj(comm, numVertices, numVerticesGlobal, i, j, NULL, &matadj);CHKERRQ(ierr);
+  /* construct the adjacency matrix, whose values are the edge weights */
+  ierr = MatCreateMPIAdj(comm, numVertices, numVerticesGlobal, i, j, ewgt, &matadj);CHKERRQ(ierr);
   ierr = MatPartitioningSetAdjacency(p->mp, matadj);CHKERRQ(ierr);
+  if (ewgt) {ierr = MatPartitioningSetUseEdgeWeights(p->mp, PETSC_TRUE);CHKERRQ(ierr);}
   ierr = MatPartitioningSetNParts(p->mp, nparts);CHKERRQ(ierr);
 
   /* calculate partition weights */
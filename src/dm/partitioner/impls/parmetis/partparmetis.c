@@ -90,7 +90,7 @@ static PetscErrorCode PetscPartitionerPartition_ParMetis(PetscPartitioner part,
   PetscInt      *xadj        = start;       /* Start of edge list for each vertex */
   PetscInt      *adjncy      = adjacency;   /* Edge lists for all vertices */
   PetscInt      *vwgt        = NULL;        /* Vertex weights */
-  PetscInt      *adjwgt      = NULL;        /* Edge weights */
+  PetscInt      *adjwgt      = part->edgeWeights; /* Edge weights */
   PetscInt       wgtflag     = 0;           /* Indicates which weights are present */
   PetscInt       numflag     = 0;           /* Indicates initial offset (0 or 1) */
   PetscInt       ncon        = 1;           /* The number of weights per vertex */
@@ -98,7 +98,7 @@ static PetscErrorCode PetscPartitionerPartition_ParMetis(PetscPartitioner part,
   real_t        *tpwgts;                    /* The fraction of vertex weights assigned to each partition */
   real_t        *ubvec;                     /* The balance intolerance for vertex weights */
   PetscInt       options[64];               /* Options */
-  PetscInt       v, i, *assignment, *points;
+  PetscInt       v, c, i, *assignment, *points;
   PetscMPIInt    p, size, rank;
   PetscBool      hasempty = PETSC_FALSE;
   PetscErrorCode ierr;
@@ -107,6 +107,11 @@ static PetscErrorCode PetscPartitionerPartition_ParMetis(PetscPartitioner part,
   ierr = PetscObjectGetComm((PetscObject) part, &comm);CHKERRQ(ierr);
   ierr = MPI_Comm_size(comm, &size);CHKERRMPI(ierr);
   ierr = MPI_Comm_rank(comm, &rank);CHKERRMPI(ierr);
+  /* Each field of the vertex section is a separate balance constraint */
+  if (vertSection) {
+    ierr = PetscSectionGetNumFields(vertSection, &ncon);CHKERRQ(ierr);
+    ncon = PetscMax(ncon, 1);
+  }
   /* Calculate vertex distribution */
   ierr = PetscMalloc4(size+1,&vtxdist,nparts*ncon,&tpwgts,ncon,&ubvec,nvtxs,&assignment);CHKERRQ(ierr);
   vtxdist[0] = 0;
@@ -131,30 +136,36 @@ static PetscErrorCode PetscPartitionerPartition_ParMetis(PetscPartitioner part,
 
       ierr = PetscSectionGetDof(targetSection,p,&tpd);CHKERRQ(ierr);
       sumt += tpd;
-      tpwgts[p] = tpd;
+      tpwgts[p*ncon] = tpd;
     }
     if (sumt) { /* METIS/ParMETIS do not like exactly zero weight */
       for (p = 0, sumt = 0.0; p < nparts; ++p) {
-        tpwgts[p] = PetscMax(tpwgts[p],PETSC_SMALL);
-        sumt += tpwgts[p];
+        tpwgts[p*ncon] = PetscMax(tpwgts[p*ncon],PETSC_SMALL);
+        sumt += tpwgts[p*ncon];
       }
-      for (p = 0; p < nparts; ++p) tpwgts[p] /= sumt;
-      for (p = 0, sumt = 0.0; p < nparts-1; ++p) sumt += tpwgts[p];
-      tpwgts[nparts - 1] = 1. - sumt;
+      for (p = 0; p < nparts; ++p) tpwgts[p*ncon] /= sumt;
+      for (p = 0, sumt = 0.0; p < nparts-1; ++p) sumt += tpwgts[p*ncon];
+      tpwgts[(nparts - 1)*ncon] = 1. - sumt;
     }
   } else {
-    for (p = 0; p < nparts; ++p) tpwgts[p] = 1.0/nparts;
+    for (p = 0; p < nparts; ++p) tpwgts[p*ncon] = 1.0/nparts;
   }
-  ubvec[0] = pm->imbalanceRatio;
+  /* Every constraint gets the same target fractions and tolerance */
+  for (p = 0; p < nparts; ++p) for (c = 1; c < ncon; ++c) tpwgts[p*ncon+c] = tpwgts[p*ncon];
+  for (c = 0; c < ncon; ++c) ubvec[c] = pm->imbalanceRatio;
 
   /* Weight cells */
   if (vertSection) {
-    ierr = PetscMalloc1(nvtxs,&vwgt);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nvtxs*ncon,&vwgt);CHKERRQ(ierr);
     for (v = 0; v < nvtxs; ++v) {
-      ierr = PetscSectionGetDof(vertSection, v, &vwgt[v]);CHKERRQ(ierr);
+      if (ncon == 1) {ierr = PetscSectionGetDof(vertSection, v, &vwgt[v]);CHKERRQ(ierr);}
+      else {
+        for (c = 0; c < ncon; ++c) {ierr = PetscSectionGetFieldDof(vertSection, v, c, &vwgt[v*ncon+c]);CHKERRQ(ierr);}
+      }
     }
     wgtflag |= 2; /* have weights on graph vertices */
   }
+  if (adjwgt) wgtflag |= 1; /* have weights on graph edges */
 
   for (p = 0; !vtxdist[p+1] && p < size; ++p);
   if (vtxdist[p+1] == vtxdist[size]) {
@@ -206,7 +206,7 @@ static PetscErrorCode PetscPartitionerPartition_PTScotch(PetscPartitioner part,
   PetscInt       *xadj   = start;       /* Start of edge list for each vertex */
   PetscInt       *adjncy = adjacency;   /* Edge lists for all vertices */
   PetscInt       *vwgt   = NULL;        /* Vertex weights */
-  PetscInt       *adjwgt = NULL;        /* Edge weights */
+  PetscInt       *adjwgt = part->edgeWeights; /* Edge weights */
   PetscInt       v, i, *assignment, *points;
   PetscMPIInt    size, rank, p;
   PetscBool      hasempty = PETSC_FALSE;
@@ -232,7 +232,7 @@ static PetscErrorCode PetscPartitionerPartition_PTScotch(PetscPartitioner part,
     PetscFunctionReturn(0);
   }
 
-  /* Calculate vertex weights */
+  /* Calculate vertex weights, PT-Scotch has a single constraint so the weights of a multi-constraint vertSection are summed */
   if (vertSection) {
     ierr = PetscMalloc1(nvtxs,&vwgt);CHKERRQ(ierr);
     for (v = 0; v < nvtxs; ++v) {
@@ -118,6 +118,8 @@ PetscErrorCode PetscPartitionerView(PetscPartitioner part, PetscViewer v)
     ierr = PetscViewerASCIIPrintf(v, "  edge cut: %D\n", part->edgeCut);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(v, "  balance: %.2g\n", part->balance);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(v, "  use vertex weights: %d\n", part->usevwgt);CHKERRQ(ierr);
+    if (part->useewgt) {ierr = PetscViewerASCIIPrintf(v, "  use edge weights: %d\n", part->useewgt);CHKERRQ(ierr);}
+    if (part->useawgt) {ierr = PetscViewerASCIIPrintf(v, "  use assembly weights: %d\n", part->useawgt);CHKERRQ(ierr);}
   }
   if (part->ops->view) {ierr = (*part->ops->view)(part, v);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
@@ -157,6 +159,8 @@ static PetscErrorCode PetscPartitionerGetDefaultType(MPI_Comm comm, const char *
   Options Database Keys:
 +  -petscpartitioner_type <type> - Sets the PetscPartitioner type; use -help for a list of available types
 .  -petscpartitioner_use_vertex_weights - Uses weights associated with the graph vertices
+.  -petscpartitioner_use_edge_weights - Uses weights associated with the graph edges, see PetscPartitionerSetEdgeWeights()
+.  -petscpartitioner_use_assembly_weights - Balances the assembly cost of the vertices as a second constraint, see PetscPartitionerDMPlexPartition()
 -  -petscpartitioner_view_graph - View the graph each time PetscPartitionerPartition is called. Viewer can be customized, see PetscOptionsGetViewer()
 
   Level: developer
@@ -179,6 +183,8 @@ PetscErrorCode PetscPartitionerSetFromOptions(PetscPartitioner part)
     ierr = PetscPartitionerSetType(part, name);CHKERRQ(ierr);
   }
   ierr = PetscOptionsBool("-petscpartitioner_use_vertex_weights","Use vertex weights","",part->usevwgt,&part->usevwgt,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-petscpartitioner_use_edge_weights","Use edge weights","PetscPartitionerSetEdgeWeights",part->useewgt,&part->useewgt,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-petscpartitioner_use_assembly_weights","Balance the assembly cost as a second vertex weight","PetscPartitionerDMPlexPartition",part->useawgt,&part->useawgt,NULL);CHKERRQ(ierr);
   if (part->ops->setfromoptions) {
     ierr = (*part->ops->setfromoptions)(PetscOptionsObject,part);CHKERRQ(ierr);
   }
@@ -232,6 +238,7 @@ PetscErrorCode PetscPartitionerReset(PetscPartitioner part)
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(part, PETSCPARTITIONER_CLASSID, 1);
+  ierr = PetscFree(part->edgeWeights);CHKERRQ(ierr);
   if (part->ops->reset) {ierr = (*part->ops->reset)(part);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
@@ -263,6 +270,7 @@ PetscErrorCode PetscPartitionerDestroy(PetscPartitioner *part)
 
   ierr = PetscViewerDestroy(&(*part)->viewer);CHKERRQ(ierr);
   ierr = PetscViewerDestroy(&(*part)->viewerGraph);CHKERRQ(ierr);
+  ierr = PetscFree((*part)->edgeWeights);CHKERRQ(ierr);
   if ((*part)->ops->destroy) {ierr = (*(*part)->ops->destroy)(*part);CHKERRQ(ierr);}
   ierr = PetscHeaderDestroy(part);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -292,11 +300,12 @@ PetscErrorCode PetscPartitionerDestroy(PetscPartitioner *part)
 
   Notes:
     The chart of the vertexSection (if present) must contain [0,numVertices), with the number of dofs in the section specifying the absolute weight for each vertex.
+    If the vertexSection has fields, the number of dofs in each field is a separate weight, and partitioners supporting multiple constraints balance each of them; the others balance the total.
     The chart of the targetSection (if present) must contain [0,nparts), with the number of dofs in the section specifying the absolute weight for each partition. This information must be the same across processes, PETSc does not check it.
 
   Level: developer
 
-.seealso PetscPartitionerCreate(), PetscSectionCreate(), PetscSectionSetChart(), PetscSectionSetDof()
+.seealso PetscPartitionerCreate(), PetscPartitionerSetEdgeWeights(), PetscSectionCreate(), PetscSectionSetChart(), PetscSectionSetDof()
 @*/
 PetscErrorCode PetscPartitionerPartition(PetscPartitioner part, PetscInt nparts, PetscInt numVertices, PetscInt start[], PetscInt adjacency[], PetscSection vertexSection, PetscSection targetSection, PetscSection partSection, IS *partition)
 {
@@ -336,7 +345,11 @@ PetscErrorCode PetscPartitionerPartition(PetscPartitioner part, PetscInt nparts,
     ierr = ISCreateStride(PetscObjectComm((PetscObject)part),numVertices,0,1,partition);CHKERRQ(ierr);
   } else {
     if (!part->ops->partition) SETERRQ1(PetscObjectComm((PetscObject) part), PETSC_ERR_SUP, "PetscPartitioner %s has no partitioning method", ((PetscObject)part)->type_name);
-    ierr = (*part->ops->partition)(part, nparts, numVertices, start, adjacency, vertexSection, targetSection, partSection, partition);CHKERRQ(ierr);
+    ierr = (*part->ops->partition)(part, nparts, numVertices, start, adjacency, vertexSection, targetSection, partSection, partition);
+    if (ierr) { /* The weights belong to this graph only, do not leave them for the next call */
+      PetscErrorCode ierr2 = PetscFree(part->edgeWeights);CHKERRQ(ierr2);
+    }
+    CHKERRQ(ierr);
   }
   ierr = PetscSectionSetUp(partSection);CHKERRQ(ierr);
   if (part->viewerGraph) {
@@ -355,19 +368,64 @@ PetscErrorCode PetscPartitionerPartition(PetscPartitioner part, PetscInt nparts,
         const PetscInt e = start[v+1];
 
         ierr = PetscViewerASCIISynchronizedPrintf(viewer, "[%d]  ", rank);CHKERRQ(ierr);
-        for (i = s; i < e; ++i) {ierr = PetscViewerASCIISynchronizedPrintf(viewer, "%D ", adjacency[i]);CHKERRQ(ierr);}
-        ierr = PetscViewerASCIISynchronizedPrintf(viewer, "[%D-%D)\n", s, e);CHKERRQ(ierr);
+        for (i = s; i < e; ++i) {
+          if (part->edgeWeights) {ierr = PetscViewerASCIISynchronizedPrintf(viewer, "%D(%D) ", adjacency[i], part->edgeWeights[i]);CHKERRQ(ierr);}
+          else                   {ierr = PetscViewerASCIISynchronizedPrintf(viewer, "%D ", adjacency[i]);CHKERRQ(ierr);}
+        }
+        ierr = PetscViewerASCIISynchronizedPrintf(viewer, "[%D-%D)", s, e);CHKERRQ(ierr);
+        if (vertexSection) { /* Show the constraints of multi-constraint weights */
+          PetscInt Nf, f, w;
+
+          ierr = PetscSectionGetNumFields(vertexSection, &Nf);CHKERRQ(ierr);
+          for (f = 0; f < Nf; ++f) {
+            ierr = PetscSectionGetFieldDof(vertexSection, v, f, &w);CHKERRQ(ierr);
+            ierr = PetscViewerASCIISynchronizedPrintf(viewer, "%s%D", f ? " " : " weights ", w);CHKERRQ(ierr);
+          }
+        }
+        ierr = PetscViewerASCIISynchronizedPrintf(viewer, "\n");CHKERRQ(ierr);
       }
       ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
       ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
     }
   }
+  ierr = PetscFree(part->edgeWeights);CHKERRQ(ierr);
   if (part->viewer) {
     ierr = PetscPartitionerView(part,part->viewer);CHKERRQ(ierr);
   }
   PetscFunctionReturn(0);
 }
 
+/*@C
+  PetscPartitionerSetEdgeWeights - Sets the weights of the graph edges for the next call to PetscPartitionerPartition()
+
+  Logically collective on PetscPartitioner
+
+  Input Parameters:
++ part    - The PetscPartitioner
+- weights - The weight of each local edge, in the order of the adjacency list passed to PetscPartitionerPartition(), or NULL
+
+  Notes:
+    The PetscPartitioner takes ownership of the array, which must be allocated with PetscMalloc(), and frees it once the partition is computed or has failed.
+    The weights must be positive and symmetric, that is the edge (u,v) must have the same weight on the process owning u as (v,u) has on the process owning v.
+    They are used by PETSCPARTITIONERPARMETIS, PETSCPARTITIONERPTSCOTCH and PETSCPARTITIONERMATPARTITIONING, which stores them as the values
+    of the MATMPIADJ graph and calls MatPartitioningSetUseEdgeWeights(), so that MatPartitioning types supporting edge weights use them.
+    The other partitioners ignore them.
+
+  Level: developer
+
+.seealso: PetscPartitionerPartition(), PetscPartitionerDMPlexPartition(), MatPartitioningSetUseEdgeWeights()
+@*/
+PetscErrorCode PetscPartitionerSetEdgeWeights(PetscPartitioner part, PetscInt weights[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(part, PETSCPARTITIONER_CLASSID, 1);
+  ierr = PetscFree(part->edgeWeights);CHKERRQ(ierr);
+  part->edgeWeights = weights;
+  PetscFunctionReturn(0);
+}
+
 /*@
   PetscPartitionerCreate - Creates an empty PetscPartitioner object. The type can then be set with PetscPartitionerSetType().
 
@@ -401,6 +459,8 @@ PetscErrorCode PetscPartitionerCreate(MPI_Comm comm, PetscPartitioner *part)
   p->edgeCut = 0;
   p->balance = 0.0;
   p->usevwgt = PETSC_TRUE;
+  p->useewgt = PETSC_FALSE;
+  p->useawgt = PETSC_FALSE;
 
   *part = p;
   PetscFunctionReturn(0);
@@ -0,0 +1,120 @@
+static char help[] = "Tests the one-sided and structured ghost point updates of DMDA against the scatter.\n\n";
+
+#include <petscdm.h>
+#include <petscdmda.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode      ierr;
+  DM                  da;
+  Vec                 g,lref,l;
+  VecScatter          gtol;
+  PetscInt            dim = 2,dof = 2,s = 1,M = 7,it,i,n;
+  DMBoundaryType      bx = DM_BOUNDARY_PERIODIC,by = DM_BOUNDARY_GHOSTED,bz = DM_BOUNDARY_NONE;
+  DMDAStencilType     st = DMDA_STENCIL_BOX;
+  DMDAGhostUpdateType type = DMDA_GHOST_UPDATE_RMA_ACTIVE;
+  PetscBool           star = PETSC_FALSE,same = PETSC_TRUE;
+  const PetscScalar   *aref,*a;
+  PetscRandom         rand;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dim",&dim,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dof",&dof,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-s",&s,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-star",&star,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetEnum(NULL,NULL,"-type",DMDAGhostUpdateTypes,(PetscEnum*)&type,NULL);CHKERRQ(ierr);
+  if (star) st = DMDA_STENCIL_STAR;
+
+  if (dim == 1) {
+    ierr = DMDACreate1d(PETSC_COMM_WORLD,bx,4*M,dof,s,NULL,&da);CHKERRQ(ierr);
+  } else if (dim == 2) {
+    ierr = DMDACreate2d(PETSC_COMM_WORLD,bx,by,st,M,M+1,PETSC_DECIDE,PETSC_DECIDE,dof,s,NULL,NULL,&da);CHKERRQ(ierr);
+  } else {
+    ierr = DMDACreate3d(PETSC_COMM_WORLD,bx,by,bz,st,M,M+1,M-1,PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE,dof,s,NULL,NULL,NULL,&da);CHKERRQ(ierr);
+  }
+  ierr = DMSetFromOptions(da);CHKERRQ(ierr);
+  ierr = DMSetUp(da);CHKERRQ(ierr);
+  ierr = DMDASetGhostUpdateType(da,type);CHKERRQ(ierr);
+  ierr = DMDAGetScatter(da,&gtol,NULL);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(da,&g);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(da,&lref);CHKERRQ(ierr);
+  ierr = VecDuplicate(lref,&l);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+
+  /* Several updates, to check that the persistent windows are reused correctly */
+  for (it=0; it<3; it++) {
+    ierr = VecSetRandom(g,rand);CHKERRQ(ierr);
+    ierr = VecSet(lref,-1.0);CHKERRQ(ierr);
+    ierr = VecSet(l,-1.0);CHKERRQ(ierr);
+    ierr = VecScatterBegin(gtol,g,lref,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecScatterEnd(gtol,g,lref,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalBegin(da,g,INSERT_VALUES,l);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalEnd(da,g,INSERT_VALUES,l);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(l,&n);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(lref,&aref);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(l,&a);CHKERRQ(ierr);
+    for (i=0; i<n; i++) if (a[i] != aref[i]) same = PETSC_FALSE;
+    ierr = VecRestoreArrayRead(l,&a);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(lref,&aref);CHKERRQ(ierr);
+  }
+  ierr = MPI_Allreduce(MPI_IN_PLACE,&same,1,MPIU_BOOL,MPI_LAND,PETSC_COMM_WORLD);CHKERRMPI(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Ghost values of the %s update %s the scatter\n",DMDAGhostUpdateTypes[type],same ? "match" : "DO NOT match");CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&g);CHKERRQ(ierr);
+  ierr = VecDestroy(&lref);CHKERRQ(ierr);
+  ierr = VecDestroy(&l);CHKERRQ(ierr);
+  ierr = DMDestroy(&da);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+     requires: define(PETSC_HAVE_MPI_ONE_SIDED)
+     test:
+       suffix: active
+       nsize: 4
+     test:
+       suffix: active_3d
+       nsize: 4
+       args: -dim 3 -s 2 -star -dof 3
+       output_file: output/ex54_active.out
+     test:
+       suffix: passive
+       nsize: 4
+       args: -type rma_passive
+     test:
+       suffix: passive_3d
+       nsize: 3
+       args: -type rma_passive -dim 3
+       output_file: output/ex54_passive.out
+
+   testset:
+     args: -type structured
+     output_file: output/ex54_structured.out
+     test:
+       suffix: structured
+       nsize: 4
+     test:
+       suffix: structured_3d
+       nsize: 4
+       args: -dim 3 -s 2 -star -dof 3
+     test:
+       suffix: structured_3d_box
+       nsize: 3
+       args: -dim 3
+     test:
+       suffix: structured_deep
+       nsize: 2
+       args: -s 3
+     test:
+       suffix: structured_1d
+       nsize: 3
+       args: -dim 1 -s 2
+     test:
+       suffix: structured_self
+       args: -s 2 -dof 1
+
+TEST*/
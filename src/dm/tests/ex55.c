@@ -0,0 +1,197 @@
+static char help[] = "Tests the tiled iteration and the stencil application of DMDA.\n\n";
+
+#include <petscdm.h>
+#include <petscdmda.h>
+
+/* Index of point (i,j,k), dof c, in the local array described by info */
+PETSC_STATIC_INLINE PetscInt LocalIndex(DMDALocalInfo *info,PetscInt i,PetscInt j,PetscInt k,PetscInt c)
+{
+  return (((k-info->gzs)*info->gym+j-info->gys)*info->gxm+i-info->gxs)*info->dof+c;
+}
+
+PETSC_STATIC_INLINE PetscBool InGhosted(DMDALocalInfo *info,PetscInt i,PetscInt j,PetscInt k)
+{
+  return (PetscBool)(i >= info->gxs && i < info->gxs+info->gxm && j >= info->gys && j < info->gys+info->gym && k >= info->gzs && k < info->gzs+info->gzm);
+}
+
+/* Copies the locally owned values of a local array to a global array */
+static PetscErrorCode CopyOwned(DMDALocalInfo *info,Vec l,Vec g)
+{
+  PetscErrorCode    ierr;
+  const PetscScalar *la;
+  PetscScalar       *ga;
+  PetscInt          i,j,k,c;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetArrayRead(l,&la);CHKERRQ(ierr);
+  ierr = VecGetArray(g,&ga);CHKERRQ(ierr);
+  for (k=info->zs; k<info->zs+info->zm; k++) for (j=info->ys; j<info->ys+info->ym; j++) for (i=info->xs; i<info->xs+info->xm; i++) {
+    for (c=0; c<info->dof; c++) ga[(((k-info->zs)*info->ym+j-info->ys)*info->xm+i-info->xs)*info->dof+c] = la[LocalIndex(info,i,j,k,c)];
+  }
+  ierr = VecRestoreArray(g,&ga);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(l,&la);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* One explicit step of a diffusion with radius 1 at point (i,j,k), keeping the values on nonperiodic boundaries */
+PETSC_STATIC_INLINE void Step(DMDALocalInfo *info,const PetscScalar *in,PetscScalar *out,PetscInt i,PetscInt j,PetscInt k)
+{
+  PetscInt c,p = LocalIndex(info,i,j,k,0);
+
+  for (c=0; c<info->dof; c++) {
+    if ((info->bx != DM_BOUNDARY_PERIODIC && (i == 0 || i == info->mx-1)) ||
+        (info->dim > 1 && info->by != DM_BOUNDARY_PERIODIC && (j == 0 || j == info->my-1)) ||
+        (info->dim > 2 && info->bz != DM_BOUNDARY_PERIODIC && (k == 0 || k == info->mz-1))) {
+      out[p+c] = in[p+c];
+    } else {
+      PetscScalar sum = in[LocalIndex(info,i-1,j,k,c)]+in[LocalIndex(info,i+1,j,k,c)]-2.0*in[p+c];
+
+      if (info->dim > 1) sum += in[LocalIndex(info,i,j-1,k,c)]+in[LocalIndex(info,i,j+1,k,c)]-2.0*in[p+c];
+      if (info->dim > 2) sum += in[LocalIndex(info,i,j,k-1,c)]+in[LocalIndex(info,i,j,k+1,c)]-2.0*in[p+c];
+      out[p+c] = in[p+c]+0.1*sum;
+    }
+  }
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode    ierr;
+  DM                da;
+  Vec               x,y,yref,xloc,u,v;
+  DMDALocalInfo     info,tile;
+  DMDATileIterator  it;
+  PetscInt          dim = 2,dof = 2,s = 2,M = 11,nsteps = 2,ncoef = 1,o,d,i,j,k,c,step;
+  PetscScalar       *coef,*ya,*la[2];
+  const PetscScalar *xa;
+  PetscReal         nrm,err;
+  PetscBool         star = PETSC_FALSE,more;
+  DMDAStencilType   st = DMDA_STENCIL_BOX;
+  PetscRandom       rand;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dim",&dim,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dof",&dof,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-s",&s,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nsteps",&nsteps,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-star",&star,NULL);CHKERRQ(ierr);
+  if (star) st = DMDA_STENCIL_STAR;
+  if (dim == 1) {
+    ierr = DMDACreate1d(PETSC_COMM_WORLD,DM_BOUNDARY_PERIODIC,4*M,dof,s,NULL,&da);CHKERRQ(ierr);
+  } else if (dim == 2) {
+    ierr = DMDACreate2d(PETSC_COMM_WORLD,DM_BOUNDARY_PERIODIC,DM_BOUNDARY_NONE,st,M,M+2,PETSC_DECIDE,PETSC_DECIDE,dof,s,NULL,NULL,&da);CHKERRQ(ierr);
+  } else {
+    ierr = DMDACreate3d(PETSC_COMM_WORLD,DM_BOUNDARY_PERIODIC,DM_BOUNDARY_NONE,DM_BOUNDARY_GHOSTED,st,M,M+2,M-1,PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE,dof,s,NULL,NULL,NULL,&da);CHKERRQ(ierr);
+  }
+  ierr = DMSetFromOptions(da);CHKERRQ(ierr);
+  ierr = DMSetUp(da);CHKERRQ(ierr);
+  ierr = DMDAGetLocalInfo(da,&info);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(da,&x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&yref);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+
+  /* The stencil application, against a plain loop over the points and the offsets */
+  for (d=0; d<dim; d++) ncoef *= 2*s+1;
+  ierr = PetscMalloc1(ncoef,&coef);CHKERRQ(ierr);
+  for (o=0; o<ncoef; o++) coef[o] = 1.0/(1.0+o);
+  ierr = DMDAStencilApply(da,coef,x,y);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(da,&xloc);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(da,x,INSERT_VALUES,xloc);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(da,x,INSERT_VALUES,xloc);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xloc,&xa);CHKERRQ(ierr);
+  ierr = VecGetArray(yref,&ya);CHKERRQ(ierr);
+  for (k=info.zs; k<info.zs+info.zm; k++) for (j=info.ys; j<info.ys+info.ym; j++) for (i=info.xs; i<info.xs+info.xm; i++) {
+    for (c=0; c<dof; c++) {
+      PetscScalar sum = 0.0;
+
+      for (o=0; o<ncoef; o++) {
+        PetscInt ox = o%(2*s+1)-s,oy = dim > 1 ? (o/(2*s+1))%(2*s+1)-s : 0,oz = dim > 2 ? o/((2*s+1)*(2*s+1))-s : 0;
+
+        if (star && ((ox != 0)+(oy != 0)+(oz != 0)) > 1) continue;
+        if (!InGhosted(&info,i+ox,j+oy,k+oz)) continue;
+        sum += coef[o]*xa[LocalIndex(&info,i+ox,j+oy,k+oz,c)];
+      }
+      ya[(((k-info.zs)*info.ym+j-info.ys)*info.xm+i-info.xs)*dof+c] = sum;
+    }
+  }
+  ierr = VecRestoreArray(yref,&ya);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xloc,&xa);CHKERRQ(ierr);
+  ierr = VecAXPY(y,-1.0,yref);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = VecNorm(yref,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Stencil application %s\n",err <= 1.e-10*nrm ? "matches" : "DOES NOT match");CHKERRQ(ierr);
+
+  /* Several explicit steps with wavefront temporal blocking and a single ghost update, against a ghost update per step */
+  ierr = VecCopy(x,yref);CHKERRQ(ierr);
+  for (step=0; step<nsteps; step++) {
+    ierr = DMGlobalToLocalBegin(da,yref,INSERT_VALUES,xloc);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalEnd(da,yref,INSERT_VALUES,xloc);CHKERRQ(ierr);
+    ierr = DMGetLocalVector(da,&u);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(xloc,&xa);CHKERRQ(ierr);
+    ierr = VecGetArray(u,&la[0]);CHKERRQ(ierr);
+    for (k=info.zs; k<info.zs+info.zm; k++) for (j=info.ys; j<info.ys+info.ym; j++) for (i=info.xs; i<info.xs+info.xm; i++) Step(&info,xa,la[0],i,j,k);
+    ierr = VecRestoreArray(u,&la[0]);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(xloc,&xa);CHKERRQ(ierr);
+    ierr = CopyOwned(&info,u,yref);CHKERRQ(ierr);
+    ierr = DMRestoreLocalVector(da,&u);CHKERRQ(ierr);
+  }
+  ierr = DMGetLocalVector(da,&u);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(da,&v);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(da,x,INSERT_VALUES,u);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(da,x,INSERT_VALUES,u);CHKERRQ(ierr);
+  ierr = VecGetArray(u,&la[0]);CHKERRQ(ierr);
+  ierr = VecGetArray(v,&la[1]);CHKERRQ(ierr);
+  ierr = DMDATileIteratorBegin(da,nsteps,&it);CHKERRQ(ierr);
+  while (1) {
+    ierr = DMDATileIteratorNext(&it,&tile,&step,&more);CHKERRQ(ierr);
+    if (!more) break;
+    for (k=tile.zs; k<tile.zs+tile.zm; k++) for (j=tile.ys; j<tile.ys+tile.ym; j++) for (i=tile.xs; i<tile.xs+tile.xm; i++) Step(&info,la[step%2],la[(step+1)%2],i,j,k);
+  }
+  ierr = VecRestoreArray(v,&la[1]);CHKERRQ(ierr);
+  ierr = VecRestoreArray(u,&la[0]);CHKERRQ(ierr);
+  ierr = CopyOwned(&info,nsteps%2 ? v : u,y);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(da,&v);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(da,&u);CHKERRQ(ierr);
+  ierr = VecAXPY(y,-1.0,yref);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = VecNorm(yref,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Steps with temporal blocking %s\n",err <= 1.e-10*nrm ? "match" : "DO NOT match");CHKERRQ(ierr);
+
+  ierr = DMRestoreLocalVector(da,&xloc);CHKERRQ(ierr);
+  ierr = PetscFree(coef);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&yref);CHKERRQ(ierr);
+  ierr = DMDestroy(&da);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+     output_file: output/ex55_1.out
+     test:
+       suffix: 1
+       nsize: 4
+       args: -da_tile_size 3,2
+     test:
+       suffix: 1d
+       nsize: 3
+       args: -dim 1 -s 3 -nsteps 3 -da_tile_size 4
+     test:
+       suffix: 3d
+       nsize: 4
+       args: -dim 3 -dof 1 -da_tile_size 4,3,2
+     test:
+       suffix: 3d_star
+       nsize: 2
+       args: -dim 3 -star -s 3 -nsteps 1 -da_tile_size 0,2,1
+     test:
+       suffix: default_tiles
+       nsize: 2
+       args: -nsteps 1 -s 1
+
+TEST*/
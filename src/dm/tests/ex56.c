@@ -0,0 +1,131 @@
+static char help[] = "Tests overlapping ghost updates of several vectors with a DMComposite of DMDAs.\n\n";
+
+#include <petscdmda.h>
+#include <petscdmcomposite.h>
+
+/* The value of component c at point (i,j) of the packed DM d in vector v */
+static PetscScalar Value(PetscInt v,PetscInt d,PetscInt c,PetscInt i,PetscInt j)
+{
+  return (PetscScalar)(10000*v+1000*(2*d+c)+100*j+i);
+}
+
+static PetscErrorCode FillGlobal(DM packer,PetscInt v,Vec global)
+{
+  PetscErrorCode ierr;
+  DM             da[2];
+  Vec            g[2];
+  PetscInt       d,c,i,j,xs,ys,xm,ym,dof;
+  PetscScalar    ***a;
+
+  PetscFunctionBegin;
+  ierr = DMCompositeGetEntries(packer,&da[0],&da[1]);CHKERRQ(ierr);
+  ierr = DMCompositeGetAccess(packer,global,&g[0],&g[1]);CHKERRQ(ierr);
+  for (d=0; d<2; d++) {
+    ierr = DMDAGetInfo(da[d],NULL,NULL,NULL,NULL,NULL,NULL,NULL,&dof,NULL,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+    ierr = DMDAGetCorners(da[d],&xs,&ys,NULL,&xm,&ym,NULL);CHKERRQ(ierr);
+    ierr = DMDAVecGetArrayDOF(da[d],g[d],&a);CHKERRQ(ierr);
+    for (j=ys; j<ys+ym; j++) for (i=xs; i<xs+xm; i++) for (c=0; c<dof; c++) a[j][i][c] = Value(v,d,c,i,j);
+    ierr = DMDAVecRestoreArrayDOF(da[d],g[d],&a);CHKERRQ(ierr);
+  }
+  ierr = DMCompositeRestoreAccess(packer,global,&g[0],&g[1]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Counts the owned and ghost points of the local vector that do not hold the values of vector v */
+static PetscErrorCode CheckLocal(DM packer,PetscInt v,Vec local,PetscInt *nerr)
+{
+  PetscErrorCode ierr;
+  DM             da[2];
+  Vec            l[2];
+  PetscInt       d,c,i,j,xs,ys,xm,ym,dof;
+  PetscScalar    ***a;
+
+  PetscFunctionBegin;
+  ierr = DMCompositeGetEntries(packer,&da[0],&da[1]);CHKERRQ(ierr);
+  ierr = DMCompositeGetLocalAccessArray(packer,local,2,NULL,l);CHKERRQ(ierr);
+  for (d=0; d<2; d++) {
+    ierr = DMDAGetInfo(da[d],NULL,NULL,NULL,NULL,NULL,NULL,NULL,&dof,NULL,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+    ierr = DMDAGetGhostCorners(da[d],&xs,&ys,NULL,&xm,&ym,NULL);CHKERRQ(ierr);
+    ierr = DMDAVecGetArrayDOFRead(da[d],l[d],&a);CHKERRQ(ierr);
+    for (j=ys; j<ys+ym; j++) for (i=xs; i<xs+xm; i++) for (c=0; c<dof; c++) if (a[j][i][c] != Value(v,d,c,i,j)) (*nerr)++;
+    ierr = DMDAVecRestoreArrayDOFRead(da[d],l[d],&a);CHKERRQ(ierr);
+  }
+  ierr = DMCompositeRestoreLocalAccessArray(packer,local,2,NULL,l);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  DM             packer,da1,da2;
+  Vec            g1,g2,l1,l2;
+  PetscInt       it,nerr = 0,nits = 2;
+  PetscBool      reverse = PETSC_FALSE;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-reverse_end",&reverse,NULL);CHKERRQ(ierr);
+
+  ierr = DMDACreate2d(PETSC_COMM_WORLD,DM_BOUNDARY_NONE,DM_BOUNDARY_NONE,DMDA_STENCIL_BOX,8,6,PETSC_DECIDE,PETSC_DECIDE,1,1,NULL,NULL,&da1);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(da1);CHKERRQ(ierr);
+  ierr = DMSetUp(da1);CHKERRQ(ierr);
+  ierr = DMDACreate2d(PETSC_COMM_WORLD,DM_BOUNDARY_NONE,DM_BOUNDARY_NONE,DMDA_STENCIL_BOX,5,7,PETSC_DECIDE,PETSC_DECIDE,2,2,NULL,NULL,&da2);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(da2);CHKERRQ(ierr);
+  ierr = DMSetUp(da2);CHKERRQ(ierr);
+  ierr = DMCompositeCreate(PETSC_COMM_WORLD,&packer);CHKERRQ(ierr);
+  ierr = DMCompositeAddDM(packer,da1);CHKERRQ(ierr);
+  ierr = DMCompositeAddDM(packer,da2);CHKERRQ(ierr);
+
+  ierr = DMCreateGlobalVector(packer,&g1);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(packer,&g2);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(packer,&l1);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(packer,&l2);CHKERRQ(ierr);
+
+  /* The second iteration reuses the batches kept with the local vectors */
+  for (it=0; it<nits; it++) {
+    ierr = FillGlobal(packer,2*it,g1);CHKERRQ(ierr);
+    ierr = FillGlobal(packer,2*it+1,g2);CHKERRQ(ierr);
+    ierr = VecZeroEntries(l1);CHKERRQ(ierr);
+    ierr = VecZeroEntries(l2);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalBegin(packer,g1,INSERT_VALUES,l1);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalBegin(packer,g2,INSERT_VALUES,l2);CHKERRQ(ierr);
+    if (reverse) {
+      ierr = DMGlobalToLocalEnd(packer,g2,INSERT_VALUES,l2);CHKERRQ(ierr);
+      ierr = DMGlobalToLocalEnd(packer,g1,INSERT_VALUES,l1);CHKERRQ(ierr);
+    } else {
+      ierr = DMGlobalToLocalEnd(packer,g1,INSERT_VALUES,l1);CHKERRQ(ierr);
+      ierr = DMGlobalToLocalEnd(packer,g2,INSERT_VALUES,l2);CHKERRQ(ierr);
+    }
+    ierr = CheckLocal(packer,2*it,l1,&nerr);CHKERRQ(ierr);
+    ierr = CheckLocal(packer,2*it+1,l2,&nerr);CHKERRQ(ierr);
+  }
+  ierr = MPI_Allreduce(MPI_IN_PLACE,&nerr,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRMPI(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Number of wrong local values: %D\n",nerr);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&g1);CHKERRQ(ierr);
+  ierr = VecDestroy(&g2);CHKERRQ(ierr);
+  ierr = VecDestroy(&l1);CHKERRQ(ierr);
+  ierr = VecDestroy(&l2);CHKERRQ(ierr);
+  ierr = DMDestroy(&packer);CHKERRQ(ierr);
+  ierr = DMDestroy(&da1);CHKERRQ(ierr);
+  ierr = DMDestroy(&da2);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      nsize: 4
+      output_file: output/ex56_1.out
+
+   test:
+      suffix: reverse
+      nsize: 3
+      args: -reverse_end
+      output_file: output/ex56_1.out
+
+   test:
+      suffix: seq
+      output_file: output/ex56_1.out
+
+TEST*/
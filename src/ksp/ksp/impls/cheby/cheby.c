@@ -10,6 +10,53 @@ static PetscErrorCode KSPReset_Chebyshev(KSP ksp)
   if (cheb->kspest) {
     ierr = KSPReset(cheb->kspest);CHKERRQ(ierr);
   }
+  ierr = VecDestroy(&cheb->diaginv);CHKERRQ(ierr);
+  cheb->diaginvid    = 0;
+  cheb->diaginvstate = -1;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Returns the fused kernel y = alpha xkm1 + beta xk + gamma D^{-1} (b - A xk) if it can be used for this solve, that is
+   if no norms are needed, the preconditioner is PCJACOBI and the operator implements it. The inverse diagonal used by
+   PCJACOBI is extracted by applying the preconditioner to a vector of ones and is cached until the preconditioner is set
+   up again, which PCJACOBI records by increasing its state, for example after Pmat or the PCJacobiType changes.
+*/
+static PetscErrorCode KSPChebyshevGetFusedStep_Private(KSP ksp,Mat Amat,Mat Pmat,PetscErrorCode (**step)(Mat,Vec,Vec,PetscScalar,PetscScalar,PetscScalar,Vec,Vec,Vec))
+{
+  KSP_Chebyshev    *cheb = (KSP_Chebyshev*)ksp->data;
+  PetscBool        isjacobi,supported;
+  PetscObjectId    pcid;
+  PetscObjectState pcstate;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  *step = NULL;
+  if (!cheb->fused || ksp->normtype != KSP_NORM_NONE || ksp->transpose_solve) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)ksp->pc,PCJACOBI,&isjacobi);CHKERRQ(ierr);
+  if (!isjacobi) PetscFunctionReturn(0);
+  /* derived types (GPU, MKL, ...) may keep their values elsewhere so only the base types are trusted */
+  ierr = PetscObjectTypeCompareAny((PetscObject)Amat,&supported,MATSEQAIJ,MATMPIAIJ,MATSEQBAIJ,"");CHKERRQ(ierr);
+  if (!supported) PetscFunctionReturn(0);
+  ierr = PetscObjectQueryFunction((PetscObject)Amat,"MatChebyshevJacobiStep_C",step);CHKERRQ(ierr);
+  if (!*step) PetscFunctionReturn(0);
+  /* the fused kernel bypasses PCApply(), which would otherwise set up the preconditioner again after changes */
+  ierr = PCSetUp(ksp->pc);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)ksp->pc,&pcid);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)ksp->pc,&pcstate);CHKERRQ(ierr);
+  if (!cheb->diaginv || pcid != cheb->diaginvid || pcstate != cheb->diaginvstate) {
+    Vec ones = ksp->work[2];
+
+    if (!cheb->diaginv) {
+      ierr = VecDuplicate(ksp->vec_rhs,&cheb->diaginv);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)cheb->diaginv);CHKERRQ(ierr);
+    }
+    ierr = VecSet(ones,1.0);CHKERRQ(ierr);
+    ierr = PCApply(ksp->pc,ones,cheb->diaginv);CHKERRQ(ierr);
+    ierr = PetscObjectStateGet((PetscObject)ksp->pc,&pcstate);CHKERRQ(ierr);
+    cheb->diaginvid    = pcid;
+    cheb->diaginvstate = pcstate;
+  }
   PetscFunctionReturn(0);
 }
 
@@ -371,6 +418,7 @@ static PetscErrorCode KSPSetFromOptions_Chebyshev(PetscOptionItems *PetscOptions
     ierr = PetscOptionsBool("-ksp_chebyshev_esteig_noisy","Use noisy right hand side for estimate","KSPChebyshevEstEigSetUseNoisy",cheb->usenoisy,&cheb->usenoisy,NULL);CHKERRQ(ierr);
     ierr = KSPSetFromOptions(cheb->kspest);CHKERRQ(ierr);
   }
+  ierr = PetscOptionsBool("-ksp_chebyshev_fused","Fuse residual, Jacobi preconditioner and update into one pass over the matrix","None",cheb->fused,&cheb->fused,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -385,6 +433,7 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
   Vec            sol_orig,b,p[3],r;
   Mat            Amat,Pmat;
   PetscBool      diagonalscale;
+  PetscErrorCode (*step)(Mat,Vec,Vec,PetscScalar,PetscScalar,PetscScalar,Vec,Vec,Vec);
 
   PetscFunctionBegin;
   ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
@@ -416,7 +465,21 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
   c[km1] = 1.0;
   c[k]   = mu;
 
-  if (!ksp->guess_zero) {
+  ierr = KSPChebyshevGetFusedStep_Private(ksp,Amat,Pmat,&step);CHKERRQ(ierr);
+  if (step) {
+    /* p[k] = p[km1] + scale D^{-1}(b - A p[km1]) */
+    ksp->reason = KSP_CONVERGED_ITERATING;
+    if (ksp->max_it == 0) {
+      ksp->reason = KSP_DIVERGED_ITS; /* This for a V(0,x) cycle */
+      PetscFunctionReturn(0);
+    }
+    if (!ksp->guess_zero) {
+      ierr = (*step)(Amat,b,cheb->diaginv,0.0,1.0,scale,p[km1],p[km1],p[k]);CHKERRQ(ierr);
+    } else {
+      ierr = VecPointwiseMult(p[k],cheb->diaginv,b);CHKERRQ(ierr);
+      ierr = VecAYPX(p[k],scale,p[km1]);CHKERRQ(ierr);
+    }
+  } else if (!ksp->guess_zero) {
     ierr = KSP_MatMult(ksp,Amat,sol_orig,r);CHKERRQ(ierr);     /*  r = b - A*p[km1] */
     ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
   } else {
@@ -448,10 +511,12 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
     if (ksp->max_it==0) ksp->reason = KSP_DIVERGED_ITS; /* This for a V(0,x) cycle */
     PetscFunctionReturn(0);
   }
-  if (ksp->normtype != KSP_NORM_PRECONDITIONED) {
-    ierr = KSP_PCApply(ksp,r,p[k]);CHKERRQ(ierr);  /* p[k] = B^{-1}r */
+  if (!step) {
+    if (ksp->normtype != KSP_NORM_PRECONDITIONED) {
+      ierr = KSP_PCApply(ksp,r,p[k]);CHKERRQ(ierr);  /* p[k] = B^{-1}r */
+    }
+    ierr = VecAYPX(p[k],scale,p[km1]);CHKERRQ(ierr);  /* p[k] = scale B^{-1}r + p[km1] */
   }
-  ierr = VecAYPX(p[k],scale,p[km1]);CHKERRQ(ierr);  /* p[k] = scale B^{-1}r + p[km1] */
   ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
   ksp->its = 1;
   ierr   = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
@@ -461,6 +526,21 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
     ksp->its++;
     ierr   = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
 
+    if (step) {
+      c[kp1] = 2.0*mu*c[k] - c[km1];
+      omega  = omegaprod*c[k]/c[kp1];
+
+      ksp->vec_sol = p[k];
+      ierr = KSPLogErrorHistory(ksp);CHKERRQ(ierr);
+      /* y^{k+1} = omega(y^{k} - y^{k-1} + Gamma*D^{-1}(b - A y^{k})) + y^{k-1} in a single pass over the matrix */
+      ierr = (*step)(Amat,b,cheb->diaginv,1.0-omega,omega,omega*Gamma*scale,p[km1],p[k],p[kp1]);CHKERRQ(ierr);
+
+      ktmp = km1;
+      km1  = k;
+      k    = kp1;
+      kp1  = ktmp;
+      continue;
+    }
     ierr = KSP_MatMult(ksp,Amat,p[k],r);CHKERRQ(ierr);          /*  r = b - Ap[k]    */
     ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
     /* calculate residual norm if requested */
@@ -569,6 +649,9 @@ static  PetscErrorCode KSPView_Chebyshev(KSP ksp,PetscViewer viewer)
         ierr = PetscViewerASCIIPrintf(viewer,"  estimating eigenvalues using noisy right hand side\n");CHKERRQ(ierr);
       }
     }
+    if (cheb->fused) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  fusing residual, Jacobi preconditioner and update when supported by the operator\n");CHKERRQ(ierr);
+    }
   }
   PetscFunctionReturn(0);
 }
@@ -580,6 +663,7 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
 
   PetscFunctionBegin;
   ierr = KSPDestroy(&cheb->kspest);CHKERRQ(ierr);
+  ierr = VecDestroy(&cheb->diaginv);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevSetEigenvalues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSet_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetUseNoisy_C",NULL);CHKERRQ(ierr);
@@ -597,7 +681,9 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
 .   -ksp_chebyshev_esteig <a,b,c,d> - estimate eigenvalues using a Krylov method, then use this
                          transform for Chebyshev eigenvalue bounds (KSPChebyshevEstEigSet())
 .   -ksp_chebyshev_esteig_steps - number of estimation steps
--   -ksp_chebyshev_esteig_noisy - use noisy number generator to create right hand side for eigenvalue estimator
+.   -ksp_chebyshev_esteig_noisy - use noisy number generator to create right hand side for eigenvalue estimator
+-   -ksp_chebyshev_fused - with PCJACOBI and no norm computation, compute the residual, apply the inverse diagonal and update
+                         the iterate in a single pass over a MATSEQAIJ, MATMPIAIJ or MATSEQBAIJ operator
 
    Level: beginner
 
@@ -609,6 +695,9 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
           Chebyshev is configured as a smoother by default, targetting the "upper" part of the spectrum.
           The user should call KSPChebyshevSetEigenvalues() if they have eigenvalue estimates.
 
+          With -ksp_chebyshev_fused each iteration reads the matrix and the vectors only once instead of once each for
+          MatMult(), the residual update, PCApply() and the Chebyshev update, which pays off when used as a multigrid smoother.
+
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP,
            KSPChebyshevSetEigenvalues(), KSPChebyshevEstEigSet(), KSPChebyshevEstEigSetUseNoisy()
            KSPRICHARDSON, KSPCG, PCMG
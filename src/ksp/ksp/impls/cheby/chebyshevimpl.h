@@ -17,6 +17,11 @@ typedef struct {
   /* For tracking when to update the eigenvalue estimates */
   PetscObjectId    amatid,    pmatid;
   PetscObjectState amatstate, pmatstate;
+  /* For the fused residual, point Jacobi and update kernel */
+  PetscBool        fused;        /* use the kernel when the operator provides it and the preconditioner is PCJACOBI */
+  Vec              diaginv;      /* inverse of the diagonal used by PCJACOBI */
+  PetscObjectId    diaginvid;
+  PetscObjectState diaginvstate;
 } KSP_Chebyshev;
 
 #endif
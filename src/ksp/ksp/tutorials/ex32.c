@@ -204,4 +204,12 @@ PetscErrorCode ComputeMatrix(KSP ksp, Mat J,Mat jac, void *ctx)
    test:
       args: -pc_type mg -pc_mg_type full -ksp_type fgmres -ksp_monitor_short -pc_mg_levels 3 -mg_coarse_pc_factor_shift_type nonzero
 
+   test:
+      suffix: additive
+      args: -pc_type mg -pc_mg_type additive -ksp_type fgmres -ksp_monitor_short -pc_mg_levels 3 -mg_coarse_pc_factor_shift_type nonzero -pc_mg_additive_type {{bpx afacx mult}separate output}
+
+   test:
+      suffix: cheby_fused
+      args: -pc_type mg -ksp_type fgmres -ksp_monitor_short -pc_mg_levels 3 -mg_coarse_pc_factor_shift_type nonzero -mg_levels_pc_type jacobi -mg_levels_ksp_chebyshev_fused
+
 TEST*/
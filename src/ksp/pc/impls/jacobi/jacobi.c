@@ -68,15 +68,12 @@ typedef struct {
 static PetscErrorCode  PCJacobiSetType_Jacobi(PC pc,PCJacobiType type)
 {
   PC_Jacobi *j = (PC_Jacobi*)pc->data;
+  PetscBool userowmax = (PetscBool)(type == PC_JACOBI_ROWMAX),userowsum = (PetscBool)(type == PC_JACOBI_ROWSUM);
 
   PetscFunctionBegin;
-  j->userowmax = PETSC_FALSE;
-  j->userowsum = PETSC_FALSE;
-  if (type == PC_JACOBI_ROWMAX) {
-    j->userowmax = PETSC_TRUE;
-  } else if (type == PC_JACOBI_ROWSUM) {
-    j->userowsum = PETSC_TRUE;
-  }
+  if (userowmax != j->userowmax || userowsum != j->userowsum) pc->setupcalled = 0; /* the diagonal must be recomputed */
+  j->userowmax = userowmax;
+  j->userowsum = userowsum;
   PetscFunctionReturn(0);
 }
 
@@ -100,6 +97,7 @@ static PetscErrorCode  PCJacobiSetUseAbs_Jacobi(PC pc,PetscBool flg)
   PC_Jacobi *j = (PC_Jacobi*)pc->data;
 
   PetscFunctionBegin;
+  if (flg != j->useabs) pc->setupcalled = 0;
   j->useabs = flg;
   PetscFunctionReturn(0);
 }
@@ -205,6 +203,8 @@ static PetscErrorCode PCSetUp_Jacobi(PC pc)
   if (zeroflag) {
     ierr = PetscInfo(pc,"Zero detected in diagonal of matrix, using 1 at those locations\n");CHKERRQ(ierr);
   }
+  /* lets users of the diagonal, such as the fused KSPCHEBYSHEV kernel, know it changed */
+  ierr = PetscObjectStateIncrease((PetscObject)pc);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 /* -------------------------------------------------------------------------- */
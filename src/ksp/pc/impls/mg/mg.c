@@ -197,6 +197,8 @@ PetscErrorCode PCReset_MG(PC pc)
     ierr = VecDestroy(&mglevels[n-1]->b);CHKERRQ(ierr);
 
     for (i=0; i<n; i++) {
+      ierr = VecDestroy(&mglevels[i]->wx);CHKERRQ(ierr);
+      ierr = VecDestroy(&mglevels[i]->wr);CHKERRQ(ierr);
       if (mglevels[i]->coarseSpace) for (c = 0; c < mg->Nc; ++c) {ierr = VecDestroy(&mglevels[i]->coarseSpace[c]);CHKERRQ(ierr);}
       ierr = PetscFree(mglevels[i]->coarseSpace);CHKERRQ(ierr);
       mglevels[i]->coarseSpace = NULL;
@@ -632,6 +634,14 @@ PetscErrorCode PCSetFromOptions_MG(PetscOptionItems *PetscOptionsObject,PC pc)
       ierr = PCMGMultiplicativeSetCycles(pc,cycles);CHKERRQ(ierr);
     }
   }
+  if (mg->am == PC_MG_ADDITIVE) {
+    PCMGAdditiveType atype = mg->additivetype;
+
+    ierr = PetscOptionsEnum("-pc_mg_additive_type","Variant of additive multigrid","PCMGSetAdditiveType",PCMGAdditiveTypes,(PetscEnum)atype,(PetscEnum*)&atype,&flg);CHKERRQ(ierr);
+    if (flg) {
+      ierr = PCMGSetAdditiveType(pc,atype);CHKERRQ(ierr);
+    }
+  }
   flg  = PETSC_FALSE;
   ierr = PetscOptionsBool("-pc_mg_log","Log times for each multigrid level","None",flg,&flg,NULL);CHKERRQ(ierr);
   if (flg) {
@@ -681,6 +691,7 @@ PetscErrorCode PCSetFromOptions_MG(PetscOptionItems *PetscOptionsObject,PC pc)
 
 const char *const PCMGTypes[] = {"MULTIPLICATIVE","ADDITIVE","FULL","KASKADE","PCMGType","PC_MG",NULL};
 const char *const PCMGCycleTypes[] = {"invalid","v","w","PCMGCycleType","PC_MG_CYCLE",NULL};
+const char *const PCMGAdditiveTypes[] = {"bpx","afacx","mult","PCMGAdditiveType","PC_MG_ADDITIVE_",NULL};
 const char *const PCMGGalerkinTypes[] = {"both","pmat","mat","none","external","PCMGGalerkinType","PC_MG_GALERKIN",NULL};
 const char *const PCMGCoarseSpaceTypes[] = {"polynomial","harmonic","eigenvector","generalized_eigenvector","PCMGCoarseSpaceType","PCMG_POLYNOMIAL",NULL};
 
@@ -702,6 +713,8 @@ PetscErrorCode PCView_MG(PC pc,PetscViewer viewer)
     ierr = PetscViewerASCIIPrintf(viewer,"  type is %s, levels=%D cycles=%s\n", PCMGTypes[mg->am],levels,cyclename);CHKERRQ(ierr);
     if (mg->am == PC_MG_MULTIPLICATIVE) {
       ierr = PetscViewerASCIIPrintf(viewer,"    Cycles per PCApply=%d\n",mg->cyclesperpcapply);CHKERRQ(ierr);
+    } else if (mg->am == PC_MG_ADDITIVE) {
+      ierr = PetscViewerASCIIPrintf(viewer,"    Additive variant %s\n",PCMGAdditiveTypes[mg->additivetype]);CHKERRQ(ierr);
     }
     if (mg->galerkin == PC_MG_GALERKIN_BOTH) {
       ierr = PetscViewerASCIIPrintf(viewer,"    Using Galerkin computed coarse grid matrices\n");CHKERRQ(ierr);
@@ -1356,6 +1369,65 @@ PetscErrorCode  PCMGMultiplicativeSetCycles(PC pc,PetscInt n)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCMGSetAdditiveType - Sets the variant of additive multigrid used when the PCMGType is PC_MG_ADDITIVE
+
+   Logically Collective on PC
+
+   Input Parameters:
++  pc - the multigrid context
+-  type - one of PC_MG_ADDITIVE_BPX, PC_MG_ADDITIVE_AFACX, PC_MG_ADDITIVE_MULT
+
+   Options Database Key:
+.  -pc_mg_additive_type <bpx,afacx,mult> - the additive variant
+
+   Notes:
+   PC_MG_ADDITIVE_AFACX and PC_MG_ADDITIVE_MULT require two additional work vectors per level.
+
+   PC_MG_ADDITIVE_MULT applies both the down and the up smoother on each level, so with PCMGSetDistinctSmoothUp()
+   the resulting preconditioner is only symmetric if the two smoothers are adjoint to each other.
+
+   Level: advanced
+
+.seealso: PCMGGetAdditiveType(), PCMGSetType(), PCMGAdditiveType
+@*/
+PetscErrorCode  PCMGSetAdditiveType(PC pc,PCMGAdditiveType type)
+{
+  PC_MG *mg = (PC_MG*)pc->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(pc,type,2);
+  mg->additivetype = type;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PCMGGetAdditiveType - Gets the variant of additive multigrid used when the PCMGType is PC_MG_ADDITIVE
+
+   Not Collective
+
+   Input Parameter:
+.  pc - the multigrid context
+
+   Output Parameter:
+.  type - one of PC_MG_ADDITIVE_BPX, PC_MG_ADDITIVE_AFACX, PC_MG_ADDITIVE_MULT
+
+   Level: advanced
+
+.seealso: PCMGSetAdditiveType(), PCMGGetType()
+@*/
+PetscErrorCode  PCMGGetAdditiveType(PC pc,PCMGAdditiveType *type)
+{
+  PC_MG *mg = (PC_MG*)pc->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidPointer(type,2);
+  *type = mg->additivetype;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode PCMGSetGalerkin_MG(PC pc,PCMGGalerkinType use)
 {
   PC_MG *mg = (PC_MG*)pc->data;
@@ -1783,6 +1855,7 @@ PetscErrorCode PCMGGetCoarseSpaceConstructor(const char name[], PetscErrorCode (
 .  -pc_mg_distinct_smoothup - configure up (after interpolation) and down (before restriction) smoothers separately (with different options prefixes)
 .  -pc_mg_galerkin <both,pmat,mat,none> - use Galerkin process to compute coarser operators, i.e. Acoarse = R A R'
 .  -pc_mg_multiplicative_cycles - number of cycles to use as the preconditioner (defaults to 1)
+.  -pc_mg_additive_type <bpx,afacx,mult> - variant of additive multigrid when -pc_mg_type additive is used (defaults to bpx)
 .  -pc_mg_dump_matlab - dumps the matrices for each level and the restriction/interpolation matrices
                         to the Socket viewer for reading from MATLAB.
 -  -pc_mg_dump_binary - dumps the matrices for each level and the restriction/interpolation matrices
@@ -1804,7 +1877,7 @@ PetscErrorCode PCMGGetCoarseSpaceConstructor(const char name[], PetscErrorCode (
            PCMGSetLevels(), PCMGGetLevels(), PCMGSetType(), PCMGSetCycleType(),
            PCMGSetDistinctSmoothUp(), PCMGGetCoarseSolve(), PCMGSetResidual(), PCMGSetInterpolation(),
            PCMGSetRestriction(), PCMGGetSmoother(), PCMGGetSmootherUp(), PCMGGetSmootherDown(),
-           PCMGSetCycleTypeOnLevel(), PCMGSetRhs(), PCMGSetX(), PCMGSetR()
+           PCMGSetCycleTypeOnLevel(), PCMGSetRhs(), PCMGSetX(), PCMGSetR(), PCMGSetAdditiveType()
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_MG(PC pc)
@@ -4,7 +4,101 @@
 */
 #include <petsc/private/pcmgimpl.h>
 
-PetscErrorCode PCMGACycle_Private(PC pc,PC_MG_Levels **mglevels,PetscBool transpose)
+/*
+   Applies the down (or up) smoother of a level with a zero initial guess, honoring the transpose flag the same way
+   PCMGMCycle_Private() does: the transpose of the post smoother is the pre smoother of the transposed cycle.
+*/
+static PetscErrorCode PCMGASmooth_Private(PC pc,PC_MG_Levels *mglevels,PetscBool down,Vec b,Vec x,PetscBool transpose)
+{
+  KSP            ksp;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecSet(x,0.0);CHKERRQ(ierr);
+  if (mglevels->eventsmoothsolve) {ierr = PetscLogEventBegin(mglevels->eventsmoothsolve,0,0,0,0);CHKERRQ(ierr);}
+  if (!transpose) {
+    ksp  = down ? mglevels->smoothd : mglevels->smoothu;
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+  } else {
+    ksp  = down ? mglevels->smoothu : mglevels->smoothd;
+    ierr = KSPSolveTranspose(ksp,b,x);CHKERRQ(ierr);
+  }
+  ierr = KSPCheckSolve(ksp,pc,x);CHKERRQ(ierr);
+  if (mglevels->eventsmoothsolve) {ierr = PetscLogEventEnd(mglevels->eventsmoothsolve,0,0,0,0);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* c = R f where R restricts from the level mglevels to the next coarser one */
+static PetscErrorCode PCMGARestrict_Private(PC_MG_Levels *mglevels,Vec f,Vec c,PetscBool transpose)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mglevels->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+  if (!transpose) {
+    ierr = MatRestrict(mglevels->restrct,f,c);CHKERRQ(ierr);
+  } else {
+    ierr = MatRestrict(mglevels->interpolate,f,c);CHKERRQ(ierr);
+  }
+  if (mglevels->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* f = f + P c where P interpolates from the next coarser level to the level mglevels */
+static PetscErrorCode PCMGAInterpolateAdd_Private(PC_MG_Levels *mglevels,Vec c,Vec f,PetscBool transpose)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mglevels->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+  if (!transpose) {
+    ierr = MatInterpolateAdd(mglevels->interpolate,c,f,f);CHKERRQ(ierr);
+  } else {
+    ierr = MatInterpolateAdd(mglevels->restrct,c,f,f);CHKERRQ(ierr);
+  }
+  if (mglevels->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* r = b - A x on the level mglevels */
+static PetscErrorCode PCMGAResidual_Private(PC_MG_Levels *mglevels,Vec b,Vec x,Vec r,PetscBool transpose)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mglevels->eventresidual) {ierr = PetscLogEventBegin(mglevels->eventresidual,0,0,0,0);CHKERRQ(ierr);}
+  if (!transpose) {
+    ierr = (*mglevels->residual)(mglevels->A,b,x,r);CHKERRQ(ierr);
+  } else {
+    ierr = (*mglevels->residualtranspose)(mglevels->A,b,x,r);CHKERRQ(ierr);
+  }
+  if (mglevels->eventresidual) {ierr = PetscLogEventEnd(mglevels->eventresidual,0,0,0,0);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PCMGACreateWork_Private(PC pc,PC_MG_Levels **mglevels)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,l = mglevels[0]->levels;
+
+  PetscFunctionBegin;
+  for (i=0; i<l; i++) {
+    if (!mglevels[i]->wx) {
+      ierr = VecDuplicate(mglevels[i]->x,&mglevels[i]->wx);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)pc,(PetscObject)mglevels[i]->wx);CHKERRQ(ierr);
+    }
+    if (!mglevels[i]->wr) {
+      ierr = VecDuplicate(mglevels[i]->x,&mglevels[i]->wr);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)pc,(PetscObject)mglevels[i]->wr);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   BPX: x = sum_i P_i S_i R_i b with the restrictions and interpolations composed level by level
+*/
+static PetscErrorCode PCMGACycle_BPX_Private(PC pc,PC_MG_Levels **mglevels,PetscBool transpose)
 {
   PetscErrorCode ierr;
   PetscInt       i,l = mglevels[0]->levels;
@@ -12,35 +106,110 @@ PetscErrorCode PCMGACycle_Private(PC pc,PC_MG_Levels **mglevels,PetscBool transp
   PetscFunctionBegin;
   /* compute RHS on each level */
   for (i=l-1; i>0; i--) {
-    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
-    if (!transpose) {
-      ierr = MatRestrict(mglevels[i]->restrct,mglevels[i]->b,mglevels[i-1]->b);CHKERRQ(ierr);
-    } else {
-      ierr = MatRestrict(mglevels[i]->interpolate,mglevels[i]->b,mglevels[i-1]->b);CHKERRQ(ierr);
-    }
-    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+    ierr = PCMGARestrict_Private(mglevels[i],mglevels[i]->b,mglevels[i-1]->b,transpose);CHKERRQ(ierr);
   }
   /* solve separately on each level */
   for (i=0; i<l; i++) {
-    ierr = VecSet(mglevels[i]->x,0.0);CHKERRQ(ierr);
-    if (mglevels[i]->eventsmoothsolve) {ierr = PetscLogEventBegin(mglevels[i]->eventsmoothsolve,0,0,0,0);CHKERRQ(ierr);}
-    if (!transpose) {
-      ierr = KSPSolve(mglevels[i]->smoothd,mglevels[i]->b,mglevels[i]->x);CHKERRQ(ierr);
-      ierr = KSPCheckSolve(mglevels[i]->smoothd,pc,mglevels[i]->x);CHKERRQ(ierr);
-    } else {
-      ierr = KSPSolveTranspose(mglevels[i]->smoothu,mglevels[i]->b,mglevels[i]->x);CHKERRQ(ierr);
-      ierr = KSPCheckSolve(mglevels[i]->smoothu,pc,mglevels[i]->x);CHKERRQ(ierr);
-    }
-    if (mglevels[i]->eventsmoothsolve) {ierr = PetscLogEventEnd(mglevels[i]->eventsmoothsolve,0,0,0,0);CHKERRQ(ierr);}
+    ierr = PCMGASmooth_Private(pc,mglevels[i],PETSC_TRUE,mglevels[i]->b,mglevels[i]->x,transpose);CHKERRQ(ierr);
   }
   for (i=1; i<l; i++) {
-    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+    ierr = PCMGAInterpolateAdd_Private(mglevels[i],mglevels[i-1]->x,mglevels[i]->x,transpose);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   AFACx: the correction on level i > 0 is computed from the residual that remains after the interpolated
+   smoothed solution of the next coarser level has been removed,
+
+     x_i = S_i (b_i - A_i P_i S_{i-1} b_{i-1}),
+
+   so each level only contributes the error components the coarser level cannot represent.  The corrections
+   only depend on the restricted right hand sides, hence they are independent of each other.
+*/
+static PetscErrorCode PCMGACycle_AFACx_Private(PC pc,PC_MG_Levels **mglevels,PetscBool transpose)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,l = mglevels[0]->levels;
+
+  PetscFunctionBegin;
+  ierr = PCMGACreateWork_Private(pc,mglevels);CHKERRQ(ierr);
+  for (i=l-1; i>0; i--) {
+    ierr = PCMGARestrict_Private(mglevels[i],mglevels[i]->b,mglevels[i-1]->b,transpose);CHKERRQ(ierr);
+  }
+  ierr = PCMGASmooth_Private(pc,mglevels[0],PETSC_TRUE,mglevels[0]->b,mglevels[0]->x,transpose);CHKERRQ(ierr);
+  for (i=1; i<l; i++) {
+    ierr = PCMGASmooth_Private(pc,mglevels[i-1],PETSC_TRUE,mglevels[i-1]->b,mglevels[i-1]->wx,transpose);CHKERRQ(ierr);
+    ierr = VecSet(mglevels[i]->wx,0.0);CHKERRQ(ierr);
+    ierr = PCMGAInterpolateAdd_Private(mglevels[i],mglevels[i-1]->wx,mglevels[i]->wx,transpose);CHKERRQ(ierr);
+    ierr = PCMGAResidual_Private(mglevels[i],mglevels[i]->b,mglevels[i]->wx,mglevels[i]->wr,transpose);CHKERRQ(ierr);
+    ierr = PCMGASmooth_Private(pc,mglevels[i],PETSC_TRUE,mglevels[i]->wr,mglevels[i]->x,transpose);CHKERRQ(ierr);
+  }
+  for (i=1; i<l; i++) {
+    ierr = PCMGAInterpolateAdd_Private(mglevels[i],mglevels[i-1]->x,mglevels[i]->x,transpose);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Mult-additive: the additive counterpart of the V-cycle built from the smoothed restriction
+   Rbar_i = R_i (I - A_i S_i), the smoothed interpolation Pbar_i = (I - S'_i A_i) P_i and the symmetrized
+   smoother Sbar_i = S_i + S'_i (I - A_i S_i) on each level, where S_i is the down and S'_i the up smoother.
+   The pre smoothing done while restricting is reused for the symmetrized smoother.
+*/
+static PetscErrorCode PCMGACycle_Mult_Private(PC pc,PC_MG_Levels **mglevels,PetscBool transpose)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,l = mglevels[0]->levels;
+
+  PetscFunctionBegin;
+  ierr = PCMGACreateWork_Private(pc,mglevels);CHKERRQ(ierr);
+  /* smoothed restriction, keeping wx_i = S_i b_i and wr_i = b_i - A_i S_i b_i */
+  for (i=l-1; i>0; i--) {
+    ierr = PCMGASmooth_Private(pc,mglevels[i],PETSC_TRUE,mglevels[i]->b,mglevels[i]->wx,transpose);CHKERRQ(ierr);
+    ierr = PCMGAResidual_Private(mglevels[i],mglevels[i]->b,mglevels[i]->wx,mglevels[i]->wr,transpose);CHKERRQ(ierr);
+    ierr = PCMGARestrict_Private(mglevels[i],mglevels[i]->wr,mglevels[i-1]->b,transpose);CHKERRQ(ierr);
+  }
+  /* symmetrized smoother on each level, exact coarse solve */
+  ierr = PCMGASmooth_Private(pc,mglevels[0],PETSC_TRUE,mglevels[0]->b,mglevels[0]->x,transpose);CHKERRQ(ierr);
+  for (i=1; i<l; i++) {
+    ierr = PCMGASmooth_Private(pc,mglevels[i],PETSC_FALSE,mglevels[i]->wr,mglevels[i]->x,transpose);CHKERRQ(ierr);
+    ierr = VecAXPY(mglevels[i]->x,1.0,mglevels[i]->wx);CHKERRQ(ierr);
+  }
+  /* smoothed interpolation x_i += (I - S'_i A_i) P_i x_{i-1} */
+  for (i=1; i<l; i++) {
+    ierr = VecSet(mglevels[i]->wx,0.0);CHKERRQ(ierr);
+    ierr = PCMGAInterpolateAdd_Private(mglevels[i],mglevels[i-1]->x,mglevels[i]->wx,transpose);CHKERRQ(ierr);
+    if (mglevels[i]->eventresidual) {ierr = PetscLogEventBegin(mglevels[i]->eventresidual,0,0,0,0);CHKERRQ(ierr);}
     if (!transpose) {
-      ierr = MatInterpolateAdd(mglevels[i]->interpolate,mglevels[i-1]->x,mglevels[i]->x,mglevels[i]->x);CHKERRQ(ierr);
+      ierr = MatMult(mglevels[i]->A,mglevels[i]->wx,mglevels[i]->wr);CHKERRQ(ierr);
     } else {
-      ierr = MatInterpolateAdd(mglevels[i]->restrct,mglevels[i-1]->x,mglevels[i]->x,mglevels[i]->x);CHKERRQ(ierr);
+      ierr = MatMultTranspose(mglevels[i]->A,mglevels[i]->wx,mglevels[i]->wr);CHKERRQ(ierr);
     }
-    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+    if (mglevels[i]->eventresidual) {ierr = PetscLogEventEnd(mglevels[i]->eventresidual,0,0,0,0);CHKERRQ(ierr);}
+    ierr = PCMGASmooth_Private(pc,mglevels[i],PETSC_FALSE,mglevels[i]->wr,mglevels[i]->r,transpose);CHKERRQ(ierr);
+    ierr = VecAXPBYPCZ(mglevels[i]->x,1.0,-1.0,1.0,mglevels[i]->wx,mglevels[i]->r);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PCMGACycle_Private(PC pc,PC_MG_Levels **mglevels,PetscBool transpose)
+{
+  PC_MG          *mg = (PC_MG*)pc->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  switch (mg->additivetype) {
+  case PC_MG_ADDITIVE_BPX:
+    ierr = PCMGACycle_BPX_Private(pc,mglevels,transpose);CHKERRQ(ierr);
+    break;
+  case PC_MG_ADDITIVE_AFACX:
+    ierr = PCMGACycle_AFACx_Private(pc,mglevels,transpose);CHKERRQ(ierr);
+    break;
+  case PC_MG_ADDITIVE_MULT:
+    ierr = PCMGACycle_Mult_Private(pc,mglevels,transpose);CHKERRQ(ierr);
+    break;
+  default: SETERRQ1(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_OUTOFRANGE,"Unknown additive multigrid type %d",(int)mg->additivetype);
   }
   PetscFunctionReturn(0);
 }
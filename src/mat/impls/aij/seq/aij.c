@@ -1306,6 +1306,7 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
 
   ierr = PetscObjectChangeTypeName((PetscObject)A,NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetColumnIndices_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatChebyshevJacobiStep_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatStoreValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatRetrieveValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqsbaij_C",NULL);CHKERRQ(ierr);
@@ -1560,6 +1561,63 @@ PetscErrorCode MatMult_SeqAIJ(Mat A,Vec xx,Vec yy)
   PetscFunctionReturn(0);
 }
 
+/*
+   Computes in a single sweep over the rows
+
+     y = alpha xkm1 + beta xk + gamma D^{-1} (b - [A B] [xk; lx])
+
+   where D^{-1} is given by the vector dd. B and lx are the (optional) off-process part of an MPIAIJ matrix and the
+   ghost values of xk. This is the update of a Chebyshev iteration with point Jacobi preconditioning.
+*/
+PetscErrorCode MatChebyshevJacobiStep_SeqAIJ_Private(Mat A,Mat B,const PetscScalar lx[],Vec bb,Vec dd,PetscScalar alpha,PetscScalar beta,PetscScalar gamma,Vec xxkm1,Vec xxk,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data,*b = B ? (Mat_SeqAIJ*)B->data : NULL;
+  PetscScalar       *y,sum;
+  const PetscScalar *x,*xkm1,*rhs,*d;
+  const MatScalar   *aa;
+  const PetscInt    *aj;
+  PetscInt          i,n,m = A->rmap->n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (xxk == yy || xxkm1 == yy) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_IDN,"Output vector cannot be one of the iterates");
+  ierr = VecGetArrayRead(bb,&rhs);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(dd,&d);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xxkm1,&xkm1);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xxk,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    sum = rhs[i];
+    n   = a->i[i+1] - a->i[i];
+    aj  = a->j + a->i[i];
+    aa  = a->a + a->i[i];
+    PetscSparseDenseMinusDot(sum,x,aa,aj,n);
+    if (b) {
+      n  = b->i[i+1] - b->i[i];
+      aj = b->j + b->i[i];
+      aa = b->a + b->i[i];
+      PetscSparseDenseMinusDot(sum,lx,aa,aj,n);
+    }
+    y[i] = alpha*xkm1[i] + beta*x[i] + gamma*d[i]*sum;
+  }
+  ierr = PetscLogFlops(2.0*(a->nz + (b ? b->nz : 0)) + 6.0*m);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&rhs);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(dd,&d);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xxkm1,&xkm1);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xxk,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatChebyshevJacobiStep_SeqAIJ(Mat A,Vec bb,Vec dd,PetscScalar alpha,PetscScalar beta,PetscScalar gamma,Vec xxkm1,Vec xxk,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatChebyshevJacobiStep_SeqAIJ_Private(A,NULL,NULL,bb,dd,alpha,beta,gamma,xxkm1,xxk,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatMultMax_SeqAIJ(Mat A,Vec xx,Vec yy)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
@@ -4626,6 +4684,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
 #endif
 
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetColumnIndices_C",MatSeqAIJSetColumnIndices_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatChebyshevJacobiStep_C",MatChebyshevJacobiStep_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatStoreValues_C",MatStoreValues_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqsbaij_C",MatConvert_SeqAIJ_SeqSBAIJ);CHKERRQ(ierr);
@@ -103,6 +103,7 @@ PETSC_INTERN PetscErrorCode MatView_SeqAIJ_Inode(Mat,PetscViewer);
 PETSC_INTERN PetscErrorCode MatAssemblyEnd_SeqAIJ_Inode(Mat,MatAssemblyType);
 PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_Inode(Mat);
 PETSC_INTERN PetscErrorCode MatCreate_SeqAIJ_Inode(Mat);
+PETSC_INTERN PetscErrorCode MatChebyshevJacobiStep_SeqAIJ_Private(Mat,Mat,const PetscScalar[],Vec,Vec,PetscScalar,PetscScalar,PetscScalar,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSetOption_SeqAIJ_Inode(Mat,MatOption,PetscBool);
 PETSC_INTERN PetscErrorCode MatDuplicate_SeqAIJ_Inode(Mat,MatDuplicateOption,Mat*);
 PETSC_INTERN PetscErrorCode MatDuplicateNoCreate_SeqAIJ(Mat,Mat,MatDuplicateOption,PetscBool);
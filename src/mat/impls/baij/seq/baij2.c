@@ -1263,6 +1263,51 @@ PetscErrorCode MatMult_SeqBAIJ_N(Mat A,Vec xx,Vec zz)
   PetscFunctionReturn(0);
 }
 
+/*
+   y = alpha xkm1 + beta xk + gamma D^{-1} (b - A xk) computed block row by block row, see MatChebyshevJacobiStep_SeqAIJ_Private()
+*/
+PetscErrorCode MatChebyshevJacobiStep_SeqBAIJ(Mat A,Vec bb,Vec dd,PetscScalar alpha,PetscScalar beta,PetscScalar gamma,Vec xxkm1,Vec xxk,Vec yy)
+{
+  Mat_SeqBAIJ       *a = (Mat_SeqBAIJ*)A->data;
+  PetscScalar       *y,*sum;
+  const PetscScalar *x,*xkm1,*rhs,*d,*xb;
+  const MatScalar   *v;
+  PetscInt          i,j,k,l,row,bs = A->rmap->bs,bs2 = a->bs2;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (xxk == yy || xxkm1 == yy) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_IDN,"Output vector cannot be one of the iterates");
+  ierr = PetscMalloc1(bs,&sum);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&rhs);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(dd,&d);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xxkm1,&xkm1);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xxk,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  for (i=0; i<a->mbs; i++) {
+    for (k=0; k<bs; k++) sum[k] = rhs[i*bs+k];
+    for (j=a->i[i]; j<a->i[i+1]; j++) {
+      v  = a->a + j*bs2;
+      xb = x + bs*a->j[j];
+      /* blocks are stored column oriented */
+      for (l=0; l<bs; l++) {
+        for (k=0; k<bs; k++) sum[k] -= v[l*bs+k]*xb[l];
+      }
+    }
+    for (k=0; k<bs; k++) {
+      row    = i*bs+k;
+      y[row] = alpha*xkm1[row] + beta*x[row] + gamma*d[row]*sum[k];
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz*bs2 + 6.0*A->rmap->n);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&rhs);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(dd,&d);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xxkm1,&xkm1);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xxk,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  ierr = PetscFree(sum);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatMultAdd_SeqBAIJ_1(Mat A,Vec xx,Vec yy,Vec zz)
 {
   Mat_SeqBAIJ       *a = (Mat_SeqBAIJ*)A->data;
@@ -0,0 +1,301 @@
+static char help[] = "Tests the matrix-free sum-factorized DMPlex operator and p-multigrid.\n\
+We solve -div(k(u) grad u) + u = f on a hexahedral mesh with a high order\n\
+Lagrange element, where k = 1 or k = 1 + u^2, checking the matrix-free Jacobian\n\
+against the assembled one.\n\n\n";
+
+#include <petscdmplex.h>
+#include <petscsnes.h>
+#include <petscds.h>
+
+typedef struct {
+  PetscInt  dim;       /* The topological mesh dimension */
+  PetscBool nonlinear; /* Use the nonlinear coefficient k = 1 + u^2 */
+  PetscBool check;     /* Compare the matrix-free operator with the assembled one */
+  PetscBool pmg;       /* Create a hierarchy of lower degree spaces for PCMG */
+} AppCtx;
+
+static PetscErrorCode quadratic_u(PetscInt dim, PetscReal time, const PetscReal x[], PetscInt Nc, PetscScalar *u, void *ctx)
+{
+  PetscInt d;
+  *u = 0.0;
+  for (d = 0; d < dim; ++d) *u += x[d]*x[d];
+  return 0;
+}
+
+static void f0_u(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                 const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                 const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                 PetscReal t, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar f0[])
+{
+  PetscScalar r2 = 0.0;
+  PetscInt    d;
+
+  for (d = 0; d < dim; ++d) r2 += x[d]*x[d];
+  /* -div(grad u) + u for u = |x|^2 */
+  f0[0] = u[0] - (r2 - 2.0*dim);
+}
+
+static void f0_nonlinear_u(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                           const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                           const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                           PetscReal t, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar f0[])
+{
+  PetscScalar r2 = 0.0;
+  PetscInt    d;
+
+  for (d = 0; d < dim; ++d) r2 += x[d]*x[d];
+  /* -div((1 + u^2) grad u) + u for u = |x|^2 */
+  f0[0] = u[0] - (r2 - 2.0*dim*(1.0 + r2*r2) - 8.0*r2*r2);
+}
+
+static void f1_u(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                 const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                 const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                 PetscReal t, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar f1[])
+{
+  PetscInt d;
+  for (d = 0; d < dim; ++d) f1[d] = u_x[d];
+}
+
+static void f1_nonlinear_u(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                           const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                           const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                           PetscReal t, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar f1[])
+{
+  PetscInt d;
+  for (d = 0; d < dim; ++d) f1[d] = (1.0 + u[0]*u[0])*u_x[d];
+}
+
+static void g0_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                  const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                  const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                  PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g0[])
+{
+  g0[0] = 1.0;
+}
+
+static void g2_nonlinear_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                            const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                            const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                            PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g2[])
+{
+  PetscInt d;
+  for (d = 0; d < dim; ++d) g2[d] = 2.0*u[0]*u_x[d];
+}
+
+static void g3_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                  const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                  const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                  PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g3[])
+{
+  PetscInt d;
+  for (d = 0; d < dim; ++d) g3[d*dim+d] = 1.0;
+}
+
+static void g3_nonlinear_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                            const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                            const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                            PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g3[])
+{
+  PetscInt d;
+  for (d = 0; d < dim; ++d) g3[d*dim+d] = 1.0 + u[0]*u[0];
+}
+
+static PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  options->dim       = 2;
+  options->nonlinear = PETSC_FALSE;
+  options->check     = PETSC_FALSE;
+  options->pmg       = PETSC_FALSE;
+
+  ierr = PetscOptionsBegin(comm, "", "Matrix-free Problem Options", "DMPLEX");CHKERRQ(ierr);
+  ierr = PetscOptionsRangeInt("-dim", "The topological mesh dimension", "ex9.c", options->dim, &options->dim, NULL, 1, 3);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-nonlinear", "Use the nonlinear coefficient", "ex9.c", options->nonlinear, &options->nonlinear, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-check", "Compare the matrix-free operator with the assembled one", "ex9.c", options->check, &options->check, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-pmg", "Create a p-multigrid hierarchy", "ex9.c", options->pmg, &options->pmg, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CreateMesh(MPI_Comm comm, AppCtx *user, DM *dm)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = DMPlexCreateBoxMesh(comm, user->dim, PETSC_FALSE, NULL, NULL, NULL, NULL, PETSC_TRUE, dm);CHKERRQ(ierr);
+  {
+    DM pdm = NULL;
+
+    ierr = DMPlexDistribute(*dm, 0, NULL, &pdm);CHKERRQ(ierr);
+    if (pdm) {
+      ierr = DMDestroy(dm);CHKERRQ(ierr);
+      *dm  = pdm;
+    }
+  }
+  ierr = PetscObjectSetName((PetscObject) *dm, "Mesh");CHKERRQ(ierr);
+  ierr = DMSetFromOptions(*dm);CHKERRQ(ierr);
+  ierr = DMViewFromOptions(*dm, NULL, "-dm_view");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode SetupDiscretization(DM dm, AppCtx *user)
+{
+  PetscFE        fe;
+  PetscDS        ds;
+  const PetscInt id = 1;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = PetscFECreateDefault(PetscObjectComm((PetscObject) dm), user->dim, 1, PETSC_FALSE, NULL, -1, &fe);CHKERRQ(ierr);
+  ierr = PetscObjectSetName((PetscObject) fe, "u");CHKERRQ(ierr);
+  ierr = DMSetField(dm, 0, NULL, (PetscObject) fe);CHKERRQ(ierr);
+  ierr = DMCreateDS(dm);CHKERRQ(ierr);
+  ierr = DMGetDS(dm, &ds);CHKERRQ(ierr);
+  if (user->nonlinear) {
+    ierr = PetscDSSetResidual(ds, 0, f0_nonlinear_u, f1_nonlinear_u);CHKERRQ(ierr);
+    ierr = PetscDSSetJacobian(ds, 0, 0, g0_uu, NULL, g2_nonlinear_uu, g3_nonlinear_uu);CHKERRQ(ierr);
+  } else {
+    ierr = PetscDSSetResidual(ds, 0, f0_u, f1_u);CHKERRQ(ierr);
+    ierr = PetscDSSetJacobian(ds, 0, 0, g0_uu, NULL, NULL, g3_uu);CHKERRQ(ierr);
+  }
+  ierr = PetscDSSetExactSolution(ds, 0, quadratic_u, user);CHKERRQ(ierr);
+  ierr = DMAddBoundary(dm, DM_BC_ESSENTIAL, "wall", "marker", 0, 0, NULL, (void (*)(void)) quadratic_u, NULL, 1, &id, user);CHKERRQ(ierr);
+  if (user->pmg) {
+    PetscSpace sp;
+    DM         cdm = dm, ccdm;
+    PetscInt   degree;
+
+    ierr = PetscFEGetBasisSpace(fe, &sp);CHKERRQ(ierr);
+    ierr = PetscSpaceGetDegree(sp, &degree, NULL);CHKERRQ(ierr);
+    while (degree > 1) {
+      degree = PetscMax(1, degree/2);
+      ierr = DMPlexCreatePCoarseDM(cdm, degree, &ccdm);CHKERRQ(ierr);
+      ierr = DMDestroy(&ccdm);CHKERRQ(ierr);
+      ierr = DMGetCoarseDM(cdm, &cdm);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscFEDestroy(&fe);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckMatrixFree(DM dm, AppCtx *user)
+{
+  Mat            A, Amf;
+  Vec            X, locX, x, y, ymf;
+  PetscRandom    r;
+  PetscReal      nrm, err;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = PetscRandomCreate(PetscObjectComm((PetscObject) dm), &r);CHKERRQ(ierr);
+  ierr = PetscRandomSetInterval(r, -1.0, 1.0);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(dm, &X);CHKERRQ(ierr);
+  ierr = VecDuplicate(X, &x);CHKERRQ(ierr);
+  ierr = VecDuplicate(X, &y);CHKERRQ(ierr);
+  ierr = VecDuplicate(X, &ymf);CHKERRQ(ierr);
+  ierr = VecSetRandom(X, r);CHKERRQ(ierr);
+  ierr = VecSetRandom(x, r);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(dm, &locX);CHKERRQ(ierr);
+  ierr = DMPlexInsertBoundaryValues(dm, PETSC_TRUE, locX, 0.0, NULL, NULL, NULL);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(dm, X, INSERT_VALUES, locX);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(dm, X, INSERT_VALUES, locX);CHKERRQ(ierr);
+  /* Assembled Jacobian */
+  ierr = DMSetMatType(dm, MATAIJ);CHKERRQ(ierr);
+  ierr = DMCreateMatrix(dm, &A);CHKERRQ(ierr);
+  ierr = DMPlexSNESComputeJacobianFEM(dm, locX, A, A, user);CHKERRQ(ierr);
+  /* Matrix-free Jacobian */
+  ierr = DMPlexCreateMatrixFree(dm, &Amf);CHKERRQ(ierr);
+  ierr = DMPlexSNESComputeJacobianFEM(dm, locX, Amf, Amf, user);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm, &locX);CHKERRQ(ierr);
+  ierr = MatMult(A, x, y);CHKERRQ(ierr);
+  ierr = MatMult(Amf, x, ymf);CHKERRQ(ierr);
+  ierr = VecNorm(y, NORM_2, &nrm);CHKERRQ(ierr);
+  ierr = VecAXPY(ymf, -1.0, y);CHKERRQ(ierr);
+  ierr = VecNorm(ymf, NORM_2, &err);CHKERRQ(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject) dm), "Matrix-free action: %s\n", err < PETSC_SMALL*nrm ? "matches" : "differs");CHKERRQ(ierr);
+  ierr = MatMultTranspose(A, x, y);CHKERRQ(ierr);
+  ierr = MatMultTranspose(Amf, x, ymf);CHKERRQ(ierr);
+  ierr = VecNorm(y, NORM_2, &nrm);CHKERRQ(ierr);
+  ierr = VecAXPY(ymf, -1.0, y);CHKERRQ(ierr);
+  ierr = VecNorm(ymf, NORM_2, &err);CHKERRQ(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject) dm), "Matrix-free transpose action: %s\n", err < PETSC_SMALL*nrm ? "matches" : "differs");CHKERRQ(ierr);
+  ierr = MatGetDiagonal(A, y);CHKERRQ(ierr);
+  ierr = MatGetDiagonal(Amf, ymf);CHKERRQ(ierr);
+  ierr = VecNorm(y, NORM_2, &nrm);CHKERRQ(ierr);
+  ierr = VecAXPY(ymf, -1.0, y);CHKERRQ(ierr);
+  ierr = VecNorm(ymf, NORM_2, &err);CHKERRQ(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject) dm), "Matrix-free diagonal: %s\n", err < PETSC_SMALL*nrm ? "matches" : "differs");CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&Amf);CHKERRQ(ierr);
+  ierr = VecDestroy(&X);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&ymf);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&r);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc, char **argv)
+{
+  DM             dm;
+  SNES           snes;
+  Vec            u;
+  AppCtx         user;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc, &argv, NULL, help);if (ierr) return ierr;
+  ierr = ProcessOptions(PETSC_COMM_WORLD, &user);CHKERRQ(ierr);
+  ierr = SNESCreate(PETSC_COMM_WORLD, &snes);CHKERRQ(ierr);
+  ierr = CreateMesh(PETSC_COMM_WORLD, &user, &dm);CHKERRQ(ierr);
+  ierr = SNESSetDM(snes, dm);CHKERRQ(ierr);
+  ierr = SetupDiscretization(dm, &user);CHKERRQ(ierr);
+  ierr = DMPlexSetSNESLocalFEM(dm, &user, &user, &user);CHKERRQ(ierr);
+  if (user.check) {ierr = CheckMatrixFree(dm, &user);CHKERRQ(ierr);}
+  else {
+    PetscErrorCode (*exact)(PetscInt, PetscReal, const PetscReal[], PetscInt, PetscScalar *, void *) = quadratic_u;
+    PetscReal      error;
+
+    ierr = DMCreateGlobalVector(dm, &u);CHKERRQ(ierr);
+    ierr = PetscObjectSetName((PetscObject) u, "u");CHKERRQ(ierr);
+    ierr = VecSet(u, 0.0);CHKERRQ(ierr);
+    ierr = SNESSetFromOptions(snes);CHKERRQ(ierr);
+    ierr = SNESSolve(snes, NULL, u);CHKERRQ(ierr);
+    ierr = DMComputeL2Diff(dm, 0.0, &exact, NULL, u, &error);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "L_2 Error: %s\n", error < 1.0e-10 ? "< 1.0e-10" : "too large");CHKERRQ(ierr);
+    ierr = VecDestroy(&u);CHKERRQ(ierr);
+  }
+  ierr = SNESDestroy(&snes);CHKERRQ(ierr);
+  ierr = DMDestroy(&dm);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+  test:
+    suffix: check_2d
+    args: -nonlinear -check -petscspace_degree {{1 2 4}separate output} -dm_plex_box_faces 3,3
+  test:
+    suffix: check_3d
+    nsize: 2
+    args: -dim 3 -nonlinear -check -petscspace_degree 3 -dm_plex_box_faces 2,2,2
+  test:
+    suffix: pmg_2d
+    requires: !single
+    args: -pmg -petscspace_degree 4 -dm_plex_box_faces 4,4 -dm_mat_type shell \
+          -snes_converged_reason -ksp_type cg -ksp_rtol 1.0e-12 -ksp_converged_reason \
+          -pc_type mg -pc_mg_levels 3 -mg_levels_ksp_type chebyshev -mg_levels_pc_type jacobi \
+          -mg_coarse_ksp_type cg -mg_coarse_ksp_rtol 1.0e-12 -mg_coarse_pc_type jacobi
+  test:
+    suffix: pmg_3d
+    requires: !single
+    nsize: 2
+    args: -dim 3 -pmg -petscspace_degree 2 -dm_plex_box_faces 2,2,2 -dm_mat_type shell \
+          -snes_converged_reason -ksp_type cg -ksp_rtol 1.0e-12 -ksp_converged_reason \
+          -pc_type mg -pc_mg_levels 2 -mg_levels_ksp_type chebyshev -mg_levels_pc_type jacobi \
+          -mg_coarse_ksp_type cg -mg_coarse_ksp_rtol 1.0e-12 -mg_coarse_pc_type jacobi
+
+TEST*/
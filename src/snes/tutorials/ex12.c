@@ -1696,6 +1696,36 @@ int main(int argc, char **argv)
     TODO: broken
     args: -run_type full -dm_refine 5 -interpolate 1 -petscspace_degree 1 -dm_coarsen_hierarchy 5 -dm_plex_hash_location -dm_plex_separate_marker -dm_plex_remesh_bd -ksp_type richardson -ksp_rtol 1.0e-12 -pc_type mg -pc_mg_levels 3 -mg_levels_ksp_max_it 2 -snes_converged_reason ::ascii_info_detail -snes_monitor -ksp_monitor_true_residual -mg_levels_ksp_monitor_true_residual -dm_view -ksp_view
 
+  # Batched residual integration
+  test:
+    suffix: 2d_q2_batch
+    args: -run_type full -simplex 0 -cells 3,3 -petscspace_degree 2 -variable_coefficient field -petscfe_type batch -snes_converged_reason -snes_monitor_short -pc_type jacobi -ksp_rtol 1e-12
+
+  test:
+    suffix: 3d_q2_batch
+    args: -run_type full -dim 3 -simplex 0 -cells 2,2,3 -petscspace_degree 2 -variable_coefficient field -petscfe_type batch -snes_converged_reason -snes_monitor_short -pc_type jacobi -ksp_rtol 1e-12
+
+  # Cached element matrices
+  test:
+    suffix: 2d_q2_elemmat
+    args: -run_type full -simplex 0 -cells 3,3 -petscspace_degree 2 -dm_plex_cache_element_matrices -snes_converged_reason -snes_monitor_short -pc_type jacobi -ksp_rtol 1e-12
+
+  # Assembly through the closure dof cache
+  test:
+    suffix: 2d_q2_cldofcache
+    nsize: 2
+    args: -run_type full -simplex 0 -cells 3,3 -petscspace_degree 2 -bc_type dirichlet -dm_plex_closure_dof_cache -petscpartitioner_type simple -snes_converged_reason -snes_monitor_short -pc_type jacobi -ksp_rtol 1e-12
+  test:
+    suffix: 2d_q2_cldofcache_omp
+    requires: openmp
+    nsize: 2
+    args: -run_type full -simplex 0 -cells 3,3 -petscspace_degree 2 -bc_type dirichlet -dm_plex_closure_dof_cache -petscpartitioner_type simple -snes_converged_reason -snes_monitor_short -pc_type jacobi -ksp_rtol 1e-12 -omp_num_threads 3
+    output_file: output/ex12_2d_q2_cldofcache.out
+  test:
+    suffix: 3d_q2_cldofcache
+    nsize: 2
+    args: -run_type full -dim 3 -simplex 0 -cells 4,4,4 -petscspace_degree 2 -bc_type dirichlet -dm_plex_closure_dof_cache -petscpartitioner_type simple -snes_converged_reason -snes_monitor_short -pc_type jacobi -ksp_rtol 1e-12
+
   # Full solve tensor
   test:
     suffix: tensor_plex_2d
@@ -884,6 +884,11 @@ PetscErrorCode NonlinearGS(SNES snes,Vec X, Vec B, void *ctx)
      suffix: 5_ls
      args: -da_grid_x 81 -da_grid_y 81 -snes_monitor_short -snes_max_it 50 -par 6.0 -snes_type newtonls
 
+   test:
+     suffix: 5_ls_overlap
+     nsize: 4
+     args: -da_grid_x 81 -da_grid_y 81 -snes_monitor_short -snes_max_it 50 -par 6.0 -snes_type newtonls -dmda_snes_function_overlap
+
    test:
      suffix: 5_ls_sell_sor
      args: -da_grid_x 81 -da_grid_y 81 -snes_monitor_short -snes_max_it 50 -par 6.0 -snes_type newtonls -dm_mat_type sell -pc_type sor
@@ -11,6 +11,7 @@ typedef struct {
   void       *jacobianlocalctx;
   void       *objectivelocalctx;
   InsertMode residuallocalimode;
+  PetscBool  residuallocaloverlap;   /* evaluate the interior while the ghost points are updated */
 
   /*   For Picard iteration defined locally */
   PetscErrorCode (*rhsplocal)(DMDALocalInfo*,void*,void*,void*);
@@ -55,6 +56,100 @@ static PetscErrorCode DMDASNESGetContext(DM dm,DMSNES sdm,DMSNES_DA  **dmdasnes)
   PetscFunctionReturn(0);
 }
 
+/*
+  Evaluates the residual on the interior of the owned box, whose stencils do not reach the ghost points, while these are
+  updated, then on the strips along the sides of the owned box, one call of the local function for each
+*/
+static PetscErrorCode SNESComputeFunction_DMDA_Overlap(SNES snes,DM dm,DMSNES_DA *dmdasnes,Vec X,Vec F)
+{
+  PetscErrorCode    ierr;
+  DMDALocalInfo     info,sub;
+  Vec               Xloc;
+  void              *x,*f;
+  const PetscScalar *xg;
+  PetscScalar       *xl;
+  PetscInt          d,e,j,k,lo[3],hi[3],ilo[3],ihi[3],glo[3],gm[3];
+  PetscBool         interior = PETSC_TRUE;
+
+  PetscFunctionBegin;
+  ierr = DMDAGetLocalInfo(dm,&info);CHKERRQ(ierr);
+  lo[0]  = info.xs;  lo[1]  = info.ys;  lo[2]  = info.zs;
+  hi[0]  = info.xs+info.xm; hi[1] = info.ys+info.ym; hi[2] = info.zs+info.zm;
+  glo[0] = info.gxs; glo[1] = info.gys; glo[2] = info.gzs;
+  gm[0]  = info.gxm; gm[1]  = info.gym; gm[2]  = info.gzm;
+  for (d=0; d<3; d++) {
+    /* the points whose stencil does not reach the ghost points, on the sides that have some */
+    ilo[d] = lo[d] > glo[d] ? lo[d]+info.sw : lo[d];
+    ihi[d] = hi[d] < glo[d]+gm[d] ? hi[d]-info.sw : hi[d];
+    if (ihi[d] <= ilo[d]) interior = PETSC_FALSE;
+  }
+
+  /* The arrays are obtained before the update, which locks the local vector until it completes. The owned values
+     are copied first, since the update may only copy them at its end, depending on its implementation */
+  ierr = DMGetLocalVector(dm,&Xloc);CHKERRQ(ierr);
+  if (interior) {
+    ierr = VecGetArrayRead(X,&xg);CHKERRQ(ierr);
+    ierr = VecGetArray(Xloc,&xl);CHKERRQ(ierr);
+    for (k=0; k<info.zm; k++) {
+      for (j=0; j<info.ym; j++) {
+        ierr = PetscArraycpy(xl+(((info.zs-info.gzs+k)*info.gym+info.ys-info.gys+j)*info.gxm+info.xs-info.gxs)*info.dof,xg+(k*info.ym+j)*info.xm*info.dof,info.xm*info.dof);CHKERRQ(ierr);
+      }
+    }
+    ierr = VecRestoreArray(Xloc,&xl);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(X,&xg);CHKERRQ(ierr);
+  }
+  ierr = DMDAVecGetArray(dm,Xloc,&x);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(dm,F,&f);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(dm,X,INSERT_VALUES,Xloc);CHKERRQ(ierr);
+  if (interior) {
+    sub    = info;
+    sub.xs = ilo[0]; sub.xm = ihi[0]-ilo[0];
+    sub.ys = ilo[1]; sub.ym = ihi[1]-ilo[1];
+    sub.zs = ilo[2]; sub.zm = ihi[2]-ilo[2];
+    ierr = PetscLogEventBegin(SNES_FunctionEval,snes,X,F,0);CHKERRQ(ierr);
+    CHKMEMQ;
+    ierr = (*dmdasnes->residuallocal)(&sub,x,f,dmdasnes->residuallocalctx);CHKERRQ(ierr);
+    CHKMEMQ;
+    ierr = PetscLogEventEnd(SNES_FunctionEval,snes,X,F,0);CHKERRQ(ierr);
+  }
+  ierr = DMGlobalToLocalEnd(dm,X,INSERT_VALUES,Xloc);CHKERRQ(ierr);
+
+  /* The rest of the owned box: along dimension d, the two strips outside the interior range, restricted to the
+     interior range along the dimensions after d */
+  ierr = PetscLogEventBegin(SNES_FunctionEval,snes,X,F,0);CHKERRQ(ierr);
+  if (!interior) {
+    CHKMEMQ;
+    ierr = (*dmdasnes->residuallocal)(&info,x,f,dmdasnes->residuallocalctx);CHKERRQ(ierr);
+    CHKMEMQ;
+  } else {
+    for (d=2; d>=0; d--) {
+      for (e=0; e<2; e++) {
+        PetscInt s[3],m[3],c;
+
+        for (c=0; c<3; c++) {
+          if (c < d)       {s[c] = lo[c];  m[c] = hi[c]-lo[c];}
+          else if (c > d)  {s[c] = ilo[c]; m[c] = ihi[c]-ilo[c];}
+          else if (!e)     {s[c] = lo[c];  m[c] = ilo[c]-lo[c];}
+          else             {s[c] = ihi[c]; m[c] = hi[c]-ihi[c];}
+        }
+        if (!m[d]) continue;
+        sub    = info;
+        sub.xs = s[0]; sub.xm = m[0];
+        sub.ys = s[1]; sub.ym = m[1];
+        sub.zs = s[2]; sub.zm = m[2];
+        CHKMEMQ;
+        ierr = (*dmdasnes->residuallocal)(&sub,x,f,dmdasnes->residuallocalctx);CHKERRQ(ierr);
+        CHKMEMQ;
+      }
+    }
+  }
+  ierr = PetscLogEventEnd(SNES_FunctionEval,snes,X,F,0);CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(dm,F,&f);CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(dm,Xloc,&x);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm,&Xloc);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode SNESComputeFunction_DMDA(SNES snes,Vec X,Vec F,void *ctx)
 {
   PetscErrorCode ierr;
@@ -70,6 +165,13 @@ static PetscErrorCode SNESComputeFunction_DMDA(SNES snes,Vec X,Vec F,void *ctx)
   PetscValidHeaderSpecific(F,VEC_CLASSID,3);
   if (!dmdasnes->residuallocal) SETERRQ(PetscObjectComm((PetscObject)snes),PETSC_ERR_PLIB,"Corrupt context");
   ierr = SNESGetDM(snes,&dm);CHKERRQ(ierr);
+  if (dmdasnes->residuallocaloverlap && dmdasnes->residuallocalimode == INSERT_VALUES) {
+    ierr = SNESComputeFunction_DMDA_Overlap(snes,dm,dmdasnes,X,F);CHKERRQ(ierr);
+    if (snes->domainerror) {
+      ierr = VecSetInf(F);CHKERRQ(ierr);
+    }
+    PetscFunctionReturn(0);
+  }
   ierr = DMGetLocalVector(dm,&Xloc);CHKERRQ(ierr);
   ierr = DMGlobalToLocalBegin(dm,X,INSERT_VALUES,Xloc);CHKERRQ(ierr);
   ierr = DMGlobalToLocalEnd(dm,X,INSERT_VALUES,Xloc);CHKERRQ(ierr);
@@ -222,9 +324,12 @@ PETSC_EXTERN PetscErrorCode SNESComputeJacobian_DMDA(SNES snes,Vec X,Mat A,Mat B
 .  f - dimensional pointer to residual, write the residual here (e.g. PetscScalar *f or **f or ***f)
 -  ctx - optional context passed above
 
+   Options Database Key:
+.  -dmda_snes_function_overlap - evaluate the interior of the subdomain while the ghost points are updated, see DMDASNESSetFunctionLocalOverlap()
+
    Level: beginner
 
-.seealso: DMDASNESSetJacobianLocal(), DMSNESSetFunction(), DMDACreate1d(), DMDACreate2d(), DMDACreate3d()
+.seealso: DMDASNESSetJacobianLocal(), DMSNESSetFunction(), DMDACreate1d(), DMDACreate2d(), DMDACreate3d(), DMDASNESSetFunctionLocalOverlap()
 @*/
 PetscErrorCode DMDASNESSetFunctionLocal(DM dm,InsertMode imode,PetscErrorCode (*func)(DMDALocalInfo*,void*,void*,void*),void *ctx)
 {
@@ -240,6 +345,7 @@ PetscErrorCode DMDASNESSetFunctionLocal(DM dm,InsertMode imode,PetscErrorCode (*
   dmdasnes->residuallocalimode = imode;
   dmdasnes->residuallocal      = func;
   dmdasnes->residuallocalctx   = ctx;
+  ierr = PetscOptionsGetBool(((PetscObject)dm)->options,((PetscObject)dm)->prefix,"-dmda_snes_function_overlap",&dmdasnes->residuallocaloverlap,NULL);CHKERRQ(ierr);
 
   ierr = DMSNESSetFunction(dm,SNESComputeFunction_DMDA,dmdasnes);CHKERRQ(ierr);
   if (!sdm->ops->computejacobian) {  /* Call us for the Jacobian too, can be overridden by the user. */
@@ -248,6 +354,46 @@ PetscErrorCode DMDASNESSetFunctionLocal(DM dm,InsertMode imode,PetscErrorCode (*
   PetscFunctionReturn(0);
 }
 
+/*@
+   DMDASNESSetFunctionLocalOverlap - overlap the local residual evaluation with the update of the ghost points
+
+   Logically Collective
+
+   Input Arguments:
++  dm - DM with a local residual evaluation set by DMDASNESSetFunctionLocal()
+-  overlap - PETSC_TRUE to evaluate the interior of the subdomain while the ghost points are updated
+
+   Options Database Key:
+.  -dmda_snes_function_overlap - evaluate the interior of the subdomain while the ghost points are updated
+
+   Notes:
+   The local function is then called several times per residual evaluation with a DMDALocalInfo describing part of the
+   subdomain: first the points at least the stencil width away from the ghost points, between DMGlobalToLocalBegin()
+   and DMGlobalToLocalEnd(), then the strips along the sides of the subdomain. It must therefore compute the residual
+   on the points xs <= i < xs+xm, ys <= j < ys+ym and zs <= k < zs+zm of the DMDALocalInfo only, reading the state
+   within the stencil width of these points, as usual.
+
+   This only applies to local functions with INSERT_VALUES.
+
+   Level: intermediate
+
+.seealso: DMDASNESSetFunctionLocal(), DMGlobalToLocalBegin(), DMGlobalToLocalEnd()
+@*/
+PetscErrorCode DMDASNESSetFunctionLocalOverlap(DM dm,PetscBool overlap)
+{
+  PetscErrorCode ierr;
+  DMSNES         sdm;
+  DMSNES_DA      *dmdasnes;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  PetscValidLogicalCollectiveBool(dm,overlap,2);
+  ierr = DMGetDMSNESWrite(dm,&sdm);CHKERRQ(ierr);
+  ierr = DMDASNESGetContext(dm,sdm,&dmdasnes);CHKERRQ(ierr);
+  dmdasnes->residuallocaloverlap = overlap;
+  PetscFunctionReturn(0);
+}
+
 /*@C
    DMDASNESSetJacobianLocal - set a local Jacobian evaluation function
 
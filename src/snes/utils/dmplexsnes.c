@@ -1436,11 +1436,12 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
 
   Note:
   We form the residual one batch of elements at a time. This allows us to offload work onto an accelerator,
-  like a GPU, or vectorize on a multicore machine.
+  like a GPU, or vectorize on a multicore machine. If Jac was created by DMPlexCreateMatrixFree(), only its
+  linearization point is set, and JacP, if different, is assembled from the Jacobian.
 
   Level: developer
 
-.seealso: FormFunctionLocal()
+.seealso: FormFunctionLocal(), DMPlexCreateMatrixFree()
 @*/
 PetscErrorCode DMPlexSNESComputeJacobianFEM(DM dm, Vec X, Mat Jac, Mat JacP,void *user)
 {
@@ -1448,9 +1449,17 @@ PetscErrorCode DMPlexSNESComputeJacobianFEM(DM dm, Vec X, Mat Jac, Mat JacP,void
   IS             allcellIS;
   PetscBool      hasJac, hasPrec;
   PetscInt       Nds, s, depth;
+  PetscErrorCode (*setsol)(Mat, Vec);
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  ierr = PetscObjectQueryFunction((PetscObject) Jac, "DMPlexMatrixFreeSetSolution_C", &setsol);CHKERRQ(ierr);
+  if (setsol) {
+    /* The matrix-free operator only needs the linearization point, and an assembled preconditioner is formed from the Jacobian */
+    ierr = DMPlexMatrixFreeSetSolution(Jac, X);CHKERRQ(ierr);
+    if (Jac == JacP) PetscFunctionReturn(0);
+    Jac = JacP;
+  }
   ierr = DMGetNumDS(dm, &Nds);CHKERRQ(ierr);
   ierr = DMSNESConvertPlex(dm, &plex, PETSC_TRUE);CHKERRQ(ierr);
   ierr = DMPlexGetDepth(plex, &depth);CHKERRQ(ierr);
@@ -207,6 +207,7 @@
       PetscEnum, parameter :: PETSC_BUILDTWOSIDED_ALLREDUCE = 0
       PetscEnum, parameter :: PETSC_BUILDTWOSIDED_IBARRIER = 1
       PetscEnum, parameter :: PETSC_BUILDTWOSIDED_REDSCATTER = 2
+      PetscEnum, parameter :: PETSC_BUILDTWOSIDED_NODE = 3
 
       type tPetscSubcomm
         sequence
@@ -272,6 +273,7 @@
 !DEC$ ATTRIBUTES DLLEXPORT::PETSC_BUILDTWOSIDED_ALLREDUCE
 !DEC$ ATTRIBUTES DLLEXPORT::PETSC_BUILDTWOSIDED_IBARRIER
 !DEC$ ATTRIBUTES DLLEXPORT::PETSC_BUILDTWOSIDED_REDSCATTER
+!DEC$ ATTRIBUTES DLLEXPORT::PETSC_BUILDTWOSIDED_NODE
 !DEC$ ATTRIBUTES DLLEXPORT::PETSC_SUBCOMM_GENERAL
 !DEC$ ATTRIBUTES DLLEXPORT::PETSC_SUBCOMM_CONTIGUOUS
 !DEC$ ATTRIBUTES DLLEXPORT::PETSC_SUBCOMM_INTERLACED
@@ -82,7 +82,7 @@ int main(int argc,char **argv)
 {
   PetscErrorCode ierr;
   PetscMPIInt    rank,size,*toranks,*fromranks,nto,nfrom;
-  PetscInt       i,n;
+  PetscInt       i,n,repeat;
   PetscBool      verbose,build_twosided_f;
   Unit           *todata,*fromdata;
   MPI_Datatype   dtype;
@@ -95,6 +95,8 @@ int main(int argc,char **argv)
   ierr = PetscOptionsGetBool(NULL,NULL,"-verbose",&verbose,NULL);CHKERRQ(ierr);
   build_twosided_f = PETSC_FALSE;
   ierr = PetscOptionsGetBool(NULL,NULL,"-build_twosided_f",&build_twosided_f,NULL);CHKERRQ(ierr);
+  repeat = 0;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-repeat",&repeat,NULL);CHKERRQ(ierr);
 
   for (i=1,nto=0; i<size; i*=2) nto++;
   ierr = PetscMalloc2(nto,&todata,nto,&toranks);CHKERRQ(ierr);
@@ -131,7 +133,18 @@ int main(int argc,char **argv)
     ierr = PetscSegBufferExtractAlloc(fctx.seg,&fromdata);CHKERRQ(ierr);
     ierr = PetscSegBufferDestroy(&fctx.seg);CHKERRQ(ierr);
   } else {
-    ierr = PetscCommBuildTwoSided(PETSC_COMM_WORLD,1,dtype,nto,toranks,todata,&nfrom,&fromranks,&fromdata);CHKERRQ(ierr);
+    MPI_Comm comm;
+
+    /* Hold the PETSc inner communicator, which keeps the patterns cached with -build_twosided_cache, across the calls */
+    ierr = PetscCommDuplicate(PETSC_COMM_WORLD,&comm,NULL);CHKERRQ(ierr);
+    /* Earlier discoveries of the same pattern, whose source ranks can be reused by the last one */
+    for (i=0; i<repeat; i++) {
+      ierr = PetscCommBuildTwoSided(comm,1,dtype,nto,toranks,todata,&nfrom,&fromranks,&fromdata);CHKERRQ(ierr);
+      ierr = PetscFree(fromdata);CHKERRQ(ierr);
+      ierr = PetscFree(fromranks);CHKERRQ(ierr);
+    }
+    ierr = PetscCommBuildTwoSided(comm,1,dtype,nto,toranks,todata,&nfrom,&fromranks,&fromdata);CHKERRQ(ierr);
+    ierr = PetscCommDestroy(&comm);CHKERRQ(ierr);
   }
   ierr = MPI_Type_free(&dtype);CHKERRMPI(ierr);
 
@@ -205,4 +218,16 @@ int main(int argc,char **argv)
       args: -verbose -build_twosided redscatter
       output_file: output/ex8_1.out
 
+   test:
+      suffix: node
+      nsize: 4
+      args: -verbose -build_twosided node -build_twosided_node_size 2
+      output_file: output/ex8_1.out
+
+   test:
+      suffix: cache
+      nsize: 4
+      args: -verbose -build_twosided ibarrier -build_twosided_cache 2 -repeat 2
+      output_file: output/ex8_1.out
+
 TEST*/
@@ -8,6 +8,7 @@ const char *const PetscBuildTwoSidedTypes[] = {
   "ALLREDUCE",
   "IBARRIER",
   "REDSCATTER",
+  "NODE",
   "PetscBuildTwoSidedType",
   "PETSC_BUILDTWOSIDED_",
   NULL
@@ -247,6 +248,361 @@ static PetscErrorCode PetscCommBuildTwoSided_RedScatter(MPI_Comm comm,PetscMPIIn
 }
 #endif
 
+/*
+   Per-communicator data of PetscCommBuildTwoSided(), attached to the inner PETSc communicator: the node structure used by
+   PETSC_BUILDTWOSIDED_NODE and the cache of discovered patterns enabled with -build_twosided_cache
+*/
+typedef struct {
+  PetscInt64  key;              /* hash of the destination ranks */
+  PetscMPIInt epoch;            /* discovery in which the pattern was recorded, identical on all ranks */
+  PetscMPIInt nto,nfrom;
+  PetscMPIInt *toranks,*fromranks;
+} PetscTwoSidedPattern;
+
+typedef struct {
+  MPI_Comm             nodecomm;    /* ranks of the same node */
+  MPI_Comm             leadercomm;  /* node leaders (rank 0 of each nodecomm), MPI_COMM_NULL elsewhere */
+  PetscMPIInt          *rankinfo;   /* node (rank in leadercomm) and rank within the node of each rank, length 2*size */
+  PetscMPIInt          epoch;       /* number of discoveries recorded in the cache */
+  PetscInt             npatterns;
+  PetscTwoSidedPattern *patterns;   /* of length _twosided_cache */
+} PetscCommTwoSided;
+
+static PetscMPIInt Petsc_TwoSided_keyval = MPI_KEYVAL_INVALID;
+static PetscInt    _twosided_cache       = -1;
+
+static PetscMPIInt MPIAPI Petsc_TwoSided_Attr_Delete_Fn(MPI_Comm comm,PetscMPIInt keyval,void *attr_val,void *extra_state)
+{
+  PetscCommTwoSided *ts = (PetscCommTwoSided*)attr_val;
+  PetscInt          i;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (ts->nodecomm != MPI_COMM_NULL) {ierr = MPI_Comm_free(&ts->nodecomm);CHKERRMPI(ierr);}
+  if (ts->leadercomm != MPI_COMM_NULL) {ierr = MPI_Comm_free(&ts->leadercomm);CHKERRMPI(ierr);}
+  ierr = PetscFree(ts->rankinfo);CHKERRMPI(ierr);
+  for (i=0; i<ts->npatterns; i++) {ierr = PetscFree2(ts->patterns[i].toranks,ts->patterns[i].fromranks);CHKERRMPI(ierr);}
+  ierr = PetscFree(ts->patterns);CHKERRMPI(ierr);
+  ierr = PetscFree(ts);CHKERRMPI(ierr);
+  PetscFunctionReturn(MPI_SUCCESS);
+}
+
+static PetscErrorCode PetscCommTwoSidedFinalize_Private(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_free_keyval(&Petsc_TwoSided_keyval);CHKERRMPI(ierr);
+  _twosided_cache = -1;
+  PetscFunctionReturn(0);
+}
+
+/* comm must be an inner PETSc communicator */
+static PetscErrorCode PetscCommTwoSidedGet_Private(MPI_Comm comm,PetscCommTwoSided **ts)
+{
+  PetscMPIInt    flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (Petsc_TwoSided_keyval == MPI_KEYVAL_INVALID) {
+    ierr = MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN,Petsc_TwoSided_Attr_Delete_Fn,&Petsc_TwoSided_keyval,NULL);CHKERRMPI(ierr);
+    ierr = PetscRegisterFinalize(PetscCommTwoSidedFinalize_Private);CHKERRQ(ierr);
+  }
+  ierr = MPI_Comm_get_attr(comm,Petsc_TwoSided_keyval,ts,&flg);CHKERRMPI(ierr);
+  if (!flg) {
+    ierr = PetscNew(ts);CHKERRQ(ierr);
+    (*ts)->nodecomm   = MPI_COMM_NULL;
+    (*ts)->leadercomm = MPI_COMM_NULL;
+    ierr = MPI_Comm_set_attr(comm,Petsc_TwoSided_keyval,*ts);CHKERRMPI(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_MPI_IBARRIER)
+/*
+   Node-aggregated variant of PetscCommBuildTwoSided_Ibarrier(). Each rank sends its records (destination rank, source rank,
+   payload) to the leader of its node (ranks sharing memory, or -build_twosided_node_size consecutive ranks), the leaders run the NBX algorithm among themselves with one message
+   per pair of communicating nodes, and each leader scatters the records it received to their destinations on its node.
+   The number of messages crossing the network is thus the number of communicating node pairs rather than rank pairs.
+*/
+static PetscErrorCode PetscCommBuildTwoSided_Node(MPI_Comm comm,PetscMPIInt count,MPI_Datatype dtype,PetscMPIInt nto,const PetscMPIInt *toranks,const void *todata,PetscMPIInt *nfrom,PetscMPIInt **fromranks,void *fromdata)
+{
+  PetscErrorCode    ierr;
+  PetscCommTwoSided *ts;
+  MPI_Comm          ncomm,lcomm;
+  PetscMPIInt       tag,rank,nrank,nsize,mynode,i,j,nrec,nbytes,*counts = NULL,*displs = NULL,*keys = NULL,*perm = NULL;
+  MPI_Aint          lb,unitbytes;
+  size_t            psize,rsize;
+  char              *sendrec,*gathered = NULL,*sorted = NULL,*mine,*fdata;
+  PetscSegBuffer    segdata;
+  PetscMPIInt       *franks;
+
+  PetscFunctionBegin;
+  ierr = PetscCommDuplicate(comm,&comm,&tag);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRMPI(ierr);
+  ierr = MPI_Type_get_extent(dtype,&lb,&unitbytes);CHKERRMPI(ierr);
+  if (lb != 0) SETERRQ1(comm,PETSC_ERR_SUP,"Datatype with nonzero lower bound %ld\n",(long)lb);
+  ierr = PetscCommTwoSidedGet_Private(comm,&ts);CHKERRQ(ierr);
+  if (!ts->rankinfo) {          /* One-time setup of the node structure, the only step with a global collective */
+    PetscMPIInt size,info[2],color;
+    PetscInt    nodesize = 0;
+
+    ierr = MPI_Comm_size(comm,&size);CHKERRMPI(ierr);
+    ierr = PetscOptionsGetInt(NULL,NULL,"-build_twosided_node_size",&nodesize,NULL);CHKERRQ(ierr);
+    if (nodesize > 0) color = (PetscMPIInt)(rank/nodesize);
+    else {
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+      PetscShmComm shm;
+
+      ierr = PetscShmCommGet(comm,&shm);CHKERRQ(ierr);
+      ierr = PetscShmCommLocalToGlobal(shm,0,&color);CHKERRQ(ierr);
+#else
+      color = rank;
+#endif
+    }
+    ierr = MPI_Comm_split(comm,color,rank,&ts->nodecomm);CHKERRMPI(ierr);
+    ierr = MPI_Comm_rank(ts->nodecomm,&nrank);CHKERRMPI(ierr);
+    ierr = MPI_Comm_split(comm,nrank ? MPI_UNDEFINED : 0,rank,&ts->leadercomm);CHKERRMPI(ierr);
+    if (!nrank) {ierr = MPI_Comm_rank(ts->leadercomm,&info[0]);CHKERRMPI(ierr);}
+    ierr = MPI_Bcast(&info[0],1,MPI_INT,0,ts->nodecomm);CHKERRMPI(ierr);
+    info[1] = nrank;
+    ierr = PetscMalloc1(2*size,&ts->rankinfo);CHKERRQ(ierr);
+    ierr = MPI_Allgather(info,2,MPI_INT,ts->rankinfo,2,MPI_INT,comm);CHKERRMPI(ierr);
+  }
+  ncomm  = ts->nodecomm;
+  lcomm  = ts->leadercomm;
+  ierr   = MPI_Comm_rank(ncomm,&nrank);CHKERRMPI(ierr);
+  ierr   = MPI_Comm_size(ncomm,&nsize);CHKERRMPI(ierr);
+  mynode = ts->rankinfo[2*rank];
+  psize  = (size_t)count*unitbytes;
+  rsize  = 2*sizeof(PetscMPIInt)+psize;
+
+  /* Gather the records of the node on its leader */
+  ierr = PetscMalloc(nto*rsize,&sendrec);CHKERRQ(ierr);
+  for (i=0; i<nto; i++) {
+    char *r = sendrec+i*rsize;
+    ierr = PetscMemcpy(r,&toranks[i],sizeof(PetscMPIInt));CHKERRQ(ierr);
+    ierr = PetscMemcpy(r+sizeof(PetscMPIInt),&rank,sizeof(PetscMPIInt));CHKERRQ(ierr);
+    ierr = PetscMemcpy(r+2*sizeof(PetscMPIInt),(const char*)todata+i*psize,psize);CHKERRQ(ierr);
+  }
+  ierr = PetscMPIIntCast(nto*rsize,&nbytes);CHKERRQ(ierr);
+  if (!nrank) {ierr = PetscMalloc2(nsize,&counts,nsize+1,&displs);CHKERRQ(ierr);}
+  ierr = MPI_Gather(&nbytes,1,MPI_INT,counts,1,MPI_INT,0,ncomm);CHKERRMPI(ierr);
+  if (!nrank) {
+    for (displs[0]=0,i=0; i<nsize; i++) displs[i+1] = displs[i]+counts[i];
+    ierr = PetscMalloc(displs[nsize],&gathered);CHKERRQ(ierr);
+  }
+  ierr = MPI_Gatherv(sendrec,nbytes,MPI_BYTE,gathered,counts,displs,MPI_BYTE,0,ncomm);CHKERRMPI(ierr);
+  ierr = PetscFree(sendrec);CHKERRQ(ierr);
+
+  if (!nrank) {
+    PetscMPIInt done,nsends = 0;
+    MPI_Request *sendreqs,barrier = MPI_REQUEST_NULL;
+    PetscBool   barrier_started = PETSC_FALSE;
+    char        *all;
+    size_t      total;
+
+    /* Sort the records by destination node; those for this node stay here, the others go in one message per node */
+    nrec = displs[nsize]/(PetscMPIInt)rsize;
+    ierr = PetscMalloc3(nrec,&keys,nrec,&perm,nrec*rsize,&sorted);CHKERRQ(ierr);
+    for (i=0; i<nrec; i++) {
+      PetscMPIInt dest;
+      ierr    = PetscMemcpy(&dest,gathered+i*rsize,sizeof(PetscMPIInt));CHKERRQ(ierr);
+      keys[i] = ts->rankinfo[2*dest];
+      perm[i] = i;
+    }
+    ierr = PetscSortMPIIntWithArray(nrec,keys,perm);CHKERRQ(ierr);
+    for (i=0; i<nrec; i++) {ierr = PetscMemcpy(sorted+i*rsize,gathered+perm[i]*rsize,rsize);CHKERRQ(ierr);}
+    ierr = PetscFree(gathered);CHKERRQ(ierr);
+    ierr = PetscSegBufferCreate(1,displs[nsize]+1,&segdata);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nrec,&sendreqs);CHKERRQ(ierr);
+    for (i=0; i<nrec; i=j) {
+      for (j=i+1; j<nrec && keys[j] == keys[i]; j++) ;
+      if (keys[i] == mynode) {
+        char *buf;
+        ierr = PetscSegBufferGet(segdata,(j-i)*rsize,&buf);CHKERRQ(ierr);
+        ierr = PetscMemcpy(buf,sorted+i*rsize,(j-i)*rsize);CHKERRQ(ierr);
+      } else {
+        ierr = MPI_Issend(sorted+i*rsize,(PetscMPIInt)((j-i)*rsize),MPI_BYTE,keys[i],tag,lcomm,&sendreqs[nsends++]);CHKERRMPI(ierr);
+      }
+    }
+    for (done=0; !done;) {
+      PetscMPIInt flag,n;
+      MPI_Status  status;
+      ierr = MPI_Iprobe(MPI_ANY_SOURCE,tag,lcomm,&flag,&status);CHKERRMPI(ierr);
+      if (flag) {
+        char *buf;
+        ierr = MPI_Get_count(&status,MPI_BYTE,&n);CHKERRMPI(ierr);
+        ierr = PetscSegBufferGet(segdata,n,&buf);CHKERRQ(ierr);
+        ierr = MPI_Recv(buf,n,MPI_BYTE,status.MPI_SOURCE,tag,lcomm,MPI_STATUS_IGNORE);CHKERRMPI(ierr);
+      }
+      if (!barrier_started) {
+        PetscMPIInt sent;
+        ierr = MPI_Testall(nsends,sendreqs,&sent,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+        if (sent) {
+          ierr = MPI_Ibarrier(lcomm,&barrier);CHKERRMPI(ierr);
+          barrier_started = PETSC_TRUE;
+        }
+      } else {
+        ierr = MPI_Test(&barrier,&done,MPI_STATUS_IGNORE);CHKERRMPI(ierr);
+      }
+    }
+    ierr = PetscFree(sendreqs);CHKERRQ(ierr);
+    ierr = PetscFree3(keys,perm,sorted);CHKERRQ(ierr);
+
+    /* Sort the records destined to this node by rank within the node */
+    ierr = PetscSegBufferGetSize(segdata,&total);CHKERRQ(ierr);
+    ierr = PetscSegBufferExtractAlloc(segdata,&all);CHKERRQ(ierr);
+    ierr = PetscSegBufferDestroy(&segdata);CHKERRQ(ierr);
+    nrec = (PetscMPIInt)(total/rsize);
+    ierr = PetscMalloc3(nrec,&keys,nrec,&perm,nrec*rsize,&sorted);CHKERRQ(ierr);
+    for (i=0; i<nrec; i++) {
+      PetscMPIInt dest;
+      ierr    = PetscMemcpy(&dest,all+i*rsize,sizeof(PetscMPIInt));CHKERRQ(ierr);
+      keys[i] = ts->rankinfo[2*dest+1];
+      perm[i] = i;
+    }
+    ierr = PetscSortMPIIntWithArray(nrec,keys,perm);CHKERRQ(ierr);
+    ierr = PetscArrayzero(counts,nsize);CHKERRQ(ierr);
+    for (i=0; i<nrec; i++) {
+      ierr = PetscMemcpy(sorted+i*rsize,all+perm[i]*rsize,rsize);CHKERRQ(ierr);
+      counts[keys[i]] += (PetscMPIInt)rsize;
+    }
+    for (displs[0]=0,i=0; i<nsize; i++) displs[i+1] = displs[i]+counts[i];
+    ierr = PetscFree(all);CHKERRQ(ierr);
+  }
+
+  /* Scatter the records to their destinations on this node */
+  ierr = MPI_Scatter(counts,1,MPI_INT,&nbytes,1,MPI_INT,0,ncomm);CHKERRMPI(ierr);
+  ierr = PetscMalloc(nbytes,&mine);CHKERRQ(ierr);
+  ierr = MPI_Scatterv(sorted,counts,displs,MPI_BYTE,mine,nbytes,MPI_BYTE,0,ncomm);CHKERRMPI(ierr);
+  if (!nrank) {
+    ierr = PetscFree3(keys,perm,sorted);CHKERRQ(ierr);
+    ierr = PetscFree2(counts,displs);CHKERRQ(ierr);
+  }
+  nrec = nbytes/(PetscMPIInt)rsize;
+  ierr = PetscMalloc1(nrec,&franks);CHKERRQ(ierr);
+  ierr = PetscMalloc(nrec*psize,&fdata);CHKERRQ(ierr);
+  for (i=0; i<nrec; i++) {
+    ierr = PetscMemcpy(&franks[i],mine+i*rsize+sizeof(PetscMPIInt),sizeof(PetscMPIInt));CHKERRQ(ierr);
+    ierr = PetscMemcpy(fdata+i*psize,mine+i*rsize+2*sizeof(PetscMPIInt),psize);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(mine);CHKERRQ(ierr);
+  ierr = PetscCommDestroy(&comm);CHKERRQ(ierr);
+
+  *nfrom            = nrec;
+  *fromranks        = franks;
+  *(void**)fromdata = fdata;
+  PetscFunctionReturn(0);
+}
+#endif
+
+/* FNV-1a hash of a list of ranks */
+static PetscInt64 PetscTwoSidedHash_Private(PetscMPIInt n,const PetscMPIInt *ranks)
+{
+  unsigned long long h = 14695981039346656037ULL;
+  PetscMPIInt        i;
+
+  h = (h ^ (unsigned int)n)*1099511628211ULL;
+  for (i=0; i<n; i++) h = (h ^ (unsigned int)ranks[i])*1099511628211ULL;
+  return (PetscInt64)h;
+}
+
+/*
+   Looks up the destination pattern in the cache of the communicator. The cached source ranks can only be used if every rank
+   finds its pattern recorded in the same discovery, otherwise some rank may have a new destination; this is decided with a
+   reduction of two integers, which replaces the discovery with a plain exchange of O(neighbors) messages per rank.
+*/
+static PetscErrorCode PetscCommBuildTwoSidedCacheLookup_Private(MPI_Comm comm,PetscCommTwoSided *ts,PetscMPIInt nto,const PetscMPIInt *toranks,PetscInt64 key,PetscTwoSidedPattern **pattern)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+  PetscMPIInt    b1[2],b2[2];
+  PetscBool      same;
+
+  PetscFunctionBegin;
+  *pattern = NULL;
+  for (i=0; i<ts->npatterns; i++) {
+    PetscTwoSidedPattern *p = &ts->patterns[i];
+    if (p->key != key || p->nto != nto) continue;
+    ierr = PetscArraycmp(p->toranks,toranks,nto,&same);CHKERRQ(ierr);
+    if (same) {*pattern = p; break;}
+  }
+  b1[0] = *pattern ? (*pattern)->epoch : -1;
+  b1[1] = -b1[0];
+  ierr  = MPIU_Allreduce(b1,b2,2,MPI_INT,MPI_MAX,comm);CHKERRQ(ierr);
+  if (b2[0] < 0 || -b2[1] != b2[0]) *pattern = NULL;
+  PetscFunctionReturn(0);
+}
+
+/* Records the pattern of a new discovery, collectively, replacing the same pattern or else the oldest one */
+static PetscErrorCode PetscCommBuildTwoSidedCacheInsert_Private(PetscCommTwoSided *ts,PetscMPIInt nto,const PetscMPIInt *toranks,PetscInt64 key,PetscMPIInt nfrom,const PetscMPIInt *fromranks)
+{
+  PetscErrorCode       ierr;
+  PetscInt             i,slot = -1;
+  PetscTwoSidedPattern *p;
+  PetscBool            same;
+
+  PetscFunctionBegin;
+  if (!ts->patterns) {ierr = PetscCalloc1(_twosided_cache,&ts->patterns);CHKERRQ(ierr);}
+  ts->epoch++;
+  for (i=0; i<ts->npatterns && slot < 0; i++) {
+    p = &ts->patterns[i];
+    if (p->key != key || p->nto != nto) continue;
+    ierr = PetscArraycmp(p->toranks,toranks,nto,&same);CHKERRQ(ierr);
+    if (same) slot = i;
+  }
+  if (slot < 0 && ts->npatterns < _twosided_cache) slot = ts->npatterns++;
+  if (slot < 0) {
+    for (slot=0,i=1; i<ts->npatterns; i++) {
+      if (ts->patterns[i].epoch < ts->patterns[slot].epoch) slot = i;
+    }
+  }
+  p = &ts->patterns[slot];
+  ierr = PetscFree2(p->toranks,p->fromranks);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nto,&p->toranks,nfrom,&p->fromranks);CHKERRQ(ierr);
+  ierr = PetscArraycpy(p->toranks,toranks,nto);CHKERRQ(ierr);
+  ierr = PetscArraycpy(p->fromranks,fromranks,nfrom);CHKERRQ(ierr);
+  p->key   = key;
+  p->epoch = ts->epoch;
+  p->nto   = nto;
+  p->nfrom = nfrom;
+  PetscFunctionReturn(0);
+}
+
+/* Exchanges the data with the source ranks already known from a previous discovery */
+static PetscErrorCode PetscCommBuildTwoSided_Cached(MPI_Comm comm,PetscMPIInt count,MPI_Datatype dtype,PetscMPIInt nto,const PetscMPIInt *toranks,const void *todata,PetscTwoSidedPattern *pattern,PetscMPIInt *nfrom,PetscMPIInt **fromranks,void *fromdata)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    tag,i,nrecvs = pattern->nfrom,*franks;
+  MPI_Aint       lb,unitbytes;
+  char           *tdata = (char*)todata,*fdata;
+  MPI_Request    *reqs;
+
+  PetscFunctionBegin;
+  ierr = PetscCommDuplicate(comm,&comm,&tag);CHKERRQ(ierr);
+  ierr = MPI_Type_get_extent(dtype,&lb,&unitbytes);CHKERRMPI(ierr);
+  if (lb != 0) SETERRQ1(comm,PETSC_ERR_SUP,"Datatype with nonzero lower bound %ld\n",(long)lb);
+  ierr = PetscMalloc(nrecvs*count*unitbytes,&fdata);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nrecvs,&franks);CHKERRQ(ierr);
+  ierr = PetscArraycpy(franks,pattern->fromranks,nrecvs);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nto+nrecvs,&reqs);CHKERRQ(ierr);
+  for (i=0; i<nrecvs; i++) {
+    ierr = MPI_Irecv((void*)(fdata+count*unitbytes*i),count,dtype,franks[i],tag,comm,reqs+i);CHKERRMPI(ierr);
+  }
+  for (i=0; i<nto; i++) {
+    ierr = MPI_Isend((void*)(tdata+count*unitbytes*i),count,dtype,toranks[i],tag,comm,reqs+nrecvs+i);CHKERRMPI(ierr);
+  }
+  ierr = MPI_Waitall(nto+nrecvs,reqs,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+  ierr = PetscFree(reqs);CHKERRQ(ierr);
+  ierr = PetscCommDestroy(&comm);CHKERRQ(ierr);
+
+  *nfrom            = nrecvs;
+  *fromranks        = franks;
+  *(void**)fromdata = fdata;
+  PetscFunctionReturn(0);
+}
+
 /*@C
    PetscCommBuildTwoSided - discovers communicating ranks given one-sided information, moving constant-sized data in the process (often message lengths)
 
@@ -268,7 +624,9 @@ static PetscErrorCode PetscCommBuildTwoSided_RedScatter(MPI_Comm comm,PetscMPIIn
    Level: developer
 
    Options Database Keys:
-.  -build_twosided <allreduce|ibarrier|redscatter> - algorithm to set up two-sided communication. Default is allreduce for communicators with <= 1024 ranks, otherwise ibarrier.
++  -build_twosided <allreduce|ibarrier|redscatter|node> - algorithm to set up two-sided communication. Default is allreduce for communicators with <= 1024 ranks, otherwise ibarrier.
+.  -build_twosided_node_size <n> - for the node algorithm, number of consecutive ranks forming a node, or 0 (default) to use the shared-memory nodes
+-  -build_twosided_cache <n> - number of destination patterns whose source ranks are remembered on each communicator (default 0)
 
    Notes:
    This memory-scalable interface is an alternative to calling PetscGatherNumberOfMessages() and
@@ -276,6 +634,14 @@ static PetscErrorCode PetscCommBuildTwoSided_RedScatter(MPI_Comm comm,PetscMPIIn
 
    Basic data types as well as contiguous types are supported, but non-contiguous (e.g., strided) types are not.
 
+   The node algorithm aggregates the messages of all ranks of a shared-memory node through a node leader, so that only
+   one message is exchanged between each pair of communicating nodes.
+
+   With -build_twosided_cache, a call in which every rank repeats the destination ranks (in the same order) of an earlier
+   discovery reuses the source ranks found then: it only costs a reduction of two integers and the point-to-point
+   messages carrying the data. The patterns are kept on the PETSc inner communicator (see PetscCommDuplicate()), hence as long
+   as PETSc objects or the caller hold a reference to it.
+
    References:
 .  1. - Hoefler, Siebert and Lumsdaine, The MPI_Ibarrier implementation uses the algorithm in
    Scalable communication protocols for dynamic sparse data exchange, 2010.
@@ -286,11 +652,32 @@ PetscErrorCode PetscCommBuildTwoSided(MPI_Comm comm,PetscMPIInt count,MPI_Dataty
 {
   PetscErrorCode         ierr;
   PetscBuildTwoSidedType buildtype = PETSC_BUILDTWOSIDED_NOTSET;
+  PetscCommTwoSided      *ts = NULL;
+  PetscTwoSidedPattern   *pattern = NULL;
+  PetscInt64             key = 0;
+  MPI_Comm               icomm = MPI_COMM_NULL;
 
   PetscFunctionBegin;
   ierr = PetscSysInitializePackage();CHKERRQ(ierr);
   ierr = PetscLogEventSync(PETSC_BuildTwoSided,comm);CHKERRQ(ierr);
   ierr = PetscLogEventBegin(PETSC_BuildTwoSided,0,0,0,0);CHKERRQ(ierr);
+  if (_twosided_cache < 0) {
+    _twosided_cache = 0;
+    ierr = PetscOptionsGetInt(NULL,NULL,"-build_twosided_cache",&_twosided_cache,NULL);CHKERRQ(ierr);
+  }
+  if (_twosided_cache > 0) {
+    ierr = PetscCommDuplicate(comm,&icomm,NULL);CHKERRQ(ierr);
+    ierr = PetscCommTwoSidedGet_Private(icomm,&ts);CHKERRQ(ierr);
+    key  = PetscTwoSidedHash_Private(nto,toranks);
+    ierr = PetscCommBuildTwoSidedCacheLookup_Private(icomm,ts,nto,toranks,key,&pattern);CHKERRQ(ierr);
+  }
+  if (pattern) {
+    ierr = PetscInfo1(NULL,"Reusing the source ranks found in discovery %d\n",pattern->epoch);CHKERRQ(ierr);
+    ierr = PetscCommBuildTwoSided_Cached(comm,count,dtype,nto,toranks,todata,pattern,nfrom,fromranks,fromdata);CHKERRQ(ierr);
+    ierr = PetscCommDestroy(&icomm);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(PETSC_BuildTwoSided,0,0,0,0);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = PetscCommBuildTwoSidedGetType(comm,&buildtype);CHKERRQ(ierr);
   switch (buildtype) {
   case PETSC_BUILDTWOSIDED_IBARRIER:
@@ -309,9 +696,20 @@ PetscErrorCode PetscCommBuildTwoSided(MPI_Comm comm,PetscMPIInt count,MPI_Dataty
     break;
 #else
     SETERRQ(comm,PETSC_ERR_PLIB,"MPI implementation does not provide MPI_Reduce_scatter_block (part of MPI-2.2)");
+#endif
+  case PETSC_BUILDTWOSIDED_NODE:
+#if defined(PETSC_HAVE_MPI_IBARRIER)
+    ierr = PetscCommBuildTwoSided_Node(comm,count,dtype,nto,toranks,todata,nfrom,fromranks,fromdata);CHKERRQ(ierr);
+    break;
+#else
+    SETERRQ(comm,PETSC_ERR_PLIB,"MPI implementation does not provide MPI_Ibarrier (part of MPI-3)");
 #endif
   default: SETERRQ(comm,PETSC_ERR_PLIB,"Unknown method for building two-sided communication");
   }
+  if (ts) {
+    ierr = PetscCommBuildTwoSidedCacheInsert_Private(ts,nto,toranks,key,*nfrom,*fromranks);CHKERRQ(ierr);
+    ierr = PetscCommDestroy(&icomm);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(PETSC_BuildTwoSided,0,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -576,6 +974,7 @@ PetscErrorCode PetscCommBuildTwoSidedFReq(MPI_Comm comm,PetscMPIInt count,MPI_Da
 #endif
   case PETSC_BUILDTWOSIDED_ALLREDUCE:
   case PETSC_BUILDTWOSIDED_REDSCATTER:
+  case PETSC_BUILDTWOSIDED_NODE:
     f = PetscCommBuildTwoSidedFReq_Reference;
     break;
   default: SETERRQ(comm,PETSC_ERR_PLIB,"Unknown method for building two-sided communication");
@@ -64,6 +64,8 @@ PetscErrorCode PetscSectionCreate(MPI_Comm comm, PetscSection *s)
   (*s)->clHash             = NULL;
   (*s)->clSection          = NULL;
   (*s)->clPoints           = NULL;
+  (*s)->clDofCache         = NULL;
+  (*s)->clDofCacheDestroy  = NULL;
   PetscFunctionReturn(0);
 }
 
@@ -2119,6 +2121,18 @@ static PetscErrorCode PetscSectionResetClosurePermutation(PetscSection section)
   PetscFunctionReturn(0);
 }
 
+/* The closure dof cache is attached by DMPlexCreateClosureDofCache(), and is destroyed whenever the closure it flattens may change */
+PetscErrorCode PetscSectionSetClosureDofCache_Internal(PetscSection section, void *cache, PetscErrorCode (*destroy)(void*))
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (section->clDofCache && section->clDofCacheDestroy) {ierr = (*section->clDofCacheDestroy)(section->clDofCache);CHKERRQ(ierr);}
+  section->clDofCache        = cache;
+  section->clDofCacheDestroy = destroy;
+  PetscFunctionReturn(0);
+}
+
 /*@
   PetscSectionReset - Frees all section data.
 
@@ -2156,6 +2170,7 @@ PetscErrorCode PetscSectionReset(PetscSection s)
   ierr = ISDestroy(&s->clPoints);CHKERRQ(ierr);
   ierr = ISDestroy(&s->perm);CHKERRQ(ierr);
   ierr = PetscSectionResetClosurePermutation(s);CHKERRQ(ierr);
+  ierr = PetscSectionSetClosureDofCache_Internal(s, NULL, NULL);CHKERRQ(ierr);
   ierr = PetscSectionSymDestroy(&s->sym);CHKERRQ(ierr);
   ierr = PetscSectionDestroy(&s->clSection);CHKERRQ(ierr);
   ierr = ISDestroy(&s->clPoints);CHKERRQ(ierr);
@@ -2537,7 +2552,10 @@ PetscErrorCode PetscSectionSetClosureIndex(PetscSection section, PetscObject obj
   PetscValidHeaderSpecific(section,PETSC_SECTION_CLASSID,1);
   PetscValidHeaderSpecific(clSection,PETSC_SECTION_CLASSID,3);
   PetscValidHeaderSpecific(clPoints,IS_CLASSID,4);
-  if (section->clObj != obj) {ierr = PetscSectionResetClosurePermutation(section);CHKERRQ(ierr);}
+  if (section->clObj != obj) {
+    ierr = PetscSectionResetClosurePermutation(section);CHKERRQ(ierr);
+    ierr = PetscSectionSetClosureDofCache_Internal(section, NULL, NULL);CHKERRQ(ierr);
+  }
   section->clObj     = obj;
   ierr = PetscObjectReference((PetscObject)clSection);CHKERRQ(ierr);
   ierr = PetscObjectReference((PetscObject)clPoints);CHKERRQ(ierr);
@@ -2594,6 +2612,7 @@ PetscErrorCode PetscSectionSetClosurePermutation_Internal(PetscSection section,
     ierr = PetscSectionDestroy(&section->clSection);CHKERRQ(ierr);
     ierr = ISDestroy(&section->clPoints);CHKERRQ(ierr);
   }
+  ierr = PetscSectionSetClosureDofCache_Internal(section, NULL, NULL);CHKERRQ(ierr);
   section->clObj = obj;
   if (!section->clHash) {ierr = PetscClPermCreate(&section->clHash);CHKERRQ(ierr);}
   iter = kh_put(ClPerm, section->clHash, key, &new_entry);
@@ -3,6 +3,8 @@
 #include <../src/vec/is/sf/impls/basic/sfbasic.h>
 #include <../src/vec/is/sf/impls/basic/sfpack.h>
 
+const char *const PetscSFDatatypesTypes[] = {"AUTO","NEVER","ALWAYS","PetscSFDatatypesType","PETSCSF_DATATYPES_",NULL};
+
 /*===================================================================================*/
 /*              SF public interface implementations                                  */
 /*===================================================================================*/
@@ -127,6 +129,18 @@ PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode PetscSFSetFromOptions_Basic(PetscOptionItems *PetscOptionsObject,PetscSF sf)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Basic options");CHKERRQ(ierr);
+  ierr = PetscOptionsEnum("-sf_basic_datatypes","Send/receive noncontiguous data of remote ranks with MPI derived datatypes instead of packing it","PetscSFSetFromOptions",PetscSFDatatypesTypes,(PetscEnum)bas->datatypes,(PetscEnum*)&bas->datatypes,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,void *leafdata,MPI_Op op)
 {
   PetscErrorCode    ierr;
@@ -406,6 +420,7 @@ PETSC_EXTERN PetscErrorCode PetscSFCreate_Basic(PetscSF sf)
   sf->ops->Reset                = PetscSFReset_Basic;
   sf->ops->Destroy              = PetscSFDestroy_Basic;
   sf->ops->View                 = PetscSFView_Basic;
+  sf->ops->SetFromOptions       = PetscSFSetFromOptions_Basic;
   sf->ops->BcastAndOpBegin      = PetscSFBcastAndOpBegin_Basic;
   sf->ops->BcastAndOpEnd        = PetscSFBcastAndOpEnd_Basic;
   sf->ops->ReduceBegin          = PetscSFReduceBegin_Basic;
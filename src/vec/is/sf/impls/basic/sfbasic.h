@@ -5,6 +5,10 @@
 
 typedef struct _n_PetscSFLink* PetscSFLink;
 
+/* Whether SFBasic may send/receive data of remote ranks with MPI derived datatypes instead of packing it */
+typedef enum {PETSCSF_DATATYPES_AUTO=0,PETSCSF_DATATYPES_NEVER,PETSCSF_DATATYPES_ALWAYS} PetscSFDatatypesType;
+PETSC_INTERN const char *const PetscSFDatatypesTypes[];
+
 #define SFBASICHEADER \
   PetscMPIInt      niranks;         /* Number of incoming ranks (ranks accessing my roots) */                                      \
   PetscMPIInt      ndiranks;        /* Number of incoming ranks (ranks accessing my roots) in distinguished set */                 \
@@ -20,8 +24,17 @@ typedef struct _n_PetscSFLink* PetscSFLink;
   PetscSFPackOpt   rootpackopt_d[2];/* Copy of rootpackopt[] on device if needed */                                                \
   PetscBool        rootdups[2];     /* Indices of roots in irootloc[local/remote] have dups. Used for data-race test */            \
   PetscInt         nrootreqs;       /* Number of MPI reqests */                                                                    \
+  PetscMPIInt      tag;             /* Tag of all links with persistent requests, whose number may differ from rank to rank */     \
   PetscSFLink      avail;           /* One or more entries per MPI Datatype, lazily constructed */                                 \
-  PetscSFLink      inuse            /* Buffers being used for transactions that have not yet completed */
+  PetscSFLink      inuse;           /* Buffers being used for transactions that have not yet completed */                          \
+  PetscSFDatatypesType datatypes;   /* Use MPI derived datatypes for remote ranks: calibrated per rank (auto), never or always */  \
+  PetscBool        dtypecalibrated; /* Have rootdtype[] and leafdtype[] been decided? */                                          \
+  PetscBool        *rootdtype;      /* [niranks-ndiranks] Roots of this remote rank are sent/received with a derived datatype */   \
+  PetscBool        *leafdtype;      /* [nranks-ndranks] Leaves of this remote rank are sent/received with a derived datatype */    \
+  PetscInt         nrootdtypes;     /* Number of true entries in rootdtype[] */                                                    \
+  PetscInt         nleafdtypes;     /* Number of true entries in leafdtype[] */                                                    \
+  PetscBool        rootrecvok;      /* No dups in remote root indices, so MPI can receive directly into rootdata */                \
+  PetscBool        leafrecvok       /* No dups in remote leaf indices, so MPI can receive directly into leafdata */
 
 typedef struct {
   SFBASICHEADER;
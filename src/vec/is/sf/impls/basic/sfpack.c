@@ -1,6 +1,7 @@
 #include "petsc/private/sfimpl.h"
 #include <../src/vec/is/sf/impls/basic/sfpack.h>
 #include <../src/vec/is/sf/impls/basic/sfbasic.h>
+#include <petsctime.h>
 
 /* This is a C file that contains packing facilities, with dispatches to device if enabled. */
 
@@ -477,6 +478,168 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
 }
 #endif
 
+/* Create a committed MPI datatype that selects data[idx[0]], data[idx[1]], ..., data[idx[n-1]] in that order, relative to &data[idx[0]],
+   where data is an array of unit. Callers pass &data[idx[0]] to MPI along with the datatype.
+
+   Runs of consecutive indices become blocks. Equally sized blocks with a constant stride make an MPI vector, which MPI implementations
+   handle best; otherwise we fall back to an indexed block or indexed type. Displacements are in extents of unit, so callers must
+   make sure unit has a zero lower bound and an extent equal to its size, as SF computes offsets with the latter.
+*/
+static PetscErrorCode PetscSFCreateIndexedType_Private(PetscInt n,const PetscInt *idx,MPI_Datatype unit,MPI_Datatype *newtype)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,nb;
+  PetscMPIInt    *blens,*displs,bn,stride;
+  PetscBool      sameblen = PETSC_TRUE,samestride = PETSC_TRUE;
+
+  PetscFunctionBegin;
+  for (i=1,nb=1; i<n; i++) {if (idx[i] != idx[i-1]+1) nb++;}
+  ierr = PetscMalloc2(nb,&blens,nb,&displs);CHKERRQ(ierr);
+  displs[0] = 0;
+  blens[0]  = 1;
+  for (i=1,nb=0; i<n; i++) {
+    if (idx[i] == idx[i-1]+1) blens[nb]++;
+    else {
+      nb++;
+      ierr = PetscMPIIntCast(idx[i]-idx[0],&displs[nb]);CHKERRQ(ierr);
+      blens[nb] = 1;
+    }
+  }
+  nb++;
+  ierr   = PetscMPIIntCast(nb,&bn);CHKERRQ(ierr);
+  stride = nb > 1 ? displs[1] : 0;
+  for (i=1; i<nb; i++) {
+    if (blens[i] != blens[0]) sameblen = PETSC_FALSE;
+    if (displs[i] - displs[i-1] != stride) samestride = PETSC_FALSE;
+  }
+  if (sameblen && samestride && stride > 0) {ierr = MPI_Type_vector(bn,blens[0],stride,unit,newtype);CHKERRMPI(ierr);}
+  else if (sameblen) {ierr = MPI_Type_create_indexed_block(bn,blens[0],displs,unit,newtype);CHKERRMPI(ierr);}
+  else {ierr = MPI_Type_indexed(bn,blens,displs,unit,newtype);CHKERRMPI(ierr);}
+  ierr = MPI_Type_commit(newtype);CHKERRMPI(ierr);
+  ierr = PetscFree2(blens,displs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Can data of unit be addressed by MPI datatypes with the same offsets SF uses, i.e., index*unitbytes? */
+static PetscErrorCode PetscSFUnitIsDense_Private(MPI_Datatype unit,PetscBool *dense)
+{
+  PetscErrorCode ierr;
+  MPI_Aint       lb,extent;
+  PetscMPIInt    size;
+
+  PetscFunctionBegin;
+  ierr   = MPI_Type_get_extent(unit,&lb,&extent);CHKERRMPI(ierr);
+  ierr   = MPI_Type_size(unit,&size);CHKERRMPI(ierr);
+  *dense = (!lb && extent == (MPI_Aint)size) ? PETSC_TRUE : PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/* Decide, for each of the n remote ranks whose indices are idx[offset[j]..offset[j+1]), whether its data is sent/received with a
+   derived datatype (dtype[j] = PETSC_TRUE) or packed. In auto mode, indices contiguous within the rank always go with datatypes since
+   MPI then accesses the data in place, small messages are always packed, and otherwise we time packing with the link against MPI_Pack
+   with the datatype, which is the copy MPI does internally for noncontiguous data unless its network supports gather/scatter.
+*/
+static PetscErrorCode PetscSFDecideDatatypes_Private(PetscSF sf,PetscSFLink link,PetscInt n,const PetscInt *offset,const PetscInt *idx,PetscBool *dtype,PetscInt *ndtypes)
+{
+  PetscErrorCode ierr;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscInt       i,j,k,cnt,maxcnt = 0,maxidx = 0;
+  PetscMPIInt    size,pos;
+  MPI_Datatype   dt;
+  char           *data = NULL,*buf = NULL,*mpibuf = NULL;
+  PetscLogDouble t0,t1,tpack,tmpi;
+  PetscBool      contig;
+
+  PetscFunctionBegin;
+  *ndtypes = 0;
+  if (bas->datatypes == PETSCSF_DATATYPES_AUTO) {
+    for (j=0; j<n; j++) maxcnt = PetscMax(maxcnt,offset[j+1]-offset[j]);
+    for (i=offset[0]; i<offset[n]; i++) maxidx = PetscMax(maxidx,idx[i]);
+    if (maxcnt*link->unitbytes >= PETSCSF_DATATYPES_MIN_BYTES) {
+      ierr = PetscCalloc3((maxidx+1)*link->unitbytes,&data,maxcnt*link->unitbytes,&buf,maxcnt*link->unitbytes,&mpibuf);CHKERRQ(ierr);
+    }
+  }
+  for (j=0; j<n; j++) {
+    cnt = offset[j+1] - offset[j];
+    if (bas->datatypes == PETSCSF_DATATYPES_ALWAYS) dtype[j] = PETSC_TRUE;
+    else {
+      for (i=offset[j]+1,contig=PETSC_TRUE; i<offset[j+1]; i++) {if (idx[i] != idx[i-1]+1) {contig = PETSC_FALSE; break;}}
+      if (contig) dtype[j] = PETSC_TRUE;
+      else if (cnt*link->unitbytes < PETSCSF_DATATYPES_MIN_BYTES) dtype[j] = PETSC_FALSE;
+      else {
+        ierr = PetscSFCreateIndexedType_Private(cnt,idx+offset[j],link->unit,&dt);CHKERRQ(ierr);
+        ierr = PetscMPIIntCast(maxcnt*link->unitbytes,&size);CHKERRQ(ierr);
+        tpack = tmpi = PETSC_MAX_REAL;
+        for (k=0; k<3; k++) { /* Take the best of a few runs to filter out cold caches and noise */
+          ierr  = PetscTime(&t0);CHKERRQ(ierr);
+          ierr  = (*link->h_Pack)(link,cnt,0,NULL,idx+offset[j],data,buf);CHKERRQ(ierr);
+          ierr  = PetscTime(&t1);CHKERRQ(ierr);
+          tpack = PetscMin(tpack,t1-t0);
+          pos   = 0;
+          ierr  = PetscTime(&t0);CHKERRQ(ierr);
+          ierr  = MPI_Pack(data+idx[offset[j]]*link->unitbytes,1,dt,mpibuf,size,&pos,PETSC_COMM_SELF);CHKERRMPI(ierr);
+          ierr  = PetscTime(&t1);CHKERRQ(ierr);
+          tmpi  = PetscMin(tmpi,t1-t0);
+        }
+        ierr     = MPI_Type_free(&dt);CHKERRMPI(ierr);
+        dtype[j] = tmpi < tpack ? PETSC_TRUE : PETSC_FALSE;
+      }
+    }
+    if (dtype[j]) (*ndtypes)++;
+  }
+  ierr = PetscFree3(data,buf,mpibuf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Decide once per SF which remote ranks' roots and leaves are sent/received with derived datatypes instead of being packed.
+   The decision is made with the first unit the SF communicates, and only applies to links whose unit is dense (see above).
+*/
+static PetscErrorCode PetscSFLinkCalibrateDatatypes(PetscSF sf,MPI_Datatype unit)
+{
+  PetscErrorCode         ierr;
+  PetscSF_Basic          *bas = (PetscSF_Basic*)sf->data;
+  struct _n_PetscSFLink  tmp;
+  PetscBool              dense,dups;
+
+  PetscFunctionBegin;
+  bas->dtypecalibrated = PETSC_TRUE;
+  ierr = PetscSFUnitIsDense_Private(unit,&dense);CHKERRQ(ierr);
+  if (!dense) PetscFunctionReturn(0);
+  ierr = PetscMemzero(&tmp,sizeof(tmp));CHKERRQ(ierr);
+  ierr = PetscSFLinkSetUp_Host(sf,&tmp,unit);CHKERRQ(ierr); /* We only need its unit info and packing routine */
+
+  if (bas->rootbuflen[PETSCSF_REMOTE] && !bas->rootcontig[PETSCSF_REMOTE]) {
+    ierr = PetscCheckDupsInt(bas->itotal,bas->irootloc,&dups);CHKERRQ(ierr);
+    bas->rootrecvok = dups ? PETSC_FALSE : PETSC_TRUE;
+    ierr = PetscMalloc1(bas->nrootreqs,&bas->rootdtype);CHKERRQ(ierr);
+    ierr = PetscSFDecideDatatypes_Private(sf,&tmp,bas->nrootreqs,bas->ioffset+bas->ndiranks,bas->irootloc,bas->rootdtype,&bas->nrootdtypes);CHKERRQ(ierr);
+  }
+  if (sf->leafbuflen[PETSCSF_REMOTE] && !sf->leafcontig[PETSCSF_REMOTE]) {
+    ierr = PetscCheckDupsInt(sf->roffset[sf->nranks],sf->rmine,&dups);CHKERRQ(ierr);
+    bas->leafrecvok = dups ? PETSC_FALSE : PETSC_TRUE;
+    ierr = PetscMalloc1(sf->nleafreqs,&bas->leafdtype);CHKERRQ(ierr);
+    ierr = PetscSFDecideDatatypes_Private(sf,&tmp,sf->nleafreqs,sf->roffset+sf->ndranks,sf->rmine,bas->leafdtype,&bas->nleafdtypes);CHKERRQ(ierr);
+  }
+  if (!tmp.isbuiltin) {ierr = MPI_Type_free(&tmp.unit);CHKERRMPI(ierr);}
+  ierr = PetscInfo4(sf,"Derived datatypes are used for %D of %D remote root ranks and %D of %D remote leaf ranks\n",bas->nrootdtypes,bas->nrootreqs,bas->nleafdtypes,sf->nleafreqs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Build the per-rank derived datatypes of a link in dtype mode */
+static PetscErrorCode PetscSFLinkCreateDatatypes_Private(PetscInt n,const PetscInt *offset,const PetscInt *idx,const PetscBool *dtype,MPI_Datatype unit,MPI_Datatype **dtypes)
+{
+  PetscErrorCode ierr;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(n,dtypes);CHKERRQ(ierr);
+  for (j=0; j<n; j++) {
+    (*dtypes)[j] = MPI_DATATYPE_NULL;
+    if (dtype[j]) {ierr = PetscSFCreateIndexedType_Private(offset[j+1]-offset[j],idx+offset[j],unit,&(*dtypes)[j]);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
 /*
    The routine Creates a communication link for the given operation. It first looks up its link cache. If
    there is a free & suitable one, it uses it. Otherwise it creates a new one.
@@ -498,14 +661,16 @@ PetscErrorCode PetscSFLinkCreate(PetscSF sf,MPI_Datatype unit,PetscMemType xroot
   PetscErrorCode    ierr;
   PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
   PetscInt          i,j,k,nrootreqs,nleafreqs,nreqs;
-  PetscSFLink       *p,link;
+  PetscSFLink       *p,*lru = NULL,link;
   PetscSFDirection  direction;
   MPI_Request       *reqs = NULL;
-  PetscBool         match,rootdirect[2],leafdirect[2];
+  PetscBool         match,bound,rootdirect[2],leafdirect[2];
+  PetscInt          nbound = 0;
   PetscMemType      rootmtype = PetscMemTypeHost(xrootmtype) ? PETSC_MEMTYPE_HOST : PETSC_MEMTYPE_DEVICE; /* Convert to 0/1*/
   PetscMemType      leafmtype = PetscMemTypeHost(xleafmtype) ? PETSC_MEMTYPE_HOST : PETSC_MEMTYPE_DEVICE;
   PetscMemType      rootmtype_mpi,leafmtype_mpi;   /* mtypes seen by MPI */
   PetscInt          rootdirect_mpi,leafdirect_mpi; /* root/leafdirect seen by MPI*/
+  PetscBool         rootdtypemode = PETSC_FALSE,leafdtypemode = PETSC_FALSE,dense = PETSC_FALSE;
 
   PetscFunctionBegin;
   ierr = PetscSFSetErrorOnUnsupportedOverlap(sf,unit,rootdata,leafdata);CHKERRQ(ierr);
@@ -534,35 +699,70 @@ PetscErrorCode PetscSFLinkCreate(PetscSF sf,MPI_Datatype unit,PetscMemType xroot
   rootdirect_mpi = rootdirect[PETSCSF_REMOTE] && (rootmtype_mpi == rootmtype)? 1 : 0;
   leafdirect_mpi = leafdirect[PETSCSF_REMOTE] && (leafmtype_mpi == leafmtype)? 1 : 0;
 
+  /* Can remote root/leafdata of some ranks be directly passed to MPI with derived datatypes instead of being packed? Like rootdirect_mpi,
+     it needs persistent requests bound to the data. MPI receives directly into the data only when op is MPIU_REPLACE and no two remote
+     entries alias, and never when rootdata and leafdata are the same array, since sends would then see data being received.
+  */
+  if (sf->persistent && bas->datatypes != PETSCSF_DATATYPES_NEVER && rootmtype == PETSC_MEMTYPE_HOST && leafmtype == PETSC_MEMTYPE_HOST && rootdata != leafdata && sfop != PETSCSF_FETCH) {
+    if (!bas->dtypecalibrated) {ierr = PetscSFLinkCalibrateDatatypes(sf,unit);CHKERRQ(ierr);}
+    if (bas->nrootdtypes || bas->nleafdtypes) {ierr = PetscSFUnitIsDense_Private(unit,&dense);CHKERRQ(ierr);}
+    if (dense) {
+      rootdtypemode = (bas->nrootdtypes && !rootdirect[PETSCSF_REMOTE] && (sfop == PETSCSF_BCAST || (op == MPIU_REPLACE && bas->rootrecvok))) ? PETSC_TRUE : PETSC_FALSE;
+      leafdtypemode = (bas->nleafdtypes && !leafdirect[PETSCSF_REMOTE] && (sfop == PETSCSF_REDUCE || (op == MPIU_REPLACE && bas->leafrecvok))) ? PETSC_TRUE : PETSC_FALSE;
+      if (rootdtypemode) rootdirect_mpi = 1; /* So that the requests are bound to rootdata */
+      if (leafdtypemode) leafdirect_mpi = 1;
+    }
+  }
+
   direction = (sfop == PETSCSF_BCAST)? PETSCSF_ROOT2LEAF : PETSCSF_LEAF2ROOT;
   nrootreqs = bas->nrootreqs;
   nleafreqs = sf->nleafreqs;
 
-  /* Look for free links in cache */
+  /* Look for free links in cache. With persistent requests, a link whose requests were initialized on the same root/leafdata is
+     restarted as is. Up to PETSCSF_MAX_BOUND_LINKS links per unit are kept bound to different data, so that codes alternating
+     between a few arrays (e.g., ghost updates of several vectors) do not free and reinit requests on every call. Beyond that,
+     the least recently used free link is rebound. Link units of builtin types are the user's, so comparing handles first is cheap.
+  */
+  bound = (sf->persistent && (rootdirect_mpi || leafdirect_mpi)) ? PETSC_TRUE : PETSC_FALSE;
   for (p=&bas->avail; (link=*p); p=&link->next) {
-    ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
-    if (match) {
-      /* If root/leafdata will be directly passed to MPI, test if the data used to initialized the MPI requests matches with current.
-         If not, free old requests. New requests will be lazily init'ed until one calls PetscSFLinkGetMPIBuffersAndRequests().
-      */
-      if (rootdirect_mpi && sf->persistent && link->rootreqsinited[direction][rootmtype][1] && link->rootdatadirect[direction][rootmtype] != rootdata) {
-        reqs = link->rootreqs[direction][rootmtype][1]; /* Here, rootmtype = rootmtype_mpi */
-        for (i=0; i<nrootreqs; i++) {if (reqs[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&reqs[i]);CHKERRMPI(ierr);}}
-        link->rootreqsinited[direction][rootmtype][1] = PETSC_FALSE;
-      }
-      if (leafdirect_mpi && sf->persistent && link->leafreqsinited[direction][leafmtype][1] && link->leafdatadirect[direction][leafmtype] != leafdata) {
-        reqs = link->leafreqs[direction][leafmtype][1];
-        for (i=0; i<nleafreqs; i++) {if (reqs[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&reqs[i]);CHKERRMPI(ierr);}}
-        link->leafreqsinited[direction][leafmtype][1] = PETSC_FALSE;
-      }
-      *p = link->next; /* Remove from available list */
-      goto found;
+    if (unit == link->unit) match = PETSC_TRUE;
+    else {ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);}
+    if (!match) continue;
+    if (bound) {
+      PetscBool rootok = (!rootdirect_mpi || !link->rootreqsinited[direction][rootmtype][1] || link->rootdatadirect[direction][rootmtype] == rootdata) ? PETSC_TRUE : PETSC_FALSE;
+      PetscBool leafok = (!leafdirect_mpi || !link->leafreqsinited[direction][leafmtype][1] || link->leafdatadirect[direction][leafmtype] == leafdata) ? PETSC_TRUE : PETSC_FALSE;
+
+      if (!rootok || !leafok) {nbound++; lru = p; continue;}
     }
+    *p = link->next; /* Remove from available list */
+    goto found;
+  }
+  if (lru && nbound >= PETSCSF_MAX_BOUND_LINKS) {
+    link = *lru;
+    /* Root/leafdata will be directly passed to MPI but differ from those used to init the MPI requests, so free old requests.
+       New requests will be lazily init'ed until one calls PetscSFLinkGetMPIBuffersAndRequests().
+    */
+    if (rootdirect_mpi && link->rootreqsinited[direction][rootmtype][1] && link->rootdatadirect[direction][rootmtype] != rootdata) {
+      reqs = link->rootreqs[direction][rootmtype][1]; /* Here, rootmtype = rootmtype_mpi */
+      for (i=0; i<nrootreqs; i++) {if (reqs[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&reqs[i]);CHKERRMPI(ierr);}}
+      link->rootreqsinited[direction][rootmtype][1] = PETSC_FALSE;
+    }
+    if (leafdirect_mpi && link->leafreqsinited[direction][leafmtype][1] && link->leafdatadirect[direction][leafmtype] != leafdata) {
+      reqs = link->leafreqs[direction][leafmtype][1];
+      for (i=0; i<nleafreqs; i++) {if (reqs[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&reqs[i]);CHKERRMPI(ierr);}}
+      link->leafreqsinited[direction][leafmtype][1] = PETSC_FALSE;
+    }
+    *lru = link->next; /* Remove from available list */
+    goto found;
   }
 
   ierr = PetscNew(&link);CHKERRQ(ierr);
   ierr = PetscSFLinkSetUp_Host(sf,link,unit);CHKERRQ(ierr);
-  ierr = PetscCommGetNewTag(PetscObjectComm((PetscObject)sf),&link->tag);CHKERRQ(ierr); /* One tag per link */
+  /* Whether a free link is reused depends on which data it is bound to and on derived datatype decisions, so ranks may create different
+     numbers of links. Persistent links thus share the tag got at setup; MPI non-overtaking still matches concurrent operations, which all
+     ranks start in the same order. Otherwise, one tag per link */
+  if (sf->persistent) link->tag = bas->tag;
+  else {ierr = PetscCommGetNewTag(PetscObjectComm((PetscObject)sf),&link->tag);CHKERRQ(ierr);}
 
   nreqs = (nrootreqs+nleafreqs)*8;
   ierr  = PetscMalloc1(nreqs,&link->reqs);CHKERRQ(ierr);
@@ -650,6 +850,8 @@ found:
   }
   link->rootdirect_mpi  = rootdirect_mpi;
   link->leafdirect_mpi  = leafdirect_mpi;
+  link->rootdtypemode   = rootdtypemode;
+  link->leafdtypemode   = leafdtypemode;
   link->rootmtype       = rootmtype;
   link->leafmtype       = leafmtype;
   link->rootmtype_mpi   = rootmtype_mpi;
@@ -669,11 +871,11 @@ PetscErrorCode PetscSFLinkGetMPIBuffersAndRequests(PetscSF sf,PetscSFLink link,P
   PetscErrorCode       ierr;
   PetscSF_Basic        *bas = (PetscSF_Basic*)sf->data;
   PetscInt             i,j,nrootranks,ndrootranks,nleafranks,ndleafranks;
-  const PetscInt       *rootoffset,*leafoffset;
+  const PetscInt       *rootoffset,*leafoffset,*leafloc;
   PetscMPIInt          n;
-  MPI_Aint             disp;
+  char                 *buf;
   MPI_Comm             comm = PetscObjectComm((PetscObject)sf);
-  MPI_Datatype         unit = link->unit;
+  MPI_Datatype         unit = link->unit,dtype;
   const PetscMemType   rootmtype_mpi = link->rootmtype_mpi,leafmtype_mpi = link->leafmtype_mpi; /* Used to select buffers passed to MPI */
   const PetscInt       rootdirect_mpi = link->rootdirect_mpi,leafdirect_mpi = link->leafdirect_mpi;
 
@@ -682,36 +884,33 @@ PetscErrorCode PetscSFLinkGetMPIBuffersAndRequests(PetscSF sf,PetscSFLink link,P
   if (sf->persistent) {
     if (rootreqs && bas->rootbuflen[PETSCSF_REMOTE] && !link->rootreqsinited[direction][rootmtype_mpi][rootdirect_mpi]) {
       ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
-      if (direction == PETSCSF_LEAF2ROOT) {
-        for (i=ndrootranks,j=0; i<nrootranks; i++,j++) {
-          disp = (rootoffset[i] - rootoffset[ndrootranks])*link->unitbytes;
-          ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
-          ierr = MPI_Recv_init(link->rootbuf[PETSCSF_REMOTE][rootmtype_mpi]+disp,n,unit,bas->iranks[i],link->tag,comm,link->rootreqs[direction][rootmtype_mpi][rootdirect_mpi]+j);CHKERRMPI(ierr);
-        }
-      } else { /* PETSCSF_ROOT2LEAF */
-        for (i=ndrootranks,j=0; i<nrootranks; i++,j++) {
-          disp = (rootoffset[i] - rootoffset[ndrootranks])*link->unitbytes;
-          ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
-          ierr = MPI_Send_init(link->rootbuf[PETSCSF_REMOTE][rootmtype_mpi]+disp,n,unit,bas->iranks[i],link->tag,comm,link->rootreqs[direction][rootmtype_mpi][rootdirect_mpi]+j);CHKERRMPI(ierr);
+      if (link->rootdtypemode && !link->rootdtypes) {ierr = PetscSFLinkCreateDatatypes_Private(bas->nrootreqs,rootoffset+ndrootranks,bas->irootloc,bas->rootdtype,unit,&link->rootdtypes);CHKERRQ(ierr);}
+      for (i=ndrootranks,j=0; i<nrootranks; i++,j++) {
+        /* Ranks with a derived datatype access rootdata in place from their first root on, others use their portion of rootbuf */
+        if (link->rootdtypemode && bas->rootdtype[j]) {buf = (char*)link->rootdatadirect[direction][rootmtype_mpi] + bas->irootloc[rootoffset[i]]*link->unitbytes; n = 1; dtype = link->rootdtypes[j];}
+        else {
+          buf   = link->rootbuf[PETSCSF_REMOTE][rootmtype_mpi] + (rootoffset[i] - rootoffset[ndrootranks])*link->unitbytes;
+          dtype = unit;
+          ierr  = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
         }
+        if (direction == PETSCSF_LEAF2ROOT) {ierr = MPI_Recv_init(buf,n,dtype,bas->iranks[i],link->tag,comm,link->rootreqs[direction][rootmtype_mpi][rootdirect_mpi]+j);CHKERRMPI(ierr);}
+        else {ierr = MPI_Send_init(buf,n,dtype,bas->iranks[i],link->tag,comm,link->rootreqs[direction][rootmtype_mpi][rootdirect_mpi]+j);CHKERRMPI(ierr);} /* PETSCSF_ROOT2LEAF */
       }
       link->rootreqsinited[direction][rootmtype_mpi][rootdirect_mpi] = PETSC_TRUE;
     }
 
     if (leafreqs && sf->leafbuflen[PETSCSF_REMOTE] && !link->leafreqsinited[direction][leafmtype_mpi][leafdirect_mpi]) {
-      ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL,NULL);CHKERRQ(ierr);
-      if (direction == PETSCSF_LEAF2ROOT) {
-        for (i=ndleafranks,j=0; i<nleafranks; i++,j++) {
-          disp = (leafoffset[i] - leafoffset[ndleafranks])*link->unitbytes;
-          ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
-          ierr = MPI_Send_init(link->leafbuf[PETSCSF_REMOTE][leafmtype_mpi]+disp,n,unit,sf->ranks[i],link->tag,comm,link->leafreqs[direction][leafmtype_mpi][leafdirect_mpi]+j);CHKERRMPI(ierr);
-        }
-      } else { /* PETSCSF_ROOT2LEAF */
-        for (i=ndleafranks,j=0; i<nleafranks; i++,j++) {
-          disp = (leafoffset[i] - leafoffset[ndleafranks])*link->unitbytes;
-          ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
-          ierr = MPI_Recv_init(link->leafbuf[PETSCSF_REMOTE][leafmtype_mpi]+disp,n,unit,sf->ranks[i],link->tag,comm,link->leafreqs[direction][leafmtype_mpi][leafdirect_mpi]+j);CHKERRMPI(ierr);
+      ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,&leafloc,NULL);CHKERRQ(ierr);
+      if (link->leafdtypemode && !link->leafdtypes) {ierr = PetscSFLinkCreateDatatypes_Private(sf->nleafreqs,leafoffset+ndleafranks,leafloc,bas->leafdtype,unit,&link->leafdtypes);CHKERRQ(ierr);}
+      for (i=ndleafranks,j=0; i<nleafranks; i++,j++) {
+        if (link->leafdtypemode && bas->leafdtype[j]) {buf = (char*)link->leafdatadirect[direction][leafmtype_mpi] + leafloc[leafoffset[i]]*link->unitbytes; n = 1; dtype = link->leafdtypes[j];}
+        else {
+          buf   = link->leafbuf[PETSCSF_REMOTE][leafmtype_mpi] + (leafoffset[i] - leafoffset[ndleafranks])*link->unitbytes;
+          dtype = unit;
+          ierr  = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
         }
+        if (direction == PETSCSF_LEAF2ROOT) {ierr = MPI_Send_init(buf,n,dtype,sf->ranks[i],link->tag,comm,link->leafreqs[direction][leafmtype_mpi][leafdirect_mpi]+j);CHKERRMPI(ierr);}
+        else {ierr = MPI_Recv_init(buf,n,dtype,sf->ranks[i],link->tag,comm,link->leafreqs[direction][leafmtype_mpi][leafdirect_mpi]+j);CHKERRMPI(ierr);} /* PETSCSF_ROOT2LEAF */
       }
       link->leafreqsinited[direction][leafmtype_mpi][leafdirect_mpi] = PETSC_TRUE;
     }
@@ -734,8 +933,10 @@ PetscErrorCode PetscSFLinkGetInUse(PetscSF sf,MPI_Datatype unit,const void *root
   /* Look for types in cache */
   for (p=&bas->inuse; (link=*p); p=&link->next) {
     PetscBool match;
-    ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
-    if (match && (rootdata == link->rootdata) && (leafdata == link->leafdata)) {
+    if ((rootdata != link->rootdata) || (leafdata != link->leafdata)) continue; /* Cheap test before comparing types */
+    if (unit == link->unit) match = PETSC_TRUE;
+    else {ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);}
+    if (match) {
       switch (cmode) {
       case PETSC_OWN_POINTER: *p = link->next; break; /* Remove from inuse list */
       case PETSC_USE_POINTER: break;
@@ -777,6 +978,10 @@ PetscErrorCode PetscSFLinkDestroy(PetscSF sf,PetscSFLink *avail)
       if (link->reqs[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->reqs[i]);CHKERRMPI(ierr);}
     }
     ierr = PetscFree(link->reqs);CHKERRQ(ierr);
+    for (i=0; link->rootdtypes && i<bas->nrootreqs; i++) {if (link->rootdtypes[i] != MPI_DATATYPE_NULL) {ierr = MPI_Type_free(&link->rootdtypes[i]);CHKERRMPI(ierr);}}
+    for (i=0; link->leafdtypes && i<sf->nleafreqs; i++) {if (link->leafdtypes[i] != MPI_DATATYPE_NULL) {ierr = MPI_Type_free(&link->leafdtypes[i]);CHKERRMPI(ierr);}}
+    ierr = PetscFree(link->rootdtypes);CHKERRQ(ierr);
+    ierr = PetscFree(link->leafdtypes);CHKERRQ(ierr);
     for (i=PETSCSF_LOCAL; i<=PETSCSF_REMOTE; i++) {
       ierr = PetscFree(link->rootbuf_alloc[i][PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);
       ierr = PetscFree(link->leafbuf_alloc[i][PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);
@@ -1205,7 +1410,7 @@ PetscErrorCode PetscSFLinkPackRootData(PetscSF sf,PetscSFLink link,PetscSFScope
   PetscErrorCode   ierr;
   PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   const PetscInt   *rootindices = NULL;
-  PetscInt         count,start;
+  PetscInt         count,start,j,k;
   PetscErrorCode   (*Pack)(PetscSFLink,PetscInt,PetscInt,PetscSFPackOpt,const PetscInt*,const void*,void*) = NULL;
   PetscMemType     rootmtype = link->rootmtype;
   PetscSFPackOpt   opt = NULL;
@@ -1213,7 +1418,12 @@ PetscErrorCode PetscSFLinkPackRootData(PetscSF sf,PetscSFLink link,PetscSFScope
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
   if (scope == PETSCSF_REMOTE) {ierr = PetscSFLinkSyncDeviceBeforePackData(sf,link);CHKERRQ(ierr);}
-  if (!link->rootdirect[scope] && bas->rootbuflen[scope]) { /* If rootdata works directly as rootbuf, skip packing */
+  if (scope == PETSCSF_REMOTE && link->rootdtypemode) { /* Only pack roots of ranks not using derived datatypes */
+    for (j=0,k=bas->ndiranks; j<bas->nrootreqs; j++,k++) {
+      if (bas->rootdtype[j]) continue;
+      ierr = (*link->h_Pack)(link,bas->ioffset[k+1]-bas->ioffset[k],0,NULL,bas->irootloc+bas->ioffset[k],rootdata,link->rootbuf[scope][rootmtype]+(bas->ioffset[k]-bas->ioffset[bas->ndiranks])*link->unitbytes);CHKERRQ(ierr);
+    }
+  } else if (!link->rootdirect[scope] && bas->rootbuflen[scope]) { /* If rootdata works directly as rootbuf, skip packing */
     ierr = PetscSFLinkGetRootPackOptAndIndices(sf,link,rootmtype,scope,&count,&start,&opt,&rootindices);CHKERRQ(ierr);
     ierr = PetscSFLinkGetPack(link,rootmtype,&Pack);CHKERRQ(ierr);
     ierr = (*Pack)(link,count,start,opt,rootindices,rootdata,link->rootbuf[scope][rootmtype]);CHKERRQ(ierr);
@@ -1230,8 +1440,9 @@ PetscErrorCode PetscSFLinkPackRootData(PetscSF sf,PetscSFLink link,PetscSFScope
 PetscErrorCode PetscSFLinkPackLeafData(PetscSF sf,PetscSFLink link,PetscSFScope scope,const void *leafdata)
 {
   PetscErrorCode   ierr;
+  PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   const PetscInt   *leafindices = NULL;
-  PetscInt         count,start;
+  PetscInt         count,start,j,k;
   PetscErrorCode   (*Pack)(PetscSFLink,PetscInt,PetscInt,PetscSFPackOpt,const PetscInt*,const void*,void*) = NULL;
   PetscMemType     leafmtype = link->leafmtype;
   PetscSFPackOpt   opt = NULL;
@@ -1239,7 +1450,12 @@ PetscErrorCode PetscSFLinkPackLeafData(PetscSF sf,PetscSFLink link,PetscSFScope
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
   if (scope == PETSCSF_REMOTE) {ierr = PetscSFLinkSyncDeviceBeforePackData(sf,link);CHKERRQ(ierr);}
-  if (!link->leafdirect[scope] && sf->leafbuflen[scope]) { /* If leafdata works directly as rootbuf, skip packing */
+  if (scope == PETSCSF_REMOTE && link->leafdtypemode) { /* Only pack leaves of ranks not using derived datatypes */
+    for (j=0,k=sf->ndranks; j<sf->nleafreqs; j++,k++) {
+      if (bas->leafdtype[j]) continue;
+      ierr = (*link->h_Pack)(link,sf->roffset[k+1]-sf->roffset[k],0,NULL,sf->rmine+sf->roffset[k],leafdata,link->leafbuf[scope][leafmtype]+(sf->roffset[k]-sf->roffset[sf->ndranks])*link->unitbytes);CHKERRQ(ierr);
+    }
+  } else if (!link->leafdirect[scope] && sf->leafbuflen[scope]) { /* If leafdata works directly as rootbuf, skip packing */
     ierr = PetscSFLinkGetLeafPackOptAndIndices(sf,link,leafmtype,scope,&count,&start,&opt,&leafindices);CHKERRQ(ierr);
     ierr = PetscSFLinkGetPack(link,leafmtype,&Pack);CHKERRQ(ierr);
     ierr = (*Pack)(link,count,start,opt,leafindices,leafdata,link->leafbuf[scope][leafmtype]);CHKERRQ(ierr);
@@ -1257,7 +1473,7 @@ PetscErrorCode PetscSFLinkUnpackRootData(PetscSF sf,PetscSFLink link,PetscSFScop
 {
   PetscErrorCode   ierr;
   const PetscInt   *rootindices = NULL;
-  PetscInt         count,start;
+  PetscInt         count,start,j,k;
   PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   (*UnpackAndOp)(PetscSFLink,PetscInt,PetscInt,PetscSFPackOpt,const PetscInt*,void*,const void*) = NULL;
   PetscMemType     rootmtype = link->rootmtype;
@@ -1266,7 +1482,13 @@ PetscErrorCode PetscSFLinkUnpackRootData(PetscSF sf,PetscSFLink link,PetscSFScop
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
   if (scope == PETSCSF_REMOTE) {ierr = PetscSFLinkCopyRootBufferInCaseNotUseGpuAwareMPI(sf,link,PETSC_FALSE);CHKERRQ(ierr);}
-  if (!link->rootdirect[scope] && bas->rootbuflen[scope]) { /* If rootdata works directly as rootbuf, skip unpacking */
+  if (scope == PETSCSF_REMOTE && link->rootdtypemode) { /* Roots of ranks using derived datatypes were received in place, with op = MPIU_REPLACE */
+    ierr = PetscSFLinkGetUnpackAndOp(link,rootmtype,op,bas->rootdups[scope],&UnpackAndOp);CHKERRQ(ierr);
+    for (j=0,k=bas->ndiranks; j<bas->nrootreqs; j++,k++) {
+      if (bas->rootdtype[j]) continue;
+      ierr = (*UnpackAndOp)(link,bas->ioffset[k+1]-bas->ioffset[k],0,NULL,bas->irootloc+bas->ioffset[k],rootdata,link->rootbuf[scope][rootmtype]+(bas->ioffset[k]-bas->ioffset[bas->ndiranks])*link->unitbytes);CHKERRQ(ierr);
+    }
+  } else if (!link->rootdirect[scope] && bas->rootbuflen[scope]) { /* If rootdata works directly as rootbuf, skip unpacking */
     ierr = PetscSFLinkGetUnpackAndOp(link,rootmtype,op,bas->rootdups[scope],&UnpackAndOp);CHKERRQ(ierr);
     if (UnpackAndOp) {
       ierr = PetscSFLinkGetRootPackOptAndIndices(sf,link,rootmtype,scope,&count,&start,&opt,&rootindices);CHKERRQ(ierr);
@@ -1286,8 +1508,9 @@ PetscErrorCode PetscSFLinkUnpackRootData(PetscSF sf,PetscSFLink link,PetscSFScop
 PetscErrorCode PetscSFLinkUnpackLeafData(PetscSF sf,PetscSFLink link,PetscSFScope scope,void *leafdata,MPI_Op op)
 {
   PetscErrorCode   ierr;
+  PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   const PetscInt   *leafindices = NULL;
-  PetscInt         count,start;
+  PetscInt         count,start,j,k;
   PetscErrorCode   (*UnpackAndOp)(PetscSFLink,PetscInt,PetscInt,PetscSFPackOpt,const PetscInt*,void*,const void*) = NULL;
   PetscMemType     leafmtype = link->leafmtype;
   PetscSFPackOpt   opt = NULL;
@@ -1295,7 +1518,13 @@ PetscErrorCode PetscSFLinkUnpackLeafData(PetscSF sf,PetscSFLink link,PetscSFScop
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
   if (scope == PETSCSF_REMOTE) {ierr = PetscSFLinkCopyLeafBufferInCaseNotUseGpuAwareMPI(sf,link,PETSC_FALSE);CHKERRQ(ierr);}
-  if (!link->leafdirect[scope] && sf->leafbuflen[scope]) { /* If leafdata works directly as rootbuf, skip unpacking */
+  if (scope == PETSCSF_REMOTE && link->leafdtypemode) { /* Leaves of ranks using derived datatypes were received in place, with op = MPIU_REPLACE */
+    ierr = PetscSFLinkGetUnpackAndOp(link,leafmtype,op,sf->leafdups[scope],&UnpackAndOp);CHKERRQ(ierr);
+    for (j=0,k=sf->ndranks; j<sf->nleafreqs; j++,k++) {
+      if (bas->leafdtype[j]) continue;
+      ierr = (*UnpackAndOp)(link,sf->roffset[k+1]-sf->roffset[k],0,NULL,sf->rmine+sf->roffset[k],leafdata,link->leafbuf[scope][leafmtype]+(sf->roffset[k]-sf->roffset[sf->ndranks])*link->unitbytes);CHKERRQ(ierr);
+    }
+  } else if (!link->leafdirect[scope] && sf->leafbuflen[scope]) { /* If leafdata works directly as rootbuf, skip unpacking */
     ierr = PetscSFLinkGetUnpackAndOp(link,leafmtype,op,sf->leafdups[scope],&UnpackAndOp);CHKERRQ(ierr);
     if (UnpackAndOp) {
       ierr = PetscSFLinkGetLeafPackOptAndIndices(sf,link,leafmtype,scope,&count,&start,&opt,&leafindices);CHKERRQ(ierr);
@@ -1540,6 +1769,8 @@ PetscErrorCode PetscSFSetUpPackFields(PetscSF sf)
   PetscInt       i,j;
 
   PetscFunctionBegin;
+  /* Got at the first setup only, since VecScatterRemap() calls this on some processes only */
+  if (!bas->tag) {ierr = PetscObjectGetNewTag((PetscObject)sf,&bas->tag);CHKERRQ(ierr);}
   /* [0] for PETSCSF_LOCAL and [1] for PETSCSF_REMOTE in the following */
   for (i=0; i<2; i++) { /* Set defaults */
     sf->leafstart[i]   = 0;
@@ -1614,5 +1845,10 @@ PetscErrorCode PetscSFResetPackFields(PetscSF sf)
     ierr = PetscSFDestroyPackOpt(sf,PETSC_MEMTYPE_DEVICE,&bas->rootpackopt_d[i]);CHKERRQ(ierr);
 #endif
   }
+  ierr = PetscFree(bas->rootdtype);CHKERRQ(ierr);
+  ierr = PetscFree(bas->leafdtype);CHKERRQ(ierr);
+  bas->nrootdtypes     = bas->nleafdtypes = 0;
+  bas->rootrecvok      = bas->leafrecvok  = PETSC_FALSE;
+  bas->dtypecalibrated = PETSC_FALSE;
   PetscFunctionReturn(0);
 }
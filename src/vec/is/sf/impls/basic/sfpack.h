@@ -18,6 +18,13 @@
 typedef long long int          llint;
 typedef unsigned long long int ullint;
 
+/* Maximal number of free links of the same unit kept with persistent requests bound to different root/leafdata */
+#define PETSCSF_MAX_BOUND_LINKS 4
+
+/* With -sf_basic_datatypes auto, data smaller than this (in bytes) to/from a remote rank is always packed, since MPI derived datatypes
+   rarely pay off for small messages. Larger ones are timed once per SF to pick the faster of packing and derived datatypes. */
+#define PETSCSF_DATATYPES_MIN_BYTES 4096
+
 /* We separate SF communications for SFBasic and SFNeighbor in two parts: local (self,intra-rank) and remote (inter-rank) */
 typedef enum {PETSCSF_LOCAL=0, PETSCSF_REMOTE} PetscSFScope;
 
@@ -187,6 +194,8 @@ struct _n_PetscSFLink {
   PetscBool    rootreqsinited[2][2][2];      /* Are root requests initialized? Also in layout of [PETSCSF_DIRECTION][PETSC_MEMTYPE][rootdirect_mpi]*/
   PetscBool    leafreqsinited[2][2][2];      /* Are leaf requests initialized? Also in layout of [PETSCSF_DIRECTION][PETSC_MEMTYPE][leafdirect_mpi]*/
   MPI_Request  *reqs;                        /* An array of length (nrootreqs+nleafreqs)*8. Pointers in rootreqs[][][] and leafreqs[][][] point here */
+  PetscBool    rootdtypemode,leafdtypemode;  /* Are remote roots/leaves of some ranks directly sent/received from/to root/leafdata with derived datatypes? */
+  MPI_Datatype *rootdtypes,*leafdtypes;      /* [nrootreqs], [nleafreqs] Per-rank derived datatypes built from unit, or MPI_DATATYPE_NULL for ranks that are packed */
   PetscSFLink  next;
 };
 
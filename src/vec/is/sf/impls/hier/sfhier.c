@@ -0,0 +1,501 @@
+#include <petsc/private/sfimpl.h> /*I "petscsf.h" I*/
+
+/*
+   A hierarchical star forest splits the communicator into nodes and routes every edge through at most three
+   sub-SFs so that each pair of nodes exchanges a single message per direction:
+
+     local   - edges whose root and leaf live on the same node (on the node communicator)
+     gather  - on the node leader, copies roots referenced by other nodes into an outbox (on the node communicator)
+     leaders - moves outboxes between node leaders into inboxes (on the parent communicator)
+     scatter - spreads the inbox of a node leader to the leaves of its node (on the node communicator)
+
+   The node sub-SFs are created with the options prefix -sf_hier_node_ and the leader SF with -sf_hier_leader_, so for
+   instance -sf_hier_node_sf_type window -sf_hier_node_sf_window_flavor shared does the intra-node exchange through
+   MPI-3 shared-memory windows.
+*/
+
+typedef struct _n_PetscSFHierLink *PetscSFHierLink;
+
+struct _n_PetscSFHierLink {
+  MPI_Datatype    unit;
+  MPI_Aint        extent;
+  const void      *rootdata;   /* Keys of an operation in flight */
+  const void      *leafdata;
+  char            *inbox;
+  char            *outbox;
+  PetscSFHierLink next;
+};
+
+typedef struct {
+  PetscInt        nodesize;    /* Number of consecutive ranks per node, or 0 to detect nodes with MPI_COMM_TYPE_SHARED */
+  MPI_Comm        nodecomm;    /* Ranks on my node; rank 0 is the node leader */
+  PetscSF         local,gather,leaders,scatter;
+  PetscSF         full;        /* A basic SF with the same graph, built lazily for operations without a hierarchical variant */
+  PetscInt        ninbox;      /* Number of remote leaf values received by this node leader for its node */
+  PetscInt        noutbox;     /* Number of local root values sent by this node leader to other nodes */
+  PetscMPIInt     nnodes,maxnodesize;
+  PetscSFHierLink inuse,avail;
+} PetscSF_Hier;
+
+static PetscErrorCode PetscSFHierCreateSubSF(PetscSF sf,MPI_Comm comm,const char prefix[],PetscSF *sub)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFCreate(comm,sub);CHKERRQ(ierr);
+  ierr = PetscSFSetType(*sub,PETSCSFBASIC);CHKERRQ(ierr);
+  ierr = PetscObjectSetOptionsPrefix((PetscObject)*sub,((PetscObject)sf)->prefix);CHKERRQ(ierr);
+  ierr = PetscObjectAppendOptionsPrefix((PetscObject)*sub,prefix);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(*sub);CHKERRQ(ierr);
+  ierr = PetscSFSetAutotune(*sub,PETSC_FALSE,NULL);CHKERRQ(ierr); /* The node-local and leader SFs are not autotuned on their own */
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFHierGetFullSF(PetscSF sf,PetscSF *full)
+{
+  PetscSF_Hier   *h = (PetscSF_Hier*)sf->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!h->full) {
+    ierr = PetscSFCreate(PetscObjectComm((PetscObject)sf),&h->full);CHKERRQ(ierr);
+    ierr = PetscSFSetType(h->full,PETSCSFBASIC);CHKERRQ(ierr);
+    ierr = PetscSFSetGraph(h->full,sf->nroots,sf->nleaves,sf->mine,PETSC_COPY_VALUES,sf->remote,PETSC_COPY_VALUES);CHKERRQ(ierr);
+    ierr = PetscSFSetUp(h->full);CHKERRQ(ierr);
+  }
+  *full = h->full;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSetUp_Hier(PetscSF sf)
+{
+  PetscSF_Hier   *h = (PetscSF_Hier*)sf->data;
+  MPI_Comm       comm;
+  PetscMPIInt    size,rank,color,nsize,nrank,nto = 0,nfrom,*nodeglob,*leaders,*counts = NULL,*displs = NULL,*toranks,*fromranks,tag;
+  PetscInt       i,j,k,nlocal = 0,nremote = 0,offset = 0,*llocal,*lremote,*perm,*tocounts,*fromcounts,*sendbuf,*recvbuf;
+  PetscSFNode    *rlocal,*rremote,*inbox = NULL,*iremote;
+  MPI_Request    *reqs;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSetUpRanks(sf,MPI_GROUP_EMPTY);CHKERRQ(ierr);
+  ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRMPI(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRMPI(ierr);
+
+  /* Split the communicator into nodes, keeping the rank order so that the node leader is the lowest rank of a node */
+  if (h->nodesize > 0) color = (PetscMPIInt)(rank/h->nodesize);
+  else {
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    PetscShmComm shm;
+
+    ierr = PetscShmCommGet(comm,&shm);CHKERRQ(ierr);
+    ierr = PetscShmCommLocalToGlobal(shm,0,&color);CHKERRQ(ierr);
+#else
+    color = rank;
+#endif
+  }
+  ierr = MPI_Comm_split(comm,color,rank,&h->nodecomm);CHKERRMPI(ierr);
+  ierr = MPI_Comm_size(h->nodecomm,&nsize);CHKERRMPI(ierr);
+  ierr = MPI_Comm_rank(h->nodecomm,&nrank);CHKERRMPI(ierr);
+  ierr = PetscMalloc2(nsize,&nodeglob,size,&leaders);CHKERRQ(ierr);
+  ierr = MPI_Allgather(&rank,1,MPI_INT,nodeglob,1,MPI_INT,h->nodecomm);CHKERRMPI(ierr);
+  ierr = MPI_Allgather(&nodeglob[0],1,MPI_INT,leaders,1,MPI_INT,comm);CHKERRMPI(ierr);
+  for (i=0,h->nnodes=0; i<size; i++) if (leaders[i] == i) h->nnodes++;
+  ierr = MPIU_Allreduce(&nsize,&h->maxnodesize,1,MPI_INT,MPI_MAX,comm);CHKERRQ(ierr);
+
+  /* Split the edges into intra-node edges and edges going through the node leaders */
+  for (i=0; i<sf->nleaves; i++) {
+    if (leaders[sf->remote[i].rank] == nodeglob[0]) nlocal++;
+    else nremote++;
+  }
+  ierr = PetscMalloc1(nlocal,&llocal);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nlocal,&rlocal);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nremote,&lremote);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nremote,&rremote);CHKERRQ(ierr);
+  for (i=0,j=0,k=0; i<sf->nleaves; i++) {
+    const PetscInt leaf = sf->mine ? sf->mine[i] : i;
+
+    if (leaders[sf->remote[i].rank] == nodeglob[0]) {
+      PetscMPIInt lrank;
+
+      ierr = PetscFindMPIInt((PetscMPIInt)sf->remote[i].rank,nsize,nodeglob,&lrank);CHKERRQ(ierr);
+      llocal[j]       = leaf;
+      rlocal[j].rank  = lrank;
+      rlocal[j].index = sf->remote[i].index;
+      j++;
+    } else {
+      lremote[k] = leaf;
+      rremote[k] = sf->remote[i];
+      k++;
+    }
+  }
+  ierr = PetscSFHierCreateSubSF(sf,h->nodecomm,"sf_hier_node_",&h->local);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(h->local,sf->nroots,nlocal,llocal,PETSC_OWN_POINTER,rlocal,PETSC_OWN_POINTER);CHKERRQ(ierr);
+
+  /* Each leaf with a root on another node gets a slot in the inbox of its node leader; the leader learns the roots of its slots */
+  {
+    PetscMPIInt nrem;
+
+    ierr = PetscMPIIntCast(nremote,&nrem);CHKERRQ(ierr);
+    if (!nrank) {ierr = PetscMalloc2(nsize,&counts,nsize+1,&displs);CHKERRQ(ierr);}
+    ierr = MPI_Gather(&nrem,1,MPI_INT,counts,1,MPI_INT,0,h->nodecomm);CHKERRMPI(ierr);
+    if (!nrank) {
+      for (i=0,displs[0]=0; i<nsize; i++) displs[i+1] = displs[i]+counts[i];
+      h->ninbox = displs[nsize];
+      ierr = PetscMalloc1(h->ninbox,&inbox);CHKERRQ(ierr);
+    } else h->ninbox = 0;
+    ierr = MPI_Gatherv(rremote,nrem,MPIU_2INT,inbox,counts,displs,MPIU_2INT,0,h->nodecomm);CHKERRMPI(ierr);
+    ierr = MPI_Exscan(&nremote,&offset,1,MPIU_INT,MPI_SUM,h->nodecomm);CHKERRMPI(ierr);
+    if (!nrank) offset = 0;
+    if (!nrank) {ierr = PetscFree2(counts,displs);CHKERRQ(ierr);}
+  }
+  for (k=0; k<nremote; k++) {
+    rremote[k].rank  = 0;
+    rremote[k].index = offset+k;
+  }
+  ierr = PetscSFHierCreateSubSF(sf,h->nodecomm,"sf_hier_node_",&h->scatter);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(h->scatter,h->ninbox,nremote,lremote,PETSC_OWN_POINTER,rremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+
+  /* Leaders send (root rank, root index, inbox slot) of their slots to the leader of the node owning the root */
+  ierr = PetscMalloc2(h->ninbox,&perm,h->ninbox,&toranks);CHKERRQ(ierr);
+  for (i=0; i<h->ninbox; i++) {perm[i] = i; toranks[i] = leaders[inbox[i].rank];}
+  ierr = PetscSortMPIIntWithIntArray((PetscMPIInt)h->ninbox,toranks,perm);CHKERRQ(ierr);
+  ierr = PetscMalloc2(h->ninbox,&tocounts,3*h->ninbox,&sendbuf);CHKERRQ(ierr);
+  for (i=0; i<h->ninbox; i++) {
+    if (!i || toranks[i] != toranks[nto-1]) {toranks[nto] = toranks[i]; tocounts[nto++] = 0;}
+    tocounts[nto-1]++;
+    sendbuf[3*i+0] = inbox[perm[i]].rank;
+    sendbuf[3*i+1] = inbox[perm[i]].index;
+    sendbuf[3*i+2] = perm[i];
+  }
+  ierr = PetscFree(inbox);CHKERRQ(ierr);
+  ierr = PetscCommBuildTwoSided(comm,1,MPIU_INT,nto,toranks,tocounts,&nfrom,&fromranks,&fromcounts);CHKERRQ(ierr);
+  for (i=0,h->noutbox=0; i<nfrom; i++) h->noutbox += fromcounts[i];
+  ierr = PetscMalloc2(3*h->noutbox,&recvbuf,nto+nfrom,&reqs);CHKERRQ(ierr);
+  ierr = PetscCommGetNewTag(comm,&tag);CHKERRQ(ierr);
+  for (i=0,j=0; i<nfrom; j+=3*fromcounts[i],i++) {
+    PetscMPIInt n;
+
+    ierr = PetscMPIIntCast(3*fromcounts[i],&n);CHKERRQ(ierr);
+    ierr = MPI_Irecv(recvbuf+j,n,MPIU_INT,fromranks[i],tag,comm,&reqs[i]);CHKERRMPI(ierr);
+  }
+  for (i=0,j=0; i<nto; j+=3*tocounts[i],i++) {
+    PetscMPIInt n;
+
+    ierr = PetscMPIIntCast(3*tocounts[i],&n);CHKERRQ(ierr);
+    ierr = MPI_Isend(sendbuf+j,n,MPIU_INT,toranks[i],tag,comm,&reqs[nfrom+i]);CHKERRMPI(ierr);
+  }
+  ierr = MPI_Waitall(nto+nfrom,reqs,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+
+  /* The outbox of a leader is filled from roots on its node and sent to the inbox slots of the other leaders */
+  ierr = PetscMalloc1(h->noutbox,&iremote);CHKERRQ(ierr);
+  for (i=0; i<h->noutbox; i++) {
+    PetscMPIInt lrank;
+
+    ierr = PetscFindMPIInt((PetscMPIInt)recvbuf[3*i],nsize,nodeglob,&lrank);CHKERRQ(ierr);
+    if (lrank < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Rank %D is not on the node of this leader",recvbuf[3*i]);
+    iremote[i].rank  = lrank;
+    iremote[i].index = recvbuf[3*i+1];
+  }
+  ierr = PetscSFHierCreateSubSF(sf,h->nodecomm,"sf_hier_node_",&h->gather);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(h->gather,sf->nroots,h->noutbox,NULL,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscMalloc1(h->noutbox,&iremote);CHKERRQ(ierr);
+  for (i=0,k=0; i<nfrom; i++) {
+    for (j=0; j<fromcounts[i]; j++,k++) {
+      iremote[k].rank  = fromranks[i];
+      iremote[k].index = recvbuf[3*k+2];
+    }
+  }
+  ierr = PetscSFHierCreateSubSF(sf,comm,"sf_hier_leader_",&h->leaders);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(h->leaders,h->ninbox,h->noutbox,NULL,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+
+  ierr = PetscSFSetUp(h->local);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(h->gather);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(h->leaders);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(h->scatter);CHKERRQ(ierr);
+  ierr = PetscInfo4(sf,"Node of %d ranks: %D intra-node leaves, %D leaves through the node leader, leader sends %D values\n",nsize,nlocal,nremote,h->noutbox);CHKERRQ(ierr);
+
+  ierr = PetscFree2(recvbuf,reqs);CHKERRQ(ierr);
+  ierr = PetscFree(fromranks);CHKERRQ(ierr);
+  ierr = PetscFree(fromcounts);CHKERRQ(ierr);
+  ierr = PetscFree2(tocounts,sendbuf);CHKERRQ(ierr);
+  ierr = PetscFree2(perm,toranks);CHKERRQ(ierr);
+  ierr = PetscFree2(nodeglob,leaders);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Get inbox/outbox buffers for an operation on (unit,rootdata,leafdata), reusing freed buffers so that persistent requests of the sub-SFs stay valid */
+static PetscErrorCode PetscSFHierGetLink(PetscSF sf,MPI_Datatype unit,const void *rootdata,const void *leafdata,PetscSFHierLink *mylink)
+{
+  PetscSF_Hier    *h = (PetscSF_Hier*)sf->data;
+  PetscSFHierLink link,*p;
+  MPI_Aint        lb,extent;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  for (link=h->inuse; link; link=link->next) {
+    if (link->unit == unit && link->rootdata == rootdata && link->leafdata == leafdata) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Communication already in progress on rootdata %p and leafdata %p",rootdata,leafdata);
+  }
+  ierr = MPI_Type_get_extent(unit,&lb,&extent);CHKERRMPI(ierr);
+  for (p=&h->avail; *p; p=&(*p)->next) if ((*p)->unit == unit && (*p)->extent >= extent) break;
+  if (!*p) for (p=&h->avail; *p; p=&(*p)->next) if ((*p)->extent >= extent) break;
+  if (*p) {
+    link = *p;
+    *p   = link->next;
+  } else {
+    ierr = PetscNew(&link);CHKERRQ(ierr);
+    ierr = PetscMalloc2(h->ninbox*extent,&link->inbox,h->noutbox*extent,&link->outbox);CHKERRQ(ierr);
+    link->extent = extent;
+  }
+  link->unit     = unit;
+  link->rootdata = rootdata;
+  link->leafdata = leafdata;
+  link->next     = h->inuse;
+  h->inuse       = link;
+  *mylink        = link;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFHierGetInUse(PetscSF sf,MPI_Datatype unit,const void *rootdata,const void *leafdata,PetscSFHierLink *mylink)
+{
+  PetscSF_Hier    *h = (PetscSF_Hier*)sf->data;
+  PetscSFHierLink *p;
+
+  PetscFunctionBegin;
+  for (p=&h->inuse; *p; p=&(*p)->next) {
+    if ((*p)->unit == unit && (*p)->rootdata == rootdata && (*p)->leafdata == leafdata) {
+      *mylink = *p;
+      *p      = (*mylink)->next;
+      PetscFunctionReturn(0);
+    }
+  }
+  SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Could not find communication in progress on rootdata %p and leafdata %p",rootdata,leafdata);
+}
+
+static PetscErrorCode PetscSFHierReclaimLink(PetscSF sf,PetscSFHierLink link)
+{
+  PetscSF_Hier *h = (PetscSF_Hier*)sf->data;
+
+  PetscFunctionBegin;
+  link->rootdata = NULL;
+  link->leafdata = NULL;
+  link->next     = h->avail;
+  h->avail       = link;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpBegin_Hier(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,void *leafdata,MPI_Op op)
+{
+  PetscSF_Hier    *h = (PetscSF_Hier*)sf->data;
+  PetscSFHierLink link;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierGetLink(sf,unit,rootdata,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpBegin(h->local,unit,rootdata,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(h->gather,unit,rootdata,link->outbox);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(h->gather,unit,rootdata,link->outbox);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(h->leaders,unit,link->outbox,link->inbox,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpEnd_Hier(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscSF_Hier    *h = (PetscSF_Hier*)sf->data;
+  PetscSFHierLink link;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierGetInUse(sf,unit,rootdata,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(h->leaders,unit,link->outbox,link->inbox,MPIU_REPLACE);CHKERRQ(ierr);
+  /* Finish the intra-node part before the scatter also updates leafdata */
+  ierr = PetscSFBcastAndOpEnd(h->local,unit,rootdata,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpBegin(h->scatter,unit,link->inbox,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpEnd(h->scatter,unit,link->inbox,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFHierReclaimLink(sf,link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Hier(PetscSF sf,MPI_Datatype unit,PetscMemType leafmtype,const void *leafdata,PetscMemType rootmtype,void *rootdata,MPI_Op op)
+{
+  PetscSF_Hier    *h = (PetscSF_Hier*)sf->data;
+  PetscSFHierLink link;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierGetLink(sf,unit,rootdata,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(h->local,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(h->scatter,unit,leafdata,link->inbox,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(h->scatter,unit,leafdata,link->inbox,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(h->leaders,unit,link->inbox,link->outbox);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Hier(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_Hier    *h = (PetscSF_Hier*)sf->data;
+  PetscSFHierLink link;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierGetInUse(sf,unit,rootdata,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(h->leaders,unit,link->inbox,link->outbox);CHKERRQ(ierr);
+  /* Finish the intra-node part before the gather also updates rootdata */
+  ierr = PetscSFReduceEnd(h->local,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(h->gather,unit,link->outbox,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(h->gather,unit,link->outbox,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFHierReclaimLink(sf,link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Fetch-and-op needs atomicity over all leaves of a root, so it is done by a basic SF with the same graph */
+static PetscErrorCode PetscSFFetchAndOpBegin_Hier(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,void *rootdata,PetscMemType leafmtype,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscSF        full;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierGetFullSF(sf,&full);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpBegin(full,unit,rootdata,leafdata,leafupdate,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpEnd_Hier(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscSF        full;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierGetFullSF(sf,&full);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpEnd(full,unit,rootdata,leafdata,leafupdate,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFGetLeafRanks_Hier(PetscSF sf,PetscInt *niranks,const PetscMPIInt **iranks,const PetscInt **ioffset,const PetscInt **irootloc)
+{
+  PetscSF        full;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierGetFullSF(sf,&full);CHKERRQ(ierr);
+  ierr = PetscSFGetLeafRanks(full,niranks,iranks,ioffset,irootloc);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSetFromOptions_Hier(PetscOptionItems *PetscOptionsObject,PetscSF sf)
+{
+  PetscSF_Hier   *h = (PetscSF_Hier*)sf->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Hier options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-sf_hier_node_size","Number of consecutive ranks forming a node, 0 to detect shared-memory nodes","PETSCSFHIER",h->nodesize,&h->nodesize,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFView_Hier(PetscSF sf,PetscViewer viewer)
+{
+  PetscSF_Hier   *h = (PetscSF_Hier*)sf->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    if (sf->setupcalled) {ierr = PetscViewerASCIIPrintf(viewer,"  nodes=%d max node size=%d sort=%s\n",h->nnodes,h->maxnodesize,sf->rankorder ? "rank-order" : "unordered");CHKERRQ(ierr);}
+    else {ierr = PetscViewerASCIIPrintf(viewer,"  sort=%s\n",sf->rankorder ? "rank-order" : "unordered");CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_Hier(PetscSF sf)
+{
+  PetscSF_Hier    *h = (PetscSF_Hier*)sf->data;
+  PetscSFHierLink link,next;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  if (h->inuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Communication is still in progress");
+  for (link=h->avail; link; link=next) {
+    next = link->next;
+    ierr = PetscFree2(link->inbox,link->outbox);CHKERRQ(ierr);
+    ierr = PetscFree(link);CHKERRQ(ierr);
+  }
+  h->avail = NULL;
+  ierr = PetscSFDestroy(&h->local);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&h->gather);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&h->leaders);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&h->scatter);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&h->full);CHKERRQ(ierr);
+  if (h->nodecomm != MPI_COMM_NULL) {ierr = MPI_Comm_free(&h->nodecomm);CHKERRMPI(ierr);}
+  h->ninbox  = 0;
+  h->noutbox = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_Hier(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Hier(sf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDuplicate_Hier(PetscSF sf,PetscSFDuplicateOption opt,PetscSF newsf)
+{
+  PetscSF_Hier *h = (PetscSF_Hier*)sf->data,*newh = (PetscSF_Hier*)newsf->data;
+
+  PetscFunctionBegin;
+  newh->nodesize = h->nodesize;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   PETSCSFHIER - A PetscSF implementation that exploits the node topology of the communicator.
+
+   Edges between ranks on the same node are handled by an SF on the node communicator, while the values of all
+   edges between two nodes are aggregated by the node leaders (the lowest rank of each node) into a single message.
+   This reduces the number of inter-node messages from one per pair of ranks to one per pair of nodes.
+
+   Options Database Keys:
++  -sf_hier_node_size <n> - number of consecutive ranks forming a node, or 0 (default) to use the shared-memory nodes given by MPI_COMM_TYPE_SHARED
+.  -sf_hier_node_sf_type <type> - type of the SFs exchanging data within a node, for instance window with -sf_hier_node_sf_window_flavor shared
+-  -sf_hier_leader_sf_type <type> - type of the SF exchanging data between node leaders
+
+   Notes:
+   PetscSFFetchAndOpBegin() is done by a PETSCSFBASIC SF with the same graph.
+
+   Level: advanced
+
+.seealso: PetscSFCreate(), PetscSFSetType(), PETSCSFBASIC, PETSCSFWINDOW, PetscShmCommGet()
+M*/
+
+PETSC_INTERN PetscErrorCode PetscSFCreate_Hier(PetscSF sf)
+{
+  PetscSF_Hier   *h;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  sf->ops->SetUp           = PetscSFSetUp_Hier;
+  sf->ops->SetFromOptions  = PetscSFSetFromOptions_Hier;
+  sf->ops->Reset           = PetscSFReset_Hier;
+  sf->ops->Destroy         = PetscSFDestroy_Hier;
+  sf->ops->View            = PetscSFView_Hier;
+  sf->ops->Duplicate       = PetscSFDuplicate_Hier;
+  sf->ops->BcastAndOpBegin = PetscSFBcastAndOpBegin_Hier;
+  sf->ops->BcastAndOpEnd   = PetscSFBcastAndOpEnd_Hier;
+  sf->ops->ReduceBegin     = PetscSFReduceBegin_Hier;
+  sf->ops->ReduceEnd       = PetscSFReduceEnd_Hier;
+  sf->ops->FetchAndOpBegin = PetscSFFetchAndOpBegin_Hier;
+  sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_Hier;
+  sf->ops->GetLeafRanks    = PetscSFGetLeafRanks_Hier;
+
+  ierr = PetscNewLog(sf,&h);CHKERRQ(ierr);
+  sf->data    = (void*)h;
+  h->nodecomm = MPI_COMM_NULL;
+  PetscFunctionReturn(0);
+}
@@ -20,6 +20,7 @@ PetscLogEvent PETSCSF_SectSF;
 PetscLogEvent PETSCSF_RemoteOff;
 PetscLogEvent PETSCSF_Pack;
 PetscLogEvent PETSCSF_Unpack;
+PetscLogEvent PETSCSF_Autotune;
 
 /*@C
    PetscSFInitializePackage - Initialize SF package
@@ -60,6 +61,7 @@ PetscErrorCode PetscSFInitializePackage(void)
   ierr = PetscLogEventRegister("SFRemoteOff"    , PETSCSF_CLASSID, &PETSCSF_RemoteOff);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("SFPack"         , PETSCSF_CLASSID, &PETSCSF_Pack);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("SFUnpack"       , PETSCSF_CLASSID, &PETSCSF_Unpack);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("SFAutotune"     , PETSCSF_CLASSID, &PETSCSF_Autotune);CHKERRQ(ierr);
   /* Process Info */
   {
     PetscClassId  classids[1];
@@ -101,6 +101,7 @@ PetscErrorCode PetscSFCreate(MPI_Comm comm,PetscSF *sf)
   b->ingroup   = MPI_GROUP_NULL;
   b->outgroup  = MPI_GROUP_NULL;
   b->graphset  = PETSC_FALSE;
+  b->autotunereps = 5;
 #if defined(PETSC_HAVE_DEVICE)
   b->use_gpu_aware_mpi    = use_gpu_aware_mpi;
   b->use_stream_aware_mpi = PETSC_FALSE;
@@ -181,6 +182,7 @@ PetscErrorCode PetscSFReset(PetscSF sf)
    Notes:
    See "include/petscsf.h" for available methods (for instance)
 +    PETSCSFWINDOW - MPI-2/3 one-sided
+.    PETSCSFHIER - node-aware aggregation of the messages between nodes
 -    PETSCSFBASIC - basic implementation using MPI-1 two-sided
 
   Level: intermediate
@@ -257,6 +259,8 @@ PetscErrorCode PetscSFDestroy(PetscSF *sf)
   if ((*sf)->ops->Destroy) {ierr = (*(*sf)->ops->Destroy)(*sf);CHKERRQ(ierr);}
   ierr = PetscSFDestroy(&(*sf)->vscat.lsf);CHKERRQ(ierr);
   if ((*sf)->vscat.bs > 1) {ierr = MPI_Type_free(&(*sf)->vscat.unit);CHKERRMPI(ierr);}
+  ierr = PetscFree((*sf)->autotunetypes);CHKERRQ(ierr);
+  ierr = PetscFree((*sf)->autotunechoice);CHKERRQ(ierr);
   ierr = PetscHeaderDestroy(sf);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -306,6 +310,7 @@ PetscErrorCode PetscSFSetUp(PetscSF sf)
   if (sf->setupcalled) PetscFunctionReturn(0);
   ierr = PetscLogEventBegin(PETSCSF_SetUp,sf,0,0,0);CHKERRQ(ierr);
   ierr = PetscSFCheckGraphValid_Private(sf);CHKERRQ(ierr);
+  if (sf->autotune && sf->pattern == PETSCSF_PATTERN_GENERAL) {ierr = PetscSFAutotune_Private(sf);CHKERRQ(ierr);}
   if (!((PetscObject)sf)->type_name) {ierr = PetscSFSetType(sf,PETSCSFBASIC);CHKERRQ(ierr);} /* Zero all sf->ops */
   if (sf->ops->SetUp) {ierr = (*sf->ops->SetUp)(sf);CHKERRQ(ierr);}
 #if defined(PETSC_HAVE_CUDA)
@@ -344,11 +349,17 @@ PetscErrorCode PetscSFSetUp(PetscSF sf)
    Options Database Keys:
 +  -sf_type               - implementation type, see PetscSFSetType()
 .  -sf_rank_order         - sort composite points for gathers and scatters in rank order, gathers are non-deterministic otherwise
+.  -sf_autotune           - choose the type in PetscSFSetUp() by timing candidate types on the graph, see PetscSFSetAutotune()
+.  -sf_autotune_types <basic,neighbor> - comma-separated candidate types for -sf_autotune
+.  -sf_autotune_reps <5>  - number of timed communication rounds per candidate
+.  -sf_autotune_choice <type> - choose this candidate without timing, for testing
 .  -sf_use_default_stream - Assume callers of SF computed the input root/leafdata with the default cuda stream. SF will also
                             use the default stream to process data. Therefore, no stream synchronization is needed between SF and its caller (default: true).
                             If true, this option only works with -use_gpu_aware_mpi 1.
 .  -sf_use_stream_aware_mpi  - Assume the underlying MPI is cuda-stream aware and SF won't sync streams for send/recv buffers passed to MPI (default: false).
                                If true, this option only works with -use_gpu_aware_mpi 1.
+.  -sf_basic_datatypes <auto,never,always> - With -sf_type basic, send/receive data of remote ranks directly from/to host root/leafdata with MPI derived
+                               datatypes instead of packing it. auto decides per rank by timing both once per SF (default: auto).
 
 -  -sf_backend cuda | hip | kokkos -Select the device backend SF uses. Currently SF has these backends: cuda, hip and Kokkos.
                               On CUDA (HIP) devices, one can choose cuda (hip) or kokkos with the default being kokkos. On other devices,
@@ -370,6 +381,22 @@ PetscErrorCode PetscSFSetFromOptions(PetscSF sf)
   ierr = PetscOptionsFList("-sf_type","PetscSF implementation type","PetscSFSetType",PetscSFList,deft,type,sizeof(type),&flg);CHKERRQ(ierr);
   ierr = PetscSFSetType(sf,flg ? type : deft);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-sf_rank_order","sort composite points for gathers and scatters in rank order, gathers are non-deterministic otherwise","PetscSFSetRankOrder",sf->rankorder,&sf->rankorder,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-sf_autotune","Choose the type in PetscSFSetUp() by timing candidate types on the graph","PetscSFSetAutotune",sf->autotune,&sf->autotune,NULL);CHKERRQ(ierr);
+  if (sf->autotune) {
+    char types[256];
+
+    ierr = PetscOptionsString("-sf_autotune_types","Comma-separated candidate types","PetscSFSetAutotune",sf->autotunetypes,types,sizeof(types),&flg);CHKERRQ(ierr);
+    if (flg) {
+      ierr = PetscFree(sf->autotunetypes);CHKERRQ(ierr);
+      ierr = PetscStrallocpy(types,&sf->autotunetypes);CHKERRQ(ierr);
+    }
+    ierr = PetscOptionsInt("-sf_autotune_reps","Number of timed communication rounds per candidate","PetscSFSetAutotune",sf->autotunereps,&sf->autotunereps,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsString("-sf_autotune_choice","Candidate to choose without timing, for testing","PetscSFSetAutotune",sf->autotunechoice,types,sizeof(types),&flg);CHKERRQ(ierr);
+    if (flg) {
+      ierr = PetscFree(sf->autotunechoice);CHKERRQ(ierr);
+      ierr = PetscStrallocpy(types,&sf->autotunechoice);CHKERRQ(ierr);
+    }
+  }
 #if defined(PETSC_HAVE_DEVICE)
   {
     char        backendstr[32] = {0};
@@ -883,6 +910,7 @@ PetscErrorCode PetscSFView(PetscSF sf,PetscViewer viewer)
 
     ierr = PetscObjectPrintClassNamePrefixType((PetscObject)sf,viewer);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+    if (sf->autotune) {ierr = PetscViewerASCIIPrintf(viewer,"Type chosen by autotuning among %s\n",sf->autotunetypes ? sf->autotunetypes : "the default candidates");CHKERRQ(ierr);}
     if (sf->ops->View) {ierr = (*sf->ops->View)(sf,viewer);CHKERRQ(ierr);}
     if (sf->pattern == PETSCSF_PATTERN_GENERAL) {
       if (!sf->graphset) {
@@ -0,0 +1,521 @@
+#include <petsc/private/sfimpl.h> /*I "petscsf.h" I*/
+
+/* One operation enqueued on a batch. For a Bcast data flows from roots to leaves, for a Reduce from leaves to roots. */
+typedef struct {
+  PetscSF      sf;
+  MPI_Datatype unit;
+  MPI_Op       op;
+  PetscBool    reduce;    /* Is this a Reduce (leaves to roots)? */
+  const void   *src;      /* rootdata of a Bcast or leafdata of a Reduce */
+  void         *dst;      /* leafdata of a Bcast or rootdata of a Reduce */
+  PetscBool    fused;     /* Is the operation communicated in the combined messages? Otherwise it is done with its own SF calls */
+  size_t       unitbytes;
+  PetscInt     bs;        /* Number of PetscScalars in unit when op is MPIU_SUM */
+  PetscInt     sstart,rstart,rend; /* Ranges in the plan's bufoff[] of the offsets of the data sent to and received from each rank */
+} PetscSFBatchOp;
+
+/* A function run once the operations of the batch are complete, for instance to restore the arrays of vectors */
+typedef struct {
+  PetscErrorCode (*hook)(void*);
+  void           *ctx;
+} PetscSFBatchHook;
+
+struct _n_PetscSFBatch {
+  MPI_Comm       comm;    /* Inner PETSc communicator, on which the combined messages are sent */
+  PetscMPIInt    tag;
+  PetscBool      started; /* Between PetscSFBatchBegin() and PetscSFBatchEnd() */
+  PetscInt       nops,maxops;
+  PetscSFBatchOp *ops;
+  PetscInt       nhooks,maxhooks;
+  PetscSFBatchHook *hooks;            /* Run in order after the operations are complete */
+
+  /* Plan of the combined communication round, rebuilt by each PetscSFBatchBegin() */
+  PetscInt       nnbrs,maxnbrs;
+  PetscMPIInt    *nbrs;              /* Sorted ranks exchanging data with me in any fused operation, including myself */
+  size_t         *sendoff,*recvoff;  /* Byte offsets of the message to/from each neighbor in sendbuf/recvbuf, of length nnbrs+1 */
+  size_t         *bufoff;            /* Byte offset in sendbuf/recvbuf of the data of each fused operation for each of its ranks */
+  PetscInt       *bufnbr;            /* Neighbor index of these ranks, only used while building the plan */
+  char           *sendbuf,*recvbuf;
+  size_t         sendcap,recvcap;
+  MPI_Request    *reqs;              /* Receive requests followed by send requests */
+  PetscMPIInt    nrecvreqs,nsendreqs;
+};
+
+/*@C
+   PetscSFBatchCreate - Creates a batch that combines several PetscSF Bcast and Reduce operations into one communication round
+
+   Collective
+
+   Input Arguments:
+.  comm - communicator of the star forests whose operations will be enqueued
+
+   Output Arguments:
+.  batch - the new batch
+
+   Notes:
+   Operations are enqueued with PetscSFBatchAddBcast() and PetscSFBatchAddReduce(), possibly on different star forests and
+   with different MPI datatypes, and are then executed together between PetscSFBatchBegin() and PetscSFBatchEnd(). All
+   data that fused operations send to the same rank travels in a single message, so a multiphysics code updating ghost
+   values of several fields pays the message latency once per neighbor instead of once per field and neighbor.
+
+   Level: advanced
+
+.seealso: PetscSFBatchDestroy(), PetscSFBatchAddBcast(), PetscSFBatchAddReduce(), PetscSFBatchBegin(), PetscSFBatchEnd()
+@*/
+PetscErrorCode PetscSFBatchCreate(MPI_Comm comm,PetscSFBatch *batch)
+{
+  PetscSFBatch   b;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(batch,2);
+  ierr = PetscSFInitializePackage();CHKERRQ(ierr);
+  ierr = PetscNew(&b);CHKERRQ(ierr);
+  ierr = PetscCommDuplicate(comm,&b->comm,&b->tag);CHKERRQ(ierr);
+  *batch = b;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFBatchDestroy - Destroys a batch created with PetscSFBatchCreate()
+
+   Collective
+
+   Input Arguments:
+.  batch - the batch
+
+   Level: advanced
+
+.seealso: PetscSFBatchCreate()
+@*/
+PetscErrorCode PetscSFBatchDestroy(PetscSFBatch *batch)
+{
+  PetscSFBatch   b;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!batch || !*batch) PetscFunctionReturn(0);
+  b = *batch;
+  if (b->started) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot destroy a batch between PetscSFBatchBegin() and PetscSFBatchEnd()");
+  for (i=0; i<b->nops; i++) {ierr = PetscSFDestroy(&b->ops[i].sf);CHKERRQ(ierr);}
+  for (i=0; i<b->nhooks; i++) {ierr = (*b->hooks[i].hook)(b->hooks[i].ctx);CHKERRQ(ierr);}
+  ierr = PetscFree(b->ops);CHKERRQ(ierr);
+  ierr = PetscFree(b->hooks);CHKERRQ(ierr);
+  ierr = PetscFree6(b->nbrs,b->sendoff,b->recvoff,b->reqs,b->bufoff,b->bufnbr);CHKERRQ(ierr);
+  ierr = PetscFree(b->sendbuf);CHKERRQ(ierr);
+  ierr = PetscFree(b->recvbuf);CHKERRQ(ierr);
+  ierr = PetscCommDestroy(&b->comm);CHKERRQ(ierr);
+  ierr = PetscFree(*batch);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Decide whether an operation can travel in the combined messages. The decision only depends on data that is the same
+   on all ranks (SF type, unit and op), so that senders and receivers agree on the message layout. */
+static PetscErrorCode PetscSFBatchOpSetUp_Private(PetscSFBatch b,PetscSFBatchOp *o)
+{
+  PetscBool      general;
+  PetscMPIInt    size,result;
+  MPI_Aint       lb,extent;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_compare(PetscObjectComm((PetscObject)o->sf),b->comm,&result);CHKERRMPI(ierr);
+  if (result != MPI_IDENT && result != MPI_CONGRUENT) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_NOTSAMECOMM,"The PetscSF and the batch must be on the same communicator");
+  ierr = PetscSFSetUp(o->sf);CHKERRQ(ierr);
+  o->fused = PETSC_FALSE;
+  /* The root and leaf ranks of these types list matching indices in matching order on both sides of each message */
+  ierr = PetscObjectTypeCompareAny((PetscObject)o->sf,&general,PETSCSFBASIC,PETSCSFNEIGHBOR,"");CHKERRQ(ierr);
+  if (!general || o->sf->pattern != PETSCSF_PATTERN_GENERAL) PetscFunctionReturn(0);
+  ierr = MPI_Type_size(o->unit,&size);CHKERRMPI(ierr);
+  ierr = MPI_Type_get_extent(o->unit,&lb,&extent);CHKERRMPI(ierr);
+  if (lb != 0 || (MPI_Aint)size != extent) PetscFunctionReturn(0);
+  o->unitbytes = (size_t)size;
+  if (o->op == MPIU_REPLACE) o->fused = PETSC_TRUE;
+  else if (o->op == MPIU_SUM) {
+    ierr = MPIPetsc_Type_compare_contig(o->unit,MPIU_SCALAR,&o->bs);CHKERRQ(ierr);
+    if (o->bs > 0) o->fused = PETSC_TRUE;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBatchAdd_Private(PetscSFBatch b,PetscSF sf,MPI_Datatype unit,const void *src,void *dst,MPI_Op op,PetscBool reduce)
+{
+  PetscSFBatchOp *o;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (b->started) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot add operations to a batch between PetscSFBatchBegin() and PetscSFBatchEnd()");
+  if (b->nops == b->maxops) {
+    PetscSFBatchOp *ops;
+
+    b->maxops = PetscMax(4,2*b->maxops);
+    ierr = PetscMalloc1(b->maxops,&ops);CHKERRQ(ierr);
+    ierr = PetscArraycpy(ops,b->ops,b->nops);CHKERRQ(ierr);
+    ierr = PetscFree(b->ops);CHKERRQ(ierr);
+    b->ops = ops;
+  }
+  o         = &b->ops[b->nops];
+  ierr      = PetscMemzero(o,sizeof(*o));CHKERRQ(ierr);
+  o->sf     = sf;
+  o->unit   = unit;
+  o->op     = op;
+  o->reduce = reduce;
+  o->src    = src;
+  o->dst    = dst;
+  ierr      = PetscSFBatchOpSetUp_Private(b,o);CHKERRQ(ierr);
+  ierr      = PetscObjectReference((PetscObject)sf);CHKERRQ(ierr);
+  b->nops++;
+  PetscFunctionReturn(0);
+}
+
+/* Adds a function run by PetscSFBatchEnd(), after the operations added so far are complete, or by PetscSFBatchDestroy() if
+   the batch is never executed. Hooks are run in the order they were added. */
+PetscErrorCode PetscSFBatchAddEndHook_Private(PetscSFBatch b,PetscErrorCode (*hook)(void*),void *ctx)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (b->started) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot add hooks to a batch between PetscSFBatchBegin() and PetscSFBatchEnd()");
+  if (b->nhooks == b->maxhooks) {
+    PetscSFBatchHook *hooks;
+
+    b->maxhooks = PetscMax(4,2*b->maxhooks);
+    ierr = PetscMalloc1(b->maxhooks,&hooks);CHKERRQ(ierr);
+    ierr = PetscArraycpy(hooks,b->hooks,b->nhooks);CHKERRQ(ierr);
+    ierr = PetscFree(b->hooks);CHKERRQ(ierr);
+    b->hooks = hooks;
+  }
+  b->hooks[b->nhooks].hook = hook;
+  b->hooks[b->nhooks].ctx  = ctx;
+  b->nhooks++;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFBatchAddBcast - Enqueues a broadcast of rootdata to leafdata, reduced with op, on a batch
+
+   Logically Collective
+
+   Input Arguments:
++  batch - the batch
+.  sf - star forest on which to communicate
+.  unit - data type associated with each node
+.  rootdata - buffer to broadcast
+.  leafdata - buffer to be reduced with values from each leaf's respective root
+-  op - operation to use for reduction, such as MPIU_REPLACE
+
+   Notes:
+   The operation is only executed by PetscSFBatchBegin() and PetscSFBatchEnd(), so the buffers must stay valid and untouched
+   until PetscSFBatchEnd() returns. All ranks of the communicator must add the same sequence of operations.
+
+   Operations on PETSCSFBASIC and PETSCSFNEIGHBOR star forests with MPIU_REPLACE, or with MPIU_SUM on units of PetscScalars, are
+   fused into the combined messages and require host memory. Other operations are executed with their own PetscSF calls inside
+   the same Begin/End pair.
+
+   Level: advanced
+
+.seealso: PetscSFBatchCreate(), PetscSFBatchAddReduce(), PetscSFBatchBegin(), PetscSFBcastAndOpBegin()
+@*/
+PetscErrorCode PetscSFBatchAddBcast(PetscSFBatch batch,PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(batch,1);
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,2);
+  ierr = PetscSFBatchAdd_Private(batch,sf,unit,rootdata,leafdata,op,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFBatchAddReduce - Enqueues a reduction of leafdata into rootdata on a batch
+
+   Logically Collective
+
+   Input Arguments:
++  batch - the batch
+.  sf - star forest on which to communicate
+.  unit - data type associated with each node
+.  leafdata - values to reduce
+.  rootdata - result of reduction of values from all leaves of each root
+-  op - reduction operation, such as MPIU_SUM
+
+   Notes:
+   See PetscSFBatchAddBcast() for the lifetime of the buffers and which operations are fused.
+
+   Level: advanced
+
+.seealso: PetscSFBatchCreate(), PetscSFBatchAddBcast(), PetscSFBatchBegin(), PetscSFReduceBegin()
+@*/
+PetscErrorCode PetscSFBatchAddReduce(PetscSFBatch batch,PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(batch,1);
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,2);
+  ierr = PetscSFBatchAdd_Private(batch,sf,unit,leafdata,rootdata,op,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Ranks and indices of the sending and receiving sides of an operation */
+static PetscErrorCode PetscSFBatchOpGetSides_Private(PetscSFBatchOp *o,PetscInt *nsend,const PetscMPIInt **sranks,const PetscInt **soffset,const PetscInt **sidx,PetscInt *nrecv,const PetscMPIInt **rranks,const PetscInt **roffset,const PetscInt **ridx)
+{
+  PetscInt          nroot,nleaf;
+  const PetscMPIInt *rootranks,*leafranks;
+  const PetscInt    *rootoffset,*leafoffset,*rootloc,*leafloc;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  /* Ranks owning roots of my leaves, and ranks having leaves on my roots */
+  ierr = PetscSFGetRootRanks(o->sf,&nleaf,&leafranks,&leafoffset,&leafloc,NULL);CHKERRQ(ierr);
+  ierr = PetscSFGetLeafRanks(o->sf,&nroot,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
+  if (o->reduce) {
+    *nsend = nleaf; *sranks = leafranks; *soffset = leafoffset; *sidx = leafloc;
+    *nrecv = nroot; *rranks = rootranks; *roffset = rootoffset; *ridx = rootloc;
+  } else {
+    *nsend = nroot; *sranks = rootranks; *soffset = rootoffset; *sidx = rootloc;
+    *nrecv = nleaf; *rranks = leafranks; *roffset = leafoffset; *ridx = leafloc;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBatchSetUpPlan_Private(PetscSFBatch b)
+{
+  PetscInt          i,j,k,n,nsend,nrecv;
+  const PetscMPIInt *sranks,*rranks;
+  const PetscInt    *soffset,*roffset,*sidx,*ridx;
+  PetscMPIInt       *nbrs;
+  size_t            *sendlen,*recvlen;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  /* Gather the union of the neighbors of all fused operations */
+  for (i=0,n=0; i<b->nops; i++) {
+    PetscSFBatchOp *o = &b->ops[i];
+
+    if (!o->fused) continue;
+    ierr      = PetscSFBatchOpGetSides_Private(o,&nsend,&sranks,&soffset,&sidx,&nrecv,&rranks,&roffset,&ridx);CHKERRQ(ierr);
+    o->sstart = n;
+    o->rstart = n+nsend;
+    o->rend   = n+nsend+nrecv;
+    n         = o->rend;
+  }
+  if (n > b->maxnbrs) {
+    ierr       = PetscFree6(b->nbrs,b->sendoff,b->recvoff,b->reqs,b->bufoff,b->bufnbr);CHKERRQ(ierr);
+    b->maxnbrs = PetscMax(n,2*b->maxnbrs);
+    ierr       = PetscMalloc6(b->maxnbrs,&b->nbrs,b->maxnbrs+1,&b->sendoff,b->maxnbrs+1,&b->recvoff,2*b->maxnbrs,&b->reqs,b->maxnbrs,&b->bufoff,b->maxnbrs,&b->bufnbr);CHKERRQ(ierr);
+  }
+  nbrs = b->nbrs;
+  for (i=0,n=0; i<b->nops; i++) {
+    if (!b->ops[i].fused) continue;
+    ierr = PetscSFBatchOpGetSides_Private(&b->ops[i],&nsend,&sranks,&soffset,&sidx,&nrecv,&rranks,&roffset,&ridx);CHKERRQ(ierr);
+    for (j=0; j<nsend; j++) nbrs[n++] = sranks[j];
+    for (j=0; j<nrecv; j++) nbrs[n++] = rranks[j];
+  }
+  ierr     = PetscSortRemoveDupsMPIInt(&n,nbrs);CHKERRQ(ierr);
+  b->nnbrs = n;
+
+  /* Message lengths: each operation appends its data for a neighbor after that of the previous operations. The rank to
+     neighbor lookup is done here once, recording where each operation's data for each rank starts in the message. */
+  sendlen = b->sendoff+1;
+  recvlen = b->recvoff+1;
+  ierr    = PetscArrayzero(b->sendoff,n+1);CHKERRQ(ierr);
+  ierr    = PetscArrayzero(b->recvoff,n+1);CHKERRQ(ierr);
+  for (i=0; i<b->nops; i++) {
+    PetscSFBatchOp *o = &b->ops[i];
+
+    if (!o->fused) continue;
+    ierr = PetscSFBatchOpGetSides_Private(o,&nsend,&sranks,&soffset,&sidx,&nrecv,&rranks,&roffset,&ridx);CHKERRQ(ierr);
+    for (j=0; j<nsend; j++) {
+      ierr = PetscFindMPIInt(sranks[j],n,nbrs,&k);CHKERRQ(ierr);
+      b->bufnbr[o->sstart+j] = k;
+      b->bufoff[o->sstart+j] = sendlen[k];
+      sendlen[k] += (size_t)(soffset[j+1]-soffset[j])*o->unitbytes;
+    }
+    for (j=0; j<nrecv; j++) {
+      ierr = PetscFindMPIInt(rranks[j],n,nbrs,&k);CHKERRQ(ierr);
+      b->bufnbr[o->rstart+j] = k;
+      b->bufoff[o->rstart+j] = recvlen[k];
+      recvlen[k] += (size_t)(roffset[j+1]-roffset[j])*o->unitbytes;
+    }
+  }
+  for (k=0; k<n; k++) {
+    b->sendoff[k+1] += b->sendoff[k];
+    b->recvoff[k+1] += b->recvoff[k];
+  }
+  for (i=0; i<b->nops; i++) {
+    PetscSFBatchOp *o = &b->ops[i];
+
+    if (!o->fused) continue;
+    for (j=o->sstart; j<o->rstart; j++) b->bufoff[j] += b->sendoff[b->bufnbr[j]];
+    for (j=o->rstart; j<o->rend; j++) b->bufoff[j] += b->recvoff[b->bufnbr[j]];
+  }
+  if (b->sendoff[n] > b->sendcap) {
+    ierr       = PetscFree(b->sendbuf);CHKERRQ(ierr);
+    b->sendcap = PetscMax(b->sendoff[n],2*b->sendcap);
+    ierr       = PetscMalloc(b->sendcap,&b->sendbuf);CHKERRQ(ierr);
+  }
+  if (b->recvoff[n] > b->recvcap) {
+    ierr       = PetscFree(b->recvbuf);CHKERRQ(ierr);
+    b->recvcap = PetscMax(b->recvoff[n],2*b->recvcap);
+    ierr       = PetscMalloc(b->recvcap,&b->recvbuf);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFBatchBegin - Begins all operations enqueued on a batch, to be concluded with PetscSFBatchEnd()
+
+   Collective
+
+   Input Arguments:
+.  batch - the batch
+
+   Notes:
+   The data of all fused operations is packed and one message is posted to and from each neighbor rank.
+
+   Level: advanced
+
+.seealso: PetscSFBatchCreate(), PetscSFBatchEnd(), PetscSFBatchAddBcast(), PetscSFBatchAddReduce()
+@*/
+PetscErrorCode PetscSFBatchBegin(PetscSFBatch batch)
+{
+  PetscSFBatch      b = batch;
+  PetscInt          i,j,k,l,r,nsend,nrecv;
+  const PetscMPIInt *sranks,*rranks;
+  const PetscInt    *soffset,*roffset,*sidx,*ridx;
+  PetscMPIInt       rank,len;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(batch,1);
+  if (b->started) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"PetscSFBatchBegin() has already been called on this batch");
+  b->started = PETSC_TRUE;
+  ierr = PetscSFBatchSetUpPlan_Private(b);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(b->comm,&rank);CHKERRMPI(ierr);
+
+  /* Post the receives first so that the sends can complete early */
+  b->nrecvreqs = 0;
+  for (k=0; k<b->nnbrs; k++) {
+    if (b->nbrs[k] == rank || b->recvoff[k+1] == b->recvoff[k]) continue;
+    ierr = PetscMPIIntCast(b->recvoff[k+1]-b->recvoff[k],&len);CHKERRQ(ierr);
+    ierr = MPI_Irecv(b->recvbuf+b->recvoff[k],len,MPI_BYTE,b->nbrs[k],b->tag,b->comm,&b->reqs[b->nrecvreqs++]);CHKERRMPI(ierr);
+  }
+
+  /* Pack each run of consecutive indices with one copy */
+  for (i=0; i<b->nops; i++) {
+    PetscSFBatchOp *o = &b->ops[i];
+    const char     *src = (const char*)o->src;
+    size_t         ub = o->unitbytes;
+
+    if (!o->fused) continue;
+    ierr = PetscSFBatchOpGetSides_Private(o,&nsend,&sranks,&soffset,&sidx,&nrecv,&rranks,&roffset,&ridx);CHKERRQ(ierr);
+    for (j=0; j<nsend; j++) {
+      char *buf = b->sendbuf+b->bufoff[o->sstart+j];
+
+      for (l=soffset[j]; l<soffset[j+1]; l=r) {
+        for (r=l+1; r<soffset[j+1] && sidx[r] == sidx[r-1]+1; r++) ;
+        ierr = PetscMemcpy(buf,src+sidx[l]*ub,(r-l)*ub);CHKERRQ(ierr);
+        buf += (r-l)*ub;
+      }
+    }
+  }
+
+  b->nsendreqs = 0;
+  for (k=0; k<b->nnbrs; k++) {
+    size_t n = b->sendoff[k+1]-b->sendoff[k];
+
+    if (!n) continue;
+    if (b->nbrs[k] == rank) {
+      if (n != b->recvoff[k+1]-b->recvoff[k]) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Inconsistent sizes of the data sent to and received from myself");
+      ierr = PetscMemcpy(b->recvbuf+b->recvoff[k],b->sendbuf+b->sendoff[k],n);CHKERRQ(ierr);
+    } else {
+      ierr = PetscMPIIntCast(n,&len);CHKERRQ(ierr);
+      ierr = MPI_Isend(b->sendbuf+b->sendoff[k],len,MPI_BYTE,b->nbrs[k],b->tag,b->comm,&b->reqs[b->nrecvreqs+b->nsendreqs++]);CHKERRMPI(ierr);
+    }
+  }
+
+  /* Operations that could not be fused overlap with the combined messages */
+  for (i=0; i<b->nops; i++) {
+    PetscSFBatchOp *o = &b->ops[i];
+
+    if (o->fused) continue;
+    if (o->reduce) {ierr = PetscSFReduceBegin(o->sf,o->unit,o->src,o->dst,o->op);CHKERRQ(ierr);}
+    else {ierr = PetscSFBcastAndOpBegin(o->sf,o->unit,o->src,o->dst,o->op);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFBatchEnd - Completes all operations enqueued on a batch and empties it
+
+   Collective
+
+   Input Arguments:
+.  batch - the batch
+
+   Notes:
+   Fused operations are unpacked in the order they were added. Afterwards the batch holds no operations and can be filled
+   again, reusing its communication buffers.
+
+   Level: advanced
+
+.seealso: PetscSFBatchCreate(), PetscSFBatchBegin()
+@*/
+PetscErrorCode PetscSFBatchEnd(PetscSFBatch batch)
+{
+  PetscSFBatch      b = batch;
+  PetscInt          i,j,l,r,m,nsend,nrecv;
+  const PetscMPIInt *sranks,*rranks;
+  const PetscInt    *soffset,*roffset,*sidx,*ridx;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(batch,1);
+  if (!b->started) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call PetscSFBatchBegin() before PetscSFBatchEnd()");
+  ierr = MPI_Waitall(b->nrecvreqs,b->reqs,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+
+  for (i=0; i<b->nops; i++) {
+    PetscSFBatchOp *o = &b->ops[i];
+    char           *dst = (char*)o->dst;
+    size_t         ub = o->unitbytes;
+
+    if (!o->fused) continue;
+    ierr = PetscSFBatchOpGetSides_Private(o,&nsend,&sranks,&soffset,&sidx,&nrecv,&rranks,&roffset,&ridx);CHKERRQ(ierr);
+    for (j=0; j<nrecv; j++) {
+      const char *buf = b->recvbuf+b->bufoff[o->rstart+j];
+
+      if (o->op == MPIU_REPLACE) {
+        for (l=roffset[j]; l<roffset[j+1]; l=r) {
+          for (r=l+1; r<roffset[j+1] && ridx[r] == ridx[r-1]+1; r++) ;
+          ierr = PetscMemcpy(dst+ridx[l]*ub,buf,(r-l)*ub);CHKERRQ(ierr);
+          buf += (r-l)*ub;
+        }
+      } else { /* MPIU_SUM on bs PetscScalars */
+        for (l=roffset[j]; l<roffset[j+1]; l++,buf+=ub) {
+          PetscScalar       *y = (PetscScalar*)(dst+ridx[l]*ub);
+          const PetscScalar *x = (const PetscScalar*)buf;
+          for (m=0; m<o->bs; m++) y[m] += x[m];
+        }
+      }
+    }
+  }
+  ierr = MPI_Waitall(b->nsendreqs,b->reqs+b->nrecvreqs,MPI_STATUSES_IGNORE);CHKERRMPI(ierr);
+
+  for (i=0; i<b->nops; i++) {
+    PetscSFBatchOp *o = &b->ops[i];
+
+    if (!o->fused) {
+      if (o->reduce) {ierr = PetscSFReduceEnd(o->sf,o->unit,o->src,o->dst,o->op);CHKERRQ(ierr);}
+      else {ierr = PetscSFBcastAndOpEnd(o->sf,o->unit,o->src,o->dst,o->op);CHKERRQ(ierr);}
+    }
+    ierr = PetscSFDestroy(&o->sf);CHKERRQ(ierr);
+  }
+  b->nops    = 0;
+  b->started = PETSC_FALSE;
+  for (i=0; i<b->nhooks; i++) {ierr = (*b->hooks[i].hook)(b->hooks[i].ctx);CHKERRQ(ierr);}
+  b->nhooks  = 0;
+  PetscFunctionReturn(0);
+}
@@ -12,6 +12,7 @@ PETSC_INTERN PetscErrorCode PetscSFCreate_Alltoall(PetscSF);
 #if defined(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
 PETSC_INTERN PetscErrorCode PetscSFCreate_Neighbor(PetscSF);
 #endif
+PETSC_INTERN PetscErrorCode PetscSFCreate_Hier(PetscSF);
 
 PetscFunctionList PetscSFList;
 PetscBool         PetscSFRegisterAllCalled;
@@ -44,6 +45,7 @@ PetscErrorCode  PetscSFRegisterAll(void)
 #if defined(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
   ierr = PetscSFRegister(PETSCSFNEIGHBOR,  PetscSFCreate_Neighbor);CHKERRQ(ierr);
 #endif
+  ierr = PetscSFRegister(PETSCSFHIER,      PetscSFCreate_Hier);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -0,0 +1,273 @@
+#include <petsc/private/sfimpl.h> /*I "petscsf.h" I*/
+
+/*
+   Selection of the PetscSF type by timing the candidate types on the actual graph.
+
+   The choice is cached per graph signature, a hash of the whole graph, so SFs rebuilt with the same graph (e.g., after a
+   PetscSFReset() or in each of many identical solves) do not pay for the timing again.
+*/
+
+typedef struct {
+  PetscInt64 key;
+  char       type[64];
+} PetscSFTuneEntry;
+
+static PetscSFTuneEntry *PetscSFTuneCache  = NULL;
+static PetscInt         PetscSFTuneCacheN  = 0;
+static PetscInt         PetscSFTuneCacheMax = 0;
+
+static PetscErrorCode PetscSFTuneCacheDestroy_Private(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(PetscSFTuneCache);CHKERRQ(ierr);
+  PetscSFTuneCacheN   = 0;
+  PetscSFTuneCacheMax = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFTuneCacheInsert_Private(PetscInt64 key,PetscSFType type)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (PetscSFTuneCacheN == PetscSFTuneCacheMax) {
+    PetscSFTuneEntry *cache;
+
+    if (!PetscSFTuneCacheMax) {ierr = PetscRegisterFinalize(PetscSFTuneCacheDestroy_Private);CHKERRQ(ierr);}
+    PetscSFTuneCacheMax = PetscMax(16,2*PetscSFTuneCacheMax);
+    ierr = PetscMalloc1(PetscSFTuneCacheMax,&cache);CHKERRQ(ierr);
+    ierr = PetscArraycpy(cache,PetscSFTuneCache,PetscSFTuneCacheN);CHKERRQ(ierr);
+    ierr = PetscFree(PetscSFTuneCache);CHKERRQ(ierr);
+    PetscSFTuneCache = cache;
+  }
+  PetscSFTuneCache[PetscSFTuneCacheN].key = key;
+  ierr = PetscStrncpy(PetscSFTuneCache[PetscSFTuneCacheN].type,type,sizeof(PetscSFTuneCache[0].type));CHKERRQ(ierr);
+  PetscSFTuneCacheN++;
+  PetscFunctionReturn(0);
+}
+
+/* Index of the cached choice for key in the candidate list, -1 if none */
+static PetscErrorCode PetscSFTuneCacheLookup_Private(PetscInt64 key,int ntypes,char **types,PetscMPIInt *choice)
+{
+  PetscInt       i;
+  int            j;
+  PetscBool      match;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *choice = -1;
+  for (i=PetscSFTuneCacheN-1; i>=0; i--) {
+    if (PetscSFTuneCache[i].key != key) continue;
+    for (j=0; j<ntypes; j++) {
+      ierr = PetscStrcmp(PetscSFTuneCache[i].type,types[j],&match);CHKERRQ(ierr);
+      if (match) {*choice = j; PetscFunctionReturn(0);}
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+PETSC_STATIC_INLINE PetscInt64 PetscSFTuneHash_Private(PetscInt64 h,PetscInt64 v)
+{
+  unsigned long long u = (unsigned long long)h;
+
+  /* FNV-1a style mixing of a 64-bit value */
+  u ^= (unsigned long long)v;
+  u *= 0x100000001b3ULL;
+  u ^= u >> 29;
+  return (PetscInt64)u;
+}
+
+/* A hash of the whole graph, identical on all ranks */
+static PetscErrorCode PetscSFGetGraphSignature_Private(PetscSF sf,PetscInt64 *key)
+{
+  PetscInt       i;
+  PetscMPIInt    rank,size;
+  PetscInt64     h = (PetscInt64)0xcbf29ce484222325ULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)sf),&rank);CHKERRMPI(ierr);
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)sf),&size);CHKERRMPI(ierr);
+  h = PetscSFTuneHash_Private(h,rank);
+  h = PetscSFTuneHash_Private(h,size);
+  h = PetscSFTuneHash_Private(h,sf->nroots);
+  h = PetscSFTuneHash_Private(h,sf->nleaves);
+  for (i=0; i<sf->nleaves; i++) {
+    h = PetscSFTuneHash_Private(h,sf->mine ? sf->mine[i] : i);
+    h = PetscSFTuneHash_Private(h,sf->remote[i].rank);
+    h = PetscSFTuneHash_Private(h,sf->remote[i].index);
+  }
+  ierr = MPIU_Allreduce(&h,key,1,MPIU_INT64,MPI_BXOR,PetscObjectComm((PetscObject)sf));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Time one Bcast plus Reduce round of PetscScalars on the graph of sf with the given type, the max over ranks of the best of nreps */
+static PetscErrorCode PetscSFTuneTime_Private(PetscSF sf,PetscSFType type,PetscInt nreps,PetscLogDouble *time)
+{
+  PetscSF        tsf;
+  PetscInt       i,nleafdata;
+  PetscScalar    *rootdata,*leafdata;
+  PetscLogDouble t0,t1,best = PETSC_MAX_REAL;
+  PetscLogEvent  event;
+  char           name[64];
+  MPI_Comm       comm = PetscObjectComm((PetscObject)sf);
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSNPrintf(name,sizeof(name),"SFTune_%s",type);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister(name,PETSCSF_CLASSID,&event);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(event,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSFDuplicate(sf,PETSCSF_DUPLICATE_GRAPH,&tsf);CHKERRQ(ierr);
+  ierr = PetscSFSetType(tsf,type);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(tsf);CHKERRQ(ierr);
+  nleafdata = sf->nleaves ? sf->maxleaf+1 : 0;
+  ierr = PetscCalloc2(sf->nroots,&rootdata,nleafdata,&leafdata);CHKERRQ(ierr);
+  for (i=-1; i<nreps; i++) { /* The first round warms up the communication buffers and is not timed */
+    ierr = MPI_Barrier(comm);CHKERRMPI(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    ierr = PetscSFBcastBegin(tsf,MPIU_SCALAR,rootdata,leafdata);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(tsf,MPIU_SCALAR,rootdata,leafdata);CHKERRQ(ierr);
+    ierr = PetscSFReduceBegin(tsf,MPIU_SCALAR,leafdata,rootdata,MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(tsf,MPIU_SCALAR,leafdata,rootdata,MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    if (i >= 0) best = PetscMin(best,t1-t0);
+  }
+  ierr = PetscFree2(rootdata,leafdata);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&tsf);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&best,time,1,MPIU_PETSCLOGDOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(event,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Candidate types: the ones requested with PetscSFSetAutotune() or -sf_autotune_types, otherwise the general-graph types
+   that work with every MPI */
+static PetscErrorCode PetscSFTuneGetCandidates_Private(PetscSF sf,int *ntypes,char ***types)
+{
+  char           deft[64] = PETSCSFBASIC;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES) && !defined(PETSC_HAVE_OMPI_MAJOR_VERSION)
+  ierr = PetscStrlcat(deft,","PETSCSFNEIGHBOR,sizeof(deft));CHKERRQ(ierr);
+#endif
+  ierr = PetscStrToArray(sf->autotunetypes ? sf->autotunetypes : deft,',',ntypes,types);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscSFAutotune_Private - Sets the type of sf to the fastest of the candidate types on its graph. Called by PetscSFSetUp()
+   when autotuning is on. Collective.
+*/
+PetscErrorCode PetscSFAutotune_Private(PetscSF sf)
+{
+  int            ntypes,j;
+  char           **types;
+  PetscInt64     key;
+  PetscMPIInt    choice,lims[2],glims[2];
+  PetscLogDouble t,best = PETSC_MAX_REAL;
+  PetscSFType    oldtype;
+  PetscBool      match;
+  PetscErrorCode ierr,(*r)(PetscSF);
+
+  PetscFunctionBegin;
+  ierr = PetscSFTuneGetCandidates_Private(sf,&ntypes,&types);CHKERRQ(ierr);
+  for (j=0; j<ntypes; j++) {
+    ierr = PetscFunctionListFind(PetscSFList,types[j],&r);CHKERRQ(ierr);
+    if (!r) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_UNKNOWN_TYPE,"Unable to find requested PetscSF type %s for autotuning",types[j]);
+    ierr = PetscStrInList(types[j],PETSCSFALLGATHERV","PETSCSFALLGATHER","PETSCSFGATHERV","PETSCSFGATHER","PETSCSFALLTOALL,',',&match);CHKERRQ(ierr);
+    if (match) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"PetscSF type %s only supports patterned graphs and cannot be autotuned",types[j]);
+  }
+  if (ntypes < 2) {
+    if (ntypes) {ierr = PetscSFSetType(sf,types[0]);CHKERRQ(ierr);}
+    ierr = PetscStrToArrayDestroy(ntypes,types);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  ierr = PetscLogEventBegin(PETSCSF_Autotune,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSFGetGraphSignature_Private(sf,&key);CHKERRQ(ierr);
+  ierr = PetscSFTuneCacheLookup_Private(key,ntypes,types,&choice);CHKERRQ(ierr);
+  /* Use the cached choice only if all ranks have it, as timing is collective */
+  lims[0] = choice;
+  lims[1] = -choice;
+  ierr = MPIU_Allreduce(lims,glims,2,MPI_INT,MPI_MAX,PetscObjectComm((PetscObject)sf));CHKERRQ(ierr);
+  if (sf->autotunechoice) {
+    for (j=0; j<ntypes; j++) {
+      ierr = PetscStrcmp(sf->autotunechoice,types[j],&match);CHKERRQ(ierr);
+      if (match) break;
+    }
+    if (j == ntypes) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"PetscSF type %s chosen for autotuning is not a candidate",sf->autotunechoice);
+    choice = j;
+    ierr = PetscInfo1(sf,"Chose type %s without timing\n",types[choice]);CHKERRQ(ierr);
+  } else if (glims[0] >= 0 && glims[0] == -glims[1]) {
+    ierr = PetscInfo2(sf,"Using the cached choice %s for a graph with signature %lld\n",types[choice],(long long)key);CHKERRQ(ierr);
+  } else {
+    for (j=0,choice=0; j<ntypes; j++) {
+      ierr = PetscSFTuneTime_Private(sf,types[j],sf->autotunereps,&t);CHKERRQ(ierr);
+      ierr = PetscInfo2(sf,"Type %s takes %g seconds per round\n",types[j],(double)t);CHKERRQ(ierr);
+      if (t < best) {best = t; choice = j;}
+    }
+    ierr = PetscSFTuneCacheInsert_Private(key,types[choice]);CHKERRQ(ierr);
+    ierr = PetscInfo1(sf,"Chose type %s\n",types[choice]);CHKERRQ(ierr);
+  }
+
+  ierr = PetscSFGetType(sf,&oldtype);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)sf,types[choice],&match);CHKERRQ(ierr);
+  if (!match) {
+    ierr = PetscSFSetType(sf,types[choice]);CHKERRQ(ierr);
+    /* Options of the new type were not processed by PetscSFSetFromOptions() */
+    if (oldtype && sf->ops->SetFromOptions) {
+      ierr = PetscObjectOptionsBegin((PetscObject)sf);CHKERRQ(ierr);
+      ierr = (*sf->ops->SetFromOptions)(PetscOptionsObject,sf);CHKERRQ(ierr);
+      ierr = PetscOptionsEnd();CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscStrToArrayDestroy(ntypes,types);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(PETSCSF_Autotune,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFSetAutotune - Lets PetscSFSetUp() choose the type of the PetscSF by timing communication on its graph
+
+   Logically Collective
+
+   Input Arguments:
++  sf - the star forest
+.  flg - PETSC_TRUE to autotune
+-  types - comma-separated list of candidate types, such as "basic,neighbor,window", or NULL for the default candidates
+
+   Options Database Keys:
++  -sf_autotune - autotune the type
+.  -sf_autotune_types <basic,neighbor> - candidate types
+.  -sf_autotune_reps <5> - number of timed communication rounds per candidate
+-  -sf_autotune_choice <type> - choose this candidate without timing, to test each candidate through the autotuning path
+
+   Notes:
+   For each candidate, PetscSFSetUp() times a PetscSFBcastBegin()/End() followed by a PetscSFReduceBegin()/End() of
+   PetscScalars on a copy of the graph and keeps the fastest type, the time of a candidate being the maximum over the
+   processes of the best of the timed rounds. The choice is cached by a hash of the graph, so star forests with a
+   graph already tuned do not time the candidates again. The default candidates are PETSCSFBASIC and, when the MPI
+   neighborhood collectives are usable, PETSCSFNEIGHBOR. Only general graphs (see PetscSFSetGraph()) are autotuned.
+
+   The time spent timing each candidate is logged in the SFTune_<type> events of -log_view, and the whole selection,
+   including cache lookups, in the SFAutotune event. Use -info to see the measured times and the chosen type.
+
+   Level: intermediate
+
+.seealso: PetscSFSetType(), PetscSFSetUp(), PetscSFSetFromOptions()
+@*/
+PetscErrorCode PetscSFSetAutotune(PetscSF sf,PetscBool flg,const char types[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  PetscValidLogicalCollectiveBool(sf,flg,2);
+  if (sf->setupcalled && flg != sf->autotune) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Must be called before PetscSFSetUp()");
+  sf->autotune = flg;
+  ierr = PetscFree(sf->autotunetypes);CHKERRQ(ierr);
+  ierr = PetscStrallocpy(types,&sf->autotunetypes);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -1387,3 +1387,102 @@ PetscErrorCode  VecScatterEnd(VecScatter sf,Vec x,Vec y,InsertMode addv,ScatterM
   }
   PetscFunctionReturn(0);
 }
+
+/* A scatter enqueued on a PetscSFBatch, whose vector arrays are held until the batch is complete */
+typedef struct {
+  Vec               x,y;
+  const PetscScalar *xdata;
+  PetscScalar       *ydata;
+  PetscBool         memtype;  /* Were the arrays got with their memory type? */
+} VecScatterBatchOp;
+
+/* Restores the arrays and locks of the vectors in the order of VecScatterEnd() */
+static PetscErrorCode VecScatterBatchRestore_Private(void *ctx)
+{
+  VecScatterBatchOp *op = (VecScatterBatchOp*)ctx;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (op->x != op->y) {
+    if (op->memtype) {ierr = VecRestoreArrayReadAndMemType(op->x,&op->xdata);CHKERRQ(ierr);}
+    else {ierr = VecRestoreArrayRead(op->x,&op->xdata);CHKERRQ(ierr);}
+    ierr = VecLockReadPop(op->x);CHKERRQ(ierr);
+  }
+  if (op->memtype) {ierr = VecRestoreArrayAndMemType(op->y,&op->ydata);CHKERRQ(ierr);}
+  else {ierr = VecRestoreArray(op->y,&op->ydata);CHKERRQ(ierr);}
+  ierr = VecLockWriteSet_Private(op->y,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = PetscFree(op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecScatterBatchAdd - Enqueues a vector scatter on a PetscSFBatch, to be executed with the other operations of the batch
+
+   Logically Collective on VecScatter
+
+   Input Parameters:
++  sf - scatter context generated by VecScatterCreate()
+.  batch - the batch, created with PetscSFBatchCreate()
+.  x - the vector from which we scatter
+.  y - the vector to which we scatter
+.  addv - either ADD_VALUES, MAX_VALUES, MIN_VALUES or INSERT_VALUES
+-  mode - the scattering mode, usually SCATTER_FORWARD. SCATTER_REVERSE also works.
+
+   Notes:
+   The scatter is only complete after PetscSFBatchEnd() returns. Until then, as between VecScatterBegin() and VecScatterEnd(),
+   x is locked for reading and y for writing. Local scatters (SCATTER_LOCAL) do not communicate and are completed immediately.
+   The vectors must be in host memory.
+
+   Level: advanced
+
+.seealso: VecScatterBegin(), PetscSFBatchCreate(), PetscSFBatchBegin(), PetscSFBatchEnd()
+@*/
+PetscErrorCode VecScatterBatchAdd(VecScatter sf,PetscSFBatch batch,Vec x,Vec y,InsertMode addv,ScatterMode mode)
+{
+  PetscErrorCode    ierr;
+  VecScatterBatchOp *op;
+  MPI_Op            mop = MPI_OP_NULL;
+  PetscMemType      xmtype = PETSC_MEMTYPE_HOST,ymtype = PETSC_MEMTYPE_HOST;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  PetscValidPointer(batch,2);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,3);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,4);
+  if (mode & SCATTER_LOCAL) {
+    ierr = VecScatterBegin(sf,x,y,addv,mode);CHKERRQ(ierr);
+    ierr = VecScatterEnd(sf,x,y,addv,mode);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (addv == INSERT_VALUES)   mop = MPIU_REPLACE;
+  else if (addv == ADD_VALUES) mop = MPIU_SUM;
+  else if (addv == MAX_VALUES) mop = MPIU_MAX;
+  else if (addv == MIN_VALUES) mop = MPIU_MIN;
+  else SETERRQ1(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"Unsupported InsertMode %D in VecScatterBatchAdd",addv);
+
+  /* Take the locks and arrays as VecScatterBegin() does, they are released once the batch is complete */
+  ierr = PetscNew(&op);CHKERRQ(ierr);
+  op->x       = x;
+  op->y       = y;
+  op->memtype = (sf->use_gpu_aware_mpi || sf->vscat.packongpu) ? PETSC_TRUE : PETSC_FALSE;
+  if (x != y) {ierr = VecLockReadPush(x);CHKERRQ(ierr);}
+  if (op->memtype) {ierr = VecGetArrayReadAndMemType(x,&op->xdata,&xmtype);CHKERRQ(ierr);}
+  else {ierr = VecGetArrayRead(x,&op->xdata);CHKERRQ(ierr);}
+  if (x != y) {
+    if (op->memtype) {ierr = VecGetArrayAndMemType(y,&op->ydata,&ymtype);CHKERRQ(ierr);}
+    else {ierr = VecGetArray(y,&op->ydata);CHKERRQ(ierr);}
+  } else {
+    op->ydata = (PetscScalar*)op->xdata;
+    ymtype    = xmtype;
+  }
+  ierr = VecLockWriteSet_Private(y,PETSC_TRUE);CHKERRQ(ierr);
+  if (xmtype != PETSC_MEMTYPE_HOST || ymtype != PETSC_MEMTYPE_HOST) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"VecScatterBatchAdd() requires vectors in host memory");
+
+  if (mode & SCATTER_REVERSE) {
+    ierr = PetscSFBatchAddReduce(batch,sf,sf->vscat.unit,op->xdata,op->ydata,mop);CHKERRQ(ierr);
+  } else {
+    ierr = PetscSFBatchAddBcast(batch,sf,sf->vscat.unit,op->xdata,op->ydata,mop);CHKERRQ(ierr);
+  }
+  ierr = PetscSFBatchAddEndHook_Private(batch,VecScatterBatchRestore_Private,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
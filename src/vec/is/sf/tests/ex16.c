@@ -0,0 +1,120 @@
+static char help[]= "Ping-pong benchmark of PetscSF between pairs of processes.\n\
+  Each process owns n roots and n leaves connected to the roots of its partner. A round trip is a Bcast followed by\n\
+  a Reduce, and alternates between -narrays pairs of root/leaf arrays, like ghost updates of several vectors do.\n\
+  Message sizes are doubled from 1 to -n. Use -timing to print the half round-trip latency and -print_type to print the\n\
+  type of the PetscSF used for each size, e.g., the one chosen by -sf_autotune.\n\n";
+
+#include <petscsf.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    size,rank,partner;
+  PetscInt       i,j,k,n = 1024,m,narrays = 2,niter = 100,nwarmup = 10,nsizes = 0;
+  PetscSFNode    *iremote;
+  PetscScalar    **rootdata,**leafdata;
+  PetscSF        sf;
+  PetscBool      timing = PETSC_FALSE,printtype = PETSC_FALSE;
+  PetscSFType    type;
+  double         t0 = 0.0,t1;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRMPI(ierr);
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRMPI(ierr);
+  if (size%2) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_ARG_SIZ,"This benchmark must run with an even number of processes");
+  partner = rank^1;
+
+  ierr = PetscOptionsBegin(PETSC_COMM_WORLD,NULL,"PetscSF ping-pong options","none");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-n","Largest message size in scalars","ex16.c",n,&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-narrays","Number of root/leaf array pairs to alternate between","ex16.c",narrays,&narrays,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-niter","Number of round trips to time","ex16.c",niter,&niter,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-nwarmup","Number of round trips before timing","ex16.c",nwarmup,&nwarmup,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-timing","Print the half round-trip latency","ex16.c",timing,&timing,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-print_type","Print the PetscSF type used for each message size","ex16.c",printtype,&printtype,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+
+  ierr = PetscMalloc1(n,&iremote);CHKERRQ(ierr);
+  ierr = PetscMalloc2(narrays,&rootdata,narrays,&leafdata);CHKERRQ(ierr);
+  for (k=0; k<narrays; k++) {ierr = PetscMalloc2(n,&rootdata[k],n,&leafdata[k]);CHKERRQ(ierr);}
+
+  if (timing) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%10s %16s\n","scalars","latency (us)");CHKERRQ(ierr);}
+  for (m=1; m<=n; m*=2, nsizes++) {
+    for (i=0; i<m; i++) {
+      iremote[i].rank  = partner;
+      iremote[i].index = i;
+    }
+    ierr = PetscSFCreate(PETSC_COMM_WORLD,&sf);CHKERRQ(ierr);
+    ierr = PetscSFSetFromOptions(sf);CHKERRQ(ierr);
+    ierr = PetscSFSetGraph(sf,m,m,NULL,PETSC_COPY_VALUES,iremote,PETSC_COPY_VALUES);CHKERRQ(ierr);
+    ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+    if (printtype) {
+      ierr = PetscSFGetType(sf,&type);CHKERRQ(ierr);
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"%D scalars use PetscSF type %s\n",m,type);CHKERRQ(ierr);
+    }
+
+    for (k=0; k<narrays; k++) {
+      for (i=0; i<m; i++) rootdata[k][i] = 1000*rank+100*k+i;
+    }
+    /* Each round trip adds one to the roots: leaves get the partner's roots, are incremented, and are sent back */
+    for (j=0; j<nwarmup+niter; j++) {
+      if (j == nwarmup) {
+        ierr = MPI_Barrier(PETSC_COMM_WORLD);CHKERRMPI(ierr);
+        t0   = MPI_Wtime();
+      }
+      k    = j%narrays;
+      ierr = PetscSFBcastBegin(sf,MPIU_SCALAR,rootdata[k],leafdata[k]);CHKERRQ(ierr);
+      ierr = PetscSFBcastEnd(sf,MPIU_SCALAR,rootdata[k],leafdata[k]);CHKERRQ(ierr);
+      for (i=0; i<m; i++) leafdata[k][i] += 1.0;
+      ierr = PetscSFReduceBegin(sf,MPIU_SCALAR,leafdata[k],rootdata[k],MPIU_REPLACE);CHKERRQ(ierr);
+      ierr = PetscSFReduceEnd(sf,MPIU_SCALAR,leafdata[k],rootdata[k],MPIU_REPLACE);CHKERRQ(ierr);
+    }
+    t1 = MPI_Wtime();
+
+    for (k=0; k<narrays; k++) {
+      PetscInt ntrips = (nwarmup+niter)/narrays + (k < (nwarmup+niter)%narrays ? 1 : 0);
+
+      for (i=0; i<m; i++) {
+        if (rootdata[k][i] != (PetscScalar)(1000*rank+100*k+i+ntrips)) SETERRQ5(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Wrong value %g for root %D of array %D with %D scalars, expected %D",(double)PetscRealPart(rootdata[k][i]),i,k,m,1000*rank+100*k+i+ntrips);
+      }
+    }
+    if (timing) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%10D %16.3f\n",m,0.5e6*(t1-t0)/PetscMax(niter,1));CHKERRQ(ierr);}
+    ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Ping-pong verified for %D message sizes and %D arrays\n",nsizes,narrays);CHKERRQ(ierr);
+
+  for (k=0; k<narrays; k++) {ierr = PetscFree2(rootdata[k],leafdata[k]);CHKERRQ(ierr);}
+  ierr = PetscFree2(rootdata,leafdata);CHKERRQ(ierr);
+  ierr = PetscFree(iremote);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   build:
+     requires: !define(PETSC_HAVE_MPIUNI)
+
+   testset:
+     nsize: 2
+     args: -n 64 -niter 20
+     output_file: output/ex16_1.out
+     test:
+       suffix: 1
+     test:
+       suffix: 2
+       args: -narrays 6
+       output_file: output/ex16_2.out
+     test:
+       suffix: 3
+       args: -sf_type neighbor
+       requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES) !define(PETSC_HAVE_OMPI_MAJOR_VERSION)
+     test:
+       suffix: 4
+       args: -sf_autotune -sf_autotune_types basic,hier
+
+   test:
+     suffix: 5
+     nsize: 2
+     args: -n 64 -niter 20 -sf_autotune -sf_autotune_types basic,hier -sf_autotune_choice {{basic hier}separate output} -print_type
+
+TEST*/
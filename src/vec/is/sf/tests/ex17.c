@@ -0,0 +1,136 @@
+static char help[]= "Test PetscSFBatch: several Bcast and Reduce operations on different PetscSFs and MPI datatypes communicated together.\n\n";
+
+#include <petscsf.h>
+
+/* Leaves reference roots on the ranks at distance shift, each of the n roots being referenced by one leaf */
+static PetscErrorCode CreateShiftSF(MPI_Comm comm,PetscInt n,PetscMPIInt shift,PetscSF *sf)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    size,rank;
+  PetscSFNode    *iremote;
+  PetscInt       *ilocal,i;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_size(comm,&size);CHKERRMPI(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRMPI(ierr);
+  ierr = PetscMalloc1(n,&iremote);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&ilocal);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    ilocal[i]        = 2*i+1;                  /* Leaves are interlaced with unused entries */
+    iremote[i].rank  = (rank+shift)%size;
+    iremote[i].index = (3*i)%n;                /* Permuted roots */
+  }
+  ierr = PetscSFCreate(comm,sf);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(*sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(*sf,n,n,ilocal,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(*sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    size,rank;
+  PetscInt       i,j,it,n = 10,nleaves = 20,N;
+  PetscSF        sfa,sfb,sfc;
+  PetscSFBatch   batch;
+  PetscLayout    map;
+  MPI_Datatype   pair;
+  PetscScalar    *aroot,*aleaf,*aleaf2,*broot,*broot2,*bleaf;
+  PetscInt       *iroot,*ileaf,*ileaf2,*groot,*gleaf,*gleaf2;
+  PetscBool      same = PETSC_TRUE;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRMPI(ierr);
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRMPI(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  nleaves = 2*n;
+
+  ierr = CreateShiftSF(PETSC_COMM_WORLD,n,1,&sfa);CHKERRQ(ierr);
+  ierr = CreateShiftSF(PETSC_COMM_WORLD,n,size > 2 ? 2 : 0,&sfb);CHKERRQ(ierr);
+  /* A patterned SF, whose operations are not fused but executed alongside the fused ones */
+  ierr = PetscLayoutCreate(PETSC_COMM_WORLD,&map);CHKERRQ(ierr);
+  ierr = PetscLayoutSetLocalSize(map,n);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(map);CHKERRQ(ierr);
+  ierr = PetscLayoutGetSize(map,&N);CHKERRQ(ierr);
+  ierr = PetscSFCreate(PETSC_COMM_WORLD,&sfc);CHKERRQ(ierr);
+  ierr = PetscSFSetGraphWithPattern(sfc,map,PETSCSF_PATTERN_ALLGATHER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(sfc);CHKERRQ(ierr);
+  ierr = MPI_Type_contiguous(2,MPIU_SCALAR,&pair);CHKERRMPI(ierr);
+  ierr = MPI_Type_commit(&pair);CHKERRMPI(ierr);
+
+  ierr = PetscMalloc6(n,&aroot,nleaves,&aleaf,nleaves,&aleaf2,2*n,&broot,2*n,&broot2,2*nleaves,&bleaf);CHKERRQ(ierr);
+  ierr = PetscMalloc6(n,&iroot,nleaves,&ileaf,nleaves,&ileaf2,n,&groot,N,&gleaf,N,&gleaf2);CHKERRQ(ierr);
+
+  ierr = PetscSFBatchCreate(PETSC_COMM_WORLD,&batch);CHKERRQ(ierr);
+  /* Run twice to check that a batch can be refilled after PetscSFBatchEnd() */
+  for (it=0; it<2; it++) {
+    for (i=0; i<n; i++) {
+      aroot[i]     = 100*rank+i+it;
+      broot[2*i]   = broot2[2*i]   = rank;
+      broot[2*i+1] = broot2[2*i+1] = -i;
+      iroot[i]     = 1000*rank+10*i+it;
+      groot[i]     = -(1000*rank+i+it);
+    }
+    for (i=0; i<nleaves; i++) {
+      aleaf[i]      = aleaf2[i] = -1;
+      bleaf[2*i]    = 10*rank+i;
+      bleaf[2*i+1]  = i;
+      ileaf[i]      = ileaf2[i] = -1;
+    }
+    for (i=0; i<N; i++) gleaf[i] = gleaf2[i] = -1;
+
+    /* Reference results with individual operations */
+    ierr = PetscSFBcastBegin(sfa,MPIU_SCALAR,aroot,aleaf2);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sfa,MPIU_SCALAR,aroot,aleaf2);CHKERRQ(ierr);
+    ierr = PetscSFReduceBegin(sfb,pair,bleaf,broot2,MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(sfb,pair,bleaf,broot2,MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSFBcastBegin(sfb,MPIU_INT,iroot,ileaf2);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sfb,MPIU_INT,iroot,ileaf2);CHKERRQ(ierr);
+    ierr = PetscSFBcastBegin(sfc,MPIU_INT,groot,gleaf2);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sfc,MPIU_INT,groot,gleaf2);CHKERRQ(ierr);
+
+    ierr = PetscSFBatchAddBcast(batch,sfa,MPIU_SCALAR,aroot,aleaf,MPIU_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFBatchAddReduce(batch,sfb,pair,bleaf,broot,MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSFBatchAddBcast(batch,sfb,MPIU_INT,iroot,ileaf,MPIU_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFBatchAddBcast(batch,sfc,MPIU_INT,groot,gleaf,MPIU_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFBatchBegin(batch);CHKERRQ(ierr);
+    ierr = PetscSFBatchEnd(batch);CHKERRQ(ierr);
+
+    for (i=0; i<nleaves; i++) {
+      if (aleaf[i] != aleaf2[i] || ileaf[i] != ileaf2[i]) same = PETSC_FALSE;
+    }
+    for (i=0; i<2*n; i++) if (broot[i] != broot2[i]) same = PETSC_FALSE;
+    for (j=0; j<N; j++) if (gleaf[j] != gleaf2[j]) same = PETSC_FALSE;
+  }
+  ierr = MPI_Allreduce(MPI_IN_PLACE,&same,1,MPIU_BOOL,MPI_LAND,PETSC_COMM_WORLD);CHKERRMPI(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Batched operations %s the individual operations\n",same ? "match" : "DO NOT match");CHKERRQ(ierr);
+
+  ierr = PetscSFBatchDestroy(&batch);CHKERRQ(ierr);
+  ierr = PetscFree6(aroot,aleaf,aleaf2,broot,broot2,bleaf);CHKERRQ(ierr);
+  ierr = PetscFree6(iroot,ileaf,ileaf2,groot,gleaf,gleaf2);CHKERRQ(ierr);
+  ierr = MPI_Type_free(&pair);CHKERRMPI(ierr);
+  ierr = PetscLayoutDestroy(&map);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sfa);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sfb);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sfc);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+     output_file: output/ex17_1.out
+     test:
+       suffix: 1
+     test:
+       suffix: 2
+       nsize: 4
+     test:
+       suffix: 3
+       nsize: 3
+       args: -sf_type neighbor
+       requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES) !define(PETSC_HAVE_OMPI_MAJOR_VERSION)
+
+TEST*/
@@ -599,4 +599,33 @@ int main(int argc,char **argv)
       nsize: 4
       args: -sf_type basic -test_all -test_bcastop 0 -test_fetchandop 0
 
+   # Send/receive noncontiguous roots and leaves in place with MPI derived datatypes
+   testset:
+      nsize: 4
+      args: -sf_type basic -sf_basic_datatypes always
+      test:
+         suffix: 10_basic_datatypes
+         args: -test_all -test_bcastop 0 -test_fetchandop 0
+         output_file: output/ex1_10_basic.out
+      test:
+         suffix: bcastop_basic_datatypes
+         args: -test_bcastop
+         output_file: output/ex1_bcastop_basic.out
+
+   testset:
+      filter: grep -v "type" | grep -v "sort"
+      args: -sf_type hier -sf_hier_node_size {{0 1 2}}
+      test:
+         suffix: 10_hier
+         nsize: 4
+         args: -test_all -test_bcastop 0 -test_fetchandop 0
+      test:
+         suffix: bcastop_hier
+         nsize: 4
+         args: -test_bcastop
+      test:
+         suffix: 8_hier
+         nsize: 3
+         args: -test_bcast -test_sf_distribute
+
 TEST*/